@@ -21,6 +21,10 @@
 #include <map>
 #include <unordered_map>
 #include <memory>
+#include <atomic>
+#include <future>
+#include <thread>
+#include <vector>
 
 // #include <FairLogger.h>
 
@@ -36,23 +40,47 @@ namespace o2::ccdb
 ///
 /// In cases where caching is not needed or just 1 instance of the manager is enough, one case use
 /// a singleton version BasicCCDBManager
+///
+/// Optionally, the retrieved objects are also kept in a persistent disk cache shared between the processes,
+/// which can be filled in advance by the asynchronous prefetching of the objects needed for the upcoming
+/// timestamps range (e.g. at the start of run), so that the getters do not wait for the server.
 
 class CCDBManagerInstance
 {
   struct CachedObject {
     std::shared_ptr<void> objPtr;
     std::string uuid;
+    std::string diskFile; // disk cache file the object was read from
+    long startvalidity = 0;
+    long endvalidity = 0;
+    bool isValid(long ts) { return ts < endvalidity && ts >= startvalidity; }
+  };
+
+  /// object stored in the disk cache
+  struct DiskCacheEntry {
+    std::string file;
     long startvalidity = 0;
     long endvalidity = 0;
-    bool isValid(long ts) { return ts < endvalidity && ts > startvalidity; }
+    long created = 0;
   };
 
  public:
+  /// counters of the objects requests
+  struct CacheMetrics {
+    size_t memoryHits = 0;       ///< served by the memory cache (incl. the server confirming the validity of the cached object)
+    size_t diskHits = 0;         ///< served by the disk cache
+    size_t misses = 0;           ///< downloaded from the server on request
+    size_t prefetched = 0;       ///< downloaded to the disk cache by the prefetching
+    size_t prefetchFailures = 0; ///< objects the prefetching failed to retrieve
+  };
+
   CCDBManagerInstance(std::string const& path) : mCCDBAccessor{}
   {
     mCCDBAccessor.init(path);
   }
 
+  ~CCDBManagerInstance() { waitForPrefetch(); }
+
   /// set a URL to query from
   void setURL(const std::string& url);
 
@@ -126,7 +154,43 @@ class CCDBManagerInstance
   /// reset the object upper validity limit
   void resetCreatedNotBefore() { mCreatedNotBefore = 0; }
 
+  /// set the directory of the disk cache, an empty string disables it. The objects are stored there in the snapshot layout as
+  /// dir/path/<Valid-From>_<Valid-Until>_<Created>_<ETag>/snapshot.root and are served without querying the server whenever
+  /// their validity covers the requested timestamp. The disk cache is not used in the TimeMachine mode
+  void setDiskCache(std::string const& dir);
+
+  /// query the directory of the disk cache
+  std::string const& getDiskCache() const { return mDiskCacheDir; }
+
+  /// check if the disk cache can be used for the queries
+  bool isDiskCacheUsable() const { return !mDiskCacheDir.empty() && !mCreatedNotAfter && !mCreatedNotBefore; }
+
+  /// asynchronously retrieve to the disk cache all objects of the paths valid in the [start, end] timestamps range,
+  /// using up to nThreads concurrent downloads. The getters of the path being prefetched wait for its prefetching to finish
+  void prefetch(std::vector<std::string> const& paths, long start, long end, int nThreads = 8);
+
+  /// wait until all prefetching is finished
+  void waitForPrefetch();
+
+  /// get the requests counters
+  CacheMetrics getCacheMetrics() const;
+
+  /// print the requests counters
+  void printCacheMetrics() const;
+
  private:
+  /// get the object valid for the timestamp from the disk cache, retrieving it from the server if it is not there
+  bool getFromDiskCache(std::string const& path, long timestamp, DiskCacheEntry& entry);
+
+  /// find in the disk cache the most recent object valid for the timestamp
+  bool findInDiskCache(std::string const& path, long timestamp, DiskCacheEntry& entry) const;
+
+  /// retrieve from the server to the disk cache the object valid for the timestamp
+  bool fetchToDiskCache(std::string const& path, long timestamp, DiskCacheEntry& entry);
+
+  /// retrieve to the disk cache all objects of the path valid in the [start, end] timestamps range
+  void prefetchPath(std::string const& path, long start, long end);
+
   // we access the CCDB via the CURL based C++ API
   o2::ccdb::CcdbApi mCCDBAccessor;
   std::unordered_map<std::string, CachedObject> mCache; //! map for {path, CachedObject} associations
@@ -138,32 +202,65 @@ class CCDBManagerInstance
   bool mCheckObjValidityEnabled = false;                // wether the validity of cached object is checked before proceeding to a CCDB API query
   long mCreatedNotAfter = 0;                            // upper limit for object creation timestamp (TimeMachine mode) - If-Not-After HTTP header
   long mCreatedNotBefore = 0;                           // lower limit for object creation timestamp (TimeMachine mode) - If-Not-Before HTTP header
+  std::string mDiskCacheDir;                            // directory of the disk cache, not used if empty
+  std::unordered_map<std::string, std::shared_future<void>> mPrefetchPending; //! paths being prefetched
+  std::vector<std::thread> mPrefetchWorkers;                                  //! prefetching threads
+  std::atomic<size_t> mTmpFileCounter{0};                                     //! to generate unique names of files being downloaded
+  std::atomic<size_t> mMemoryHits{0};                                         //! requests counters, see CacheMetrics
+  std::atomic<size_t> mDiskHits{0};                                           //!
+  std::atomic<size_t> mMisses{0};                                             //!
+  std::atomic<size_t> mPrefetched{0};                                         //!
+  std::atomic<size_t> mPrefetchFailures{0};                                   //!
 };
 
 template <typename T>
 T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
 {
   if (!isCachingEnabled()) {
+    mMisses++;
     return mCCDBAccessor.retrieveFromTFileAny<T>(path, mMetaData, timestamp, nullptr, "",
                                                  mCreatedNotAfter ? std::to_string(mCreatedNotAfter) : "",
                                                  mCreatedNotBefore ? std::to_string(mCreatedNotBefore) : "");
   }
   auto& cached = mCache[path];
   if (mCheckObjValidityEnabled && cached.isValid(timestamp)) {
+    mMemoryHits++;
     return reinterpret_cast<T*>(cached.objPtr.get());
   }
 
+  DiskCacheEntry entry;
+  if (isDiskCacheUsable() && getFromDiskCache(path, timestamp, entry)) {
+    if (cached.objPtr && cached.diskFile == entry.file) { // the object is already in memory
+      return reinterpret_cast<T*>(cached.objPtr.get());
+    }
+    T* ptr = reinterpret_cast<T*>(mCCDBAccessor.extractFromLocalFile(entry.file, typeid(T), &mHeaders));
+    if (ptr) {
+      cached.objPtr.reset(ptr);
+      cached.uuid = mHeaders["ETag"];
+      cached.diskFile = entry.file;
+      cached.startvalidity = entry.startvalidity;
+      cached.endvalidity = entry.endvalidity;
+      mHeaders.clear();
+      return ptr;
+    }
+    mHeaders.clear();
+    // failed to read the disk cache, query the server
+  }
+
   T* ptr = mCCDBAccessor.retrieveFromTFileAny<T>(path, mMetaData, timestamp, &mHeaders, cached.uuid,
                                                  mCreatedNotAfter ? std::to_string(mCreatedNotAfter) : "",
                                                  mCreatedNotBefore ? std::to_string(mCreatedNotBefore) : "");
   if (ptr) { // new object was shipped, old one (if any) is not valid anymore
+    mMisses++;
     cached.objPtr.reset(ptr);
     cached.uuid = mHeaders["ETag"];
+    cached.diskFile.clear();
     cached.startvalidity = std::stol(mHeaders["Valid-From"]);
     cached.endvalidity = std::stol(mHeaders["Valid-Until"]);
   } else if (mHeaders.count("Error")) { // in case of errors the pointer is 0 and headers["Error"] should be set
     clearCache(path);                   // in case of any error clear cache for this object
   } else {                              // the old object is valid
+    mMemoryHits++;
     ptr = reinterpret_cast<T*>(cached.objPtr.get());
   }
   mHeaders.clear();
@@ -224,6 +224,13 @@ class CcdbApi //: public DatabaseInterface
   */
   void retrieveBlob(std::string const& path, std::string const& targetdir, std::map<std::string, std::string> const& metadata, long timestamp) const;
 
+  /**
+   *  Retrieve the blob corresponding to some path and timestamp into the targetpath file, which gets the same content
+   *  as a snapshot.root file. In snapshot mode the snapshot file is copied.
+   *  @return the headers of the retrieved object, empty map in case of failure
+   */
+  std::map<std::string, std::string> retrieveBlobToFile(std::string const& path, std::string const& targetpath, std::map<std::string, std::string> const& metadata, long timestamp) const;
+
   /**
    * Retrieve the headers of a CCDB entry, if it exists.
    * @param path The path where the object is to be found.
@@ -341,7 +348,6 @@ class CcdbApi //: public DatabaseInterface
                           long timestamp = -1, std::map<std::string, std::string>* headers = nullptr, std::string const& etag = "",
                           const std::string& createdNotAfter = "", const std::string& createdNotBefore = "") const;
 
- private:
   /**
    * A helper function to extract object from a local ROOT file
    * @param filename name of ROOT file
@@ -350,6 +356,7 @@ class CcdbApi //: public DatabaseInterface
    */
   void* extractFromLocalFile(std::string const& filename, std::type_info const& tinfo, std::map<std::string, std::string>* headers) const;
 
+ private:
   /**
    * Helper function to download binary content from alien:// storage
    * @param fullUrl The alien URL
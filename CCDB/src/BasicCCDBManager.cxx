@@ -13,17 +13,202 @@
 // Created by Sandro Wenzel on 2019-08-14.
 //
 #include "CCDB/BasicCCDBManager.h"
+#include <FairLogger.h>
+#include <TROOT.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
 #include <string>
+#include <unistd.h>
 
 namespace o2
 {
 namespace ccdb
 {
 
+namespace
+{
+// name of the disk cache entry directory: <Valid-From>_<Valid-Until>_<Created>_<ETag>, with the ETag stripped of
+// the characters which are not allowed in the file names
+std::string diskCacheEntryName(long startvalidity, long endvalidity, long created, std::string const& etag)
+{
+  std::string tag;
+  std::copy_if(etag.begin(), etag.end(), std::back_inserter(tag), [](unsigned char c) { return std::isalnum(c) || c == '-'; });
+  return std::to_string(startvalidity) + "_" + std::to_string(endvalidity) + "_" + std::to_string(created) + "_" + tag;
+}
+
+bool parseDiskCacheEntryName(std::string const& name, long& startvalidity, long& endvalidity, long& created)
+{
+  return std::sscanf(name.c_str(), "%ld_%ld_%ld_", &startvalidity, &endvalidity, &created) == 3;
+}
+
+long getHeaderValue(std::map<std::string, std::string> const& headers, std::string const& key)
+{
+  auto it = headers.find(key);
+  return it == headers.end() ? -1 : std::stol(it->second);
+}
+} // namespace
+
 void CCDBManagerInstance::setURL(std::string const& url)
 {
+  waitForPrefetch();
   mCCDBAccessor.init(url);
 }
 
+void CCDBManagerInstance::setDiskCache(std::string const& dir)
+{
+  waitForPrefetch();
+  mDiskCacheDir = dir;
+}
+
+void CCDBManagerInstance::prefetch(std::vector<std::string> const& paths, long start, long end, int nThreads)
+{
+  if (mDiskCacheDir.empty()) {
+    LOG(WARNING) << "Disk cache is not set, cannot prefetch CCDB objects";
+    return;
+  }
+  if (paths.empty()) {
+    return;
+  }
+  auto pathsToFetch = std::make_shared<std::vector<std::string>>(paths);
+  auto done = std::make_shared<std::vector<std::promise<void>>>(paths.size());
+  auto next = std::make_shared<std::atomic<size_t>>(0);
+  for (size_t ip = 0; ip < paths.size(); ip++) {
+    mPrefetchPending[paths[ip]] = (*done)[ip].get_future().share();
+  }
+  nThreads = std::clamp(nThreads, 1, int(paths.size()));
+  // the workers open the snapshot files of a local CCDB with ROOT
+  ROOT::EnableThreadSafety();
+  LOG(INFO) << "Prefetching " << paths.size() << " CCDB paths for timestamps " << start << " : " << end << " with " << nThreads << " threads";
+  for (int i = 0; i < nThreads; i++) {
+    mPrefetchWorkers.emplace_back([this, pathsToFetch, done, next, start, end]() {
+      size_t ip;
+      while ((ip = (*next)++) < pathsToFetch->size()) {
+        prefetchPath((*pathsToFetch)[ip], start, end);
+        (*done)[ip].set_value();
+      }
+    });
+  }
+}
+
+void CCDBManagerInstance::prefetchPath(std::string const& path, long start, long end)
+{
+  long timestamp = start;
+  while (true) {
+    DiskCacheEntry entry;
+    if (!findInDiskCache(path, timestamp, entry)) {
+      if (!fetchToDiskCache(path, timestamp, entry)) {
+        mPrefetchFailures++;
+        return;
+      }
+      mPrefetched++;
+    }
+    if (entry.endvalidity > end || entry.endvalidity <= timestamp) { // the range is covered
+      return;
+    }
+    timestamp = entry.endvalidity; // the next object starts where the current one ends
+  }
+}
+
+void CCDBManagerInstance::waitForPrefetch()
+{
+  for (auto& worker : mPrefetchWorkers) {
+    worker.join();
+  }
+  mPrefetchWorkers.clear();
+  mPrefetchPending.clear();
+}
+
+bool CCDBManagerInstance::getFromDiskCache(std::string const& path, long timestamp, DiskCacheEntry& entry)
+{
+  auto pending = mPrefetchPending.find(path);
+  if (pending != mPrefetchPending.end()) {
+    pending->second.wait();
+    mPrefetchPending.erase(pending);
+  }
+  if (findInDiskCache(path, timestamp, entry)) {
+    mDiskHits++;
+    return true;
+  }
+  if (fetchToDiskCache(path, timestamp, entry)) {
+    mMisses++;
+    return true;
+  }
+  return false;
+}
+
+bool CCDBManagerInstance::findInDiskCache(std::string const& path, long timestamp, DiskCacheEntry& entry) const
+{
+  std::error_code ec, ecEntry;
+  std::filesystem::directory_iterator dirIt(mDiskCacheDir + "/" + path, ec), dirEnd;
+  bool found = false;
+  for (; !ec && dirIt != dirEnd; dirIt.increment(ec)) {
+    long startvalidity, endvalidity, created;
+    if (!dirIt->is_directory(ecEntry) || !parseDiskCacheEntryName(dirIt->path().filename().string(), startvalidity, endvalidity, created) ||
+        timestamp < startvalidity || timestamp >= endvalidity || (found && created <= entry.created)) {
+      continue;
+    }
+    auto file = dirIt->path().string() + "/snapshot.root";
+    if (!std::filesystem::exists(file, ecEntry)) {
+      continue;
+    }
+    entry.file = file;
+    entry.startvalidity = startvalidity;
+    entry.endvalidity = endvalidity;
+    entry.created = created;
+    found = true;
+  }
+  return found;
+}
+
+bool CCDBManagerInstance::fetchToDiskCache(std::string const& path, long timestamp, DiskCacheEntry& entry)
+{
+  std::error_code ec;
+  std::string pathDir = mDiskCacheDir + "/" + path;
+  std::filesystem::create_directories(pathDir, ec);
+  // download to a temporary file and move it to its final location only when the headers are known, so that the other
+  // processes sharing the cache never see incomplete files
+  std::string tmpFile = pathDir + "/.download_" + std::to_string(getpid()) + "_" + std::to_string(mTmpFileCounter++) + ".root";
+  auto headers = mCCDBAccessor.retrieveBlobToFile(path, tmpFile, mMetaData, timestamp);
+  entry.startvalidity = getHeaderValue(headers, "Valid-From");
+  entry.endvalidity = getHeaderValue(headers, "Valid-Until");
+  entry.created = std::max(0L, getHeaderValue(headers, "Created"));
+  if (entry.startvalidity < 0 || entry.endvalidity < 0) {
+    LOG(ERROR) << "Failed to retrieve " << path << " for timestamp " << timestamp << " to the disk cache";
+    std::filesystem::remove(tmpFile, ec);
+    return false;
+  }
+  std::string entryDir = pathDir + "/" + diskCacheEntryName(entry.startvalidity, entry.endvalidity, entry.created, headers["ETag"]);
+  entry.file = entryDir + "/snapshot.root";
+  std::filesystem::create_directories(entryDir, ec);
+  std::filesystem::rename(tmpFile, entry.file, ec);
+  if (ec) {
+    LOG(ERROR) << "Failed to store " << entry.file << " in the disk cache: " << ec.message();
+    std::filesystem::remove(tmpFile, ec);
+    return false;
+  }
+  return true;
+}
+
+CCDBManagerInstance::CacheMetrics CCDBManagerInstance::getCacheMetrics() const
+{
+  CacheMetrics metrics;
+  metrics.memoryHits = mMemoryHits;
+  metrics.diskHits = mDiskHits;
+  metrics.misses = mMisses;
+  metrics.prefetched = mPrefetched;
+  metrics.prefetchFailures = mPrefetchFailures;
+  return metrics;
+}
+
+void CCDBManagerInstance::printCacheMetrics() const
+{
+  auto metrics = getCacheMetrics();
+  LOG(INFO) << "CCDB requests served from memory: " << metrics.memoryHits << ", from disk cache: " << metrics.diskHits
+            << ", from server: " << metrics.misses << "; prefetched: " << metrics.prefetched << ", failed to prefetch: " << metrics.prefetchFailures;
+}
+
 } // namespace ccdb
 } // namespace o2
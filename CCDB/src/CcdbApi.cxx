@@ -347,11 +347,33 @@ void CcdbApi::retrieveBlob(std::string const& path, std::string const& targetdir
     }
   }
 
-  std::string targetpath = fulltargetdir + "/snapshot.root";
+  retrieveBlobToFile(path, fulltargetdir + "/snapshot.root", metadata, timestamp);
+}
+
+std::map<std::string, std::string> CcdbApi::retrieveBlobToFile(std::string const& path, std::string const& targetpath, std::map<std::string, std::string> const& metadata, long timestamp) const
+{
+  std::map<std::string, std::string> headers;
+  if (mInSnapshotMode) { // the snapshot already has the final layout, just copy it
+    auto snapshotpath = getSnapshotPath(mSnapshotTopPath, path);
+    std::error_code ec;
+    if (!std::filesystem::exists(snapshotpath) || !std::filesystem::copy_file(snapshotpath, targetpath, std::filesystem::copy_options::overwrite_existing, ec)) {
+      LOG(ERROR) << "Could not copy local snapshot " << snapshotpath << " to " << targetpath;
+      return headers;
+    }
+    std::lock_guard<std::mutex> guard(gIOMutex);
+    TFile snapshotfile(targetpath.c_str(), "READ");
+    auto storedmeta = retrieveMetaInfo(snapshotfile);
+    if (storedmeta) {
+      headers = *storedmeta;
+      delete storedmeta;
+    }
+    return headers;
+  }
+
   FILE* fp = fopen(targetpath.c_str(), "w");
   if (!fp) {
     std::cerr << " Could not open/create target file " << targetpath << "\n";
-    return;
+    return headers;
   }
 
   // Prepare CURL
@@ -407,13 +429,14 @@ void CcdbApi::retrieveBlob(std::string const& path, std::string const& targetdir
     // Just a demonstrator for the moment
     CCDBQuery querysummary(path, metadata, timestamp);
     // retrieveHeaders
-    auto headers = retrieveHeaders(path, metadata, timestamp);
+    headers = retrieveHeaders(path, metadata, timestamp);
     std::lock_guard<std::mutex> guard(gIOMutex);
     TFile snapshotfile(targetpath.c_str(), "UPDATE");
     snapshotfile.WriteObjectAny(&querysummary, TClass::GetClass(typeid(querysummary)), CCDBQUERY_ENTRY);
     snapshotfile.WriteObjectAny(&headers, TClass::GetClass(typeid(metadata)), CCDBMETA_ENTRY);
     snapshotfile.Close();
   }
+  return headers;
 }
 
 void CcdbApi::snapshot(std::string const& ccdbrootpath, std::string const& localDir, long timestamp) const
@@ -0,0 +1,105 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCCDBDiskCache.cxx
+/// \brief  Test prefetching and disk cache of the CCDBManagerInstance, using a local snapshot in place of the server
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CcdbApi.h"
+#include "CCDB/BasicCCDBManager.h"
+#include <boost/test/unit_test.hpp>
+#include <TFile.h>
+#include <TClass.h>
+#include <filesystem>
+#include <unistd.h>
+
+using namespace o2::ccdb;
+
+namespace
+{
+// write the object with given headers to the snapshot, as done by CcdbApi::snapshot
+void writeSnapshot(std::string const& topdir, std::string const& path, std::string const& obj, long start, long stop, std::string const& etag)
+{
+  std::filesystem::create_directories(topdir + "/" + path);
+  std::map<std::string, std::string> headers{{"Valid-From", std::to_string(start)}, {"Valid-Until", std::to_string(stop)},
+                                             {"Created", std::to_string(start)}, {"ETag", "\"" + etag + "\""}};
+  TFile f((topdir + "/" + path + "/snapshot.root").c_str(), "RECREATE");
+  f.WriteObjectAny(&obj, TClass::GetClass(typeid(obj)), CcdbApi::CCDBOBJECT_ENTRY);
+  f.WriteObjectAny(&headers, TClass::GetClass(typeid(headers)), CcdbApi::CCDBMETA_ENTRY);
+  f.Close();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestCCDBDiskCache)
+{
+  auto topdir = std::filesystem::temp_directory_path().string() + "/testCCDBDiskCache_" + std::to_string(getpid());
+  std::string serverDir = topdir + "/server", cacheDir = topdir + "/cache";
+  std::string pathA = "Test/PrefetchA", pathB = "Test/PrefetchB", pathC = "Test/NotPrefetched";
+  long start = 1000, stop = 2000, ts = (start + stop) / 2;
+  writeSnapshot(serverDir, pathA, "objectA", start, stop, "etag-a");
+  writeSnapshot(serverDir, pathB, "objectB", start, stop, "etag-b");
+  writeSnapshot(serverDir, pathC, "objectC", start, stop, "etag-c");
+
+  {
+    CCDBManagerInstance mgr("file://" + serverDir);
+    mgr.setDiskCache(cacheDir);
+    mgr.setTimestamp(ts);
+    mgr.prefetch({pathA, pathB, "Test/Absent"}, ts, ts + 1, 2);
+    auto* objA = mgr.get<std::string>(pathA); // waits for the prefetching of A
+    BOOST_CHECK(objA && *objA == "objectA");
+    mgr.waitForPrefetch();
+    auto metrics = mgr.getCacheMetrics();
+    BOOST_CHECK_EQUAL(metrics.prefetched, 2u);
+    BOOST_CHECK_EQUAL(metrics.prefetchFailures, 1u);
+    BOOST_CHECK(metrics.diskHits == 1 && metrics.misses == 0);
+
+    auto* objB = mgr.get<std::string>(pathB);
+    BOOST_CHECK(objB && *objB == "objectB");
+    std::string hack = "Cached";
+    *objB = hack;
+    objB = mgr.get<std::string>(pathB); // already in memory
+    BOOST_CHECK(objB && *objB == hack);
+    auto* objC = mgr.get<std::string>(pathC); // not prefetched, will be fetched to the disk cache
+    BOOST_CHECK(objC && *objC == "objectC");
+    metrics = mgr.getCacheMetrics();
+    mgr.printCacheMetrics();
+    BOOST_CHECK(metrics.diskHits == 3 && metrics.misses == 1);
+  }
+
+  // the disk cache persists: another instance gets the objects even if the server does not have them anymore
+  std::filesystem::remove_all(serverDir);
+  {
+    CCDBManagerInstance mgr("file://" + serverDir);
+    mgr.setDiskCache(cacheDir);
+    mgr.setTimestamp(ts);
+    for (auto& [path, expected] : std::vector<std::pair<std::string, std::string>>{{pathA, "objectA"}, {pathB, "objectB"}, {pathC, "objectC"}}) {
+      auto* obj = mgr.get<std::string>(path);
+      BOOST_CHECK(obj && *obj == expected);
+    }
+    auto metrics = mgr.getCacheMetrics();
+    BOOST_CHECK(metrics.diskHits == 3 && metrics.misses == 0);
+
+    // the validity starts at Valid-From, in memory as in the disk cache
+    mgr.setLocalObjectValidityChecking();
+    mgr.setTimestamp(start);
+    auto* obj = mgr.get<std::string>(pathA);
+    BOOST_CHECK(obj && *obj == "objectA");
+    metrics = mgr.getCacheMetrics();
+    BOOST_CHECK_EQUAL(metrics.memoryHits, 1u);
+    BOOST_CHECK_EQUAL(metrics.diskHits, 3u);
+  }
+  std::filesystem::remove_all(topdir);
+}
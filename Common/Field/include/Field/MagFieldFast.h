@@ -55,6 +55,10 @@ class MagFieldFast
   bool Field(const float xyz[3], float bxyz[3]) const;
   bool Field(const math_utils::Point3D<float> xyz, float bxyz[3]) const;
   bool Field(const math_utils::Point3D<double> xyz, double bxyz[3]) const;
+  /// field at the np points (x[i], y[i], z[i]), as Field for each of them. The field of the points outside of the
+  /// parametrization is not modified and ok[i] (if provided) is set to false for them. Returns the number of points inside
+  int Field(int np, const float* x, const float* y, const float* z, float* bx, float* by, float* bz, bool* ok = nullptr) const;
+  int Field(int np, const double* x, const double* y, const double* z, double* bx, double* by, double* bz, bool* ok = nullptr) const;
   bool GetBcomp(EDim comp, const double xyz[3], double& b) const;
   bool GetBcomp(EDim comp, const float xyz[3], float& b) const;
   bool GetBcomp(EDim comp, const math_utils::Point3D<float> xyz, double& b) const;
@@ -81,6 +85,12 @@ class MagFieldFast
   }
 
   float CalcPol(const float* cf, float x, float y, float z) const;
+  void CalcPol(int np, const float* cf, const float* x, const float* y, const float* z, float* val) const;
+
+  template <typename T>
+  int FieldBatch(int np, const T* x, const T* y, const T* z, T* bx, T* by, T* bz, bool* ok) const;
+
+  static constexpr int kBatchSize = 64; // points processed at once by the batched queries
 
  private:
   float mFactorSol; // scaling factor
@@ -103,6 +113,16 @@ inline float MagFieldFast::CalcPol(const float* cf, float x, float y, float z) c
 
   return val;
 }
+
+inline void MagFieldFast::CalcPol(int np, const float* cf, const float* x, const float* y, const float* z, float* val) const
+{
+  /// calculate the same polynomial at np points, the loop is vectorized since all the points share the coefficients
+  for (int i = 0; i < np; i++) {
+    val[i] = cf[0] + x[i] * (cf[1] + x[i] * (cf[4] + x[i] * cf[10] + y[i] * cf[11] + z[i] * cf[12]) + y[i] * (cf[5] + z[i] * cf[14])) +
+             y[i] * (cf[2] + y[i] * (cf[7] + x[i] * cf[13] + y[i] * cf[16] + z[i] * cf[17]) + z[i] * (cf[8])) +
+             z[i] * (cf[3] + z[i] * (cf[9] + x[i] * cf[15] + y[i] * cf[18] + z[i] * cf[19]) + x[i] * (cf[6]));
+  }
+}
 } // namespace field
 } // namespace o2
 
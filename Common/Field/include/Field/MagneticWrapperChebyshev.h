@@ -210,6 +210,10 @@ class MagneticWrapperChebyshev : public TNamed
   /// it gets it at closest valid point
   virtual void Field(const Double_t* xyz, Double_t* b) const;
 
+  /// Computes field in cartesian coordinates at the np points (x[i], y[i], z[i]), as Field does for each of them.
+  /// The points are processed in blocks, within a block those falling in the same parameterization segment are evaluated together
+  void Field(int np, const Double_t* x, const Double_t* y, const Double_t* z, Double_t* bx, Double_t* by, Double_t* bz) const;
+
   /// Computes Bz for the point in cartesian coordinates. If point is outside of the parameterized region
   /// it gets it at closest valid point
   Double_t getBz(const Double_t* xyz) const;
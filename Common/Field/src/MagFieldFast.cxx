@@ -17,7 +17,9 @@
 #include <GPUCommonLogger.h>
 
 #ifndef GPUCA_GPUCODE_DEVICE
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <sstream>
 using namespace std;
@@ -234,6 +236,67 @@ bool MagFieldFast::Field(const math_utils::Point3D<double> xyz, double bxyz[3])
   return true;
 }
 
+//_______________________________________________________________________
+template <typename T>
+int MagFieldFast::FieldBatch(int np, const T* x, const T* y, const T* z, T* bx, T* by, T* bz, bool* ok) const
+{
+  // get field for the points in blocks of kBatchSize, the points of the block sharing the same
+  // parametrization segment are evaluated together
+  static_assert(kBatchSize <= 256, "the point index must fit in 8 bits");
+  uint32_t keys[kBatchSize]; // segment << 8 | point index in the block
+  float xs[kBatchSize], ys[kBatchSize], zs[kBatchSize], b[kNDim][kBatchSize];
+  int nInside = 0;
+  for (int ib = 0; ib < np; ib += kBatchSize) {
+    int nb = std::min(kBatchSize, np - ib), nk = 0;
+    for (int ip = 0; ip < nb; ip++) {
+      int i = ib + ip, zSeg, rSeg, quadrant;
+      bool inside = GetSegment(x[i], y[i], z[i], zSeg, rSeg, quadrant);
+      if (ok) {
+        ok[i] = inside;
+      }
+      if (inside) {
+        keys[nk++] = (uint32_t((rSeg * kNSolZRanges + zSeg) * kNQuadrants + quadrant) << 8) | ip;
+      }
+    }
+    nInside += nk;
+    std::sort(keys, keys + nk);
+
+    for (int ik = 0; ik < nk;) {
+      int seg = keys[ik] >> 8, nSeg = 0;
+      for (; ik + nSeg < nk && int(keys[ik + nSeg] >> 8) == seg; nSeg++) {
+        int i = ib + (keys[ik + nSeg] & 0xff);
+        xs[nSeg] = x[i];
+        ys[nSeg] = y[i];
+        zs[nSeg] = z[i];
+      }
+      const SolParam* par = &mSolPar[seg / (kNSolZRanges * kNQuadrants)][(seg / kNQuadrants) % kNSolZRanges][seg % kNQuadrants];
+      for (int id = 0; id < kNDim; id++) {
+        CalcPol(nSeg, par->parBxyz[id], xs, ys, zs, b[id]);
+      }
+      for (int is = 0; is < nSeg; is++) {
+        int i = ib + (keys[ik + is] & 0xff);
+        bx[i] = b[kX][is] * mFactorSol;
+        by[i] = b[kY][is] * mFactorSol;
+        bz[i] = b[kZ][is] * mFactorSol;
+      }
+      ik += nSeg;
+    }
+  }
+  return nInside;
+}
+
+//_______________________________________________________________________
+int MagFieldFast::Field(int np, const float* x, const float* y, const float* z, float* bx, float* by, float* bz, bool* ok) const
+{
+  return FieldBatch(np, x, y, z, bx, by, bz, ok);
+}
+
+//_______________________________________________________________________
+int MagFieldFast::Field(int np, const double* x, const double* y, const double* z, double* bx, double* by, double* bz, bool* ok) const
+{
+  return FieldBatch(np, x, y, z, bx, by, bz, ok);
+}
+
 //_______________________________________________________________________
 bool MagFieldFast::GetSegment(float x, float y, float z, int& zSeg, int& rSeg, int& quadrant) const
 {
@@ -17,6 +17,8 @@
 #include <TArrayF.h>    // for TArrayF
 #include <TArrayI.h>    // for TArrayI
 #include <TSystem.h>    // for TSystem, gSystem
+#include <algorithm>    // for sort
+#include <cstdint>      // for uint32_t
 #include <cstdio>       // for printf, fprintf, fclose, fopen, FILE
 #include <cstring>      // for memcpy
 #include "FairLogger.h" // for FairLogger
@@ -445,6 +447,77 @@ void MagneticWrapperChebyshev::Field(const Double_t* xyz, Double_t* b) const
   par->Eval(xyz, b);
 }
 
+void MagneticWrapperChebyshev::Field(int np, const Double_t* x, const Double_t* y, const Double_t* z, Double_t* bx, Double_t* by,
+                                     Double_t* bz) const
+{
+  constexpr int BlockSize = Chebyshev3DCalc::MaxEvalBatch;
+  Double_t c0[BlockSize], c1[BlockSize], c2[BlockSize]; // r,phi,z for the solenoid, x,y,z for the dipole
+  Double_t p0[BlockSize], p1[BlockSize], p2[BlockSize], b0[BlockSize], b1[BlockSize], b2[BlockSize];
+  Double_t* res[3] = {b0, b1, b2};
+  uint32_t keys[BlockSize]; // segment ID (dipole ones after the solenoid ones) << 8 | point index in the block
+  static_assert(BlockSize <= 256, "the point index must fit in 8 bits");
+
+  for (int ib = 0; ib < np; ib += BlockSize) {
+    int nb = TMath::Min(BlockSize, np - ib), nk = 0;
+    for (int ip = 0; ip < nb; ip++) {
+      int i = ib + ip;
+      Double_t xyz[3] = {x[i], y[i], z[i]}, pnt[3];
+      bx[i] = by[i] = bz[i] = 0;
+      int id;
+      Chebyshev3D* par = nullptr;
+      if (xyz[2] > mMinZSolenoid) {
+        cartesianToCylindrical(xyz, pnt);
+        id = findSolenoidSegment(pnt);
+        par = id < 0 ? nullptr : getParameterSolenoid(id);
+      } else {
+        std::copy(xyz, xyz + 3, pnt);
+        id = findDipoleSegment(xyz);
+        par = id < 0 ? nullptr : getParameterDipole(id);
+        id += mNumberOfParameterizationSolenoid;
+      }
+      if (!par) {
+        continue;
+      }
+#ifndef _BRING_TO_BOUNDARY_
+      if (!par->isInside(pnt)) {
+        continue;
+      }
+#endif
+      c0[ip] = pnt[0];
+      c1[ip] = pnt[1];
+      c2[ip] = pnt[2];
+      keys[nk++] = (uint32_t(id) << 8) | ip;
+    }
+    std::sort(keys, keys + nk);
+
+    // evaluate the points of each segment at once
+    for (int ik = 0; ik < nk;) {
+      int id = keys[ik] >> 8, nSeg = 0;
+      for (; ik + nSeg < nk && int(keys[ik + nSeg] >> 8) == id; nSeg++) {
+        int ip = keys[ik + nSeg] & 0xff;
+        p0[nSeg] = c0[ip];
+        p1[nSeg] = c1[ip];
+        p2[nSeg] = c2[ip];
+      }
+      bool sol = id < mNumberOfParameterizationSolenoid;
+      auto par = sol ? getParameterSolenoid(id) : getParameterDipole(id - mNumberOfParameterizationSolenoid);
+      par->Eval(nSeg, p0, p1, p2, res);
+      for (int is = 0; is < nSeg; is++) {
+        int ip = keys[ik + is] & 0xff, i = ib + ip;
+        Double_t b[3] = {b0[is], b1[is], b2[is]};
+        if (sol) { // convert field to cartesian system
+          Double_t rphiz[3] = {c0[ip], c1[ip], c2[ip]};
+          cylindricalToCartesianCylB(rphiz, b, b);
+        }
+        bx[i] = b[0];
+        by[i] = b[1];
+        bz[i] = b[2];
+      }
+      ik += nSeg;
+    }
+  }
+}
+
 Double_t MagneticWrapperChebyshev::getBz(const Double_t* xyz) const
 {
   Double_t rphiz[3];
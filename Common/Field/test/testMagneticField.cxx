@@ -17,6 +17,7 @@
 #include "Field/MagneticField.h"
 #include "Field/MagFieldFast.h"
 #include <memory>
+#include <vector>
 #include "FairLogger.h" // for FairLogger
 #include <TStopwatch.h>
 #include <TRandom.h>
@@ -98,3 +99,56 @@ BOOST_AUTO_TEST_CASE(MagneticField_test)
     BOOST_CHECK(TMath::Abs(rms[i] / nomBz) < 1.e-3);
   }
 }
+
+BOOST_AUTO_TEST_CASE(MagneticFieldBatch_test)
+{
+  // batched queries must reproduce the single point ones
+  std::unique_ptr<MagneticField> fld = std::make_unique<MagneticField>("Maps", "Maps", 1., 1., o2::field::MagFieldParam::k5kG);
+  fld->AllowFastField(true);
+  const auto* map = fld->getMeasuredMap();
+  const auto* fast = fld->getFastField();
+
+  const int ntst = 10000;
+  float rnd[3];
+  std::vector<double> x(ntst), y(ntst), z(ntst), bx(ntst), by(ntst), bz(ntst);
+  std::vector<float> xf(ntst), yf(ntst), zf(ntst), bxf(ntst), byf(ntst), bzf(ntst);
+  for (int it = ntst; it--;) {
+    gRandom->RndmArray(3, rnd);
+    x[it] = xf[it] = rnd[0] * 600. * TMath::Cos(rnd[1] * TMath::Pi() * 2);
+    y[it] = yf[it] = rnd[0] * 600. * TMath::Sin(rnd[1] * TMath::Pi() * 2);
+    z[it] = zf[it] = (rnd[2] - 0.7) * 2000; // dipole region included
+  }
+
+  TStopwatch swBatch;
+  swBatch.Start();
+  map->Field(ntst, x.data(), y.data(), z.data(), bx.data(), by.data(), bz.data());
+  swBatch.Stop();
+  TStopwatch swSingle;
+  swSingle.Start();
+  double b[3];
+  for (int it = 0; it < ntst; it++) {
+    double xyz[3] = {x[it], y[it], z[it]};
+    map->Field(xyz, b);
+    BOOST_CHECK_SMALL(b[0] - bx[it], 1e-5);
+    BOOST_CHECK_SMALL(b[1] - by[it], 1e-5);
+    BOOST_CHECK_SMALL(b[2] - bz[it], 1e-5);
+  }
+  swSingle.Stop();
+  LOG(INFO) << "Timing of the exact param: single points " << swSingle.CpuTime() / ntst << " batch " << swBatch.CpuTime() / ntst << " s/point";
+
+  std::unique_ptr<bool[]> ok(new bool[ntst]);
+  int nInside = fast->Field(ntst, xf.data(), yf.data(), zf.data(), bxf.data(), byf.data(), bzf.data(), ok.get()), nInsideSingle = 0;
+  for (int it = 0; it < ntst; it++) {
+    float xyz[3] = {xf[it], yf[it], zf[it]}, bf[3];
+    bool inside = fast->Field(xyz, bf);
+    BOOST_CHECK(inside == ok[it]);
+    if (!inside) {
+      continue;
+    }
+    nInsideSingle++;
+    BOOST_CHECK_SMALL(bf[0] - bxf[it], 1e-5f);
+    BOOST_CHECK_SMALL(bf[1] - byf[it], 1e-5f);
+    BOOST_CHECK_SMALL(bf[2] - bzf[it], 1e-5f);
+  }
+  BOOST_CHECK(nInside == nInsideSingle && nInside > 0);
+}
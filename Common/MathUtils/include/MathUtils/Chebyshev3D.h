@@ -136,6 +136,10 @@ class Chebyshev3D : public TNamed
 
   Double_t Eval(const Double_t* par, int idim);
 
+  /// Evaluates the parameterization at np points (par0[i], par1[i], par2[i]), res[j][i] being the j-th output at the i-th point.
+  /// The points are processed in blocks of Chebyshev3DCalc::MaxEvalBatch, each block traversing the coefficients once
+  void Eval(int np, const Double_t* par0, const Double_t* par1, const Double_t* par2, Double_t* const* res) const;
+
   void evaluateDerivative(int dimd, const Float_t* par, Float_t* res);
 
   void evaluateDerivative2(int dimd1, int dimd2, const Float_t* par, Float_t* res);
@@ -282,41 +286,45 @@ inline Bool_t Chebyshev3D::isInside(const Double_t* par) const
 /// Evaluates Chebyshev parameterization for 3d->DimOut function
 inline void Chebyshev3D::Eval(const Float_t* par, Float_t* res)
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
   for (int i = mOutputArrayDimension; i--;) {
-    res[i] = getChebyshevCalc(i)->Eval(mTemporaryCoefficient);
+    res[i] = getChebyshevCalc(i)->Eval(x);
   }
 }
 
 /// Evaluates Chebyshev parameterization for 3d->DimOut function
 inline void Chebyshev3D::Eval(const Double_t* par, Double_t* res)
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
   for (int i = mOutputArrayDimension; i--;) {
-    res[i] = getChebyshevCalc(i)->Eval(mTemporaryCoefficient);
+    res[i] = getChebyshevCalc(i)->Eval(x);
   }
 }
 
 /// Evaluates Chebyshev parameterization for idim-th output dimension of 3d->DimOut function
 inline Double_t Chebyshev3D::Eval(const Double_t* par, int idim)
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
-  return getChebyshevCalc(idim)->Eval(mTemporaryCoefficient);
+  return getChebyshevCalc(idim)->Eval(x);
 }
 
 /// Evaluates Chebyshev parameterization for idim-th output dimension of 3d->DimOut function
 inline Float_t Chebyshev3D::Eval(const Float_t* par, int idim)
 {
+  Float_t x[3];
   for (int i = 3; i--;) {
-    mTemporaryCoefficient[i] = mapToInternal(par[i], i);
+    x[i] = mapToInternal(par[i], i);
   }
-  return getChebyshevCalc(idim)->Eval(mTemporaryCoefficient);
+  return getChebyshevCalc(idim)->Eval(x);
 }
 
 /// Returns the gradient matrix
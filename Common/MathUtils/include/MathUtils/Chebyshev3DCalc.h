@@ -148,6 +148,9 @@ class Chebyshev3DCalc : public TNamed
 
   static Float_t chebyshevEvaluation1D(Float_t x, const Float_t* array, int ncf);
 
+  /// Evaluates 1D Chebyshev parameterization at np (<= MaxEvalBatch) arguments x[i] mapped to [-1:1] interval
+  static void chebyshevEvaluation1D(int np, const Float_t* x, const Float_t* array, int ncf, Float_t* res);
+
   /// Evaluates 1D Chebyshev parameterization's derivative. x is the argument mapped to [-1:1] interval
   static Float_t chebyshevEvaluation1Derivative(Float_t x, const Float_t* array, int ncf);
 
@@ -169,6 +172,12 @@ class Chebyshev3DCalc : public TNamed
 
   Double_t Eval(const Double_t* par) const;
 
+  /// Evaluates Chebyshev parameterization for 3D function at np (<= MaxEvalBatch) points (x0[i], x1[i], x2[i]).
+  /// VERY IMPORTANT: the arguments must be ALREADY MAPPED to [-1:1] interval
+  void Eval(int np, const Float_t* x0, const Float_t* x1, const Float_t* x2, Float_t* res) const;
+
+  static constexpr int MaxEvalBatch = 64; ///< max number of points evaluated at once
+
  private:
   Int_t mNumberOfCoefficients;    ///< total number of coeeficients
   Int_t mNumberOfRows;            ///< number of significant rows in the 3D coeffs matrix
@@ -215,34 +224,54 @@ inline Float_t Chebyshev3DCalc::chebyshevEvaluation1D(Float_t x, const Float_t*
 
 /// Evaluates Chebyshev parameterization for 3D function.
 /// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
+/// The 1D sums over rows and columns are accumulated on the fly, from the highest coefficient down, with
+/// the same Clenshaw recurrence as chebyshevEvaluation1D, instead of going through the temporary arrays,
+/// so that the parameterization can be evaluated concurrently from several threads
 inline Float_t Chebyshev3DCalc::Eval(const Float_t* par) const
 {
+  Float_t x0 = par[0], x1 = par[1], x2 = par[2];
+  Float_t b00 = 0, b01 = 0, b02 = 0;
   for (int id0 = mNumberOfRows; id0--;) {
     int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
     int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
+    Float_t b10 = 0, b11 = 0, b12 = 0;
     for (int id1 = nCLoc; id1--;) {
       int id = id1 + col0;
-      mTemporaryCoefficients2D[id1] = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]);
+      b12 = b11;
+      b11 = b10;
+      b10 = chebyshevEvaluation1D(x2, mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]) + (x1 + x1) * b11 - b12;
     }
-    mTemporaryCoefficients1D[id0] = chebyshevEvaluation1D(par[1], mTemporaryCoefficients2D, nCLoc);
+    b02 = b01;
+    b01 = b00;
+    b00 = ((nCLoc > 0) ? b10 - x1 * b11 : 0) + (x0 + x0) * b01 - b02;
   }
-  return chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
+  return (mNumberOfRows > 0) ? b00 - x0 * b01 : 0;
 }
 
 /// Evaluates Chebyshev parameterization for 3D function.
 /// VERY IMPORTANT: par must contain the function arguments ALREADY MAPPED to [-1:1] interval
+/// The 1D sums over rows and columns are accumulated on the fly, from the highest coefficient down, with
+/// the same Clenshaw recurrence as chebyshevEvaluation1D, instead of going through the temporary arrays,
+/// so that the parameterization can be evaluated concurrently from several threads
 inline Double_t Chebyshev3DCalc::Eval(const Double_t* par) const
 {
+  Float_t x0 = par[0], x1 = par[1], x2 = par[2];
+  Float_t b00 = 0, b01 = 0, b02 = 0;
   for (int id0 = mNumberOfRows; id0--;) {
     int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
     int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
+    Float_t b10 = 0, b11 = 0, b12 = 0;
     for (int id1 = nCLoc; id1--;) {
       int id = id1 + col0;
-      mTemporaryCoefficients2D[id1] = chebyshevEvaluation1D(par[2], mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]);
+      b12 = b11;
+      b11 = b10;
+      b10 = chebyshevEvaluation1D(x2, mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id]) + (x1 + x1) * b11 - b12;
     }
-    mTemporaryCoefficients1D[id0] = chebyshevEvaluation1D(par[1], mTemporaryCoefficients2D, nCLoc);
+    b02 = b01;
+    b01 = b00;
+    b00 = ((nCLoc > 0) ? b10 - x1 * b11 : 0) + (x0 + x0) * b01 - b02;
   }
-  return chebyshevEvaluation1D(par[0], mTemporaryCoefficients1D, mNumberOfRows);
+  return (mNumberOfRows > 0) ? b00 - x0 * b01 : 0;
 }
 } // namespace math_utils
 } // namespace o2
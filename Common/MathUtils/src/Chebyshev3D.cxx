@@ -324,6 +324,27 @@ void Chebyshev3D::Print(const Option_t* opt) const
   }
 }
 
+void Chebyshev3D::Eval(int np, const Double_t* par0, const Double_t* par1, const Double_t* par2, Double_t* const* res) const
+{
+  // evaluate block by block, with the arguments mapped as in the single point Eval
+  constexpr int BlockSize = Chebyshev3DCalc::MaxEvalBatch;
+  Float_t x0[BlockSize], x1[BlockSize], x2[BlockSize], val[BlockSize];
+  for (int ib = 0; ib < np; ib += BlockSize) {
+    int nb = TMath::Min(BlockSize, np - ib);
+    for (int ip = 0; ip < nb; ip++) {
+      x0[ip] = mapToInternal(par0[ib + ip], 0);
+      x1[ip] = mapToInternal(par1[ib + ip], 1);
+      x2[ip] = mapToInternal(par2[ib + ip], 2);
+    }
+    for (int i = mOutputArrayDimension; i--;) {
+      getChebyshevCalc(i)->Eval(nb, x0, x1, x2, val);
+      for (int ip = 0; ip < nb; ip++) {
+        res[i][ib + ip] = val[ip];
+      }
+    }
+  }
+}
+
 void Chebyshev3D::prepareBoundaries(const Float_t* bmin, const Float_t* bmax)
 {
   // Set and check boundaries defined by user, prepare coefficients for their conversion to [-1:1] interval
@@ -467,6 +467,65 @@ void Chebyshev3DCalc::initializeCoefficients(int nc)
   }
 }
 
+void Chebyshev3DCalc::chebyshevEvaluation1D(int np, const Float_t* x, const Float_t* array, int ncf, Float_t* res)
+{
+  // same recurrence as the single point version, the loop over the points is the innermost one so that it is vectorized
+  if (ncf <= 0) {
+    for (int ip = 0; ip < np; ip++) {
+      res[ip] = 0;
+    }
+    return;
+  }
+  Float_t b0[MaxEvalBatch], b1[MaxEvalBatch], b2[MaxEvalBatch];
+  Float_t cf = array[--ncf];
+  for (int ip = 0; ip < np; ip++) {
+    b0[ip] = cf;
+    b1[ip] = b2[ip] = 0;
+  }
+  for (int i = ncf; i--;) {
+    cf = array[i];
+    for (int ip = 0; ip < np; ip++) {
+      b2[ip] = b1[ip];
+      b1[ip] = b0[ip];
+      b0[ip] = cf + (x[ip] + x[ip]) * b1[ip] - b2[ip];
+    }
+  }
+  for (int ip = 0; ip < np; ip++) {
+    res[ip] = b0[ip] - x[ip] * b1[ip];
+  }
+}
+
+void Chebyshev3DCalc::Eval(int np, const Float_t* x0, const Float_t* x1, const Float_t* x2, Float_t* res) const
+{
+  // same as the single point Eval, all the points share the coefficients, which are traversed only once
+  Float_t b00[MaxEvalBatch] = {0}, b01[MaxEvalBatch] = {0}, b02[MaxEvalBatch] = {0};
+  Float_t b10[MaxEvalBatch], b11[MaxEvalBatch], b12[MaxEvalBatch], cf[MaxEvalBatch];
+  for (int id0 = mNumberOfRows; id0--;) {
+    int nCLoc = mNumberOfColumnsAtRow[id0]; // number of significant coefs on this row
+    int col0 = mColumnAtRowBeginning[id0];  // beginning of local column in the 2D boundary matrix
+    for (int ip = 0; ip < np; ip++) {
+      b10[ip] = b11[ip] = b12[ip] = 0;
+    }
+    for (int id1 = nCLoc; id1--;) {
+      int id = id1 + col0;
+      chebyshevEvaluation1D(np, x2, mCoefficients + mCoefficientBound2D1[id], mCoefficientBound2D0[id], cf);
+      for (int ip = 0; ip < np; ip++) {
+        b12[ip] = b11[ip];
+        b11[ip] = b10[ip];
+        b10[ip] = cf[ip] + (x1[ip] + x1[ip]) * b11[ip] - b12[ip];
+      }
+    }
+    for (int ip = 0; ip < np; ip++) {
+      b02[ip] = b01[ip];
+      b01[ip] = b00[ip];
+      b00[ip] = ((nCLoc > 0) ? b10[ip] - x1[ip] * b11[ip] : 0) + (x0[ip] + x0[ip]) * b01[ip] - b02[ip];
+    }
+  }
+  for (int ip = 0; ip < np; ip++) {
+    res[ip] = (mNumberOfRows > 0) ? b00[ip] - x0[ip] * b01[ip] : 0;
+  }
+}
+
 Float_t Chebyshev3DCalc::chebyshevEvaluation1Derivative(Float_t x, const Float_t* array, int ncf)
 {
   if (--ncf < 1) {
@@ -51,8 +51,10 @@ struct SimConfigData {
   int mField;                                // L3 field setting in kGauss: +-2,+-5 and 0
   bool mUniformField = false;                // uniform magnetic field
   bool mAsService = false;                   // if simulation should be run as service/deamon (does not exit after run)
+  bool mFlatHits = false;                    // send trivially copyable hits as raw arrays, merged without intermediate TTrees
+  bool mFlatHitsOutput = false;              // write the merged hits also to flat files, in addition to the ROOT files
 
-  ClassDefNV(SimConfigData, 4);
+  ClassDefNV(SimConfigData, 5);
 };
 
 // A singleton class which can be used
@@ -115,6 +117,8 @@ class SimConfig
   int getNSimWorkers() const { return mConfigData.mSimWorkers; }
   bool isFilterOutNoHitEvents() const { return mConfigData.mFilterNoHitEvents; }
   bool asService() const { return mConfigData.mAsService; }
+  bool useFlatHits() const { return mConfigData.mFlatHits; }
+  bool writeFlatHits() const { return mConfigData.mFlatHitsOutput; }
 
  private:
   SimConfigData mConfigData; //!
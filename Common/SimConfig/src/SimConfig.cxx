@@ -50,7 +50,9 @@ void SimConfig::initOptions(boost::program_options::options_description& options
     "noemptyevents", "only writes events with at least one hit")(
     "CCDBUrl", bpo::value<std::string>()->default_value("ccdb-test.cern.ch:8080"), "URL for CCDB to be used.")(
     "timestamp", bpo::value<long>()->default_value(-1), "global timestamp value (for anchoring) - default is now")(
-    "asservice", bpo::value<bool>()->default_value(false), "run in service/server mode");
+    "asservice", bpo::value<bool>()->default_value(false), "run in service/server mode")(
+    "flatHits", bpo::value<bool>()->default_value(false), "send trivially copyable hits to the hit merger as raw arrays, merged without intermediate TTrees")(
+    "flatHitsOutput", bpo::value<bool>()->default_value(false), "write the merged hits also to flat files, in addition to the ROOT files");
 }
 
 bool SimConfig::resetFromParsedMap(boost::program_options::variables_map const& vm)
@@ -109,6 +111,8 @@ bool SimConfig::resetFromParsedMap(boost::program_options::variables_map const&
   mConfigData.mTimestamp = vm["timestamp"].as<long>();
   mConfigData.mCCDBUrl = vm["CCDBUrl"].as<std::string>();
   mConfigData.mAsService = vm["asservice"].as<bool>();
+  mConfigData.mFlatHits = vm["flatHits"].as<bool>();
+  mConfigData.mFlatHitsOutput = vm["flatHitsOutput"].as<bool>();
   if (vm.count("noemptyevents")) {
     mConfigData.mFilterNoHitEvents = true;
   }
@@ -0,0 +1,144 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.h
+/// \brief Native container of CTFs storing the flat EncodedBlocks images of detectors page-aligned, to be memory-mapped at reading
+///
+/// Layout of the file:
+/// FileHeader (padded to the page size)
+/// for every CTF: the flat images of its detectors, each starting at the page boundary
+/// index: FileHeader::nEntries of Entry records, starting at FileHeader::indexOffset
+/// The FileHeader is rewritten with the index position when the file is closed, so that incomplete files are recognized.
+
+#ifndef ALICEO2_CTF_FLATFILE_H
+#define ALICEO2_CTF_FLATFILE_H
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+struct CTFFlatFile {
+  static constexpr uint64_t Magic = 0x54414c4646544332; // "2CTFFLAT"
+  static constexpr uint32_t Version = 1;
+  static constexpr size_t PageSize = 4096; // alignment of the images
+
+  struct FileHeader {
+    uint64_t magic = Magic;
+    uint32_t version = Version;
+    uint32_t pageSize = PageSize;
+    uint64_t nEntries = 0;    // number of stored CTFs
+    uint64_t indexOffset = 0; // position of the index, 0 if the file was not closed properly
+  };
+
+  struct Chunk {
+    uint64_t offset = 0; // position of the detector image in the file
+    uint64_t size = 0;   // size of the image, 0 if absent
+  };
+
+  struct Entry {
+    uint64_t run = 0;
+    uint32_t firstTForbit = 0;
+    uint32_t detectors = 0; // DetID::mask_t of the stored detectors
+    std::array<Chunk, o2::detectors::DetID::nDetectors> chunks{};
+  };
+
+  static size_t alignToPage(size_t pos) { return (pos + PageSize - 1) / PageSize * PageSize; }
+};
+
+/// Writer of the CTFs in the flat file format
+class CTFFlatFileWriter
+{
+ public:
+  CTFFlatFileWriter() = default;
+  ~CTFFlatFileWriter() { close(); }
+
+  /// create new file, throws on failure
+  void open(const std::string& name);
+
+  /// add the flat image of the detector to the current CTF, return the number of bytes written
+  size_t addImage(o2::detectors::DetID det, const void* image, size_t size);
+
+  /// finalize the current CTF with its header, return the number of bytes written
+  size_t endCTF(const CTFHeader& header);
+
+  /// write the index and close the file
+  void close();
+
+  bool isOpen() const { return mFile.is_open(); }
+  const std::string& getName() const { return mName; }
+  size_t getNCTFs() const { return mIndex.size(); }
+  size_t getSize() const { return mPos; }
+
+ private:
+  void padToPage();
+
+  std::string mName;
+  std::ofstream mFile;
+  size_t mPos = 0;
+  CTFFlatFile::Entry mCurrent;
+  std::vector<CTFFlatFile::Entry> mIndex;
+};
+
+/// Reader of the CTFs in the flat file format: the file is memory-mapped and the detector images are served in place
+class CTFFlatFileReader
+{
+ public:
+  struct Image {
+    const char* data = nullptr;
+    size_t size = 0;
+  };
+
+  /// check if the file is in the flat CTF format
+  static bool isFlatFile(const std::string& name);
+
+  /// memory-map the file, throws on failure
+  void open(const std::string& name);
+
+  /// release the reader own reference on the mapping, the images obtained via getMapping stay valid
+  void close();
+
+  bool isOpen() const { return mMapping != nullptr; }
+  const std::string& getName() const { return mName; }
+  size_t getNCTFs() const { return mNEntries; }
+
+  /// header of the CTF entry
+  CTFHeader getCTFHeader(size_t entry) const;
+
+  /// flat image of the detector in the CTF entry (empty if absent)
+  Image getImage(size_t entry, o2::detectors::DetID det) const;
+
+  /// shared ownership of the mapping, keeps the images valid until released
+  std::shared_ptr<const char> getMapping() const { return mMapping; }
+
+ private:
+  const CTFFlatFile::Entry& getEntry(size_t entry) const;
+
+  std::string mName;
+  std::shared_ptr<const char> mMapping;
+  size_t mSize = 0;
+  size_t mNEntries = 0;
+  const CTFFlatFile::Entry* mIndex = nullptr;
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
@@ -18,6 +18,15 @@
 #define ALICEO2_ENCODED_BLOCKS_H
 
 #include <type_traits>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <Rtypes.h>
 #include "rANS/rans.h"
 #include "rANS/utils.h"
@@ -78,6 +87,8 @@ struct ANSHeader {
   uint8_t minorVersion;
 
   void clear() { majorVersion = minorVersion = 0; }
+  /// starting from v0.2 the blocks are coded with o2::rans::NInterleavedStreams interleaved rANS states
+  bool isInterleaved() const { return majorVersion > 0 || minorVersion > 1; }
   ClassDefNV(ANSHeader, 1);
 };
 
@@ -304,6 +315,178 @@ struct Block {
 
 ///<<======================== Auxiliary classes =======================<<
 
+///>>======================== Concurrent blocks coding ==================>>
+
+/// run f(i) for i in [0, n) on up to nThreads threads (the calling one included).
+/// An exception thrown by any of the tasks is rethrown to the caller once all threads are joined
+template <typename F>
+void runConcurrently(int n, int nThreads, F&& f)
+{
+  nThreads = std::min(nThreads, n);
+  if (nThreads < 2) {
+    for (int i = 0; i < n; i++) {
+      f(i);
+    }
+    return;
+  }
+  std::atomic<int> next{0};
+  std::exception_ptr error;
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    for (int i = next++; i < n; i = next++) {
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(nThreads - 1);
+  for (int it = 1; it < nThreads; it++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+namespace detail
+{
+
+/// Entropy coding of a single source message to a block, split in 2 steps: prepare() builds the encoder (if needed) and
+/// returns the upper bound on the words needed for the dictionary and data, encode() fills the block in the space booked
+/// for it. The encode() touches only the block, its metadata and the booked space, so that different blocks of the same
+/// container can be encoded concurrently. The literals are kept aside until the final position of the block is known.
+template <typename W>
+class BlockEncoderBase
+{
+ public:
+  virtual ~BlockEncoderBase() = default;
+
+  /// build symbol statistics and encoder if needed, return the number of W words to book for the dictionary and data
+  virtual size_t prepare() = 0;
+
+  /// encode to the empty block, using nWords words booked at dest
+  virtual void encode(Block<W>& block, Metadata& md, W* dest, size_t nWords, bool interleaved) = 0;
+
+  /// literals packed to W words, to be stored right after the data
+  const std::vector<W>& getLiterals() const { return mLiterals; }
+
+ protected:
+  std::vector<W> mLiterals;
+};
+
+template <typename W, typename S_IT>
+class BlockEncoder final : public BlockEncoderBase<W>
+{
+ public:
+  using STYP = typename std::iterator_traits<S_IT>::value_type;
+  using stream_t = typename o2::rans::Encoder64<STYP>::stream_t;
+  static_assert(std::is_same<W, stream_t>());
+
+  BlockEncoder(const S_IT srcBegin, const S_IT srcEnd, uint8_t probabilityBits, Metadata::OptStore opt, const void* encoderExt)
+    : mSrcBegin(srcBegin), mSrcEnd(srcEnd), mMessageLength(std::distance(srcBegin, srcEnd)), mProbabilityBits(probabilityBits), mOpt(opt), mEncoder(reinterpret_cast<const o2::rans::LiteralEncoder64<STYP>*>(encoderExt))
+  {
+  }
+
+  size_t prepare() final;
+  void encode(Block<W>& block, Metadata& md, W* dest, size_t nWords, bool interleaved) final;
+
+ private:
+  int getDictSize() const { return mFrequencies ? mFrequencies->size() : 0; }
+
+  const S_IT mSrcBegin;
+  const S_IT mSrcEnd;
+  const size_t mMessageLength = 0;
+  const uint8_t mProbabilityBits = 0;
+  const Metadata::OptStore mOpt = Metadata::OptStore::EENCODE;
+  const o2::rans::LiteralEncoder64<STYP>* mEncoder = nullptr;
+  std::unique_ptr<o2::rans::LiteralEncoder64<STYP>> mEncoderLoc;
+  std::unique_ptr<o2::rans::FrequencyTable> mFrequencies;
+};
+
+template <typename W, typename S_IT>
+size_t BlockEncoder<W, S_IT>::prepare()
+{
+  // cover three cases:
+  // * empty source message: no entropy coding
+  // * source message to pass through without any entropy coding
+  // * source message where entropy coding should be applied
+  if (mMessageLength == 0) {
+    return 0;
+  }
+  if (mOpt != Metadata::OptStore::EENCODE) { // no dictionary needed
+    return (mMessageLength * sizeof(STYP)) / sizeof(W) + (sizeof(STYP) < sizeof(W));
+  }
+  constexpr size_t SizeEstMarginAbs = 10 * 1024;
+  constexpr float SizeEstMarginRel = 1.05;
+  if (!mEncoder) { // no external encoder provide, create one on spot
+    mFrequencies = std::make_unique<o2::rans::FrequencyTable>();
+    mFrequencies->addSamples(mSrcBegin, mSrcEnd);
+    mEncoderLoc = std::make_unique<o2::rans::LiteralEncoder64<STYP>>(*mFrequencies, mProbabilityBits);
+    mEncoder = mEncoderLoc.get();
+  }
+  // estimate size of encode buffer
+  size_t dataSize = rans::calculateMaxBufferSize(mMessageLength, mEncoder->getAlphabetRangeBits(), sizeof(STYP)); // size in bytes
+  dataSize = SizeEstMarginAbs + size_t(SizeEstMarginRel * (dataSize / sizeof(W))) + (sizeof(STYP) < sizeof(W));   // size in words of output stream
+  return getDictSize() + dataSize;
+}
+
+template <typename W, typename S_IT>
+void BlockEncoder<W, S_IT>::encode(Block<W>& block, Metadata& md, W* dest, size_t nWords, bool interleaved)
+{
+  if (mMessageLength == 0) {
+    md = Metadata{0, 0, sizeof(uint64_t), sizeof(stream_t), mProbabilityBits, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
+    return;
+  }
+  if (block.getNStored() > 0) {
+    throw std::runtime_error("trying to write in occupied block");
+  }
+  block.payload = dest;
+  if (mOpt == Metadata::OptStore::EENCODE) {
+    // store dictionary first
+    const int dictSize = getDictSize();
+    if (dictSize) {
+      std::memcpy(dest, mFrequencies->data(), dictSize * sizeof(W));
+      block.setNDict(dictSize);
+    }
+    // directly encode source message into the block buffer, collecting incompressible literal symbols
+    std::vector<STYP> literals;
+    W* dataBegin = dest + dictSize;
+    const auto encodedMessageEnd = interleaved ? mEncoder->template process<o2::rans::NInterleavedStreams>(mSrcBegin, mSrcEnd, dataBegin, literals)
+                                               : mEncoder->process(mSrcBegin, mSrcEnd, dataBegin, literals);
+    rans::utils::checkBounds(encodedMessageEnd, dest + nWords);
+    const int dataSize = encodedMessageEnd - dataBegin;
+    block.setNData(dataSize);
+    int literalSize = 0;
+    if (literals.size()) {
+      literalSize = (literals.size() * sizeof(STYP)) / sizeof(W) + (sizeof(STYP) < sizeof(W));
+      this->mLiterals.resize(literalSize);
+      std::memcpy(this->mLiterals.data(), literals.data(), literals.size() * sizeof(STYP));
+    }
+    md = Metadata{mMessageLength, literals.size(), sizeof(uint64_t), sizeof(stream_t), static_cast<uint8_t>(mEncoder->getSymbolTablePrecision()), mOpt,
+                  mEncoder->getMinSymbol(), mEncoder->getMaxSymbol(), dictSize, dataSize, literalSize};
+  } else { // store original data w/o EEncoding
+    const int dataSize = (mMessageLength * sizeof(STYP)) / sizeof(W) + (sizeof(STYP) < sizeof(W));
+    dest[dataSize - 1] = 0; // don't leave garbage in the padding of the last word
+    std::copy(mSrcBegin, mSrcEnd, reinterpret_cast<STYP*>(dest));
+    block.setNData(dataSize);
+    md = Metadata{mMessageLength, 0, sizeof(uint64_t), sizeof(stream_t), mProbabilityBits, mOpt, 0, 0, 0, dataSize, 0};
+  }
+}
+
+} // namespace detail
+
+///<<======================== Concurrent blocks coding ==================<<
+
 template <typename H, int N, typename W = uint32_t>
 class EncodedBlocks
 {
@@ -404,6 +587,28 @@ class EncodedBlocks
   template <typename S_IT, typename VB>
   void encode(const S_IT srcBegin, const S_IT srcEnd, int slot, uint8_t probabilityBits, Metadata::OptStore opt, VB* buffer = nullptr, const void* encoderExt = nullptr);
 
+  using BlockEncoders = std::array<std::unique_ptr<detail::BlockEncoderBase<W>>, N>;
+
+  /// create the encoder of the source message for encodeConcurrently
+  template <typename S_IT>
+  static auto makeBlockEncoder(const S_IT srcBegin, const S_IT srcEnd, uint8_t probabilityBits, Metadata::OptStore opt, const void* encoderExt = nullptr)
+  {
+    return std::unique_ptr<detail::BlockEncoderBase<W>>(std::make_unique<detail::BlockEncoder<W, S_IT>>(srcBegin, srcEnd, probabilityBits, opt, encoderExt));
+  }
+
+  /// create the encoder of the vector src for encodeConcurrently
+  template <typename VE>
+  static auto makeBlockEncoder(const VE& src, uint8_t probabilityBits, Metadata::OptStore opt, const void* encoderExt = nullptr)
+  {
+    return makeBlockEncoder(std::begin(src), std::end(src), probabilityBits, opt, encoderExt);
+  }
+
+  /// encode all blocks of the empty container in the buffer on up to nThreads threads, each slot being filled by its encoder.
+  /// The space for all blocks is booked at once, the blocks are compactified at the end. Returns the container pointer,
+  /// which may change since the buffer may be expanded
+  template <typename VB>
+  static auto encodeConcurrently(VB& buffer, BlockEncoders& encoders, int nThreads);
+
   /// decode block at provided slot to destination vector (will be resized as needed)
   template <class container_T, class container_IT = typename container_T::iterator>
   void decode(container_T& dest, int slot, const void* decoderExt = nullptr) const;
@@ -743,11 +948,15 @@ void EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to
         // to D-word array
         literals = std::vector<dest_t>{reinterpret_cast<const dest_t*>(block.getLiterals()), reinterpret_cast<const dest_t*>(block.getLiterals()) + md.nLiterals};
       }
-      decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      if (mANSHeader.isInterleaved()) {
+        decoder->template process<o2::rans::NInterleavedStreams>(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      } else {
+        decoder->process(block.getData() + block.getNData(), dest, md.messageLength, literals);
+      }
     } else { // data was stored as is
       using destPtr_t = typename std::iterator_traits<D_IT>::pointer;
       destPtr_t srcBegin = reinterpret_cast<destPtr_t>(block.payload);
-      destPtr_t srcEnd = srcBegin + md.messageLength * sizeof(dest_t);
+      destPtr_t srcEnd = srcBegin + md.messageLength;
       std::copy(srcBegin, srcEnd, dest);
       //std::memcpy(dest, block.payload, md.messageLength * sizeof(dest_t));
     }
@@ -768,23 +977,10 @@ void EncodedBlocks<H, N, W>::encode(const S_IT srcBegin,     // iterator begin o
   // fill a new block
   assert(slot == mRegistry.nFilledBlocks);
   mRegistry.nFilledBlocks++;
-  using STYP = typename std::iterator_traits<S_IT>::value_type;
-  using stream_t = typename o2::rans::Encoder64<STYP>::stream_t;
 
-  const size_t messageLength = std::distance(srcBegin, srcEnd);
-  // cover three cases:
-  // * empty source message: no entropy coding
-  // * source message to pass through without any entropy coding
-  // * source message where entropy coding should be applied
-
-  // case 1: empty source message
-  if (messageLength == 0) {
-    mMetadata[slot] = Metadata{0, 0, sizeof(uint64_t), sizeof(stream_t), probabilityBits, Metadata::OptStore::NODATA, 0, 0, 0, 0, 0};
-    return;
-  }
-  static_assert(std::is_same<W, stream_t>());
-
-  Metadata md;
+  const bool interleaved = mANSHeader.isInterleaved();
+  detail::BlockEncoder<W, S_IT> blockEncoder(srcBegin, srcEnd, probabilityBits, opt, encoderExt);
+  const size_t nWords = blockEncoder.prepare();
   auto* bl = &mBlocks[slot];
   auto* meta = &mMetadata[slot];
 
@@ -804,66 +1000,97 @@ void EncodedBlocks<H, N, W>::encode(const S_IT srcBegin,     // iterator begin o
     }
   };
 
-  // case 3: message where entropy coding should be applied
-  if (opt == Metadata::OptStore::EENCODE) {
-    // build symbol statistics
-    constexpr size_t SizeEstMarginAbs = 10 * 1024;
-    constexpr float SizeEstMarginRel = 1.05;
-    const o2::rans::LiteralEncoder64<STYP>* encoder = reinterpret_cast<const o2::rans::LiteralEncoder64<STYP>*>(encoderExt);
-    std::unique_ptr<o2::rans::LiteralEncoder64<STYP>> encoderLoc;
-    std::unique_ptr<o2::rans::FrequencyTable> frequencies = nullptr;
-    int dictSize = 0;
-    if (!encoder) { // no external encoder provide, create one on spot
-      frequencies = std::make_unique<o2::rans::FrequencyTable>();
-      frequencies->addSamples(srcBegin, srcEnd);
-      encoderLoc = std::make_unique<o2::rans::LiteralEncoder64<STYP>>(*frequencies, probabilityBits);
-      encoder = encoderLoc.get();
-      dictSize = frequencies->size();
-    }
+  if (nWords) { // preliminary expansion of storage based on dict size + estimated size of encode buffer
+    expandStorage(nWords);
+  }
+  // note: "this" might be not valid after expandStorage call!!!
+  blockEncoder.encode(*bl, *meta, reinterpret_cast<W*>(bl->registry->getFreeBlockStart()), bl->registry->getFreeSize() / sizeof(W), interleaved);
+  if (!bl->getNStored()) { // empty source message
+    return;
+  }
+  // update the size claimed by encode message directly inside the block
+  bl->realignBlock();
+  // store incompressible symbols if any
+  const auto& literals = blockEncoder.getLiterals();
+  if (literals.size()) {
+    expandStorage(literals.size());
+    bl->storeLiterals(literals.size(), literals.data());
+  }
+}
 
-    // estimate size of encode buffer
-    int dataSize = rans::calculateMaxBufferSize(messageLength, encoder->getAlphabetRangeBits(), sizeof(STYP)); // size in bytes
-    // preliminary expansion of storage based on dict size + estimated size of encode buffer
-    dataSize = SizeEstMarginAbs + int(SizeEstMarginRel * (dataSize / sizeof(W))) + (sizeof(STYP) < sizeof(W)); // size in words of output stream
-    expandStorage(dictSize + dataSize);
-    //store dictionary first
-    if (dictSize) {
-      bl->storeDict(dictSize, frequencies->data());
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename VB>
+auto EncodedBlocks<H, N, W>::encodeConcurrently(VB& buffer, BlockEncoders& encoders, int nThreads)
+{
+  auto* eb = get(buffer.data());
+  if (eb->mRegistry.nFilledBlocks) {
+    throw std::runtime_error("concurrent encoding requires an empty container");
+  }
+  for (int slot = 0; slot < N; slot++) {
+    if (!encoders[slot]) {
+      throw std::runtime_error(fmt::format("no encoder provided for slot {}", slot));
     }
-    // vector of incompressible literal symbols
-    std::vector<STYP> literals;
-    // directly encode source message into block buffer.
-    auto blIn = bl->getCreateData();
-    auto frSize = bl->registry->getFreeSize(); // note: "this" might be not valid after expandStorage call!!!
-    const auto encodedMessageEnd = encoder->process(srcBegin, srcEnd, blIn, literals);
-    rans::utils::checkBounds(encodedMessageEnd, blIn + frSize);
-    dataSize = encodedMessageEnd - bl->getData();
-    bl->setNData(dataSize);
-    bl->realignBlock();
-    // update the size claimed by encode message directly inside the block
-    // store incompressible symbols if any
+  }
+  const bool interleaved = eb->mANSHeader.isInterleaved();
+
+  // build dictionaries and get upper bounds on the block sizes
+  std::array<size_t, N> nWords{};
+  runConcurrently(N, nThreads, [&encoders, &nWords](int slot) { nWords[slot] = encoders[slot]->prepare(); });
+
+  // book for every block its own region of the buffer, expanding it at most once
+  std::array<size_t, N> offsBooked{}; // in bytes wrt head
+  size_t offs = eb->mRegistry.offsFreeStart;
+  for (int slot = 0; slot < N; slot++) {
+    offsBooked[slot] = offs;
+    offs += estimateBlockSize(nWords[slot]);
+  }
+  if (offs > eb->size()) {
+    eb = expand(buffer, offs);
+  }
 
-    int literalSize = 0;
+  // each thread writes only to its own block, metadata and booked region
+  runConcurrently(N, nThreads, [eb, interleaved, &encoders, &nWords, &offsBooked](int slot) {
+    encoders[slot]->encode(eb->mBlocks[slot], eb->mMetadata[slot], reinterpret_cast<W*>(eb->mRegistry.head + offsBooked[slot]), nWords[slot], interleaved);
+  });
+
+  // compactify the blocks, leaving after the data the room for the literals
+  std::array<size_t, N> offsFinal{};
+  offs = eb->mRegistry.offsFreeStart;
+  for (int slot = 0; slot < N; slot++) {
+    offsFinal[slot] = offs;
+    offs += estimateBlockSize(eb->mBlocks[slot].getNStored() + encoders[slot]->getLiterals().size());
+  }
+  if (offs > eb->size()) { // possible only if the literals take more room than the data estimate margin
+    eb = expand(buffer, offs);
+  }
+  auto moveBlock = [eb, &offsFinal](int slot, bool toHead) {
+    auto& bl = eb->mBlocks[slot];
+    auto* dest = reinterpret_cast<W*>(eb->mRegistry.head + offsFinal[slot]);
+    if (bl.getNStored() && ((dest < bl.payload) == toHead) && dest != bl.payload) {
+      std::memmove(dest, bl.payload, bl.getNStored() * sizeof(W));
+      bl.payload = dest;
+    }
+  };
+  // moving the blocks towards the head in increasing slot order and those moving to the tail in decreasing order
+  // guarantees that no block overwrites the data of another one not moved yet
+  for (int slot = 0; slot < N; slot++) {
+    moveBlock(slot, true);
+  }
+  for (int slot = N; slot--;) {
+    moveBlock(slot, false);
+  }
+  for (int slot = 0; slot < N; slot++) {
+    const auto& literals = encoders[slot]->getLiterals();
     if (literals.size()) {
-      literalSize = (literals.size() * sizeof(STYP)) / sizeof(stream_t) + (sizeof(STYP) < sizeof(stream_t));
-      expandStorage(literalSize);
-      bl->storeLiterals(literalSize, reinterpret_cast<const stream_t*>(literals.data()));
+      auto& bl = eb->mBlocks[slot];
+      std::memcpy(bl.payload + bl.getNStored(), literals.data(), literals.size() * sizeof(W));
+      bl.setNLiterals(literals.size());
     }
-    *meta = Metadata{messageLength, literals.size(), sizeof(uint64_t), sizeof(stream_t), static_cast<uint8_t>(encoder->getSymbolTablePrecision()), opt,
-                     encoder->getMinSymbol(), encoder->getMaxSymbol(), dictSize, dataSize, literalSize};
-
-  } else { // store original data w/o EEncoding
-    const size_t szb = messageLength * sizeof(STYP);
-    const int dataSize = szb / sizeof(stream_t) + (sizeof(STYP) < sizeof(stream_t));
-    // no dictionary needed
-    expandStorage(dataSize);
-    *meta = Metadata{messageLength, 0, sizeof(uint64_t), sizeof(stream_t), probabilityBits, opt, 0, 0, 0, dataSize, 0};
-    //FIXME: no we don't need an intermediate vector.
-    // provided iterator is not necessarily pointer, need to use intermediate vector!!!
-    std::vector<STYP> vtmp(srcBegin, srcEnd);
-    bl->storeData(meta->nDataWords, reinterpret_cast<const W*>(vtmp.data()));
-  }
-  // resize block if necessary
+  }
+  eb->mRegistry.offsFreeStart = offs;
+  eb->mRegistry.nFilledBlocks = N;
+  return eb;
 }
 
 /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
@@ -32,11 +32,14 @@ class NameConf : public o2::conf::ConfigurableParamHelper<NameConf>
  public:
 
   // The Hits file name are generated by hardcoded schema, only prefix is mutable to allow the embedding
-  static std::string getHitsFileName(o2::detectors::DetID d, const std::string_view prefix = STANDARDSIMPREFIX)
+  static std::string getHitsFileName(o2::detectors::DetID d, const std::string_view prefix = STANDARDSIMPREFIX, const std::string_view ext = ROOT_EXT_STRING)
   {
-    return o2::utils::Str::concat_string(prefix, "_", HITS_STRING, d.getName(), ".root");
+    return o2::utils::Str::concat_string(prefix, "_", HITS_STRING, d.getName(), ".", ext);
   }
 
+  // extension of the hit files in the flat format
+  static constexpr std::string_view HITSFLATEXT = "flathits"; // hardcoded
+
   // The Digits file name are generated by hardcoded schema, only prefix is mutable to allow the embedding
   static std::string getDigitsFileName(o2::detectors::DetID d, const std::string_view prefix = STANDARDSIMPREFIX)
   {
@@ -100,8 +103,11 @@ class NameConf : public o2::conf::ConfigurableParamHelper<NameConf>
   // CTF tree name
   static constexpr std::string_view CTFTREENAME = "ctf"; // hardcoded
 
+  // extension of the CTF files in the flat (memory-mappable) format
+  static constexpr std::string_view CTFFLATEXT = "ctf"; // hardcoded
+
   // CTF Filename
-  static std::string getCTFFileName(uint32_t run, uint32_t orb, uint32_t id, const std::string_view prefix = "o2_ctf");
+  static std::string getCTFFileName(uint32_t run, uint32_t orb, uint32_t id, const std::string_view prefix = "o2_ctf", const std::string_view ext = ROOT_EXT_STRING);
 
   // CTF Dictionary
   static std::string getCTFDictFileName();
@@ -0,0 +1,180 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CTFFlatFile.cxx
+/// \brief Native container of CTFs storing the flat EncodedBlocks images of detectors page-aligned
+
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include "CommonUtils/StringUtils.h"
+#include <Framework/Logger.h>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+//___________________________________________________________________
+void CTFFlatFileWriter::open(const std::string& name)
+{
+  close();
+  mFile.open(name, std::ios::binary | std::ios::out | std::ios::trunc);
+  if (!mFile.is_open()) {
+    throw std::runtime_error(o2::utils::Str::concat_string("failed to open CTF file ", name));
+  }
+  mName = name;
+  CTFFlatFile::FileHeader fileHeader; // will be updated at closing
+  mFile.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+  mPos = sizeof(fileHeader);
+  mCurrent = CTFFlatFile::Entry{};
+  mIndex.clear();
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::padToPage()
+{
+  static const std::array<char, CTFFlatFile::PageSize> zeros{};
+  size_t pad = CTFFlatFile::alignToPage(mPos) - mPos;
+  mFile.write(zeros.data(), pad);
+  mPos += pad;
+}
+
+//___________________________________________________________________
+size_t CTFFlatFileWriter::addImage(DetID det, const void* image, size_t size)
+{
+  padToPage();
+  auto& chunk = mCurrent.chunks[det];
+  chunk.offset = mPos;
+  chunk.size = size;
+  mFile.write(reinterpret_cast<const char*>(image), size);
+  if (!mFile.good()) {
+    throw std::runtime_error(o2::utils::Str::concat_string("failed to write ", det.getName(), " CTF image to ", mName));
+  }
+  mPos += size;
+  mCurrent.detectors |= det.getMask().to_ulong();
+  return size;
+}
+
+//___________________________________________________________________
+size_t CTFFlatFileWriter::endCTF(const CTFHeader& header)
+{
+  mCurrent.run = header.run;
+  mCurrent.firstTForbit = header.firstTForbit;
+  mIndex.push_back(mCurrent);
+  mCurrent = CTFFlatFile::Entry{};
+  return sizeof(CTFFlatFile::Entry);
+}
+
+//___________________________________________________________________
+void CTFFlatFileWriter::close()
+{
+  if (!mFile.is_open()) {
+    return;
+  }
+  padToPage();
+  CTFFlatFile::FileHeader fileHeader;
+  fileHeader.nEntries = mIndex.size();
+  fileHeader.indexOffset = mPos;
+  mFile.write(reinterpret_cast<const char*>(mIndex.data()), mIndex.size() * sizeof(CTFFlatFile::Entry));
+  mFile.seekp(0);
+  mFile.write(reinterpret_cast<const char*>(&fileHeader), sizeof(fileHeader));
+  mFile.close();
+  if (mFile.fail()) {
+    LOG(ERROR) << "Failed to finalize CTF file " << mName;
+  }
+  mIndex.clear();
+  mPos = 0;
+}
+
+//___________________________________________________________________
+bool CTFFlatFileReader::isFlatFile(const std::string& name)
+{
+  CTFFlatFile::FileHeader fileHeader;
+  std::ifstream inp(name, std::ios::binary);
+  return inp.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader)) && fileHeader.magic == CTFFlatFile::Magic;
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::open(const std::string& name)
+{
+  close();
+  int fd = ::open(name.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(CTFFlatFile::FileHeader)) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    throw std::runtime_error(o2::utils::Str::concat_string("failed to open CTF file ", name));
+  }
+  size_t size = st.st_size;
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping stays valid
+  if (addr == MAP_FAILED) {
+    throw std::runtime_error(o2::utils::Str::concat_string("failed to memory-map CTF file ", name));
+  }
+  madvise(addr, size, MADV_SEQUENTIAL);
+  std::shared_ptr<const char> mapping(reinterpret_cast<const char*>(addr), [size](const char* ptr) { munmap(const_cast<char*>(ptr), size); });
+
+  const auto* fileHeader = reinterpret_cast<const CTFFlatFile::FileHeader*>(mapping.get());
+  if (fileHeader->magic != CTFFlatFile::Magic || fileHeader->version != CTFFlatFile::Version) {
+    throw std::runtime_error(o2::utils::Str::concat_string(name, " is not a CTF flat file of version ", std::to_string(CTFFlatFile::Version)));
+  }
+  if (!fileHeader->indexOffset || fileHeader->indexOffset + fileHeader->nEntries * sizeof(CTFFlatFile::Entry) > size) {
+    throw std::runtime_error(o2::utils::Str::concat_string("CTF file ", name, " was not closed properly or is truncated"));
+  }
+  mIndex = reinterpret_cast<const CTFFlatFile::Entry*>(mapping.get() + fileHeader->indexOffset);
+  mNEntries = fileHeader->nEntries;
+  mSize = size;
+  mName = name;
+  mMapping = std::move(mapping);
+}
+
+//___________________________________________________________________
+void CTFFlatFileReader::close()
+{
+  mMapping.reset();
+  mIndex = nullptr;
+  mNEntries = 0;
+  mSize = 0;
+}
+
+//___________________________________________________________________
+const CTFFlatFile::Entry& CTFFlatFileReader::getEntry(size_t entry) const
+{
+  if (entry >= mNEntries) {
+    throw std::out_of_range(o2::utils::Str::concat_string("CTF entry ", std::to_string(entry), " is out of range for ", mName));
+  }
+  return mIndex[entry];
+}
+
+//___________________________________________________________________
+CTFHeader CTFFlatFileReader::getCTFHeader(size_t entry) const
+{
+  const auto& ent = getEntry(entry);
+  CTFHeader header{ent.run, ent.firstTForbit};
+  header.detectors = DetID::mask_t(ent.detectors);
+  return header;
+}
+
+//___________________________________________________________________
+CTFFlatFileReader::Image CTFFlatFileReader::getImage(size_t entry, DetID det) const
+{
+  const auto& chunk = getEntry(entry).chunks[det];
+  if (!chunk.size) {
+    return {};
+  }
+  if (chunk.offset + chunk.size > mSize) {
+    throw std::runtime_error(o2::utils::Str::concat_string(det.getName(), " CTF image of entry ", std::to_string(entry), " exceeds the size of ", mName));
+  }
+  return {mMapping.get() + chunk.offset, chunk.size};
+}
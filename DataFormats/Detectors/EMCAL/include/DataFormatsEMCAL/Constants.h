@@ -101,10 +101,11 @@ constexpr Int_t EMCAL_MAXTIMEBINS = 15;      ///< Maximum number of time bins fo
 } // namespace constants
 
 enum FitAlgorithm {
-  Standard = 0,  ///< Standard raw fitter
-  Gamma2 = 1,    ///< Gamma2 raw fitter
-  NeuralNet = 2, ///< Neural net raw fitter
-  NONE = 3
+  Standard = 0,    ///< Standard raw fitter
+  Gamma2 = 1,      ///< Gamma2 raw fitter
+  NeuralNet = 2,   ///< Neural net raw fitter
+  NONE = 3,        ///< No raw fitter
+  LookupTable = 4  ///< Lookup table raw fitter
 };
 
 } // namespace emcal
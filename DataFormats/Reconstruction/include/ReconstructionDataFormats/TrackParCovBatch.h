@@ -0,0 +1,112 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file TrackParCovBatch.h
+/// \brief Structure-of-arrays container of tracks with covariance, for batched propagation on the CPU
+
+#ifndef ALICEO2_TRACK_PARCOV_BATCH_H
+#define ALICEO2_TRACK_PARCOV_BATCH_H
+
+#include "ReconstructionDataFormats/TrackParametrizationWithError.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace o2
+{
+namespace track
+{
+
+/// Batch of tracks stored as structure of arrays: every parameter and every covariance element has
+/// its own contiguous array. The kernels apply the same operation as the corresponding method of
+/// TrackParametrizationWithError to all the tracks of the batch, with identical results, in
+/// branch-free loops which the compiler can vectorize. A track for which the scalar method would
+/// return false is flagged as failed and left unchanged, the kernels skip the failed tracks.
+/// Per-track inputs are passed as arrays of size() elements.
+template <typename value_T = float>
+class TrackParCovBatch
+{
+ public:
+  using value_t = value_T;
+  using TrackParCov_t = TrackParametrizationWithError<value_t>;
+
+  size_t size() const { return mX.size(); }
+  bool empty() const { return mX.empty(); }
+  void clear();
+  void reserve(size_t n);
+
+  /// append a track, return its index in the batch
+  size_t add(const TrackParCov_t& trc);
+  /// copy the track at index i to the scalar representation
+  void get(size_t i, TrackParCov_t& trc) const;
+  TrackParCov_t get(size_t i) const
+  {
+    TrackParCov_t trc;
+    get(i, trc);
+    return trc;
+  }
+
+  bool isOK(size_t i) const { return mOK[i]; }
+  void setOK(size_t i, bool v = true) { mOK[i] = v; }
+  size_t getNOK() const;
+
+  value_t getX(size_t i) const { return mX[i]; }
+  value_t getAlpha(size_t i) const { return mAlpha[i]; }
+  value_t getParam(int ip, size_t i) const { return mP[ip][i]; }
+  value_t getCov(int ic, size_t i) const { return mC[ic][i]; }
+  void setX(size_t i, value_t x) { mX[i] = x; }
+
+  const value_t* getXData() const { return mX.data(); }
+  const value_t* getAlphaData() const { return mAlpha.data(); }
+  const value_t* getParamData(int ip) const { return mP[ip].data(); }
+  const value_t* getCovData(int ic) const { return mC[ic].data(); }
+
+  /// propagate to the planes X=xk[i] in the field b (kG)
+  void propagateTo(const value_t* xk, value_t b) { propagateTo(xk, &b, 0); }
+  /// propagate to the planes X=xk[i] in the fields b[i] (kG)
+  void propagateTo(const value_t* xk, const value_t* b) { propagateTo(xk, b, 1); }
+  /// rotate to the frames alpha[i]
+  void rotate(const value_t* alpha);
+  /// update with the space points (y[i], z[i]) having the covariances (sy2[i], syz[i], sz2[i])
+  void update(const value_t* y, const value_t* z, const value_t* sy2, const value_t* syz, const value_t* sz2);
+  /// correct for the crossed material, dedx is always calculated on the fly
+  void correctForMaterial(const value_t* x2x0, const value_t* xrho, bool anglecorr = false);
+  /// force the covariance matrices of the good tracks to be positive and within the limits
+  void checkCovariance();
+
+  /// global coordinates of the tracks
+  void getXYZGlo(value_t* x, value_t* y, value_t* z) const;
+  /// inverse of the momentum squared of the tracks
+  void getP2Inv(value_t* p2inv) const;
+
+ private:
+  void propagateTo(const value_t* xk, const value_t* b, size_t bStride);
+  void checkCovariance(const uint8_t* mask);
+  void resizeWork();
+
+  std::vector<value_t> mX;                          // X of track evaluation
+  std::vector<value_t> mAlpha;                      // track frame angle
+  std::array<std::vector<value_t>, kNParams> mP;    // Y, Z, sin(phi), tg(lambda), q/pT
+  std::array<std::vector<value_t>, kCovMatSize> mC; // covariance matrix elements
+  std::vector<value_t> mAbsCharge;                  // abs charge
+  std::vector<value_t> mMass;                       // mass of the PID hypothesis
+  std::vector<value_t> mMass2;                      // mass squared of the PID hypothesis
+  std::vector<PID::ID> mPID;                        // PID hypothesis
+  std::vector<uint8_t> mOK;                         // track is still good
+  std::vector<uint8_t> mUpdated;                    // work space: track was modified by the current kernel
+  std::vector<uint8_t> mArc;                        // work space: Z propagation along the arc is needed
+  std::array<std::vector<value_t>, 4> mWork;        // work space
+};
+
+} // namespace track
+} // namespace o2
+
+#endif
@@ -0,0 +1,598 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file TrackParCovBatch.cxx
+/// \brief Structure-of-arrays container of tracks with covariance, for batched propagation on the CPU
+
+#include "ReconstructionDataFormats/TrackParCovBatch.h"
+#include "ReconstructionDataFormats/TrackUtils.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace o2::track;
+using namespace o2::constants::math;
+
+// The arrays of the batch never overlap: tell the compiler, which otherwise gives up the vectorization
+// of the loops accessing many of them because of the number of the run-time aliasing checks
+#if defined(__clang__)
+#define O2_BATCH_LOOP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define O2_BATCH_LOOP _Pragma("GCC ivdep")
+#else
+#define O2_BATCH_LOOP
+#endif
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::clear()
+{
+  mX.clear();
+  mAlpha.clear();
+  for (auto& p : mP) {
+    p.clear();
+  }
+  for (auto& c : mC) {
+    c.clear();
+  }
+  mAbsCharge.clear();
+  mMass.clear();
+  mMass2.clear();
+  mPID.clear();
+  mOK.clear();
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::reserve(size_t n)
+{
+  mX.reserve(n);
+  mAlpha.reserve(n);
+  for (auto& p : mP) {
+    p.reserve(n);
+  }
+  for (auto& c : mC) {
+    c.reserve(n);
+  }
+  mAbsCharge.reserve(n);
+  mMass.reserve(n);
+  mMass2.reserve(n);
+  mPID.reserve(n);
+  mOK.reserve(n);
+}
+
+//______________________________________________________________
+template <typename value_T>
+size_t TrackParCovBatch<value_T>::add(const TrackParCov_t& trc)
+{
+  mX.push_back(trc.getX());
+  mAlpha.push_back(trc.getAlpha());
+  for (int ip = 0; ip < kNParams; ip++) {
+    mP[ip].push_back(trc.getParam(ip));
+  }
+  for (int ic = 0; ic < kCovMatSize; ic++) {
+    mC[ic].push_back(trc.getCov()[ic]);
+  }
+  mAbsCharge.push_back(trc.getAbsCharge());
+  mMass.push_back(trc.getPID().getMass());
+  mMass2.push_back(trc.getPID().getMass2());
+  mPID.push_back(trc.getPID().getID());
+  mOK.push_back(1);
+  return mX.size() - 1;
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::get(size_t i, TrackParCov_t& trc) const
+{
+  typename TrackParCov_t::params_t par;
+  typename TrackParCov_t::covMat_t cov;
+  for (int ip = 0; ip < kNParams; ip++) {
+    par[ip] = mP[ip][i];
+  }
+  for (int ic = 0; ic < kCovMatSize; ic++) {
+    cov[ic] = mC[ic][i];
+  }
+  trc.set(mX[i], mAlpha[i], par, cov, int(mAbsCharge[i]), PID(mPID[i]));
+}
+
+//______________________________________________________________
+template <typename value_T>
+size_t TrackParCovBatch<value_T>::getNOK() const
+{
+  size_t n = 0;
+  for (auto ok : mOK) {
+    n += ok;
+  }
+  return n;
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::resizeWork()
+{
+  auto n = size();
+  mUpdated.resize(n);
+  mArc.resize(n);
+  for (auto& w : mWork) {
+    w.resize(n);
+  }
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::propagateTo(const value_t* xk, const value_t* b, size_t bStride)
+{
+  // same as TrackParametrizationWithError::propagateTo(xk, b) for every track
+  resizeWork();
+  const size_t n = size();
+  value_t *px = mX.data(), *py = mP[kY].data(), *pz = mP[kZ].data(), *psnp = mP[kSnp].data();
+  const value_t *ptgl = mP[kTgl].data(), *pq2pt = mP[kQ2Pt].data(), *pq = mAbsCharge.data();
+  value_t *pc00 = mC[kSigY2].data(), *pc10 = mC[kSigZY].data(), *pc11 = mC[kSigZ2].data(), *pc20 = mC[kSigSnpY].data(), *pc21 = mC[kSigSnpZ].data(),
+          *pc22 = mC[kSigSnp2].data(), *pc30 = mC[kSigTglY].data(), *pc31 = mC[kSigTglZ].data(), *pc32 = mC[kSigTglSnp].data(), *pc40 = mC[kSigQ2PtY].data(),
+          *pc41 = mC[kSigQ2PtZ].data(), *pc42 = mC[kSigQ2PtSnp].data();
+  const value_t *pc33 = mC[kSigTgl2].data(), *pc43 = mC[kSigQ2PtTgl].data(), *pc44 = mC[kSigQ2Pt2].data();
+  uint8_t *ok = mOK.data(), *upd = mUpdated.data(), *arc = mArc.data();
+  value_t *wf1 = mWork[0].data(), *wrot = mWork[1].data();
+
+  // all the elements are loaded unconditionally and the results are selected, to keep the loop free of branches
+  O2_BATCH_LOOP
+  for (size_t i = 0; i < n; i++) {
+    value_t bi = b[i * bStride], x = px[i], y = py[i], z = pz[i], snp = psnp[i], tgl = ptgl[i], q2pt = pq2pt[i], q = pq[i];
+    value_t c00 = pc00[i], c10 = pc10[i], c11 = pc11[i], c20 = pc20[i], c21 = pc21[i], c22 = pc22[i], c30 = pc30[i], c31 = pc31[i],
+            c32 = pc32[i], c33 = pc33[i], c40 = pc40[i], c41 = pc41[i], c42 = pc42[i], c43 = pc43[i], c44 = pc44[i];
+
+    value_t dx = xk[i] - x;
+    value_t crvQ = q2pt * bi * B2C, zero = 0.f;
+    value_t crv = q != 0 ? crvQ : zero;
+    value_t x2r = crv * dx;
+    value_t f1 = snp, f2 = f1 + x2r;
+    value_t r1 = gpu::CAMath::Sqrt((1.f - f1) * (1.f + f1));
+    value_t r2 = gpu::CAMath::Sqrt((1.f - f2) * (1.f + f2));
+    bool valid = (gpu::CAMath::Abs(f1) <= Almost1) & (gpu::CAMath::Abs(f2) <= Almost1) & (gpu::CAMath::Abs(r1) >= Almost0) & (gpu::CAMath::Abs(r2) >= Almost0);
+    bool moved = gpu::CAMath::Abs(dx) >= Almost0;
+    bool good = (ok[i] != 0) & (valid | !moved);
+    bool doUpd = good & moved;
+    ok[i] = good;
+    upd[i] = doUpd;
+    // Z propagation along the arc is needed at large dx/R only, it is done in a separate loop
+    bool lin = gpu::CAMath::Abs(x2r) < 0.05f;
+    arc[i] = doUpd & !lin;
+    wf1[i] = f1;
+    wrot[i] = r1 * f2 - r2 * f1;
+
+    double dy2dx = (f1 + f2) / (r1 + r2);
+    value_t dY = dx * dy2dx;
+    value_t dZ = dx * (r2 + f2 * dy2dx) * tgl;
+
+    // evaluate matrix in double prec.
+    double rinv = 1. / r1;
+    double r3inv = rinv * rinv * rinv;
+    double f24 = dx * bi * B2C; // x2r/mP[kQ2Pt];
+    double f02 = dx * r3inv;
+    double f04 = 0.5 * f24 * f02;
+    double f12 = f02 * tgl * f1;
+    double f14 = 0.5 * f24 * f12; // 0.5*f24*f02*getTgl()*f1;
+    double f13 = dx * rinv;
+
+    // b = C*ft
+    double b00 = f02 * c20 + f04 * c40, b01 = f12 * c20 + f14 * c40 + f13 * c30;
+    double b02 = f24 * c40;
+    double b10 = f02 * c21 + f04 * c41, b11 = f12 * c21 + f14 * c41 + f13 * c31;
+    double b12 = f24 * c41;
+    double b20 = f02 * c22 + f04 * c42, b21 = f12 * c22 + f14 * c42 + f13 * c32;
+    double b22 = f24 * c42;
+    double b40 = f02 * c42 + f04 * c44, b41 = f12 * c42 + f14 * c44 + f13 * c43;
+    double b42 = f24 * c44;
+    double b30 = f02 * c32 + f04 * c43, b31 = f12 * c32 + f14 * c43 + f13 * c33;
+    double b32 = f24 * c43;
+
+    // a = f*b = f*C*ft
+    double a00 = f02 * b20 + f04 * b40, a01 = f02 * b21 + f04 * b41, a02 = f02 * b22 + f04 * b42;
+    double a11 = f12 * b21 + f14 * b41 + f13 * b31, a12 = f12 * b22 + f14 * b42 + f13 * b32;
+    double a22 = f24 * b42;
+
+    value_t xUpd = xk[i], yUpd = y + dY, zUpd = z + dZ, snpUpd = snp + x2r;
+    px[i] = doUpd ? xUpd : x;
+    py[i] = doUpd ? yUpd : y;
+    pz[i] = (doUpd & lin) ? zUpd : z;
+    psnp[i] = doUpd ? snpUpd : snp;
+
+    // F*C*Ft = C + (b + bt + a)
+    value_t c00Upd = c00 + (b00 + b00 + a00), c10Upd = c10 + (b10 + b01 + a01), c20Upd = c20 + (b20 + b02 + a02), c30Upd = c30 + b30, c40Upd = c40 + b40;
+    value_t c11Upd = c11 + (b11 + b11 + a11), c21Upd = c21 + (b21 + b12 + a12), c31Upd = c31 + b31, c41Upd = c41 + b41;
+    value_t c22Upd = c22 + (b22 + b22 + a22), c32Upd = c32 + b32, c42Upd = c42 + b42;
+    pc00[i] = doUpd ? c00Upd : c00;
+    pc10[i] = doUpd ? c10Upd : c10;
+    pc20[i] = doUpd ? c20Upd : c20;
+    pc30[i] = doUpd ? c30Upd : c30;
+    pc40[i] = doUpd ? c40Upd : c40;
+    pc11[i] = doUpd ? c11Upd : c11;
+    pc21[i] = doUpd ? c21Upd : c21;
+    pc31[i] = doUpd ? c31Upd : c31;
+    pc41[i] = doUpd ? c41Upd : c41;
+    pc22[i] = doUpd ? c22Upd : c22;
+    pc32[i] = doUpd ? c32Upd : c32;
+    pc42[i] = doUpd ? c42Upd : c42;
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    if (!arc[i]) {
+      continue;
+    }
+    // see TrackParametrizationWithError::propagateTo for the explanation
+    value_t f1 = wf1[i], f2 = psnp[i];
+    value_t crv = pq2pt[i] * b[i * bStride] * B2C;
+    value_t rot = gpu::CAMath::ASin(wrot[i]);
+    if (f1 * f1 + f2 * f2 > 1.f && f1 * f2 < 0.f) { // special cases of large rotations or large abs angles
+      rot = f2 > 0.f ? PI - rot : -PI - rot;
+    }
+    pz[i] += ptgl[i] / crv * rot;
+  }
+
+  checkCovariance(upd);
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::rotate(const value_t* alpha)
+{
+  // same as TrackParametrizationWithError::rotate(alpha) for every track, without the warnings
+  resizeWork();
+  const size_t n = size();
+  value_t *px = mX.data(), *palp = mAlpha.data(), *py = mP[kY].data(), *psnp = mP[kSnp].data();
+  value_t *pc00 = mC[kSigY2].data(), *pc10 = mC[kSigZY].data(), *pc20 = mC[kSigSnpY].data(), *pc21 = mC[kSigSnpZ].data(), *pc22 = mC[kSigSnp2].data(),
+          *pc30 = mC[kSigTglY].data(), *pc32 = mC[kSigTglSnp].data(), *pc40 = mC[kSigQ2PtY].data(), *pc42 = mC[kSigQ2PtSnp].data();
+  uint8_t *ok = mOK.data(), *upd = mUpdated.data();
+  value_t *wAlpha = mWork[0].data(), *wsa = mWork[1].data(), *wca = mWork[2].data();
+
+  // the trigonometric functions are not vectorized, they are evaluated in a separate loop
+  for (size_t i = 0; i < n; i++) {
+    wAlpha[i] = math_utils::detail::toPMPi<value_t>(alpha[i]);
+    math_utils::detail::sincos<value_t>(wAlpha[i] - palp[i], wsa[i], wca[i]);
+  }
+
+  O2_BATCH_LOOP
+  for (size_t i = 0; i < n; i++) {
+    value_t alp = palp[i], alpUpd = wAlpha[i], x = px[i], y = py[i], snp = psnp[i], ca = wca[i], sa = wsa[i];
+    value_t csp = gpu::CAMath::Sqrt((1.f - snp) * (1.f + snp));
+    value_t updSnp = snp * ca - csp * sa;
+    // the rotation must not invalidate the track model: cos(local_phi) must stay >= 0
+    bool doUpd = (ok[i] != 0) & (gpu::CAMath::Abs(snp) <= Almost1) & (csp * ca + snp * sa >= 0) & (gpu::CAMath::Abs(updSnp) <= Almost1);
+    ok[i] = doUpd;
+    upd[i] = doUpd;
+
+    value_t xUpd = x * ca + y * sa, yUpd = -x * sa + y * ca;
+    palp[i] = doUpd ? alpUpd : alp;
+    px[i] = doUpd ? xUpd : x;
+    py[i] = doUpd ? yUpd : y;
+    psnp[i] = doUpd ? updSnp : snp;
+
+    value_t cspCut = Almost0;
+    csp = gpu::CAMath::Abs(csp) < Almost0 ? cspCut : csp;
+    value_t rr = (ca + snp / csp * sa);
+    // unit scales for the tracks which are not rotated
+    value_t one = 1.f;
+    ca = doUpd ? ca : one;
+    rr = doUpd ? rr : one;
+
+    pc00[i] *= (ca * ca);
+    pc10[i] *= ca;
+    pc20[i] *= ca * rr;
+    pc21[i] *= rr;
+    pc22[i] *= rr * rr;
+    pc30[i] *= ca;
+    pc32[i] *= rr;
+    pc40[i] *= ca;
+    pc42[i] *= rr;
+  }
+
+  checkCovariance(upd);
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::update(const value_t* y, const value_t* z, const value_t* sy2, const value_t* syz, const value_t* sz2)
+{
+  // same as TrackParametrizationWithError::update(p, cov) for every track
+  resizeWork();
+  const size_t n = size();
+  value_t *py = mP[kY].data(), *pz = mP[kZ].data(), *psnp = mP[kSnp].data(), *ptgl = mP[kTgl].data(), *pq2pt = mP[kQ2Pt].data();
+  value_t *pc00 = mC[kSigY2].data(), *pc10 = mC[kSigZY].data(), *pc11 = mC[kSigZ2].data(), *pc20 = mC[kSigSnpY].data(), *pc21 = mC[kSigSnpZ].data(),
+          *pc22 = mC[kSigSnp2].data(), *pc30 = mC[kSigTglY].data(), *pc31 = mC[kSigTglZ].data(), *pc32 = mC[kSigTglSnp].data(), *pc33 = mC[kSigTgl2].data(),
+          *pc40 = mC[kSigQ2PtY].data(), *pc41 = mC[kSigQ2PtZ].data(), *pc42 = mC[kSigQ2PtSnp].data(), *pc43 = mC[kSigQ2PtTgl].data(),
+          *pc44 = mC[kSigQ2Pt2].data();
+  uint8_t *ok = mOK.data(), *upd = mUpdated.data();
+
+  O2_BATCH_LOOP
+  for (size_t i = 0; i < n; i++) {
+    value_t ty = py[i], tz = pz[i], snp = psnp[i], tgl = ptgl[i], q2pt = pq2pt[i];
+    value_t cm00 = pc00[i], cm10 = pc10[i], cm11 = pc11[i], cm20 = pc20[i], cm21 = pc21[i], cm22 = pc22[i], cm30 = pc30[i], cm31 = pc31[i],
+            cm32 = pc32[i], cm33 = pc33[i], cm40 = pc40[i], cm41 = pc41[i], cm42 = pc42[i], cm43 = pc43[i], cm44 = pc44[i];
+
+    double r00 = static_cast<double>(sy2[i]) + static_cast<double>(cm00);
+    double r01 = static_cast<double>(syz[i]) + static_cast<double>(cm10);
+    double r11 = static_cast<double>(sz2[i]) + static_cast<double>(cm11);
+    double det = r00 * r11 - r01 * r01;
+    bool detOK = gpu::CAMath::Abs(det) >= Almost0;
+    double detI = 1. / det;
+    double tmp = r00;
+    r00 = r11 * detI;
+    r11 = tmp * detI;
+    r01 = -r01 * detI;
+
+    double k00 = cm00 * r00 + cm10 * r01, k01 = cm00 * r01 + cm10 * r11;
+    double k10 = cm10 * r00 + cm11 * r01, k11 = cm10 * r01 + cm11 * r11;
+    double k20 = cm20 * r00 + cm21 * r01, k21 = cm20 * r01 + cm21 * r11;
+    double k30 = cm30 * r00 + cm31 * r01, k31 = cm30 * r01 + cm31 * r11;
+    double k40 = cm40 * r00 + cm41 * r01, k41 = cm40 * r01 + cm41 * r11;
+
+    value_t dy = y[i] - ty, dz = z[i] - tz;
+    value_t dsnp = k20 * dy + k21 * dz;
+    bool doUpd = (ok[i] != 0) & detOK & (gpu::CAMath::Abs(snp + dsnp) <= Almost1);
+    ok[i] = doUpd;
+    upd[i] = doUpd;
+
+    value_t yUpd = ty + value_t(k00 * dy + k01 * dz), zUpd = tz + value_t(k10 * dy + k11 * dz), snpUpd = snp + dsnp;
+    value_t tglUpd = tgl + value_t(k30 * dy + k31 * dz), q2ptUpd = q2pt + value_t(k40 * dy + k41 * dz);
+    py[i] = doUpd ? yUpd : ty;
+    pz[i] = doUpd ? zUpd : tz;
+    psnp[i] = doUpd ? snpUpd : snp;
+    ptgl[i] = doUpd ? tglUpd : tgl;
+    pq2pt[i] = doUpd ? q2ptUpd : q2pt;
+
+    double c01 = cm10, c02 = cm20, c03 = cm30, c04 = cm40;
+    double c12 = cm21, c13 = cm31, c14 = cm41;
+
+    value_t cm00Upd = cm00 - (k00 * cm00 + k01 * cm10);
+    value_t cm10Upd = cm10 - (k00 * c01 + k01 * cm11);
+    value_t cm20Upd = cm20 - (k00 * c02 + k01 * c12);
+    value_t cm30Upd = cm30 - (k00 * c03 + k01 * c13);
+    value_t cm40Upd = cm40 - (k00 * c04 + k01 * c14);
+
+    value_t cm11Upd = cm11 - (k10 * c01 + k11 * cm11);
+    value_t cm21Upd = cm21 - (k10 * c02 + k11 * c12);
+    value_t cm31Upd = cm31 - (k10 * c03 + k11 * c13);
+    value_t cm41Upd = cm41 - (k10 * c04 + k11 * c14);
+
+    value_t cm22Upd = cm22 - (k20 * c02 + k21 * c12);
+    value_t cm32Upd = cm32 - (k20 * c03 + k21 * c13);
+    value_t cm42Upd = cm42 - (k20 * c04 + k21 * c14);
+
+    value_t cm33Upd = cm33 - (k30 * c03 + k31 * c13);
+    value_t cm43Upd = cm43 - (k30 * c04 + k31 * c14);
+
+    value_t cm44Upd = cm44 - (k40 * c04 + k41 * c14);
+
+    pc00[i] = doUpd ? cm00Upd : cm00;
+    pc10[i] = doUpd ? cm10Upd : cm10;
+    pc20[i] = doUpd ? cm20Upd : cm20;
+    pc30[i] = doUpd ? cm30Upd : cm30;
+    pc40[i] = doUpd ? cm40Upd : cm40;
+    pc11[i] = doUpd ? cm11Upd : cm11;
+    pc21[i] = doUpd ? cm21Upd : cm21;
+    pc31[i] = doUpd ? cm31Upd : cm31;
+    pc41[i] = doUpd ? cm41Upd : cm41;
+    pc22[i] = doUpd ? cm22Upd : cm22;
+    pc32[i] = doUpd ? cm32Upd : cm32;
+    pc42[i] = doUpd ? cm42Upd : cm42;
+    pc33[i] = doUpd ? cm33Upd : cm33;
+    pc43[i] = doUpd ? cm43Upd : cm43;
+    pc44[i] = doUpd ? cm44Upd : cm44;
+  }
+
+  checkCovariance(upd);
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::correctForMaterial(const value_t* x2x0, const value_t* xrho, bool anglecorr)
+{
+  // same as TrackParametrizationWithError::correctForMaterial(x2x0, xrho, anglecorr) for every track
+  constexpr value_t kMSConst2 = 0.0136f * 0.0136f;
+  constexpr value_t kMaxELossFrac = 0.3f; // max allowed fractional eloss
+  constexpr value_t kMinP = 0.01f;        // kill below this momentum
+  constexpr value_t knst = 0.07f;         // energy loss fluctuation, see the scalar version
+  resizeWork();
+  const size_t n = size();
+  value_t *psnp = mP[kSnp].data(), *ptgl = mP[kTgl].data(), *pq2pt = mP[kQ2Pt].data();
+  const value_t *pq = mAbsCharge.data(), *pmass = mMass.data(), *pmass2 = mMass2.data();
+  value_t *pc22 = mC[kSigSnp2].data(), *pc33 = mC[kSigTgl2].data(), *pc43 = mC[kSigQ2PtTgl].data(), *pc44 = mC[kSigQ2Pt2].data();
+  uint8_t *ok = mOK.data(), *upd = mUpdated.data();
+  value_t *wp = mWork[0].data(), *wangle = mWork[1].data(), *wcP4 = mWork[2].data(), *wsigma2 = mWork[3].data();
+
+  // path length correction for the track inclination, kept out of the main loop
+  if (anglecorr) {
+    for (size_t i = 0; i < n; i++) {
+      value_t csp2 = (1.f - psnp[i]) * (1.f + psnp[i]);
+      value_t cst2I = (1.f + ptgl[i] * ptgl[i]);
+      wangle[i] = gpu::CAMath::Sqrt(cst2I / csp2);
+    }
+  } else {
+    std::fill_n(wangle, n, value_t(1));
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    value_t pInv = gpu::CAMath::Abs(pq2pt[i]) / gpu::CAMath::Sqrt(1.f + ptgl[i] * ptgl[i]);
+    value_t pInvQ = pInv / pq[i];
+    pInv = pq[i] > 1 ? pInvQ : pInv;
+    value_t p = 1.f / pInv;
+    wp[i] = pInv > Almost0 ? p : VeryBig;
+    wcP4[i] = 1.f;
+    wsigma2[i] = 0.f;
+  }
+
+  // energy loss, with the Bethe-Bloch dE/dx (not vectorized), for the tracks which need it only
+  for (size_t i = 0; i < n; i++) {
+    value_t txrho = xrho[i] * wangle[i], p = wp[i], p2 = p * p, e2 = p2 + pmass2[i];
+    if (!ok[i] || txrho == 0.f || p2 / e2 >= 1.f) {
+      continue;
+    }
+    value_t dedx = BetheBlochSolid(p / pmass[i]);
+    if (pq[i] != 1) {
+      dedx *= pq[i] * pq[i];
+    }
+    value_t dE = dedx * txrho;
+    value_t e = gpu::CAMath::Sqrt(e2);
+    value_t eupd = e + dE;
+    value_t pupd2 = eupd * eupd - pmass2[i];
+    if (gpu::CAMath::Abs(dE) > kMaxELossFrac * e || pupd2 < kMinP * kMinP) {
+      ok[i] = false; // the track is left unchanged, as the scalar version does
+      continue;
+    }
+    wcP4[i] = p / gpu::CAMath::Sqrt(pupd2);
+    value_t charge2Pt = pq[i] != 0 ? pq2pt[i] : 0.f;
+    value_t sigmadE = knst * gpu::CAMath::Sqrt(gpu::CAMath::Abs(dE)) * e / p2 * charge2Pt;
+    wsigma2[i] = sigmadE * sigmadE;
+  }
+
+  // multiple scattering and application of the corrections
+  O2_BATCH_LOOP
+  for (size_t i = 0; i < n; i++) {
+    value_t snp = psnp[i], tgl = ptgl[i], q2pt = pq2pt[i], q = pq[i], cP4 = wcP4[i], sigma2 = wsigma2[i];
+    value_t c22 = pc22[i], c33 = pc33[i], c43 = pc43[i], c44 = pc44[i];
+    value_t csp2 = (1.f - snp) * (1.f + snp); // cos(phi)^2
+    value_t cst2I = (1.f + tgl * tgl);        // 1/cos(lambda)^2
+    value_t tx2x0 = x2x0[i] * wangle[i];
+    value_t p = wp[i];
+    value_t p2 = p * p;
+    value_t beta2 = p2 / (p2 + pmass2[i]);
+    value_t zero = 0.f;
+    value_t charge2Pt = q != 0 ? q2pt : zero;
+
+    bool doMS = tx2x0 != 0.f;
+    value_t theta2 = kMSConst2 / (beta2 * p2) * gpu::CAMath::Abs(tx2x0);
+    value_t theta2Q = theta2 * (q * q);
+    theta2 = q != 1 ? theta2Q : theta2;
+    bool doUpd = (ok[i] != 0) & ((!doMS) | (theta2 <= PI * PI));
+    ok[i] = doUpd;
+    upd[i] = doUpd;
+
+    // the corrections are nulled, rather than the results selected, for the tracks which are not updated
+    value_t one = 1.f;
+    theta2 = (doMS & doUpd) ? theta2 : zero;
+    sigma2 = doUpd ? sigma2 : zero;
+    cP4 = doUpd ? cP4 : one;
+    value_t fp34 = tgl * charge2Pt;
+    value_t t2c2I = theta2 * cst2I;
+    pc22[i] = c22 + t2c2I * csp2;
+    pc33[i] = c33 + t2c2I * cst2I;
+    pc43[i] = c43 + t2c2I * fp34;
+    pc44[i] = c44 + (theta2 * fp34 * fp34 + sigma2);
+    pq2pt[i] = q2pt * cP4;
+  }
+
+  checkCovariance(upd);
+}
+
+namespace
+{
+// clamp the diagonal element of the covariance matrix if requested, return the scale to apply to the corresponding off-diagonal elements
+template <typename value_T>
+inline value_T clampDiagonal(value_T& diag, value_T maxVal, bool apply)
+{
+  value_T d = o2::gpu::CAMath::Abs(diag);
+  bool large = apply & (d > maxVal);
+  value_T clamped = large ? maxVal : d;
+  diag = apply ? clamped : diag;
+  value_T den = large ? d : maxVal; // unit scale otherwise, the square root is evaluated unconditionally
+  return o2::gpu::CAMath::Sqrt(maxVal / den);
+}
+} // namespace
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::checkCovariance(const uint8_t* mask)
+{
+  // same as TrackParametrizationWithError::checkCovariance for the tracks flagged in the mask
+  const size_t n = size();
+  value_t *c00 = mC[kSigY2].data(), *c10 = mC[kSigZY].data(), *c11 = mC[kSigZ2].data(), *c20 = mC[kSigSnpY].data(), *c21 = mC[kSigSnpZ].data(),
+          *c22 = mC[kSigSnp2].data(), *c30 = mC[kSigTglY].data(), *c31 = mC[kSigTglZ].data(), *c32 = mC[kSigTglSnp].data(), *c33 = mC[kSigTgl2].data(),
+          *c40 = mC[kSigQ2PtY].data(), *c41 = mC[kSigQ2PtZ].data(), *c42 = mC[kSigQ2PtSnp].data(), *c43 = mC[kSigQ2PtTgl].data(),
+          *c44 = mC[kSigQ2Pt2].data();
+
+  O2_BATCH_LOOP
+  for (size_t i = 0; i < n; i++) {
+    bool apply = mask[i];
+    value_t scl = clampDiagonal<value_t>(c00[i], kCY2max, apply);
+    c10[i] *= scl;
+    c20[i] *= scl;
+    c30[i] *= scl;
+    c40[i] *= scl;
+    scl = clampDiagonal<value_t>(c11[i], kCZ2max, apply);
+    c10[i] *= scl;
+    c21[i] *= scl;
+    c31[i] *= scl;
+    c41[i] *= scl;
+    scl = clampDiagonal<value_t>(c22[i], kCSnp2max, apply);
+    c20[i] *= scl;
+    c21[i] *= scl;
+    c32[i] *= scl;
+    c42[i] *= scl;
+    scl = clampDiagonal<value_t>(c33[i], kCTgl2max, apply);
+    c30[i] *= scl;
+    c31[i] *= scl;
+    c32[i] *= scl;
+    c43[i] *= scl;
+    scl = clampDiagonal<value_t>(c44[i], kC1Pt2max, apply);
+    c40[i] *= scl;
+    c41[i] *= scl;
+    c42[i] *= scl;
+    c43[i] *= scl;
+  }
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::checkCovariance()
+{
+  checkCovariance(mOK.data());
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::getXYZGlo(value_t* x, value_t* y, value_t* z) const
+{
+  // track coordinates in lab frame, as TrackParametrization::getXYZGlo
+  const size_t n = size();
+  const value_t *xl = mX.data(), *alp = mAlpha.data(), *yl = mP[kY].data(), *zl = mP[kZ].data();
+  for (size_t i = 0; i < n; i++) {
+#ifndef GPUCA_ALIGPUCODE
+    auto xyz = math_utils::Rotation2D<value_t>(alp[i])(math_utils::Point3D<value_t>(xl[i], yl[i], zl[i]));
+    x[i] = xyz.X();
+    y[i] = xyz.Y();
+#else // same mockup as in TrackParametrization
+    float sina, cosa;
+    gpu::CAMath::SinCos(alp[i], sina, cosa);
+    x[i] = cosa * xl[i] + sina * yl[i];
+    y[i] = cosa * yl[i] - sina * xl[i];
+#endif
+    z[i] = zl[i];
+  }
+}
+
+//______________________________________________________________
+template <typename value_T>
+void TrackParCovBatch<value_T>::getP2Inv(value_t* p2inv) const
+{
+  // inverted track momentum^2, as TrackParametrization::getP2Inv
+  const size_t n = size();
+  const value_t *ptgl = mP[kTgl].data(), *pq2pt = mP[kQ2Pt].data(), *q = mAbsCharge.data();
+  for (size_t i = 0; i < n; i++) {
+    value_t p2 = pq2pt[i] * pq2pt[i] / (1.f + ptgl[i] * ptgl[i]);
+    p2inv[i] = q[i] > 1 ? p2 * q[i] * q[i] : p2;
+  }
+}
+
+namespace o2::track
+{
+template class TrackParCovBatch<float>;
+template class TrackParCovBatch<double>;
+} // namespace o2::track
@@ -0,0 +1,106 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchTrackParCovBatch.cxx
+/// \brief Benchmark of the batched track kernels against the scalar TrackParametrizationWithError methods
+///
+/// Each iteration propagates a set of random tracks in a constant field, rotates them, updates them with
+/// a space point and corrects them for the material, once track by track and once with TrackParCovBatch.
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "ReconstructionDataFormats/Track.h"
+#include "ReconstructionDataFormats/TrackParCovBatch.h"
+
+using namespace o2::track;
+
+namespace
+{
+constexpr float BZ = 5.f;
+
+struct Inputs {
+  std::vector<TrackParCov> tracks;
+  std::vector<float> xk, alpha, y, z, sy2, syz, sz2, x2x0, xrho;
+};
+
+Inputs createInputs(size_t nTracks)
+{
+  Inputs inp;
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<float> rnd(-1., 1.);
+  for (size_t i = 0; i < nTracks; i++) {
+    std::array<float, kNParams> par{5 * rnd(gen), 20 * rnd(gen), 0.5f * rnd(gen), rnd(gen), 2 * rnd(gen)};
+    std::array<float, kCovMatSize> cov{};
+    cov[kSigY2] = 1e-2;
+    cov[kSigZ2] = 2e-2;
+    cov[kSigSnp2] = 1e-4;
+    cov[kSigTgl2] = 1e-4;
+    cov[kSigQ2Pt2] = 1e-2;
+    auto alp = 3 * rnd(gen);
+    auto& trc = inp.tracks.emplace_back(20 + rnd(gen), alp, par, cov);
+    inp.xk.push_back(trc.getX() + 5);
+    inp.alpha.push_back(alp + 0.1f * rnd(gen));
+    inp.y.push_back(trc.getY());
+    inp.z.push_back(trc.getZ());
+    inp.sy2.push_back(1e-4);
+    inp.syz.push_back(1e-6);
+    inp.sz2.push_back(2e-4);
+    inp.x2x0.push_back(1e-2);
+    inp.xrho.push_back(-0.5);
+  }
+  return inp;
+}
+
+void BM_Scalar(benchmark::State& state)
+{
+  auto inp = createInputs(state.range(0));
+  for (auto _ : state) {
+    auto tracks = inp.tracks;
+    for (size_t i = 0; i < tracks.size(); i++) {
+      auto& trc = tracks[i];
+      const float p[2] = {inp.y[i], inp.z[i]}, c[3] = {inp.sy2[i], inp.syz[i], inp.sz2[i]};
+      bool ok = trc.propagateTo(inp.xk[i], BZ) && trc.rotate(inp.alpha[i]) && trc.update(p, c) && trc.correctForMaterial(inp.x2x0[i], inp.xrho[i]);
+      benchmark::DoNotOptimize(ok);
+    }
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Batch(benchmark::State& state)
+{
+  auto inp = createInputs(state.range(0));
+  TrackParCovBatch<float> batch;
+  batch.reserve(inp.tracks.size());
+  for (auto _ : state) {
+    // refilling the batch is part of the cost for the clients which keep scalar tracks
+    batch.clear();
+    for (const auto& trc : inp.tracks) {
+      batch.add(trc);
+    }
+    batch.propagateTo(inp.xk.data(), BZ);
+    batch.rotate(inp.alpha.data());
+    batch.update(inp.y.data(), inp.z.data(), inp.sy2.data(), inp.syz.data(), inp.sz2.data());
+    batch.correctForMaterial(inp.x2x0.data(), inp.xrho.data());
+    benchmark::DoNotOptimize(batch.getCovData(kSigQ2Pt2));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+} // namespace
+
+BENCHMARK(BM_Scalar)->RangeMultiplier(8)->Range(64, 32768);
+BENCHMARK(BM_Batch)->RangeMultiplier(8)->Range(64, 32768);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,108 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test TrackParCovBatch class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "ReconstructionDataFormats/TrackParCovBatch.h"
+#include <random>
+#include <vector>
+
+namespace o2
+{
+namespace track
+{
+
+// the batch must reproduce exactly the scalar propagation, including the tracks failing on the way
+template <typename value_T>
+void compareToScalar()
+{
+  using Track = TrackParametrizationWithError<value_T>;
+  const int nTracks = 2000, nSteps = 10;
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<value_T> rnd(-1., 1.);
+
+  std::vector<Track> tracks;
+  TrackParCovBatch<value_T> batch;
+  for (int i = 0; i < nTracks; i++) {
+    std::array<value_T, kNParams> par{5 * rnd(gen), 20 * rnd(gen), value_T(0.9) * rnd(gen), value_T(1.5) * rnd(gen), (i % 7 ? 3 : 30) * rnd(gen)};
+    std::array<value_T, kCovMatSize> cov{};
+    cov[kSigY2] = 1e-2 * (1 + rnd(gen));
+    cov[kSigZY] = 1e-4 * rnd(gen);
+    cov[kSigZ2] = 2e-2 * (1 + rnd(gen));
+    cov[kSigSnpY] = 1e-5 * rnd(gen);
+    cov[kSigSnp2] = 1e-4 * (1 + rnd(gen));
+    cov[kSigTgl2] = 1e-4 * (1 + rnd(gen));
+    cov[kSigQ2PtSnp] = 1e-5 * rnd(gen);
+    cov[kSigQ2PtTgl] = 1e-6 * rnd(gen);
+    cov[kSigQ2Pt2] = 1e-2 * (1 + rnd(gen));
+    tracks.emplace_back(3 + rnd(gen), 3 * rnd(gen), par, cov, i % 11 ? 1 : 2, PID(PID::ID(i % PID::NIDs)));
+    batch.add(tracks.back());
+  }
+
+  std::vector<value_T> xk(nTracks), alpha(nTracks), y(nTracks), z(nTracks), x2x0(nTracks), xrho(nTracks);
+  std::vector<value_T> sy2(nTracks, 1e-4), syz(nTracks, 1e-6), sz2(nTracks, 2e-4);
+  std::vector<bool> ok(nTracks, true);
+  for (int is = 0; is < nSteps; is++) {
+    for (int i = 0; i < nTracks; i++) {
+      xk[i] = tracks[i].getX() + (is % 3 ? 3 * (1 + rnd(gen)) : 0);
+      alpha[i] = tracks[i].getAlpha() + value_T(0.3) * rnd(gen);
+      y[i] = tracks[i].getY() + value_T(0.01) * rnd(gen);
+      z[i] = tracks[i].getZ() + value_T(0.01) * rnd(gen);
+      x2x0[i] = 0.01 * (1 + rnd(gen));
+      xrho[i] = -0.3 * (1 + rnd(gen));
+    }
+    batch.propagateTo(xk.data(), value_T(5.));
+    batch.rotate(alpha.data());
+    batch.update(y.data(), z.data(), sy2.data(), syz.data(), sz2.data());
+    batch.correctForMaterial(x2x0.data(), xrho.data(), is % 2);
+    for (int i = 0; i < nTracks; i++) {
+      ok[i] = ok[i] && tracks[i].propagateTo(xk[i], value_T(5.));
+      ok[i] = ok[i] && tracks[i].rotate(alpha[i]);
+      const value_T p[2] = {y[i], z[i]}, c[3] = {sy2[i], syz[i], sz2[i]};
+      ok[i] = ok[i] && tracks[i].update(p, c);
+      ok[i] = ok[i] && tracks[i].correctForMaterial(x2x0[i], xrho[i], is % 2);
+    }
+  }
+
+  size_t nOK = 0;
+  for (int i = 0; i < nTracks; i++) {
+    BOOST_CHECK(batch.isOK(i) == ok[i]);
+    if (!ok[i]) {
+      continue;
+    }
+    nOK++;
+    auto trc = batch.get(i);
+    BOOST_CHECK(trc.getX() == tracks[i].getX());
+    BOOST_CHECK(trc.getAlpha() == tracks[i].getAlpha());
+    for (int ip = 0; ip < kNParams; ip++) {
+      BOOST_CHECK(trc.getParam(ip) == tracks[i].getParam(ip));
+    }
+    for (int ic = 0; ic < kCovMatSize; ic++) {
+      BOOST_CHECK(trc.getCov()[ic] == tracks[i].getCov()[ic]);
+    }
+  }
+  BOOST_CHECK(nOK > 0 && nOK == batch.getNOK());
+}
+
+BOOST_AUTO_TEST_CASE(TrackParCovBatchFloat)
+{
+  compareToScalar<float>();
+}
+
+BOOST_AUTO_TEST_CASE(TrackParCovBatchDouble)
+{
+  compareToScalar<double>();
+}
+
+} // namespace track
+} // namespace o2
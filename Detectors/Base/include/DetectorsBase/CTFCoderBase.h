@@ -81,13 +81,18 @@ class CTFCoderBase
     }
   }
 
+  /// number of threads to use for the concurrent entropy coding of the blocks
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
  protected:
   std::string getPrefix() const { return o2::utils::Str::concat_string(mDet.getName(), "_CTF: "); }
 
   std::vector<std::shared_ptr<void>> mCoders; // encoders/decoders
   DetID mDet;
+  int mNThreads = 1;
 
-  ClassDefNV(CTFCoderBase, 1);
+  ClassDefNV(CTFCoderBase, 2);
 };
 
 } // namespace ctf
@@ -23,6 +23,7 @@
 #include "FairDetector.h" // for FairDetector
 #include "FairRootManager.h"
 #include "DetectorsBase/MaterialManager.h"
+#include "DetectorsBase/FlatHits.h"
 #include "Rtypes.h" // for Float_t, Int_t, Double_t, Detector::Class, etc
 #include <cxxabi.h>
 #include <typeinfo>
@@ -31,6 +32,7 @@
 #include <TMessage.h>
 #include "CommonUtils/ShmManager.h"
 #include "CommonUtils/ShmAllocator.h"
+#include "SimConfig/SimConfig.h"
 #include <sys/shm.h>
 #include <type_traits>
 #include <unistd.h>
@@ -170,6 +172,13 @@ class Detector : public FairDetector
   // merging
   virtual void mergeHitEntries(TTree& origin, TTree& target, std::vector<int> const& trackoffsets, std::vector<int> const& nprimaries, std::vector<int> const& subevtsOrdered) = 0;
 
+  // interfaces of the flat hit transport (see FlatHits.h), used by the hit merger for the hits sent in the
+  // HitEncoding::Flat encoding: collect the hits of a sub-event without decoding them and merge those of all
+  // sub-events of an event into the target TTree, and into a flat file if writer is given
+  virtual void collectFlatHits(FairMQParts& parts, int& index, int entry, std::vector<FlatHitChunk>& chunks) = 0;
+  virtual void mergeFlatHits(std::vector<FlatHitChunk> const& chunks, TTree& target, FlatHitFileWriter* writer,
+                             std::vector<int> const& trackoffsets, std::vector<int> const& nprimaries, std::vector<int> const& subevtsOrdered) = 0;
+
   // hook which is called automatically to custom initialize the O2 detectors
   // all initialization not able to do in constructors should be done here
   // (typically the case for geometry related stuff, etc)
@@ -267,6 +276,12 @@ T decodeTMessage(FairMQParts& dataparts, int index)
 }
 
 void attachDetIDHeaderMessage(int id, FairMQChannel& channel, FairMQParts& parts);
+void attachHitHeaderMessage(HitHeader const& header, FairMQChannel& channel, FairMQParts& parts);
+
+// copies the raw hits into a new message
+void attachFlatHitsMessage(const void* hits, size_t size, FairMQChannel& channel, FairMQParts& parts);
+// takes the message with raw hits, which is kept by the chunk
+void decodeFlatHitsMessage(FairMQParts& dataparts, int index, FlatHitChunk& chunk);
 
 template <typename T>
 TBranch* getOrMakeBranch(TTree& tree, const char* brname, T* ptr)
@@ -329,11 +344,22 @@ class DetImpl : public o2::base::Detector
       return;
     }
 
-    attachDetIDHeaderMessage(GetDetId(), channel, parts); // the DetId s are universal as they come from o2::detector::DetID
+    // trivially copyable hits may be sent as raw arrays, see FlatHits.h
+    using Hit_t = typename std::remove_pointer<decltype(static_cast<Det*>(this)->Det::getHits(0))>::type::value_type;
+    const bool flat = std::is_trivially_copyable<Hit_t>::value && o2::conf::SimConfig::Instance().useFlatHits();
+    if (flat) {
+      attachHitHeaderMessage(HitHeader{GetDetId(), HitEncoding::Flat}, channel, parts);
+    } else {
+      attachDetIDHeaderMessage(GetDetId(), channel, parts); // the DetId s are universal as they come from o2::detector::DetID
+    }
 
     while (auto hits = static_cast<Det*>(this)->Det::getHits(probe++)) {
       if (!UseShm<Det>::value || !o2::utils::ShmManager::Instance().isOperational()) {
-        attachTMessage(*hits, channel, parts);
+        if (flat) {
+          attachFlatHitsMessage(hits->data(), hits->size() * sizeof(Hit_t), channel, parts);
+        } else {
+          attachTMessage(*hits, channel, parts);
+        }
       } else {
         // this is the shared mem variant
         // we will just send the sharedmem ID and the offset inside
@@ -465,6 +491,68 @@ class DetImpl : public o2::base::Detector
     }
   }
 
+  void collectFlatHits(FairMQParts& parts, int& index, int entry, std::vector<FlatHitChunk>& chunks) override
+  {
+    int probe = 0;
+    bool* busy = nullptr;
+    using Hit_t = decltype(static_cast<Det*>(this)->Det::getHits(probe));
+    using Value_t = typename std::remove_pointer<Hit_t>::type::value_type;
+    std::string name = static_cast<Det*>(this)->getHitBranchNames(probe);
+    while (name.size() > 0) {
+      auto& chunk = chunks.emplace_back();
+      chunk.entry = entry;
+      chunk.probe = probe;
+      if (!UseShm<Det>::value || !o2::utils::ShmManager::Instance().isOperational()) {
+        decodeFlatHitsMessage(parts, index++, chunk);
+      } else {
+        // the shared memory buffer is given back to the worker right away, the hits are copied
+        auto hitsptr = decodeShmMessage<Hit_t>(parts, index++, busy);
+        auto copy = std::make_shared<std::vector<Value_t>>(hitsptr->begin(), hitsptr->end());
+        chunk.data = reinterpret_cast<const char*>(copy->data());
+        chunk.size = copy->size() * sizeof(Value_t);
+        chunk.owner = std::move(copy);
+      }
+      name = static_cast<Det*>(this)->getHitBranchNames(++probe);
+    }
+    if (busy) {
+      *busy = false;
+    }
+  }
+
+  void mergeFlatHits(std::vector<FlatHitChunk> const& chunks, TTree& target, FlatHitFileWriter* writer,
+                     std::vector<int> const& trackoffsets, std::vector<int> const& nprimaries, std::vector<int> const& subevtsOrdered) override
+  {
+    int probe = 0;
+    using Hit_t = decltype(static_cast<Det*>(this)->Det::getHits(probe));
+    using VectorHit_t = typename std::remove_pointer<Hit_t>::type;
+    using Value_t = typename VectorHit_t::value_type;
+    if constexpr (std::is_trivially_copyable<Value_t>::value) {
+      auto targetdata = new VectorHit_t;
+      std::vector<const FlatHitChunk*> branchChunks;
+      std::string name = static_cast<Det*>(this)->getHitBranchNames(probe);
+      while (name.size() > 0) {
+        branchChunks.clear();
+        for (auto& chunk : chunks) {
+          if (chunk.probe == probe) {
+            branchChunks.push_back(&chunk);
+          }
+        }
+        mergeFlatHitChunks(branchChunks, *targetdata, trackoffsets, nprimaries, subevtsOrdered);
+        if (writer) {
+          writer->write(target.GetEntries(), probe, targetdata->data(), sizeof(Value_t), targetdata->size());
+        }
+        auto targetbr = o2::base::getOrMakeBranch(target, name.c_str(), &targetdata);
+        targetbr->SetAddress(&targetdata);
+        targetbr->Fill();
+        targetbr->ResetAddress();
+        name = static_cast<Det*>(this)->getHitBranchNames(++probe);
+      }
+      delete targetdata;
+    } else {
+      LOG(FATAL) << "Hits of " << GetName() << " cannot be sent in the flat encoding";
+    }
+  }
+
   // implementing CloneModule (for G4-MT mode) automatically for each deriving
   // Detector class "Det"; calls copy constructor of Det
   FairModule* CloneModule() const final
@@ -0,0 +1,170 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FlatHits.h
+/// \brief Flat transport of hits between the simulation workers and the hit merger
+///
+/// Hits of trivially copyable types are sent as raw arrays, one message per hit branch, after a detector
+/// header message announcing the encoding. The hit merger keeps the arrays of all sub-events of an event
+/// and concatenates them in the sub-event order, remapping the track IDs in place, without intermediate TTrees.
+///
+/// The merged hits may also be written to flat files with the layout:
+/// FileHeader
+/// for every merged hit array: BlockHeader, followed by BlockHeader::nHits hits of BlockHeader::hitSize bytes
+
+#ifndef ALICEO2_BASE_FLATHITS_H
+#define ALICEO2_BASE_FLATHITS_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace base
+{
+
+/// encodings of the hits sent by the simulation workers
+enum class HitEncoding : int32_t {
+  TMessage = 0, // ROOT serialized hit vectors, or pointers to hit vectors in shared memory
+  Flat = 1      // raw arrays of trivially copyable hits, or pointers to hit vectors in shared memory
+};
+
+/// header message preceding the hit messages of a detector
+struct HitHeader {
+  int32_t detID = 0;
+  HitEncoding encoding = HitEncoding::TMessage;
+};
+
+/// hits of one branch of one sub-event, received in the flat encoding
+struct FlatHitChunk {
+  int entry = 0;                     // sub-event entry, in the order of arrival as for the SubEventInfo
+  int probe = 0;                     // index of the hit branch of the detector
+  std::shared_ptr<const void> owner; // keeps the hits alive: the message they were received in, or their copy
+  const char* data = nullptr;
+  size_t size = 0; // in bytes
+
+  template <typename Hit>
+  size_t getNHits() const
+  {
+    return size / sizeof(Hit);
+  }
+};
+
+/// Concatenates the hits of one branch of all the sub-events of an event into target, in the order of the
+/// sub-events, and remaps their track IDs as done for the hits merged from the TTree entries:
+/// the primaries of each sub-event are placed first, followed by the secondaries of all sub-events.
+/// trackoffsets, nprimaries are indexed by the entry, subevtsOrdered gives the entry of each sub-event.
+template <typename Hit>
+void mergeFlatHitChunks(std::vector<const FlatHitChunk*> const& chunks, std::vector<Hit>& target,
+                        std::vector<int> const& trackoffsets, std::vector<int> const& nprimaries, std::vector<int> const& subevtsOrdered)
+{
+  const int entries = subevtsOrdered.size();
+  std::vector<const FlatHitChunk*> chunkOfEntry(entries, nullptr);
+  size_t nHits = 0;
+  for (auto chunk : chunks) {
+    chunkOfEntry[chunk->entry] = chunk;
+    nHits += chunk->getNHits<Hit>();
+  }
+  target.clear();
+  target.resize(nHits);
+
+  int nprimTot = 0;
+  for (int entry = 0; entry < entries; entry++) {
+    nprimTot += nprimaries[entry];
+  }
+  int idelta0 = 0;        // offset for the primary track index
+  int idelta1 = nprimTot; // offset for the secondary track index
+  size_t position = 0;
+  for (int entry = entries - 1; entry >= 0; --entry) {
+    int index = subevtsOrdered[entry];
+    int nprim = nprimaries[index];
+    idelta1 -= nprim;
+    if (auto chunk = chunkOfEntry[index]) {
+      // the messages give no alignment guarantee, the hits are copied bytewise and then remapped in place
+      size_t n = chunk->getNHits<Hit>();
+      std::memcpy(static_cast<void*>(target.data() + position), chunk->data, n * sizeof(Hit));
+      for (size_t i = position; i < position + n; i++) {
+        const auto oldID = target[i].GetTrackID();
+        target[i].SetTrackID(oldID + ((oldID < nprim) ? idelta0 : idelta1));
+      }
+      position += n;
+    }
+    idelta0 += nprim;
+    idelta1 += trackoffsets[index];
+  }
+}
+
+/// Writer of the merged hits in the flat file format
+class FlatHitFileWriter
+{
+ public:
+  static constexpr uint64_t Magic = 0x5354494854414c46; // "FLATHITS"
+  static constexpr uint32_t Version = 1;
+
+  struct FileHeader {
+    uint64_t magic = Magic;
+    uint32_t version = Version;
+    int32_t detID = 0;
+  };
+
+  struct BlockHeader {
+    int32_t event = 0;    // entry of the event in the ROOT hit file
+    int32_t probe = 0;    // index of the hit branch of the detector
+    uint32_t hitSize = 0; // size of a hit in bytes
+    uint32_t reserved = 0;
+    uint64_t nHits = 0;
+  };
+
+  FlatHitFileWriter() = default;
+  ~FlatHitFileWriter() { close(); }
+
+  /// create new file, throws on failure
+  void open(const std::string& name, int detID);
+
+  /// write the hits of one branch of an event, throws on failure
+  void write(int event, int probe, const void* hits, size_t hitSize, size_t nHits);
+
+  void close();
+
+  bool isOpen() const { return mFile.is_open(); }
+  const std::string& getName() const { return mName; }
+
+ private:
+  std::string mName;
+  std::ofstream mFile;
+};
+
+/// Reader of the hits in the flat file format
+class FlatHitFileReader
+{
+ public:
+  /// open the file and read its header, throws on failure
+  void open(const std::string& name);
+
+  /// read the next block of hits into hits, return false at the end of the file
+  bool next(FlatHitFileWriter::BlockHeader& header, std::vector<char>& hits);
+
+  int getDetID() const { return mHeader.detID; }
+
+ private:
+  std::string mName;
+  std::ifstream mFile;
+  FlatHitFileWriter::FileHeader mHeader;
+};
+
+} // namespace base
+} // namespace o2
+
+#endif
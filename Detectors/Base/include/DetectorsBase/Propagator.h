@@ -28,6 +28,10 @@
 #include <string>
 #endif
 
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+#include "ReconstructionDataFormats/TrackParCovBatch.h"
+#endif
+
 namespace o2
 {
 namespace parameters
@@ -86,6 +90,14 @@ class PropagatorImpl
                            value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
                            track::TrackLTIntegral* tofInfo = nullptr, int signCorr = 0) const;
 
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+  /// propagate all the good tracks of the batch to the plane X=x in the field bZ, as done by propagateToX for a single track
+  /// (no TOF integration), the tracks which fail are flagged in the batch. Returns the number of good tracks.
+  int propagateToX(track::TrackParCovBatch<value_type>& batch, value_type x, value_type bZ,
+                   value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                   int signCorr = 0) const;
+#endif
+
   template <typename track_T>
   GPUd() bool propagateTo(track_T& track, value_type x, bool bzOnly = false, value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP,
                           MatCorrType matCorr = MatCorrType::USEMatCorrLUT, track::TrackLTIntegral* tofInfo = nullptr, int signCorr = 0) const
@@ -146,6 +158,15 @@ class PropagatorImpl
 
   GPUd() void getFieldXYZ(const math_utils::Point3D<double> xyz, double* bxyz) const;
 
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+  /// material budgets of the n segments from (x0[i], y0[i], z0[i]) to (x1[i], y1[i], z1[i])
+  void getMatBudget(MatCorrType corrType, size_t n, const value_type* x0, const value_type* y0, const value_type* z0,
+                    const value_type* x1, const value_type* y1, const value_type* z1, MatBudget* mb) const;
+
+  /// field components at the n points (x[i], y[i], z[i])
+  void getFieldXYZ(size_t n, const value_type* x, const value_type* y, const value_type* z, value_type* bx, value_type* by, value_type* bz) const;
+#endif
+
  private:
 #ifndef GPUCA_GPUCODE
   PropagatorImpl(bool uninitialized = false);
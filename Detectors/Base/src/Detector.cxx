@@ -211,6 +211,26 @@ void attachDetIDHeaderMessage(int id, FairMQChannel& channel, FairMQParts& parts
   std::unique_ptr<FairMQMessage> message(channel.NewSimpleMessage(id));
   parts.AddPart(std::move(message));
 }
+void attachHitHeaderMessage(HitHeader const& header, FairMQChannel& channel, FairMQParts& parts)
+{
+  std::unique_ptr<FairMQMessage> message(channel.NewSimpleMessage(header));
+  parts.AddPart(std::move(message));
+}
+void attachFlatHitsMessage(const void* hits, size_t size, FairMQChannel& channel, FairMQParts& parts)
+{
+  std::unique_ptr<FairMQMessage> message(channel.NewMessage(size));
+  if (size) {
+    memcpy(message->GetData(), hits, size);
+  }
+  parts.AddPart(std::move(message));
+}
+void decodeFlatHitsMessage(FairMQParts& dataparts, int index, FlatHitChunk& chunk)
+{
+  std::shared_ptr<FairMQMessage> rawmessage(std::move(dataparts.At(index)));
+  chunk.data = static_cast<const char*>(rawmessage->GetData());
+  chunk.size = rawmessage->GetSize();
+  chunk.owner = std::move(rawmessage);
+}
 void attachShmMessage(void* hits_ptr, FairMQChannel& channel, FairMQParts& parts, bool* busy_ptr)
 {
   struct shmcontext {
@@ -0,0 +1,89 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FlatHits.cxx
+/// \brief Flat transport and files of hits between the simulation workers and the hit merger
+
+#include "DetectorsBase/FlatHits.h"
+#include "CommonUtils/StringUtils.h"
+#include <FairLogger.h>
+#include <stdexcept>
+
+using namespace o2::base;
+
+//___________________________________________________________________
+void FlatHitFileWriter::open(const std::string& name, int detID)
+{
+  close();
+  mFile.open(name, std::ios::binary | std::ios::out | std::ios::trunc);
+  if (!mFile.is_open()) {
+    throw std::runtime_error(o2::utils::Str::concat_string("failed to open flat hit file ", name));
+  }
+  mName = name;
+  FileHeader header;
+  header.detID = detID;
+  mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+//___________________________________________________________________
+void FlatHitFileWriter::write(int event, int probe, const void* hits, size_t hitSize, size_t nHits)
+{
+  BlockHeader header;
+  header.event = event;
+  header.probe = probe;
+  header.hitSize = hitSize;
+  header.nHits = nHits;
+  mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  mFile.write(reinterpret_cast<const char*>(hits), hitSize * nHits);
+  if (!mFile.good()) {
+    throw std::runtime_error(o2::utils::Str::concat_string("failed to write hits to ", mName));
+  }
+}
+
+//___________________________________________________________________
+void FlatHitFileWriter::close()
+{
+  if (!mFile.is_open()) {
+    return;
+  }
+  mFile.close();
+  if (mFile.fail()) {
+    LOG(ERROR) << "Failed to finalize flat hit file " << mName;
+  }
+}
+
+//___________________________________________________________________
+void FlatHitFileReader::open(const std::string& name)
+{
+  mFile.close();
+  mFile.clear();
+  mFile.open(name, std::ios::binary);
+  if (!mFile.is_open() || !mFile.read(reinterpret_cast<char*>(&mHeader), sizeof(mHeader))) {
+    throw std::runtime_error(o2::utils::Str::concat_string("failed to open flat hit file ", name));
+  }
+  if (mHeader.magic != FlatHitFileWriter::Magic || mHeader.version != FlatHitFileWriter::Version) {
+    throw std::runtime_error(o2::utils::Str::concat_string(name, " is not a flat hit file of version ", std::to_string(FlatHitFileWriter::Version)));
+  }
+  mName = name;
+}
+
+//___________________________________________________________________
+bool FlatHitFileReader::next(FlatHitFileWriter::BlockHeader& header, std::vector<char>& hits)
+{
+  if (!mFile.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+    return false;
+  }
+  hits.resize(header.hitSize * header.nHits);
+  if (!mFile.read(hits.data(), hits.size())) {
+    throw std::runtime_error(o2::utils::Str::concat_string("flat hit file ", mName, " is truncated"));
+  }
+  return true;
+}
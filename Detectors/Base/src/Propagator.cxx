@@ -620,6 +620,117 @@ GPUd() void PropagatorImpl<value_T>::getFieldXYZ(const math_utils::Point3D<doubl
   getFieldXYZImpl<double>(xyz, bxyz);
 }
 
+#if !defined(GPUCA_GPUCODE) && !defined(GPUCA_STANDALONE)
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::propagateToX(track::TrackParCovBatch<value_type>& batch, value_type xToGo, value_type bZ, value_type maxSnp,
+                                          value_type maxStep, PropagatorImpl<value_T>::MatCorrType matCorr, int signCorr) const
+{
+  //----------------------------------------------------------------
+  //
+  // Propagates the good tracks of the batch to the plane X=xk (cm)
+  // in the field bZ and correcting for the crossed material, in steps
+  // done for all the tracks at once. Each track follows exactly the
+  // steps of the single track version.
+  // The tracks which have reached xToGo are disabled in the batch until
+  // the end of the propagation, so that the kernels do not touch them.
+  //----------------------------------------------------------------
+  const value_type Epsilon = 0.00001;
+  const size_t n = batch.size();
+  std::vector<value_type> xk(n), x0(n), y0(n), z0(n), x1(n), y1(n), z1(n), x2x0(n), xrho(n);
+  std::vector<int> dir(n), sign(n);
+  std::vector<uint8_t> done(n);
+  std::vector<MatBudget> mb(matCorr != MatCorrType::USEMatCorrNONE ? n : 0);
+
+  for (size_t i = 0; i < n; i++) {
+    dir[i] = xToGo - batch.getX(i) > 0.f ? 1 : -1;
+    sign[i] = signCorr ? signCorr : -dir[i]; // sign of eloss correction is not imposed
+  }
+
+  while (true) {
+    size_t nActive = 0;
+    for (size_t i = 0; i < n; i++) {
+      auto dx = xToGo - batch.getX(i);
+      xk[i] = batch.getX(i);
+      if (!batch.isOK(i) || done[i]) {
+        continue;
+      }
+      if (math_utils::detail::abs<value_type>(dx) <= Epsilon) {
+        done[i] = true;
+        batch.setOK(i, false);
+        continue;
+      }
+      auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
+      xk[i] += dir[i] < 0 ? -step : step;
+      nActive++;
+    }
+    if (!nActive) {
+      break;
+    }
+
+    if (matCorr != MatCorrType::USEMatCorrNONE) {
+      batch.getXYZGlo(x0.data(), y0.data(), z0.data());
+    }
+    batch.propagateTo(xk.data(), bZ);
+    if (maxSnp > 0) {
+      for (size_t i = 0; i < n; i++) {
+        if (batch.isOK(i) && math_utils::detail::abs<value_type>(batch.getParam(track::kSnp, i)) >= maxSnp) {
+          batch.setOK(i, false);
+        }
+      }
+    }
+    if (matCorr != MatCorrType::USEMatCorrNONE) {
+      batch.getXYZGlo(x1.data(), y1.data(), z1.data());
+      getMatBudget(matCorr, n, x0.data(), y0.data(), z0.data(), x1.data(), y1.data(), z1.data(), mb.data());
+      for (size_t i = 0; i < n; i++) {
+        x2x0[i] = mb[i].meanX2X0;
+        xrho[i] = mb[i].getXRho(sign[i]);
+      }
+      batch.correctForMaterial(x2x0.data(), xrho.data());
+    }
+  }
+
+  for (size_t i = 0; i < n; i++) {
+    if (done[i]) {
+      batch.setOK(i);
+      batch.setX(i, xToGo);
+    }
+  }
+  return batch.getNOK();
+}
+
+//____________________________________________________________
+template <typename value_T>
+void PropagatorImpl<value_T>::getMatBudget(PropagatorImpl<value_type>::MatCorrType corrType, size_t n, const value_type* x0, const value_type* y0, const value_type* z0,
+                                           const value_type* x1, const value_type* y1, const value_type* z1, MatBudget* mb) const
+{
+  for (size_t i = 0; i < n; i++) {
+    if (x0[i] == x1[i] && y0[i] == y1[i] && z0[i] == z1[i]) { // no query for the tracks which did not move
+      mb[i] = MatBudget();
+      continue;
+    }
+    mb[i] = getMatBudget(corrType, math_utils::Point3D<value_type>(x0[i], y0[i], z0[i]), math_utils::Point3D<value_type>(x1[i], y1[i], z1[i]));
+  }
+}
+
+//____________________________________________________________
+template <typename value_T>
+void PropagatorImpl<value_T>::getFieldXYZ(size_t n, const value_type* x, const value_type* y, const value_type* z, value_type* bx, value_type* by, value_type* bz) const
+{
+  if (!mGPUField) { // the fast field groups the points by parameterization segment
+    mField->Field(int(n), x, y, z, bx, by, bz);
+    return;
+  }
+  value_type bxyz[3];
+  for (size_t i = 0; i < n; i++) {
+    getFieldXYZ(math_utils::Point3D<value_type>(x[i], y[i], z[i]), bxyz);
+    bx[i] = bxyz[0];
+    by[i] = bxyz[1];
+    bz[i] = bxyz[2];
+  }
+}
+#endif
+
 namespace o2::base
 {
 template class PropagatorImpl<float>;
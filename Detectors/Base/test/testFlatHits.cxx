@@ -0,0 +1,100 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test FlatHits
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include "DetectorsBase/FlatHits.h"
+#include <cstdio>
+
+namespace o2
+{
+namespace base
+{
+
+struct TestHit {
+  int trackID = 0;
+  float energy = 0;
+  int GetTrackID() const { return trackID; }
+  void SetTrackID(int id) { trackID = id; }
+};
+
+FlatHitChunk makeChunk(int entry, std::vector<TestHit> const& hits)
+{
+  auto copy = std::make_shared<std::vector<TestHit>>(hits);
+  FlatHitChunk chunk;
+  chunk.entry = entry;
+  chunk.data = reinterpret_cast<const char*>(copy->data());
+  chunk.size = copy->size() * sizeof(TestHit);
+  chunk.owner = std::move(copy);
+  return chunk;
+}
+
+BOOST_AUTO_TEST_CASE(MergeFlatHitChunks)
+{
+  // two sub-events received in the reverse order: entry 0 is the sub-event 2, entry 1 the sub-event 1
+  std::vector<int> subevtsOrdered{1, 0};
+  std::vector<int> nprimaries{3, 2};
+  std::vector<int> trackoffsets{5, 4};
+
+  auto chunk0 = makeChunk(0, {{1, 1.f}, {4, 2.f}});
+  auto chunk1 = makeChunk(1, {{0, 3.f}, {2, 4.f}});
+  std::vector<TestHit> merged;
+  mergeFlatHitChunks<TestHit>({&chunk1, &chunk0}, merged, trackoffsets, nprimaries, subevtsOrdered);
+
+  // same ordering and track IDs as for the hits merged from the TTree entries
+  BOOST_REQUIRE_EQUAL(merged.size(), 4);
+  std::vector<int> expectedIDs{1, 6, 3, 7};
+  std::vector<float> expectedEnergies{1.f, 2.f, 3.f, 4.f};
+  for (size_t i = 0; i < merged.size(); i++) {
+    BOOST_CHECK_EQUAL(merged[i].GetTrackID(), expectedIDs[i]);
+    BOOST_CHECK_EQUAL(merged[i].energy, expectedEnergies[i]);
+  }
+
+  // sub-events without hits only shift the track IDs
+  mergeFlatHitChunks<TestHit>({&chunk1}, merged, trackoffsets, nprimaries, subevtsOrdered);
+  BOOST_REQUIRE_EQUAL(merged.size(), 2);
+  BOOST_CHECK_EQUAL(merged[0].GetTrackID(), 3);
+  BOOST_CHECK_EQUAL(merged[1].GetTrackID(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(FlatHitFile)
+{
+  const std::string name = "testFlatHits.flathits";
+  std::vector<TestHit> hits{{1, 1.f}, {2, 2.f}, {3, 3.f}};
+  {
+    FlatHitFileWriter writer;
+    writer.open(name, 7);
+    writer.write(0, 0, hits.data(), sizeof(TestHit), hits.size());
+    writer.write(1, 1, hits.data(), sizeof(TestHit), 0);
+  }
+
+  FlatHitFileReader reader;
+  reader.open(name);
+  BOOST_CHECK_EQUAL(reader.getDetID(), 7);
+  FlatHitFileWriter::BlockHeader header;
+  std::vector<char> buffer;
+  BOOST_REQUIRE(reader.next(header, buffer));
+  BOOST_CHECK_EQUAL(header.event, 0);
+  BOOST_CHECK_EQUAL(header.nHits, hits.size());
+  BOOST_CHECK_EQUAL(header.hitSize, sizeof(TestHit));
+  BOOST_CHECK_EQUAL(reinterpret_cast<const TestHit*>(buffer.data())[2].GetTrackID(), 3);
+  BOOST_REQUIRE(reader.next(header, buffer));
+  BOOST_CHECK_EQUAL(header.probe, 1);
+  BOOST_CHECK_EQUAL(header.nHits, 0);
+  BOOST_CHECK(!reader.next(header, buffer));
+  std::remove(name.c_str());
+}
+
+} // namespace base
+} // namespace o2
@@ -0,0 +1,117 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test FlatCTFIO
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
+#include "DetectorsCommonDataFormats/NameConf.h"
+#include "FV0Reconstruction/CTFCoder.h"
+#include "FV0Base/Constants.h"
+#include "Framework/Logger.h"
+#include <TRandom.h>
+#include <TStopwatch.h>
+#include <cstring>
+
+using namespace o2::fv0;
+using DetID = o2::detectors::DetID;
+
+BOOST_AUTO_TEST_CASE(FlatCTFTest)
+{
+  constexpr int NCTF = 3;
+  std::array<std::vector<BCData>, NCTF> digits;
+  std::array<std::vector<ChannelData>, NCTF> channels;
+  std::array<std::vector<o2::ctf::BufferType>, NCTF> vecs;
+  Triggers trigger;
+
+  constexpr int MAXChan = Constants::nChannelsPerPm * Constants::nPms;
+  for (int ictf = 0; ictf < NCTF; ictf++) {
+    o2::InteractionRecord ir(0, ictf * 1000);
+    for (int idig = 0; idig < 500; idig++) {
+      ir += 1 + gRandom->Integer(200);
+      uint8_t ich = gRandom->Poisson(10);
+      auto start = channels[ictf].size();
+      while (ich < MAXChan) {
+        channels[ictf].emplace_back(ich, int16_t(-2048 + gRandom->Integer(2048 * 2)), uint16_t(gRandom->Integer(4096)));
+        ich += 1 + gRandom->Poisson(10);
+      }
+      digits[ictf].emplace_back(start, channels[ictf].size() - start, ir, trigger);
+    }
+    CTFCoder coder;
+    coder.encode(vecs[ictf], digits[ictf], channels[ictf]); // compress
+  }
+
+  // writing, the 2nd CTF has no FV0 data
+  std::string flName = o2::base::NameConf::getCTFFileName(0, 0, 0, "test_ctf", o2::base::NameConf::CTFFLATEXT);
+  TStopwatch sw;
+  {
+    o2::ctf::CTFFlatFileWriter writer;
+    writer.open(flName);
+    for (int ictf = 0; ictf < NCTF; ictf++) {
+      o2::ctf::CTFHeader header{1, uint32_t(ictf * 1000)};
+      if (ictf != 1) {
+        writer.addImage(DetID::FV0, vecs[ictf].data(), vecs[ictf].size() * sizeof(o2::ctf::BufferType));
+        header.detectors.set(DetID::FV0);
+      }
+      writer.endCTF(header);
+    }
+    writer.close();
+  }
+  BOOST_CHECK(o2::ctf::CTFFlatFileReader::isFlatFile(flName));
+
+  // reading and decoding the images in place
+  o2::ctf::CTFFlatFileReader reader;
+  sw.Start();
+  reader.open(flName);
+  BOOST_CHECK(reader.getNCTFs() == NCTF);
+  for (int ictf = 0; ictf < NCTF; ictf++) {
+    auto header = reader.getCTFHeader(ictf);
+    BOOST_CHECK(header.run == 1 && header.firstTForbit == uint32_t(ictf * 1000));
+    auto image = reader.getImage(ictf, DetID::FV0);
+    if (ictf == 1) {
+      BOOST_CHECK(!header.detectors[DetID::FV0] && image.size == 0);
+      continue;
+    }
+    BOOST_CHECK(header.detectors[DetID::FV0]);
+    BOOST_CHECK(image.size == vecs[ictf].size() * sizeof(o2::ctf::BufferType));
+    BOOST_CHECK(reinterpret_cast<uintptr_t>(image.data) % o2::ctf::CTFFlatFile::PageSize == 0);
+    BOOST_CHECK(std::memcmp(image.data, vecs[ictf].data(), image.size) == 0);
+
+    std::vector<BCData> digitsD;
+    std::vector<ChannelData> channelsD;
+    {
+      CTFCoder coder;
+      coder.decode(o2::fv0::CTF::getImage(image.data), digitsD, channelsD); // decompress
+    }
+    BOOST_CHECK(digitsD.size() == digits[ictf].size());
+    BOOST_CHECK(channelsD.size() == channels[ictf].size());
+    for (int i = digits[ictf].size(); i--;) {
+      BOOST_CHECK(digits[ictf][i].ir == digitsD[i].ir);
+      BOOST_CHECK(digits[ictf][i].ref == digitsD[i].ref);
+    }
+    for (int i = channels[ictf].size(); i--;) {
+      BOOST_CHECK(channels[ictf][i].pmtNumber == channelsD[i].pmtNumber);
+      BOOST_CHECK(channels[ictf][i].time == channelsD[i].time);
+      BOOST_CHECK(channels[ictf][i].chargeAdc == channelsD[i].chargeAdc);
+    }
+  }
+  sw.Stop();
+
+  // the images must stay valid after closing the reader while the mapping is referenced
+  auto mapping = reader.getMapping();
+  auto image = reader.getImage(0, DetID::FV0);
+  reader.close();
+  BOOST_CHECK(!reader.isOpen() && mapping);
+  BOOST_CHECK(std::memcmp(image.data, vecs[0].data(), image.size) == 0);
+  mapping.reset();
+  LOG(INFO) << "Read and decoded " << NCTF << " CTFs in place in " << sw.CpuTime() << " s";
+}
@@ -77,6 +77,21 @@ BOOST_AUTO_TEST_CASE(CompressedClustersTest)
   sw.Stop();
   LOG(INFO) << "Compressed in " << sw.CpuTime() << " s";
 
+  // concurrent encoding must produce the same CTF
+  {
+    std::vector<o2::ctf::BufferType> vecMT;
+    CTFCoder coder(o2::detectors::DetID::ITS);
+    coder.setNThreads(4);
+    coder.encode(vecMT, rofRecVec, cclusVec, pattVec);
+    auto ctfS = o2::itsmft::CTF::get(vec.data()), ctfMT = o2::itsmft::CTF::get(vecMT.data());
+    BOOST_CHECK(ctfS->compactify() == ctfMT->compactify());
+    for (int ib = 0; ib < o2::itsmft::CTF::getNBlocks(); ib++) {
+      const auto &blS = ctfS->getBlock(ib), &blMT = ctfMT->getBlock(ib);
+      BOOST_CHECK(blS.getNStored() == blMT.getNStored());
+      BOOST_CHECK(!blS.getNStored() || std::memcmp(blS.payload, blMT.payload, blS.getNStored() * sizeof(uint32_t)) == 0);
+    }
+  }
+
   // writing
   {
     sw.Start();
@@ -114,6 +129,20 @@ BOOST_AUTO_TEST_CASE(CompressedClustersTest)
   sw.Stop();
   LOG(INFO) << "Decompressed in " << sw.CpuTime() << " s";
 
+  {
+    std::vector<ROFRecord> rofRecVecMT;
+    std::vector<CompClusterExt> cclusVecMT;
+    std::vector<unsigned char> pattVecMT;
+    CTFCoder coder(o2::detectors::DetID::ITS);
+    coder.setNThreads(4);
+    coder.decode(ctfImage, rofRecVecMT, cclusVecMT, pattVecMT); // concurrent decompression
+    BOOST_CHECK(cclusVecMT.size() == cclusVecD.size());
+    BOOST_CHECK(pattVecMT == pattVecD);
+    for (size_t i = 0; i < cclusVecD.size(); i++) {
+      BOOST_CHECK(cclusVecMT[i].getChipID() == cclusVecD[i].getChipID() && cclusVecMT[i].getRow() == cclusVecD[i].getRow() && cclusVecMT[i].getCol() == cclusVecD[i].getCol());
+    }
+  }
+
   //
   // check
   BOOST_CHECK(rofRecVecD.size() == rofRecVec.size());
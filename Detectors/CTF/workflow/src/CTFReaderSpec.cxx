@@ -24,6 +24,7 @@
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "DetectorsCommonDataFormats/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "DataFormatsITSMFT/CTF.h"
 #include "DataFormatsTPC/CTF.h"
 #include "DataFormatsTRD/CTF.h"
@@ -74,11 +75,18 @@ class CTFReaderSpec : public o2::framework::Task
 
  private:
   void openCTFFile(const std::string& flname);
+  void closeCTFFile();
+  bool isCTFFileOpen() const { return mCTFTree || mCTFFlatFile.isOpen(); }
+  size_t getNCTFsInFile() const { return mCTFFlatFile.isOpen() ? mCTFFlatFile.getNCTFs() : mCTFTree->GetEntries(); }
+  void setFirstTFOrbit(ProcessingContext& pc, const CTFHeader& ctfHeader, const std::string& label);
+  template <typename C>
+  void processDetector(ProcessingContext& pc, const CTFHeader& ctfHeader, DetID det);
 
   DetID::mask_t mDets;             // detectors
   std::vector<std::string> mInput; // input files
   std::unique_ptr<TFile> mCTFFile;
   std::unique_ptr<TTree> mCTFTree;
+  CTFFlatFileReader mCTFFlatFile; // used instead of the tree for the CTFs in flat format
   uint32_t mCTFCounter = 0;
   size_t mNextToProcess = 0;
   int mCurrEntry = 0;
@@ -106,6 +114,11 @@ void CTFReaderSpec::init(InitContext& ic)
 ///_______________________________________
 void CTFReaderSpec::openCTFFile(const std::string& flname)
 {
+  mCurrEntry = 0;
+  if (CTFFlatFileReader::isFlatFile(flname)) {
+    mCTFFlatFile.open(flname);
+    return;
+  }
   mCTFFile.reset(TFile::Open(flname.c_str()));
   if (!mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
     LOG(ERROR) << "Failed to open file " << flname;
@@ -115,7 +128,49 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
   if (!mCTFTree) {
     throw std::runtime_error("failed to load CTF tree");
   }
-  mCurrEntry = 0;
+}
+
+///_______________________________________
+void CTFReaderSpec::closeCTFFile()
+{
+  if (mCTFFlatFile.isOpen()) {
+    mCTFFlatFile.close(); // the messages still being sent keep the mapping alive
+    return;
+  }
+  mCTFTree.reset();
+  mCTFFile->Close();
+  mCTFFile.reset();
+}
+
+///_______________________________________
+void CTFReaderSpec::setFirstTFOrbit(ProcessingContext& pc, const CTFHeader& ctfHeader, const std::string& label)
+{
+  auto* hd = pc.outputs().findMessageHeader({label});
+  if (!hd) {
+    throw std::runtime_error(o2::utils::Str::concat_string("failed to find output message header for ", label));
+  }
+  hd->firstTForbit = ctfHeader.firstTForbit;
+  hd->tfCounter = mCTFCounter;
+}
+
+///_______________________________________
+template <typename C>
+void CTFReaderSpec::processDetector(ProcessingContext& pc, const CTFHeader& ctfHeader, DetID det)
+{
+  if (!(mDets & ctfHeader.detectors)[det]) {
+    return;
+  }
+  if (mCTFFlatFile.isOpen()) {
+    // send the image in place: the message holds a reference on the file mapping until it is released
+    auto image = mCTFFlatFile.getImage(mCurrEntry, det);
+    auto* mapping = new std::shared_ptr<const char>(mCTFFlatFile.getMapping());
+    auto release = [](void* data, void* hint) { delete static_cast<std::shared_ptr<const char>*>(hint); };
+    pc.outputs().adoptChunk(Output{det.getDataOrigin(), "CTFDATA", 0, Lifetime::Timeframe}, const_cast<char*>(image.data), image.size, release, mapping);
+  } else {
+    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(C));
+    C::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
+  }
+  setFirstTFOrbit(pc, ctfHeader, det.getName());
 }
 
 ///_______________________________________
@@ -131,146 +186,45 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   auto cput = mTimer.CpuTime();
   mTimer.Start(false);
 
-  if (!mCTFTree) { // there is still a tree open with multiple entries
+  if (!isCTFFileOpen()) { // otherwise there is still a file open with multiple entries
     std::string inputFile = o2::utils::Str::concat_string(mCTFDir, mInput[mNextToProcess]);
     LOG(INFO) << "Reading CTF input " << mNextToProcess << ' ' << inputFile;
     openCTFFile(inputFile);
   }
   CTFHeader ctfHeader;
-  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrEntry)) {
+  if (mCTFFlatFile.isOpen()) {
+    ctfHeader = mCTFFlatFile.getCTFHeader(mCurrEntry);
+  } else if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrEntry)) {
     throw std::runtime_error("did not find CTFHeader");
   }
   LOG(INFO) << ctfHeader;
 
-  auto setFirstTFOrbit = [&pc, &ctfHeader, this](const std::string& label) {
-    auto* hd = pc.outputs().findMessageHeader({label});
-    if (!hd) {
-      throw std::runtime_error(o2::utils::Str::concat_string("failed to find output message header for ", label));
-    }
-    hd->firstTForbit = ctfHeader.firstTForbit;
-    hd->tfCounter = this->mCTFCounter;
-  };
-
   // send CTF Header
   pc.outputs().snapshot({"header"}, ctfHeader);
-  setFirstTFOrbit("header");
-
-  DetID::mask_t detsTF = mDets & ctfHeader.detectors;
-  DetID det;
-
-  det = DetID::ITS;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::itsmft::CTF));
-    o2::itsmft::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::MFT;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::itsmft::CTF));
-    o2::itsmft::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::TPC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::tpc::CTF));
-    o2::tpc::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::TRD;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::trd::CTF));
-    o2::trd::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::FT0;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::ft0::CTF));
-    o2::ft0::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::FV0;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::fv0::CTF));
-    o2::fv0::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::FDD;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::fdd::CTF));
-    o2::fdd::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::TOF;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::tof::CTF));
-    o2::tof::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::MID;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::mid::CTF));
-    o2::mid::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::MCH;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::mch::CTF));
-    o2::mch::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::EMC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::emcal::CTF));
-    o2::emcal::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::PHS;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::phos::CTF));
-    o2::phos::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::CPV;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::cpv::CTF));
-    o2::cpv::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::ZDC;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::zdc::CTF));
-    o2::zdc::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
-
-  det = DetID::HMP;
-  if (detsTF[det]) {
-    auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({det.getName()}, sizeof(o2::hmpid::CTF));
-    o2::hmpid::CTF::readFromTree(bufVec, *(mCTFTree.get()), det.getName(), mCurrEntry);
-    setFirstTFOrbit(det.getName());
-  }
+  setFirstTFOrbit(pc, ctfHeader, "header");
+
+  processDetector<o2::itsmft::CTF>(pc, ctfHeader, DetID::ITS);
+  processDetector<o2::itsmft::CTF>(pc, ctfHeader, DetID::MFT);
+  processDetector<o2::tpc::CTF>(pc, ctfHeader, DetID::TPC);
+  processDetector<o2::trd::CTF>(pc, ctfHeader, DetID::TRD);
+  processDetector<o2::ft0::CTF>(pc, ctfHeader, DetID::FT0);
+  processDetector<o2::fv0::CTF>(pc, ctfHeader, DetID::FV0);
+  processDetector<o2::fdd::CTF>(pc, ctfHeader, DetID::FDD);
+  processDetector<o2::tof::CTF>(pc, ctfHeader, DetID::TOF);
+  processDetector<o2::mid::CTF>(pc, ctfHeader, DetID::MID);
+  processDetector<o2::mch::CTF>(pc, ctfHeader, DetID::MCH);
+  processDetector<o2::emcal::CTF>(pc, ctfHeader, DetID::EMC);
+  processDetector<o2::phos::CTF>(pc, ctfHeader, DetID::PHS);
+  processDetector<o2::cpv::CTF>(pc, ctfHeader, DetID::CPV);
+  processDetector<o2::zdc::CTF>(pc, ctfHeader, DetID::ZDC);
+  processDetector<o2::hmpid::CTF>(pc, ctfHeader, DetID::HMP);
 
   mTimer.Stop();
-  LOGP(INFO, "Read CTF#{} ({} of {} in {}) in {:.3f} s", mCTFCounter, mCurrEntry, mCTFTree->GetEntries(), mCTFFile->GetName(), mTimer.CpuTime() - cput);
+  LOGP(INFO, "Read CTF#{} ({} of {} in {}) in {:.3f} s", mCTFCounter, mCurrEntry, getNCTFsInFile(), mCTFFlatFile.isOpen() ? mCTFFlatFile.getName() : mCTFFile->GetName(), mTimer.CpuTime() - cput);
 
-  bool moreToProcess = (++mCurrEntry < mCTFTree->GetEntries());
+  bool moreToProcess = (++mCurrEntry < int(getNCTFsInFile()));
   if (!moreToProcess) { // this file is done, check if there are other files
-    mCTFTree.reset();
-    mCTFFile->Close();
-    mCTFFile.reset();
+    closeCTFFile();
     moreToProcess = true;
     if (++mNextToProcess >= mInput.size()) {
       if (++mLoopsCounter >= mLoops) {
@@ -18,6 +18,7 @@
 #include "CTFWorkflow/CTFWriterSpec.h"
 
 #include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/CTFFlatFile.h"
 #include "DetectorsCommonDataFormats/NameConf.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "CommonUtils/StringUtils.h"
@@ -102,6 +103,7 @@ class CTFWriterSpec : public o2::framework::Task
   bool mWriteCTF = false;
   bool mCreateDict = false;
   bool mDictPerDetector = false;
+  bool mFlatFormat = false; // write CTFs in the flat memory-mappable format instead of the TTree
   int mSaveDictAfter = -1; // if positive and mWriteCTF==true, save dictionary after each mSaveDictAfter TFs processed
   uint64_t mRun = 0;
   size_t mMinSize = 0;     // if > 0, accumulate CTFs in the same tree until the total size exceeds this minimum
@@ -117,6 +119,7 @@ class CTFWriterSpec : public o2::framework::Task
 
   std::unique_ptr<TFile> mCTFFileOut;
   std::unique_ptr<TTree> mCTFTreeOut;
+  CTFFlatFileWriter mCTFFlatFileOut;
 
   std::unique_ptr<TFile> mDictFileOut; // file to store dictionary
   std::unique_ptr<TTree> mDictTreeOut; // tree to store dictionary
@@ -145,7 +148,11 @@ size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det
   const auto ctfImage = C::getImage(ctfBuffer.data());
   ctfImage.print(o2::utils::Str::concat_string(det.getName(), ": "));
   if (mWriteCTF) {
-    sz += ctfImage.appendToTree(*tree, det.getName());
+    if (mFlatFormat) { // store flat image as it is
+      sz += mCTFFlatFileOut.addImage(det, ctfBuffer.data(), ctfBuffer.size_bytes());
+    } else {
+      sz += ctfImage.appendToTree(*tree, det.getName());
+    }
     header.detectors.set(det);
   }
   if (mCreateDict) {
@@ -225,6 +232,11 @@ void CTFWriterSpec::init(InitContext& ic)
   mSaveDictAfter = ic.options().get<int>("save-dict-after");
   mDictDir = o2::utils::Str::rectifyDirectory(ic.options().get<std::string>("ctf-dict-dir"));
   mCTFDir = o2::utils::Str::rectifyDirectory(ic.options().get<std::string>("output-dir"));
+  auto format = ic.options().get<std::string>("ctf-format");
+  if (format != "root" && format != "flat") {
+    throw std::runtime_error(o2::utils::Str::concat_string("unknown CTF format ", format, ", use root or flat"));
+  }
+  mFlatFormat = format == "flat";
   if (mWriteCTF) {
     if (mMinSize > 0) {
       LOG(INFO) << "Multiple CTFs will be accumulated in the tree/file until its size exceeds " << mMinSize << " bytes";
@@ -283,10 +295,15 @@ void CTFWriterSpec::run(ProcessingContext& pc)
   mTimer.Stop();
 
   if (mWriteCTF) {
-    szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
+    if (mFlatFormat) {
+      szCTF += mCTFFlatFileOut.endCTF(header);
+      ++mNAccCTF;
+    } else {
+      szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
+      mCTFTreeOut->SetEntries(++mNAccCTF);
+    }
     mAccCTFSize += szCTF;
-    mCTFTreeOut->SetEntries(++mNAccCTF);
-    LOG(INFO) << "TF#" << mNCTF << ": wrote CTF{" << header << "} of size " << szCTF << " to " << mCTFFileOut->GetName() << " in " << mTimer.CpuTime() - cput << " s";
+    LOG(INFO) << "TF#" << mNCTF << ": wrote CTF{" << header << "} of size " << szCTF << " to " << (mFlatFormat ? mCTFFlatFileOut.getName() : mCTFFileOut->GetName()) << " in " << mTimer.CpuTime() - cput << " s";
     if (mNAccCTF > 1) {
       LOG(INFO) << "Current CTF tree has " << mNAccCTF << " entries with total size of " << mAccCTFSize << " bytes";
     }
@@ -325,7 +342,7 @@ void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
     return;
   }
   bool needToOpen = false;
-  if (!mCTFTreeOut) {
+  if (!mCTFTreeOut && !mCTFFlatFileOut.isOpen()) {
     needToOpen = true;
   } else {
     if ((mAccCTFSize >= mMinSize) ||                                                         // min size exceeded, may close the file
@@ -337,8 +354,12 @@ void CTFWriterSpec::prepareTFTreeAndFile(const o2::header::DataHeader* dh)
   }
   if (needToOpen) {
     closeTFTreeAndFile();
-    mCTFFileOut.reset(TFile::Open(o2::utils::Str::concat_string(mCTFDir, o2::base::NameConf::getCTFFileName(dh->runNumber, dh->firstTForbit, dh->tfCounter)).c_str(), "recreate"));
-    mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    if (mFlatFormat) {
+      mCTFFlatFileOut.open(o2::utils::Str::concat_string(mCTFDir, o2::base::NameConf::getCTFFileName(dh->runNumber, dh->firstTForbit, dh->tfCounter, "o2_ctf", o2::base::NameConf::CTFFLATEXT)));
+    } else {
+      mCTFFileOut.reset(TFile::Open(o2::utils::Str::concat_string(mCTFDir, o2::base::NameConf::getCTFFileName(dh->runNumber, dh->firstTForbit, dh->tfCounter)).c_str(), "recreate"));
+      mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
+    }
     mNCTFFiles++;
   }
 }
@@ -353,6 +374,10 @@ void CTFWriterSpec::closeTFTreeAndFile()
     mCTFFileOut.reset();
     mNAccCTF = 0;
   }
+  if (mCTFFlatFileOut.isOpen()) {
+    mCTFFlatFileOut.close();
+    mNAccCTF = 0;
+  }
   mAccCTFSize = 0;
 }
 
@@ -443,7 +468,8 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, uint64_t run, bool doCTF,
     AlgorithmSpec{adaptFromTask<CTFWriterSpec>(dets, run, doCTF, doDict, dictPerDet, szmn, szmx)},
     Options{{"save-dict-after", VariantType::Int, -1, {"In dictionary generation mode save it dictionary after certain number of TFs processed"}},
             {"ctf-dict-dir", VariantType::String, "none", {"CTF dictionary directory"}},
-            {"output-dir", VariantType::String, "none", {"CTF output directory"}}}};
+            {"output-dir", VariantType::String, "none", {"CTF output directory"}},
+            {"ctf-format", VariantType::String, "root", {"CTF file format: root (TTree) or flat (page-aligned images to be memory-mapped at reading)"}}}};
 }
 
 } // namespace ctf
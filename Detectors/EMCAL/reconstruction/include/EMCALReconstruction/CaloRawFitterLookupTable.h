@@ -0,0 +1,99 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef __CALORAWFITTERLOOKUPTABLE_H__
+#define __CALORAWFITTERLOOKUPTABLE_H__
+
+#include <array>
+#include <optional>
+#include <tuple>
+#include <Rtypes.h>
+#include "EMCALReconstruction/CaloFitResults.h"
+#include "DataFormatsEMCAL/Constants.h"
+#include "EMCALReconstruction/Bunch.h"
+#include "EMCALReconstruction/CaloRawFitter.h"
+
+namespace o2
+{
+
+namespace emcal
+{
+
+/// \class CaloRawFitterLookupTable
+/// \brief  Raw data fitting: Gamma-2 function sampled from a lookup table
+/// \ingroup EMCALreconstruction
+///
+/// Least-squares fit of the same gamma-2 response as the standard and Gamma2 fitters,
+/// without MINUIT and without any allocation per channel. The response is tabulated once
+/// in the constructor for NPHASES sub-sample phases of the peak time. For a given peak
+/// time the amplitude minimizing the chi2 is known analytically, so the fit reduces to a
+/// scan of the peak time over the table (coarse, then fine), followed by a parabolic
+/// interpolation between the best phases. The sums over the time samples run over
+/// contiguous arrays and are vectorized by the compiler.
+///
+/// Precision: only the time is interpolated between the phases. The amplitude and the
+/// chi2 are those of the best tabulated phase, at most 1/(2 NPHASES) time bin away from
+/// the fitted time. As the amplitude is taken at the maximum of the figure of merit, this
+/// biases it by less than 5e-4 relative, and the time by less than 0.1 ns, for noiseless
+/// pulses fitted on 3 or more samples around the peak.
+class CaloRawFitterLookupTable final : public CaloRawFitter
+{
+
+ public:
+  static constexpr int NPHASES = 64;                                    ///< Number of tabulated phases per time bin
+  static constexpr int COARSESTEP = 8;                                  ///< Step of the coarse scan, in phases
+  static constexpr int SCANRANGE = 2;                                   ///< Half range of the scan around the time estimate, in time bins
+  static constexpr int TABLEOFFSET = constants::EMCAL_MAXTIMEBINS + 2;  ///< Offset of the table bin for a sample at the peak time
+  static constexpr int NTABLEBINS = 2 * TABLEOFFSET + 1;                ///< Number of table bins per phase
+
+  /// \brief Constructor, fills the lookup table
+  CaloRawFitterLookupTable();
+
+  /// \brief Destructor
+  ~CaloRawFitterLookupTable() final = default;
+
+  /// \brief Evaluation Amplitude and TOF
+  /// \param bunchvector ALTRO bunches for the current channel
+  /// \param altrocfg1 ALTRO config register 1 from RCU trailer
+  /// \param altrocfg2 ALTRO config register 2 from RCU trailer
+  /// \throw RawFitterError_t::FIT_ERROR in case the peak fit failed
+  /// \return Container with the fit results (amp, time, chi2, ...)
+  CaloFitResults evaluate(const gsl::span<const Bunch> bunchvector,
+                          std::optional<unsigned int> altrocfg1,
+                          std::optional<unsigned int> altrocfg2) final;
+
+  /// \brief Fits the raw signal time distribution
+  /// \param firstTimeBin First timebin used in the fit
+  /// \param lastTimeBin Last timebin used in the fit
+  /// \param timeEstimate Initial guess of the peak time (in time bins)
+  /// \return the fit parameters: amplitude, time, chi2
+  /// \throw RawFitterError_t::FIT_ERROR in case of fit errors (insufficient number of time samples, no positive solution, minimum at the edge of the scan range)
+  std::tuple<float, float, float> fitRaw(int firstTimeBin, int lastTimeBin, float timeEstimate);
+
+ private:
+  /// \brief Figure of merit of the fit for a peak time (in units of 1/NPHASES time bin)
+  /// \return (sum y*g)^2 / sum g^2, to be maximized, or a negative value if the best amplitude is not positive
+  float evaluatePhase(int firstTimeBin, int lastTimeBin, int peakTime) const;
+
+  /// \brief Get the tabulated response for the time samples, for a peak time in units of 1/NPHASES time bin
+  /// \return Pointer to the response such that element i is the response for time bin i
+  const float* getShape(int peakTime) const;
+
+  std::array<float, NPHASES * NTABLEBINS> mShapeTable;     //!<! Tabulated response, phase-major
+  std::array<float, constants::EMCAL_MAXTIMEBINS> mSamples; //!<! Pedestal subtracted samples used in the fit
+
+  ClassDefNV(CaloRawFitterLookupTable, 1);
+}; // End of CaloRawFitterLookupTable
+
+} // namespace emcal
+
+} // namespace o2
+#endif
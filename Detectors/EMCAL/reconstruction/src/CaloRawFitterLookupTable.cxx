@@ -0,0 +1,187 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file CaloRawFitterLookupTable.cxx
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "EMCALReconstruction/Bunch.h"
+#include "EMCALReconstruction/CaloFitResults.h"
+#include "DataFormatsEMCAL/Constants.h"
+
+#include "EMCALReconstruction/CaloRawFitterLookupTable.h"
+
+using namespace o2::emcal;
+
+CaloRawFitterLookupTable::CaloRawFitterLookupTable() : CaloRawFitter("Chi Square ( Lookup table )", "LookupTable")
+{
+  mAlgo = FitAlgorithm::LookupTable;
+  mSamples.fill(0.);
+
+  // same response as CaloRawFitterStandard::rawResponseFunction, without pedestal:
+  // entry j of phase p is the response at a time j - TABLEOFFSET - p / NPHASES from the peak
+  for (int phase = 0; phase < NPHASES; phase++) {
+    for (int bin = 0; bin < NTABLEBINS; bin++) {
+      double dt = bin - TABLEOFFSET - double(phase) / NPHASES;
+      double xx = (dt + constants::TAU) / constants::TAU;
+      mShapeTable[phase * NTABLEBINS + bin] = (xx <= 0) ? 0. : std::pow(xx, constants::ORDER) * std::exp(constants::ORDER * (1 - xx));
+    }
+  }
+}
+
+CaloFitResults CaloRawFitterLookupTable::evaluate(const gsl::span<const Bunch> bunchlist,
+                                                  std::optional<unsigned int> altrocfg1, std::optional<unsigned int> altrocfg2)
+{
+  float time = 0;
+  float amp = 0;
+  float chi2 = 0;
+  int ndf = 0;
+  bool fitDone = false;
+
+  auto [nsamples, bunchIndex, ampEstimate,
+        maxADC, timeEstimate, pedEstimate, first, last] = preFitEvaluateSamples(bunchlist, altrocfg1, altrocfg2, mAmpCut);
+
+  if (bunchIndex >= 0 && ampEstimate >= mAmpCut) {
+    time = timeEstimate;
+    int timebinOffset = bunchlist[bunchIndex].getStartTime() - (bunchlist[bunchIndex].getBunchLength() - 1);
+    amp = ampEstimate;
+
+    if (nsamples > 2 && maxADC < constants::OVERFLOWCUT) {
+      try {
+        std::tie(amp, time, chi2) = fitRaw(first, last, timeEstimate);
+        fitDone = true;
+      } catch (RawFitterError_t& e) {
+        // Fit has failed, set values to estimates
+        amp = ampEstimate;
+        time = timeEstimate;
+        chi2 = 1.e9;
+      }
+
+      time += timebinOffset;
+      timeEstimate += timebinOffset;
+      ndf = nsamples - 2;
+    }
+  }
+
+  if (fitDone) {
+    float ampAsymm = (amp - ampEstimate) / (amp + ampEstimate);
+    float timeDiff = time - timeEstimate;
+
+    if ((std::abs(ampAsymm) > 0.1) || (std::abs(timeDiff) > 2)) {
+      amp = ampEstimate;
+      time = timeEstimate;
+      fitDone = false;
+    }
+  }
+  if (amp >= mAmpCut) {
+    if (!fitDone) {
+      std::default_random_engine generator;
+      std::uniform_real_distribution<float> distribution(0.0, 1.0);
+      amp += (0.5 - distribution(generator));
+    }
+    time = time * constants::EMCAL_TIMESAMPLE;
+    time -= mL1Phase;
+
+    return CaloFitResults(maxADC, pedEstimate, mAlgo, amp, time, (int)time, chi2, ndf);
+  }
+  // Fit failed, rethrow error
+  throw RawFitterError_t::FIT_ERROR;
+}
+
+std::tuple<float, float, float> CaloRawFitterLookupTable::fitRaw(int firstTimeBin, int lastTimeBin, float timeEstimate)
+{
+  if (lastTimeBin - firstTimeBin + 1 < 3) {
+    throw RawFitterError_t::FIT_ERROR;
+  }
+  for (int i = firstTimeBin; i <= lastTimeBin; i++) {
+    mSamples[i] = getReversed(i);
+  }
+
+  // peak times are scanned in units of 1/NPHASES time bin, within the range covered by the table
+  int center = std::lround(timeEstimate * NPHASES);
+  int minTime = std::max(center - SCANRANGE * NPHASES, (1 - SCANRANGE) * NPHASES);
+  int maxTime = std::min(center + SCANRANGE * NPHASES, (constants::EMCAL_MAXTIMEBINS + SCANRANGE - 1) * NPHASES);
+
+  // coarse scan, then fine scan around the best coarse point
+  int bestTime = minTime;
+  float bestMerit = -1.;
+  for (int peakTime = minTime; peakTime <= maxTime; peakTime += COARSESTEP) {
+    float merit = evaluatePhase(firstTimeBin, lastTimeBin, peakTime);
+    if (merit > bestMerit) {
+      bestMerit = merit;
+      bestTime = peakTime;
+    }
+  }
+  if (bestMerit <= 0.) {
+    throw RawFitterError_t::FIT_ERROR;
+  }
+  int coarseTime = bestTime;
+  for (int peakTime = std::max(coarseTime - COARSESTEP + 1, minTime); peakTime <= std::min(coarseTime + COARSESTEP - 1, maxTime); peakTime++) {
+    float merit = evaluatePhase(firstTimeBin, lastTimeBin, peakTime);
+    if (merit > bestMerit) {
+      bestMerit = merit;
+      bestTime = peakTime;
+    }
+  }
+  if (bestTime <= minTime || bestTime >= maxTime) {
+    // minimum not bracketed by the scan
+    throw RawFitterError_t::FIT_ERROR;
+  }
+
+  // parabolic interpolation between the neighbouring phases
+  float time = bestTime;
+  float meritBefore = evaluatePhase(firstTimeBin, lastTimeBin, bestTime - 1);
+  float meritAfter = evaluatePhase(firstTimeBin, lastTimeBin, bestTime + 1);
+  float curvature = meritBefore - 2. * bestMerit + meritAfter;
+  if (meritBefore > 0. && meritAfter > 0. && curvature < 0.) {
+    time += 0.5 * (meritBefore - meritAfter) / curvature;
+  }
+
+  // best amplitude and chi2 at the best tabulated phase
+  const float* shape = getShape(bestTime);
+  float syg(0.), sgg(0.);
+  for (int i = firstTimeBin; i <= lastTimeBin; i++) {
+    syg += mSamples[i] * shape[i];
+    sgg += shape[i] * shape[i];
+  }
+  float amp = syg / sgg;
+  float chi2(0.);
+  for (int i = firstTimeBin; i <= lastTimeBin; i++) {
+    float delta = mSamples[i] - amp * shape[i];
+    chi2 += delta * delta;
+  }
+
+  return std::make_tuple(amp, time / NPHASES, chi2);
+}
+
+float CaloRawFitterLookupTable::evaluatePhase(int firstTimeBin, int lastTimeBin, int peakTime) const
+{
+  const float* shape = getShape(peakTime);
+  float syg(0.), sgg(0.);
+  for (int i = firstTimeBin; i <= lastTimeBin; i++) {
+    syg += mSamples[i] * shape[i];
+    sgg += shape[i] * shape[i];
+  }
+  if (syg <= 0. || sgg <= 0.) {
+    return -1.;
+  }
+  return syg * syg / sgg;
+}
+
+const float* CaloRawFitterLookupTable::getShape(int peakTime) const
+{
+  // split the peak time into an integer time bin (rounded down) and a phase
+  int timeBin = (peakTime >= 0) ? peakTime / NPHASES : -((NPHASES - 1 - peakTime) / NPHASES);
+  int phase = peakTime - timeBin * NPHASES;
+  return mShapeTable.data() + phase * NTABLEBINS + TABLEOFFSET - timeBin;
+}
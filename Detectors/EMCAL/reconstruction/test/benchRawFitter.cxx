@@ -0,0 +1,137 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchRawFitter.cxx
+/// \brief Benchmark of the EMCAL raw fitters on recorded raw pages
+///
+/// usage: o2-bench-emcal-rawfitter [benchmark options] emcal.raw
+/// All the pages of the raw file are decoded once, as done in the raw to cell converter, and the
+/// bunches of every channel are kept in memory. Each iteration then fits all the channels with the
+/// standard, gamma2 or lookup table raw fitter.
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "DetectorsRaw/RawFileReader.h"
+#include "DetectorsRaw/RDHUtils.h"
+#include "EMCALReconstruction/AltroDecoder.h"
+#include "EMCALReconstruction/Bunch.h"
+#include "EMCALReconstruction/CaloFitResults.h"
+#include "EMCALReconstruction/CaloRawFitterGamma2.h"
+#include "EMCALReconstruction/CaloRawFitterLookupTable.h"
+#include "EMCALReconstruction/CaloRawFitterStandard.h"
+#include "EMCALReconstruction/RawReaderMemory.h"
+
+using namespace o2::emcal;
+
+namespace
+{
+std::vector<std::vector<Bunch>> gChannels{};
+
+void readChannels(const std::string& fileName)
+{
+  /// decode all the pages of all the timeframes and store the bunches of each channel
+  o2::raw::RawFileReader reader;
+  reader.setDefaultDataOrigin(o2::header::gDataOriginEMC);
+  reader.setDefaultDataDescription(o2::header::gDataDescriptionRawData);
+  reader.setDefaultReadoutCardType(o2::raw::RawFileReader::RORC);
+  reader.addFile(fileName);
+  reader.init();
+
+  std::vector<char> dataBuffer{};
+  for (int tfID = reader.getNextTFToRead(); tfID < reader.getNTimeFrames(); reader.setNextTFToRead(++tfID)) {
+    for (int il = 0; il < reader.getNLinks(); il++) {
+      auto& link = reader.getLink(il);
+      dataBuffer.resize(link.getNextTFSize());
+      link.readNextTF(dataBuffer.data());
+
+      RawReaderMemory parser(dataBuffer);
+      while (parser.hasNext()) {
+        parser.next();
+        if (o2::raw::RDHUtils::getFEEID(parser.getRawHeader()) >= 40) {
+          continue;
+        }
+        AltroDecoder decoder(parser);
+        try {
+          decoder.decode();
+        } catch (AltroDecoderError& e) {
+          continue;
+        }
+        for (const auto& chan : decoder.getChannels()) {
+          gChannels.emplace_back(chan.getBunches());
+        }
+      }
+    }
+  }
+}
+
+template <typename Fitter>
+void fitChannels(benchmark::State& state)
+{
+  Fitter fitter;
+  fitter.setAmpCut(3);
+  fitter.setL1Phase(0.);
+  fitter.setIsZeroSuppressed(true);
+
+  size_t nFitted = 0;
+  for (auto _ : state) {
+    nFitted = 0;
+    float sumAmp = 0.;
+    for (const auto& bunches : gChannels) {
+      try {
+        auto fitResults = fitter.evaluate(bunches, 0, 0);
+        sumAmp += fitResults.getAmp();
+        ++nFitted;
+      } catch (CaloRawFitter::RawFitterError_t& fiterror) {
+      }
+    }
+    benchmark::DoNotOptimize(sumAmp);
+  }
+
+  state.SetItemsProcessed(state.iterations() * gChannels.size());
+  state.counters["fitted"] = nFitted;
+}
+} // namespace
+
+static void BM_RawFitterStandard(benchmark::State& state)
+{
+  fitChannels<CaloRawFitterStandard>(state);
+}
+
+static void BM_RawFitterGamma2(benchmark::State& state)
+{
+  fitChannels<CaloRawFitterGamma2>(state);
+}
+
+static void BM_RawFitterLookupTable(benchmark::State& state)
+{
+  fitChannels<CaloRawFitterLookupTable>(state);
+}
+
+BENCHMARK(BM_RawFitterStandard)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RawFitterGamma2)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_RawFitterLookupTable)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " [benchmark options] emcal.raw" << std::endl;
+    return 1;
+  }
+  readChannels(argv[1]);
+  std::cout << gChannels.size() << " channels" << std::endl;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
@@ -0,0 +1,85 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testRawFitterLookupTable.cxx
+/// \brief Test of the lookup table raw fitter against the standard raw fitter on synthetic pulses
+
+#define BOOST_TEST_MODULE Test EMCAL RawFitterLookupTable
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "DataFormatsEMCAL/Constants.h"
+#include "EMCALReconstruction/Bunch.h"
+#include "EMCALReconstruction/CaloFitResults.h"
+#include "EMCALReconstruction/CaloRawFitterLookupTable.h"
+#include "EMCALReconstruction/CaloRawFitterStandard.h"
+
+namespace o2
+{
+namespace emcal
+{
+
+/// Zero suppressed gamma-2 pulse of amplitude amp peaking at time peakTime (in time bins),
+/// as a single bunch covering all time bins
+Bunch makePulse(double amp, double peakTime)
+{
+  Bunch bunch(constants::EMCAL_MAXTIMEBINS, constants::EMCAL_MAXTIMEBINS - 1);
+  // the ADC values are stored starting from the last time bin
+  for (int timeBin = constants::EMCAL_MAXTIMEBINS - 1; timeBin >= 0; timeBin--) {
+    double xx = (timeBin - peakTime + constants::TAU) / constants::TAU;
+    double signal = (xx <= 0) ? 0. : amp * std::pow(xx, constants::ORDER) * std::exp(constants::ORDER * (1 - xx));
+    bunch.addADC(static_cast<uint16_t>(std::lround(signal)));
+  }
+  return bunch;
+}
+
+template <typename Fitter>
+void configure(Fitter& fitter)
+{
+  fitter.setAmpCut(3);
+  fitter.setL1Phase(0.);
+  fitter.setIsZeroSuppressed(true);
+}
+
+BOOST_AUTO_TEST_CASE(RawFitterLookupTable_test)
+{
+  CaloRawFitterLookupTable fitterLookupTable;
+  CaloRawFitterStandard fitterStandard;
+  configure(fitterLookupTable);
+  configure(fitterStandard);
+
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> ampDistribution(50., 900.);
+  std::uniform_real_distribution<double> timeDistribution(3., 9.);
+
+  for (int iPulse = 0; iPulse < 200; iPulse++) {
+    double amp = ampDistribution(generator);
+    double peakTime = timeDistribution(generator);
+    std::vector<Bunch> bunches{makePulse(amp, peakTime)};
+
+    auto resultLookupTable = fitterLookupTable.evaluate(bunches, 0, 0);
+    auto resultStandard = fitterStandard.evaluate(bunches, 0, 0);
+
+    // the samples are rounded to integer ADC counts, both fits see the same samples
+    BOOST_CHECK_CLOSE(resultLookupTable.getAmp(), resultStandard.getAmp(), 0.5);
+    BOOST_CHECK_SMALL(resultLookupTable.getTime() - resultStandard.getTime(), 1.);
+    BOOST_CHECK_CLOSE(resultLookupTable.getAmp(), amp, 2.);
+    BOOST_CHECK_SMALL(resultLookupTable.getTime() - peakTime * constants::EMCAL_TIMESAMPLE, 2.);
+  }
+}
+
+} // namespace emcal
+} // namespace o2
@@ -389,6 +389,9 @@ class MatchTPCITS
   void setUseMatCorrFlag(MatCorrType f) { mUseMatCorrFlag = f; }
   auto getUseMatCorrFlag() const { return mUseMatCorrFlag; }
 
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
   //<<< ====================== options =============================<<<
 
 #ifdef _ALLOW_DEBUG_TREES_
@@ -445,7 +448,7 @@ class MatchTPCITS
   void doMatching(int sec);
 
   void refitWinners();
-  bool refitTrackTPCITS(int iTPC, int& iITS);
+  bool refitTrackTPCITS(int iTPC, o2::dataformats::TrackTPCITS& trfit) const;
   bool refitTPCInward(o2::track::TrackParCov& trcIn, float& chi2, float xTgt, int trcID, float timeTB) const;
 
   void selectBestMatches();
@@ -474,7 +477,7 @@ class MatchTPCITS
   int getNMatchRecordsITS(const TrackLocITS& tITS) const;
 
   ///< convert time bracket to IR bracket
-  BracketIR tBracket2IRBracket(const BracketF tbrange);
+  BracketIR tBracket2IRBracket(const BracketF tbrange) const;
 
   ///< convert time bin to ITS ROFrame units
   int time2ITSROFrame(float t) const
@@ -524,6 +527,7 @@ class MatchTPCITS
   const o2::ft0::InteractionTag* mFT0Params = nullptr;
 
   MatCorrType mUseMatCorrFlag = MatCorrType::USEMatCorrTGeo;
+  int mNThreads = 1; ///< number of threads used for the sectors matching and winners refit
 
   bool mSkipTPCOnly = false;  ///< for test only: don't use TPC only tracks, use only external ones
   bool mITSTriggered = false; ///< ITS readout is triggered
@@ -598,6 +602,16 @@ class MatchTPCITS
   ///< container for reference to MatchRecord involving particular ITS track
   std::vector<MatchRecord> mMatchRecordsITS;
 
+  ///< matching candidate found in the sector, to be registered in the match records
+  struct MatchCandidate {
+    int iITS = MinusOne;
+    int iTPC = MinusOne;
+    float chi2 = -1.f;
+    int matchedIC = MinusOne;
+  };
+  ///< per sector matching candidates, in the order they were found
+  std::array<std::vector<MatchCandidate>, o2::constants::math::NSectors> mMatchCandidates;
+
   ////  std::vector<int> mITSROFofTPCBin;    ///< aux structure for mapping of TPC time-bins on ITS ROFs
   std::vector<BracketF> mITSROFTimes;  ///< min/max times of ITS ROFs in \mus
   std::vector<TrackLocTPC> mTPCWork;   ///< TPC track params prepared for matching
@@ -269,8 +269,22 @@ void MatchTPCITS::run(const o2::globaltracking::RecoContainer& inp)
   }
 
   mTimer[SWDoMatching].Start(false);
+  // sectors are checked concurrently, the candidates are then registered in the match records in the
+  // fixed order of the sectors, so that the result does not depend on the number of threads
+  bool parallelMatching = mNThreads > 1;
+#ifdef _ALLOW_DEBUG_TREES_
+  parallelMatching &= !mDBGOut; // debug trees are filled during the matching
+#endif
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic) if (parallelMatching)
+#endif
+  for (int is = 0; is < o2::constants::math::NSectors; is++) {
+    doMatching(o2::constants::math::NSectors - 1 - is);
+  }
   for (int sec = o2::constants::math::NSectors; sec--;) {
-    doMatching(sec);
+    for (const auto& cand : mMatchCandidates[sec]) {
+      registerMatchRecordTPC(cand.iITS, cand.iTPC, cand.chi2, cand.matchedIC);
+    }
   }
   mTimer[SWDoMatching].Stop();
   if (0) { // enabling this creates very verbose output
@@ -865,7 +879,9 @@ bool MatchTPCITS::prepareFITData()
 //_____________________________________________________
 void MatchTPCITS::doMatching(int sec)
 {
-  ///< run matching for currently cached ITS data for given TPC sector
+  ///< run matching for currently cached ITS data for given TPC sector, storing the found candidates in mMatchCandidates[sec]
+  auto& candidates = mMatchCandidates[sec];
+  candidates.clear();
   auto& cacheITS = mITSSectIndexCache[sec];   // array of cached ITS track indices for this sector
   auto& cacheTPC = mTPCSectIndexCache[sec];   // array of cached ITS track indices for this sector
   auto& timeStartTPC = mTPCTimeStart[sec];    // array of 1st TPC track with timeMax in ITS ROFrame
@@ -989,7 +1005,7 @@ void MatchTPCITS::doMatching(int sec)
           continue;
         }
       }
-      registerMatchRecordTPC(cacheITS[iits], cacheTPC[itpc], chi2, matchedIC); // register matching candidate
+      candidates.push_back({cacheITS[iits], cacheTPC[itpc], chi2, matchedIC}); // store matching candidate
       nMatchesControl++;
     }
   }
@@ -1380,18 +1396,49 @@ void MatchTPCITS::refitWinners()
   mTimer[SWRefit].Start(false);
   LOG(INFO) << "Refitting winner matches";
   mWinnerChi2Refit.resize(mITSWork.size(), -1.f);
-  int iITS;
+  std::vector<int> winners;
   for (int iTPC = 0; iTPC < (int)mTPCWork.size(); iTPC++) {
-    if (!refitTrackTPCITS(iTPC, iITS)) {
+    if (!isDisabledTPC(mTPCWork[iTPC])) {
+      winners.push_back(iTPC);
+    }
+  }
+  int nWinners = winners.size();
+  std::vector<o2::dataformats::TrackTPCITS> refitted(nWinners);
+  std::vector<char> refitOK(nWinners, 0);
+  // winners are refitted concurrently only if the material LUT is used: the TGeo-based material budget is not reentrant
+  bool parallelRefit = mNThreads > 1 && mUseMatCorrFlag != MatCorrType::USEMatCorrTGeo && o2::base::Propagator::Instance()->getMatLUT();
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic, 16) if (parallelRefit)
+#endif
+  for (int iw = 0; iw < nWinners; iw++) {
+    refitOK[iw] = refitTrackTPCITS(winners[iw], refitted[iw]);
+  }
+  // store the refitted tracks in the order of TPC tracks
+  for (int iw = 0; iw < nWinners; iw++) {
+    if (!refitOK[iw]) {
       continue;
     }
-    mWinnerChi2Refit[iITS] = mMatchedTracks.back().getChi2Refit();
+    int iTPC = winners[iw], iITS = mMatchRecordsTPC[mTPCWork[iTPC].matchID].partnerID;
+    const auto& trfit = mMatchedTracks.emplace_back(refitted[iw]);
+    mWinnerChi2Refit[iITS] = trfit.getChi2Refit();
+    if (mMCTruthON) { // store MC info: we assign TPC track label and declare the match fake if the ITS and TPC labels are different (their fake flag is ignored)
+      auto& lbl = mOutLabels.emplace_back(mTPCLblWork[iTPC]);
+      lbl.setFakeFlag(mITSLblWork[iITS] != mTPCLblWork[iTPC]);
+    }
+    // if requested, fill the difference of ITS and TPC tracks tgl for vdrift calibation
+    if (mHistoDTgl) {
+      auto tglITS = mITSWork[iITS].getTgl();
+      if (std::abs(tglITS) < mHistoDTgl->getXMax()) {
+        auto dTgl = tglITS - mTPCWork[iTPC].getTgl();
+        mHistoDTgl->fill(tglITS, dTgl);
+      }
+    }
   }
   mTimer[SWRefit].Stop();
 }
 
 //______________________________________________
-bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
+bool MatchTPCITS::refitTrackTPCITS(int iTPC, o2::dataformats::TrackTPCITS& trfit) const
 {
   ///< refit in inward direction the pair of TPC and ITS tracks
 
@@ -1401,12 +1448,10 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     return false; // no match
   }
   const auto& tpcMatchRec = mMatchRecordsTPC[tTPC.matchID];
-  iITS = tpcMatchRec.partnerID;
-  const auto& tITS = mITSWork[iITS];
+  const auto& tITS = mITSWork[tpcMatchRec.partnerID];
   const auto& itsTrOrig = mITSTracksArray[tITS.sourceID];
 
-  mMatchedTracks.emplace_back(tTPC, tITS); // create a copy of TPC track at xRef
-  auto& trfit = mMatchedTracks.back();
+  trfit = o2::dataformats::TrackTPCITS(tTPC, tITS); // create a copy of TPC track at xRef
   // in continuos mode the Z of TPC track is meaningless, unless it is CE crossing
   // track (currently absent, TODO)
   if (!mCompareTracksDZ) {
@@ -1452,7 +1497,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   if (nclRefit != ncl) {
     LOGP(WARNING, "Refit in ITS failed after ncl={}, match between TPC track #{} and ITS track #{}", nclRefit, tTPC.sourceID, tITS.sourceID);
     LOGP(WARNING, "{:s}", trfit.asString());
-    mMatchedTracks.pop_back(); // destroy failed track
     return false;
   }
 
@@ -1477,7 +1521,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     if (!tracOut.getXatLabR(o2::constants::geom::XTPCInnerRef, xtogo, mBz, o2::track::DirOutward) ||
         !propagator->PropagateToXBxByBz(tracOut, xtogo, MaxSnp, 10., mUseMatCorrFlag, &tofL)) {
       LOG(DEBUG) << "Propagation to inner TPC boundary X=" << xtogo << " failed, Xtr=" << tracOut.getX() << " snp=" << tracOut.getSnp();
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     if (mVDriftCalibOn) {
@@ -1488,7 +1531,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
     int retVal = mTPCRefitter->RefitTrackAsTrackParCov(tracOut, mTPCTracksArray[tTPC.sourceID].getClusterRef(), timeC * mTPCTBinMUSInv, &chi2Out, true, false); // outward refit
     if (retVal < 0) {
       LOG(DEBUG) << "Refit failed";
-      mMatchedTracks.pop_back(); // destroy failed track
       return false;
     }
     auto posEnd = tracOut.getXYZGlo();
@@ -1517,20 +1559,6 @@ bool MatchTPCITS::refitTrackTPCITS(int iTPC, int& iITS)
   trfit.setTimeMUS(timeC, timeErr);
   trfit.setRefTPC({unsigned(tTPC.sourceID), o2::dataformats::GlobalTrackID::TPC});
   trfit.setRefITS({unsigned(tITS.sourceID), o2::dataformats::GlobalTrackID::ITS});
-
-  if (mMCTruthON) { // store MC info: we assign TPC track label and declare the match fake if the ITS and TPC labels are different (their fake flag is ignored)
-    auto& lbl = mOutLabels.emplace_back(mTPCLblWork[iTPC]);
-    lbl.setFakeFlag(mITSLblWork[iITS] != mTPCLblWork[iTPC]);
-  }
-
-  // if requested, fill the difference of ITS and TPC tracks tgl for vdrift calibation
-  if (mHistoDTgl) {
-    auto tglITS = tITS.getTgl();
-    if (std::abs(tglITS) < mHistoDTgl->getXMax()) {
-      auto dTgl = tglITS - tTPC.getTgl();
-      mHistoDTgl->fill(tglITS, dTgl);
-    }
-  }
   //  trfit.print(); // DBG
 
   return true;
@@ -2449,6 +2477,16 @@ void MatchTPCITS::refitABTrack(int ibest) const
   }
 }
 
+//______________________________________________
+void MatchTPCITS::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 //______________________________________________
 void MatchTPCITS::setITSROFrameLengthInBC(int nbc)
 {
@@ -2483,7 +2521,7 @@ void MatchTPCITS::setBunchFilling(const o2::BunchFilling& bf)
 }
 
 //___________________________________________________________________
-MatchTPCITS::BracketIR MatchTPCITS::tBracket2IRBracket(const BracketF tbrange)
+MatchTPCITS::BracketIR MatchTPCITS::tBracket2IRBracket(const BracketF tbrange) const
 {
   // convert time bracket to IR bracket
   o2::InteractionRecord irMin(mStartIR), irMax(mStartIR);
@@ -13,6 +13,8 @@
 
 #include <vector>
 #include <TStopwatch.h>
+#include <TFile.h>
+#include <TTree.h>
 #include "DataFormatsGlobalTracking/RecoContainer.h"
 #include "DataFormatsGlobalTracking/RecoContainerCreateTracksVariadic.h"
 #include "ReconstructionDataFormats/TrackTPCITS.h"
@@ -53,12 +55,16 @@ class PrimaryVertexingSpec : public Task
   void endOfStream(EndOfStreamContext& ec) final;
 
  private:
+  void dumpInput(std::vector<TrackWithTimeStamp>& tracks, std::vector<o2d::GlobalTrackID>& gids, std::vector<o2::InteractionRecord>& ft0Data, o2::InteractionRecord& startIR);
+
   std::shared_ptr<DataRequest> mDataRequest;
   o2::vertexing::PVertexer mVertexer;
   bool mUseMC{false};          ///< MC flag
   bool mValidateWithIR{false}; ///< require vertex validation with IR (e.g. from FT0)
   float mITSROFrameLengthMUS = 0.;
   TStopwatch mTimer;
+  std::unique_ptr<TFile> mDumpFile; ///< optional file to record the vertexer input, e.g. for the PVertexer benchmark
+  std::unique_ptr<TTree> mDumpTree;
 };
 
 void PrimaryVertexingSpec::init(InitContext& ic)
@@ -94,7 +100,16 @@ void PrimaryVertexingSpec::init(InitContext& ic)
   const auto* digctx = o2::steer::DigitizationContext::loadFromFile();
   const auto& bcfill = digctx->getBunchFilling();
   mVertexer.setBunchFilling(bcfill);
+  mVertexer.setNThreads(ic.options().get<int>("threads"));
   mVertexer.init();
+
+  auto dumpName = ic.options().get<std::string>("dump-input");
+  if (!dumpName.empty()) {
+    mDumpFile = std::make_unique<TFile>(dumpName.c_str(), "recreate");
+    mDumpFile->WriteObjectAny(&bcfill, "o2::BunchFilling", "bunchFilling");
+    mDumpTree = std::make_unique<TTree>("pvInput", "Primary vertexer input per TF");
+    LOG(INFO) << "Primary vertexer input will be stored in " << dumpName;
+  }
 }
 
 void PrimaryVertexingSpec::run(ProcessingContext& pc)
@@ -143,7 +158,8 @@ void PrimaryVertexingSpec::run(ProcessingContext& pc)
   std::vector<o2::MCEventLabel> lblVtx;
 
   // RS FIXME this will not have effect until the 1st orbit is propagated, until that will work only for TF starting at orbit 0
-  mVertexer.setStartIR({0, DataRefUtils::getHeader<o2::header::DataHeader*>(pc.inputs().getByPos(0))->firstTForbit});
+  o2::InteractionRecord startIR{0, DataRefUtils::getHeader<o2::header::DataHeader*>(pc.inputs().getByPos(0))->firstTForbit};
+  mVertexer.setStartIR(startIR);
 
   std::vector<o2::InteractionRecord> ft0Data;
   if (mValidateWithIR) { // select BCs for validation
@@ -156,6 +172,9 @@ void PrimaryVertexingSpec::run(ProcessingContext& pc)
     }
   }
 
+  if (mDumpTree) {
+    dumpInput(tracks, gids, ft0Data, startIR);
+  }
   mVertexer.process(tracks, gids, ft0Data, vertices, vertexTrackIDs, v2tRefs, tracksMCInfo, lblVtx);
   pc.outputs().snapshot(Output{"GLO", "PVTX", 0, Lifetime::Timeframe}, vertices);
   pc.outputs().snapshot(Output{"GLO", "PVTX_CONTIDREFS", 0, Lifetime::Timeframe}, v2tRefs);
@@ -170,9 +189,40 @@ void PrimaryVertexingSpec::run(ProcessingContext& pc)
             << mTimer.CpuTime() - timeCPU0 << " Real: " << mTimer.RealTime() - timeReal0 << " s";
 }
 
+void PrimaryVertexingSpec::dumpInput(std::vector<TrackWithTimeStamp>& tracks, std::vector<o2d::GlobalTrackID>& gids,
+                                     std::vector<o2::InteractionRecord>& ft0Data, o2::InteractionRecord& startIR)
+{
+  // store the vertexer input of the TF, so that it can be replayed outside of the workflow
+  auto tracksPtr = &tracks;
+  auto gidsPtr = &gids;
+  auto ft0DataPtr = &ft0Data;
+  auto startIRPtr = &startIR;
+  if (!mDumpTree->GetBranch("tracks")) {
+    mDumpTree->Branch("tracks", &tracksPtr);
+    mDumpTree->Branch("gids", &gidsPtr);
+    mDumpTree->Branch("ft0IR", &ft0DataPtr);
+    mDumpTree->Branch("startIR", &startIRPtr);
+    mDumpTree->Branch("itsROFrameLengthMUS", &mITSROFrameLengthMUS);
+    mDumpTree->Branch("validateWithIR", &mValidateWithIR);
+  } else {
+    mDumpTree->SetBranchAddress("tracks", &tracksPtr);
+    mDumpTree->SetBranchAddress("gids", &gidsPtr);
+    mDumpTree->SetBranchAddress("ft0IR", &ft0DataPtr);
+    mDumpTree->SetBranchAddress("startIR", &startIRPtr);
+  }
+  mDumpTree->Fill();
+}
+
 void PrimaryVertexingSpec::endOfStream(EndOfStreamContext& ec)
 {
   mVertexer.end();
+  if (mDumpTree) {
+    mDumpFile->cd();
+    mDumpTree->Write();
+    mDumpTree.reset();
+    mDumpFile->Close();
+    mDumpFile.reset();
+  }
   LOGF(INFO, "Primary vertexing total timing: Cpu: %.3e Real: %.3e s in %d slots",
        mTimer.CpuTime(), mTimer.RealTime(), mTimer.Counter() - 1);
 }
@@ -200,7 +250,9 @@ DataProcessorSpec getPrimaryVertexingSpec(GTrackID::mask_t src, bool validateWit
     dataRequest->inputs,
     outputs,
     AlgorithmSpec{adaptFromTask<PrimaryVertexingSpec>(dataRequest, validateWithFT0, useMC)},
-    Options{{"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}}}};
+    Options{{"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}},
+            {"threads", VariantType::Int, 1, {"Number of threads fitting the time-Z clusters concurrently"}},
+            {"dump-input", VariantType::String, "", {"Store the vertexer input to this file (e.g. for the PVertexer benchmark)"}}}};
 }
 
 } // namespace vertexing
@@ -118,6 +118,7 @@ void TPCITSMatchingDPL::init(InitContext& ic)
 
   int dbgFlags = ic.options().get<int>("debug-tree-flags");
   mMatching.setDebugFlag(dbgFlags);
+  mMatching.setNThreads(ic.options().get<int>("threads"));
 
   // set bunch filling. Eventually, this should come from CCDB
   const auto* digctx = o2::steer::DigitizationContext::loadFromFile();
@@ -188,7 +189,8 @@ DataProcessorSpec getTPCITSMatchingSpec(GTrackID::mask_t src, bool useFT0, bool
     Options{
       {"its-dictionary-path", VariantType::String, "", {"Path of the cluster-topology dictionary file"}},
       {"material-lut-path", VariantType::String, "", {"Path of the material LUT file"}},
-      {"debug-tree-flags", VariantType::Int, 0, {"DebugFlagTypes bit-pattern for debug tree"}}}};
+      {"debug-tree-flags", VariantType::Int, 0, {"DebugFlagTypes bit-pattern for debug tree"}},
+      {"threads", VariantType::Int, 1, {"Number of threads for sectors matching and winners refit"}}}};
 }
 
 } // namespace globaltracking
@@ -24,6 +24,7 @@
 #include <iosfwd>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "ITStracking/Configuration.h"
 #include "DetectorsBase/MatLayerCylSet.h"
@@ -80,6 +81,8 @@ class Tracker
   void setCorrType(const o2::base::PropagatorImpl<float>::MatCorrType& type) { mCorrType = type; }
   void setParameters(const std::vector<MemoryParameters>&, const std::vector<TrackingParameters>&);
   void getGlobalConfiguration();
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
   bool isMatLUT() const { return o2::base::Propagator::Instance()->getMatLUT() && (mCorrType == o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrLUT); }
 
  private:
@@ -93,7 +96,7 @@ class Tracker
   void findRoads(int& iteration);
   void findTracks(const ROframe& ev);
   bool fitTrack(const ROframe& event, TrackITSExt& track, int start, int end, int step, const float chi2cut = o2::constants::math::VeryBig);
-  void traverseCellsTree(const int, const int);
+  void traverseCellsTree(const int, const int, std::vector<Road>&);
   void computeRoadsMClabels(const ROframe&);
   void computeTracksMClabels(const ROframe&);
   void rectifyClusterIndices(const ROframe& event);
@@ -110,11 +113,16 @@ class Tracker
   bool mCUDA = false;
   o2::base::PropagatorImpl<float>::MatCorrType mCorrType = o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrLUT;
   float mBz = 5.f;
+  int mNThreads = 1;
   std::uint32_t mROFrame = 0;
   std::vector<TrackITSExt> mTracks;
   std::vector<MCCompLabel> mTrackLabels;
   o2::gpu::GPUChainITS* mRecoChain = nullptr;
 
+  static constexpr int ChunkSize = 64;                               /// cells processed per parallel task
+  std::vector<std::vector<std::pair<int, int>>> mNeighboursPerChunk; /// compatible (cell, next layer cell) pairs
+  std::vector<std::vector<Road>> mRoadsPerChunk;                     /// roads found per chunk of cells
+
 #ifdef CA_DEBUG
   StandaloneDebugger* mDebugger;
 #endif
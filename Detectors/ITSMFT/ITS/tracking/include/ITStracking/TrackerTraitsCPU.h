@@ -24,10 +24,12 @@
 #include <iosfwd>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "ITStracking/TrackerTraits.h"
 #include "ITStracking/Configuration.h"
 #include "ITStracking/Definitions.h"
+#include "ITStracking/Cell.h"
 #include "ITStracking/MathUtils.h"
 #include "ITStracking/PrimaryVertexContext.h"
 #include "ITStracking/Road.h"
@@ -48,8 +50,19 @@ class TrackerTraitsCPU : public TrackerTraits
   void refitTracks(const std::vector<std::vector<TrackingFrameInfo>>& tf, std::vector<TrackITSExt>& tracks) final;
 
  protected:
+  /// call f for every tracklet starting from the cluster iCluster of layer iLayer, return the number of tracklets
+  template <typename F>
+  int forEachTracklet(int iLayer, int iCluster, F&& f);
+  /// call f for every cell starting from the tracklet iTracklet of layer iLayer, return the number of cells
+  template <typename F>
+  int forEachCell(int iLayer, int iTracklet, F&& f);
+
+  static constexpr int ChunkSize = 64; // granularity of the work shared between threads
+
   std::vector<std::vector<Tracklet>> mTracklets;
   std::vector<std::vector<Cell>> mCells;
+  std::vector<int> mFoundPerSeed;                // tracklets (cells) per cluster (tracklet), then their offsets
+  std::vector<std::vector<Cell>> mCellsPerChunk; // cells found in the chunks of tracklets processed in parallel
 };
 } // namespace its
 } // namespace o2
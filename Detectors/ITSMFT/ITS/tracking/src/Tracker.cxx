@@ -24,8 +24,10 @@
 #include "ITStracking/TrackingConfigParam.h"
 
 #include "ReconstructionDataFormats/Track.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <optional>
 #include <dlfcn.h>
 #include <cstdlib>
 #include <string>
@@ -122,45 +124,62 @@ void Tracker::findCellsNeighbours(int& iteration)
     const int nextLayerCellsNum{static_cast<int>(mPrimaryVertexContext->getCells()[iLayer + 1].size())};
     mPrimaryVertexContext->getCellsNeighbours()[iLayer].resize(nextLayerCellsNum);
 
-    for (int iCell{0}; iCell < layerCellsNum; ++iCell) {
+    // the compatible pairs of cells are searched in parallel in chunks of cells, the neighbours and the levels
+    // are then assigned sequentially in the order of the cells
+    const int nChunks{(layerCellsNum + ChunkSize - 1) / ChunkSize};
+    mNeighboursPerChunk.resize(nChunks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+#endif
+    for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+      auto& chunkNeighbours = mNeighboursPerChunk[iChunk];
+      chunkNeighbours.clear();
+      for (int iCell{iChunk * ChunkSize}; iCell < std::min((iChunk + 1) * ChunkSize, layerCellsNum); ++iCell) {
+
+        const Cell& currentCell{mPrimaryVertexContext->getCells()[iLayer][iCell]};
+        const int nextLayerTrackletIndex{currentCell.getSecondTrackletIndex()};
+        const int nextLayerFirstCellIndex{mPrimaryVertexContext->getCellsLookupTable()[iLayer][nextLayerTrackletIndex]};
+        if (nextLayerFirstCellIndex != constants::its::UnusedIndex &&
+            mPrimaryVertexContext->getCells()[iLayer + 1][nextLayerFirstCellIndex].getFirstTrackletIndex() ==
+              nextLayerTrackletIndex) {
+
+          for (int iNextLayerCell{nextLayerFirstCellIndex}; iNextLayerCell < nextLayerCellsNum; ++iNextLayerCell) {
+
+            const Cell& nextCell{mPrimaryVertexContext->getCells()[iLayer + 1][iNextLayerCell]};
+            if (nextCell.getFirstTrackletIndex() != nextLayerTrackletIndex) {
+              break;
+            }
 
-      const Cell& currentCell{mPrimaryVertexContext->getCells()[iLayer][iCell]};
-      const int nextLayerTrackletIndex{currentCell.getSecondTrackletIndex()};
-      const int nextLayerFirstCellIndex{mPrimaryVertexContext->getCellsLookupTable()[iLayer][nextLayerTrackletIndex]};
-      if (nextLayerFirstCellIndex != constants::its::UnusedIndex &&
-          mPrimaryVertexContext->getCells()[iLayer + 1][nextLayerFirstCellIndex].getFirstTrackletIndex() ==
-            nextLayerTrackletIndex) {
+            const float3 currentCellNormalVector{currentCell.getNormalVectorCoordinates()};
+            const float3 nextCellNormalVector{nextCell.getNormalVectorCoordinates()};
+            const float3 normalVectorsDeltaVector{currentCellNormalVector.x - nextCellNormalVector.x,
+                                                  currentCellNormalVector.y - nextCellNormalVector.y,
+                                                  currentCellNormalVector.z - nextCellNormalVector.z};
 
-        for (int iNextLayerCell{nextLayerFirstCellIndex}; iNextLayerCell < nextLayerCellsNum; ++iNextLayerCell) {
+            const float deltaNormalVectorsModulus{(normalVectorsDeltaVector.x * normalVectorsDeltaVector.x) +
+                                                  (normalVectorsDeltaVector.y * normalVectorsDeltaVector.y) +
+                                                  (normalVectorsDeltaVector.z * normalVectorsDeltaVector.z)};
+            const float deltaCurvature{std::abs(currentCell.getCurvature() - nextCell.getCurvature())};
 
-          Cell& nextCell{mPrimaryVertexContext->getCells()[iLayer + 1][iNextLayerCell]};
-          if (nextCell.getFirstTrackletIndex() != nextLayerTrackletIndex) {
-            break;
+            if (deltaNormalVectorsModulus < mTrkParams[iteration].NeighbourMaxDeltaN[iLayer] &&
+                deltaCurvature < mTrkParams[iteration].NeighbourMaxDeltaCurvature[iLayer]) {
+              chunkNeighbours.emplace_back(iCell, iNextLayerCell);
+            }
           }
+        }
+      }
+    }
 
-          const float3 currentCellNormalVector{currentCell.getNormalVectorCoordinates()};
-          const float3 nextCellNormalVector{nextCell.getNormalVectorCoordinates()};
-          const float3 normalVectorsDeltaVector{currentCellNormalVector.x - nextCellNormalVector.x,
-                                                currentCellNormalVector.y - nextCellNormalVector.y,
-                                                currentCellNormalVector.z - nextCellNormalVector.z};
-
-          const float deltaNormalVectorsModulus{(normalVectorsDeltaVector.x * normalVectorsDeltaVector.x) +
-                                                (normalVectorsDeltaVector.y * normalVectorsDeltaVector.y) +
-                                                (normalVectorsDeltaVector.z * normalVectorsDeltaVector.z)};
-          const float deltaCurvature{std::abs(currentCell.getCurvature() - nextCell.getCurvature())};
-
-          if (deltaNormalVectorsModulus < mTrkParams[iteration].NeighbourMaxDeltaN[iLayer] &&
-              deltaCurvature < mTrkParams[iteration].NeighbourMaxDeltaCurvature[iLayer]) {
-
-            mPrimaryVertexContext->getCellsNeighbours()[iLayer][iNextLayerCell].push_back(iCell);
+    for (const auto& chunkNeighbours : mNeighboursPerChunk) {
+      for (const auto& [iCell, iNextLayerCell] : chunkNeighbours) {
+        mPrimaryVertexContext->getCellsNeighbours()[iLayer][iNextLayerCell].push_back(iCell);
 
-            const int currentCellLevel{currentCell.getLevel()};
+        const int currentCellLevel{mPrimaryVertexContext->getCells()[iLayer][iCell].getLevel()};
+        Cell& nextCell{mPrimaryVertexContext->getCells()[iLayer + 1][iNextLayerCell]};
 
-            if (currentCellLevel >= nextCell.getLevel()) {
+        if (currentCellLevel >= nextCell.getLevel()) {
 
-              nextCell.setLevel(currentCellLevel + 1);
-            }
-          }
+          nextCell.setLevel(currentCellLevel + 1);
         }
       }
     }
@@ -177,49 +196,62 @@ void Tracker::findRoads(int& iteration)
 
       const int levelCellsNum{static_cast<int>(mPrimaryVertexContext->getCells()[iLayer].size())};
 
-      for (int iCell{0}; iCell < levelCellsNum; ++iCell) {
+      // roads are collected per chunk of cells and appended in the order of the chunks
+      const int nChunks{(levelCellsNum + ChunkSize - 1) / ChunkSize};
+      mRoadsPerChunk.resize(nChunks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+#endif
+      for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+        auto& roads = mRoadsPerChunk[iChunk];
+        roads.clear();
+        for (int iCell{iChunk * ChunkSize}; iCell < std::min((iChunk + 1) * ChunkSize, levelCellsNum); ++iCell) {
 
-        Cell& currentCell{mPrimaryVertexContext->getCells()[iLayer][iCell]};
+          const Cell& currentCell{mPrimaryVertexContext->getCells()[iLayer][iCell]};
 
-        if (currentCell.getLevel() != iLevel) {
-          continue;
-        }
+          if (currentCell.getLevel() != iLevel) {
+            continue;
+          }
 
-        mPrimaryVertexContext->getRoads().emplace_back(iLayer, iCell);
+          roads.emplace_back(iLayer, iCell);
 
-        /// For 3 clusters roads (useful for cascades and hypertriton) we just store the single cell
-        /// and we do not do the candidate tree traversal
-        if (iLevel == 1) {
-          continue;
-        }
+          /// For 3 clusters roads (useful for cascades and hypertriton) we just store the single cell
+          /// and we do not do the candidate tree traversal
+          if (iLevel == 1) {
+            continue;
+          }
 
-        const int cellNeighboursNum{static_cast<int>(
-          mPrimaryVertexContext->getCellsNeighbours()[iLayer - 1][iCell].size())};
-        bool isFirstValidNeighbour = true;
+          const int cellNeighboursNum{static_cast<int>(
+            mPrimaryVertexContext->getCellsNeighbours()[iLayer - 1][iCell].size())};
+          bool isFirstValidNeighbour = true;
 
-        for (int iNeighbourCell{0}; iNeighbourCell < cellNeighboursNum; ++iNeighbourCell) {
+          for (int iNeighbourCell{0}; iNeighbourCell < cellNeighboursNum; ++iNeighbourCell) {
 
-          const int neighbourCellId = mPrimaryVertexContext->getCellsNeighbours()[iLayer - 1][iCell][iNeighbourCell];
-          const Cell& neighbourCell = mPrimaryVertexContext->getCells()[iLayer - 1][neighbourCellId];
+            const int neighbourCellId = mPrimaryVertexContext->getCellsNeighbours()[iLayer - 1][iCell][iNeighbourCell];
+            const Cell& neighbourCell = mPrimaryVertexContext->getCells()[iLayer - 1][neighbourCellId];
 
-          if (iLevel - 1 != neighbourCell.getLevel()) {
-            continue;
-          }
+            if (iLevel - 1 != neighbourCell.getLevel()) {
+              continue;
+            }
 
-          if (isFirstValidNeighbour) {
+            if (isFirstValidNeighbour) {
 
-            isFirstValidNeighbour = false;
+              isFirstValidNeighbour = false;
 
-          } else {
+            } else {
+
+              roads.emplace_back(iLayer, iCell);
+            }
 
-            mPrimaryVertexContext->getRoads().emplace_back(iLayer, iCell);
+            traverseCellsTree(neighbourCellId, iLayer - 1, roads);
           }
 
-          traverseCellsTree(neighbourCellId, iLayer - 1);
+          // TODO: crosscheck for short track iterations
+          // currentCell.setLevel(0);
         }
-
-        // TODO: crosscheck for short track iterations
-        // currentCell.setLevel(0);
+      }
+      for (const auto& roads : mRoadsPerChunk) {
+        mPrimaryVertexContext->getRoads().insert(mPrimaryVertexContext->getRoads().end(), roads.begin(), roads.end());
       }
     }
 #ifdef CA_DEBUG
@@ -231,9 +263,12 @@ void Tracker::findRoads(int& iteration)
 
 void Tracker::findTracks(const ROframe& event)
 {
-  mTracks.reserve(mTracks.capacity() + mPrimaryVertexContext->getRoads().size());
+  const int nRoads{static_cast<int>(mPrimaryVertexContext->getRoads().size())};
+  mTracks.reserve(mTracks.capacity() + nRoads);
   std::vector<TrackITSExt> tracks;
-  tracks.reserve(mPrimaryVertexContext->getRoads().size());
+  tracks.reserve(nRoads);
+  // roads are fitted independently, the candidates are kept at the road position to preserve their order
+  std::vector<std::optional<TrackITSExt>> candidates(nRoads);
 
 #ifdef CA_DEBUG
   std::vector<int> roadCounters(mTrkParams[0].NLayers - 3, 0);
@@ -243,7 +278,13 @@ void Tracker::findTracks(const ROframe& event)
   std::vector<int> nonsharingCounters(mTrkParams[0].NLayers - 3, 0);
 #endif
 
-  for (auto& road : mPrimaryVertexContext->getRoads()) {
+#if defined(WITH_OPENMP) && !defined(CA_DEBUG)
+  // material correction with TGeo is not thread-safe
+  const bool parallelFit{mNThreads > 1 && mCorrType != o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrTGeo};
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic) if (parallelFit)
+#endif
+  for (int iRoad = 0; iRoad < nRoads; ++iRoad) {
+    auto& road = mPrimaryVertexContext->getRoads()[iRoad];
     std::vector<int> clusters(mTrkParams[0].NLayers, constants::its::UnusedIndex);
     int lastCellLevel = constants::its::UnusedIndex;
     CA_DEBUGGER(int nClusters = 2);
@@ -311,9 +352,14 @@ void Tracker::findTracks(const ROframe& event)
       continue;
     }
     CA_DEBUGGER(refitCounters[nClusters - 4]++);
-    tracks.emplace_back(temporaryTrack);
+    candidates[iRoad] = temporaryTrack;
     CA_DEBUGGER(assert(nClusters == temporaryTrack.getNumberOfClusters()));
   }
+  for (auto& candidate : candidates) {
+    if (candidate) {
+      tracks.emplace_back(*candidate);
+    }
+  }
   //mTraits->refitTracks(event.getTrackingFrameInfo(), tracks);
 
   std::sort(tracks.begin(), tracks.end(),
@@ -440,12 +486,12 @@ bool Tracker::fitTrack(const ROframe& event, TrackITSExt& track, int start, int
   return true;
 }
 
-void Tracker::traverseCellsTree(const int currentCellId, const int currentLayerId)
+void Tracker::traverseCellsTree(const int currentCellId, const int currentLayerId, std::vector<Road>& roads)
 {
-  Cell& currentCell{mPrimaryVertexContext->getCells()[currentLayerId][currentCellId]};
+  const Cell& currentCell{mPrimaryVertexContext->getCells()[currentLayerId][currentCellId]};
   const int currentCellLevel = currentCell.getLevel();
 
-  mPrimaryVertexContext->getRoads().back().addCell(currentLayerId, currentCellId);
+  roads.back().addCell(currentLayerId, currentCellId);
 
   if (currentLayerId > 0 && currentCellLevel > 1) {
     const int cellNeighboursNum{static_cast<int>(
@@ -465,10 +511,10 @@ void Tracker::traverseCellsTree(const int currentCellId, const int currentLayerI
       if (isFirstValidNeighbour) {
         isFirstValidNeighbour = false;
       } else {
-        mPrimaryVertexContext->getRoads().push_back(mPrimaryVertexContext->getRoads().back());
+        roads.push_back(roads.back());
       }
 
-      traverseCellsTree(neighbourCellId, currentLayerId - 1);
+      traverseCellsTree(neighbourCellId, currentLayerId - 1, roads);
     }
   }
 
@@ -651,6 +697,13 @@ void Tracker::getGlobalConfiguration()
   if (tc.useMatCorrTGeo) {
     setCorrType(o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrTGeo);
   }
+  setNThreads(tc.nThreads);
+}
+
+void Tracker::setNThreads(int n)
+{
+  mNThreads = n > 0 ? n : 1;
+  mTraits->setNThreads(mNThreads);
 }
 
 } // namespace its
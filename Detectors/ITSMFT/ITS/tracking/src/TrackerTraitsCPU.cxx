@@ -24,6 +24,7 @@
 #include "ReconstructionDataFormats/Track.h"
 #include <cassert>
 #include <iostream>
+#include <numeric>
 
 #include "GPUCommonMath.h"
 
@@ -32,86 +33,115 @@ namespace o2
 namespace its
 {
 
-void TrackerTraitsCPU::computeLayerTracklets()
+template <typename F>
+int TrackerTraitsCPU::forEachTracklet(int iLayer, int iCluster, F&& f)
 {
   PrimaryVertexContext* primaryVertexContext = mPrimaryVertexContext;
-  for (int iLayer{0}; iLayer < mTrkParams.TrackletsPerRoad(); ++iLayer) {
-    if (primaryVertexContext->getClusters()[iLayer].empty() || primaryVertexContext->getClusters()[iLayer + 1].empty()) {
-      continue;
-    }
+  const float3& primaryVertex = primaryVertexContext->getPrimaryVertex();
+  const Cluster& currentCluster{primaryVertexContext->getClusters()[iLayer][iCluster]};
 
-    const float3& primaryVertex = primaryVertexContext->getPrimaryVertex();
-    const int currentLayerClustersNum{static_cast<int>(primaryVertexContext->getClusters()[iLayer].size())};
-
-    for (int iCluster{0}; iCluster < currentLayerClustersNum; ++iCluster) {
-      const Cluster& currentCluster{primaryVertexContext->getClusters()[iLayer][iCluster]};
+  if (primaryVertexContext->isClusterUsed(iLayer, currentCluster.clusterId)) {
+    return 0;
+  }
 
-      if (primaryVertexContext->isClusterUsed(iLayer, currentCluster.clusterId)) {
-        continue;
-      }
+  const float tanLambda{(currentCluster.zCoordinate - primaryVertex.z) / currentCluster.rCoordinate};
+  const float zAtRmin{tanLambda * (mPrimaryVertexContext->getMinR(iLayer + 1) -
+                                   currentCluster.rCoordinate) +
+                      currentCluster.zCoordinate};
+  const float zAtRmax{tanLambda * (mPrimaryVertexContext->getMaxR(iLayer + 1) -
+                                   currentCluster.rCoordinate) +
+                      currentCluster.zCoordinate};
 
-      const float tanLambda{(currentCluster.zCoordinate - primaryVertex.z) / currentCluster.rCoordinate};
-      const float zAtRmin{tanLambda * (mPrimaryVertexContext->getMinR(iLayer + 1) -
-                                       currentCluster.rCoordinate) +
-                          currentCluster.zCoordinate};
-      const float zAtRmax{tanLambda * (mPrimaryVertexContext->getMaxR(iLayer + 1) -
-                                       currentCluster.rCoordinate) +
-                          currentCluster.zCoordinate};
+  const int4 selectedBinsRect{getBinsRect(currentCluster, iLayer, zAtRmin, zAtRmax,
+                                          mTrkParams.TrackletMaxDeltaZ[iLayer], mTrkParams.TrackletMaxDeltaPhi)};
 
-      const int4 selectedBinsRect{getBinsRect(currentCluster, iLayer, zAtRmin, zAtRmax,
-                                              mTrkParams.TrackletMaxDeltaZ[iLayer], mTrkParams.TrackletMaxDeltaPhi)};
+  if (selectedBinsRect.x == 0 && selectedBinsRect.y == 0 && selectedBinsRect.z == 0 && selectedBinsRect.w == 0) {
+    return 0;
+  }
 
-      if (selectedBinsRect.x == 0 && selectedBinsRect.y == 0 && selectedBinsRect.z == 0 && selectedBinsRect.w == 0) {
-        continue;
-      }
+  int phiBinsNum{selectedBinsRect.w - selectedBinsRect.y + 1};
 
-      int phiBinsNum{selectedBinsRect.w - selectedBinsRect.y + 1};
+  if (phiBinsNum < 0) {
+    phiBinsNum += mTrkParams.PhiBins;
+  }
 
-      if (phiBinsNum < 0) {
-        phiBinsNum += mTrkParams.PhiBins;
-      }
+  int nTracklets{0};
+  for (int iPhiBin{selectedBinsRect.y}, iPhiCount{0}; iPhiCount < phiBinsNum;
+       iPhiBin = ++iPhiBin == mTrkParams.PhiBins ? 0 : iPhiBin, iPhiCount++) {
+    const int firstBinIndex{primaryVertexContext->mIndexTableUtils.getBinIndex(selectedBinsRect.x, iPhiBin)};
+    const int maxBinIndex{firstBinIndex + selectedBinsRect.z - selectedBinsRect.x + 1};
+    const int firstRowClusterIndex = primaryVertexContext->getIndexTables()[iLayer][firstBinIndex];
+    const int maxRowClusterIndex = primaryVertexContext->getIndexTables()[iLayer][maxBinIndex];
 
-      for (int iPhiBin{selectedBinsRect.y}, iPhiCount{0}; iPhiCount < phiBinsNum;
-           iPhiBin = ++iPhiBin == mTrkParams.PhiBins ? 0 : iPhiBin, iPhiCount++) {
-        const int firstBinIndex{primaryVertexContext->mIndexTableUtils.getBinIndex(selectedBinsRect.x, iPhiBin)};
-        const int maxBinIndex{firstBinIndex + selectedBinsRect.z - selectedBinsRect.x + 1};
-        const int firstRowClusterIndex = primaryVertexContext->getIndexTables()[iLayer][firstBinIndex];
-        const int maxRowClusterIndex = primaryVertexContext->getIndexTables()[iLayer][maxBinIndex];
+    for (int iNextLayerCluster{firstRowClusterIndex}; iNextLayerCluster < maxRowClusterIndex;
+         ++iNextLayerCluster) {
 
-        for (int iNextLayerCluster{firstRowClusterIndex}; iNextLayerCluster < maxRowClusterIndex;
-             ++iNextLayerCluster) {
+      if (iNextLayerCluster >= (int)primaryVertexContext->getClusters()[iLayer + 1].size()) {
+        break;
+      }
 
-          if (iNextLayerCluster >= (int)primaryVertexContext->getClusters()[iLayer + 1].size()) {
-            break;
-          }
+      const Cluster& nextCluster{primaryVertexContext->getClusters()[iLayer + 1][iNextLayerCluster]};
 
-          const Cluster& nextCluster{primaryVertexContext->getClusters()[iLayer + 1][iNextLayerCluster]};
+      if (primaryVertexContext->isClusterUsed(iLayer + 1, nextCluster.clusterId)) {
+        continue;
+      }
 
-          if (primaryVertexContext->isClusterUsed(iLayer + 1, nextCluster.clusterId)) {
-            continue;
-          }
+      const float deltaZ{o2::gpu::GPUCommonMath::Abs(tanLambda * (nextCluster.rCoordinate - currentCluster.rCoordinate) +
+                                                     currentCluster.zCoordinate - nextCluster.zCoordinate)};
+      const float deltaPhi{o2::gpu::GPUCommonMath::Abs(currentCluster.phiCoordinate - nextCluster.phiCoordinate)};
 
-          const float deltaZ{o2::gpu::GPUCommonMath::Abs(tanLambda * (nextCluster.rCoordinate - currentCluster.rCoordinate) +
-                                                         currentCluster.zCoordinate - nextCluster.zCoordinate)};
-          const float deltaPhi{o2::gpu::GPUCommonMath::Abs(currentCluster.phiCoordinate - nextCluster.phiCoordinate)};
+      if (deltaZ < mTrkParams.TrackletMaxDeltaZ[iLayer] &&
+          (deltaPhi < mTrkParams.TrackletMaxDeltaPhi ||
+           o2::gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < mTrkParams.TrackletMaxDeltaPhi)) {
+        f(iNextLayerCluster, currentCluster, nextCluster);
+        ++nTracklets;
+      }
+    }
+  }
+  return nTracklets;
+}
 
-          if (deltaZ < mTrkParams.TrackletMaxDeltaZ[iLayer] &&
-              (deltaPhi < mTrkParams.TrackletMaxDeltaPhi ||
-               o2::gpu::GPUCommonMath::Abs(deltaPhi - constants::math::TwoPi) < mTrkParams.TrackletMaxDeltaPhi)) {
+void TrackerTraitsCPU::computeLayerTracklets()
+{
+  PrimaryVertexContext* primaryVertexContext = mPrimaryVertexContext;
+  for (int iLayer{0}; iLayer < mTrkParams.TrackletsPerRoad(); ++iLayer) {
+    if (primaryVertexContext->getClusters()[iLayer].empty() || primaryVertexContext->getClusters()[iLayer + 1].empty()) {
+      continue;
+    }
 
-            if (iLayer > 0 &&
-                primaryVertexContext->getTrackletsLookupTable()[iLayer - 1][iCluster] == constants::its::UnusedIndex) {
+    const int currentLayerClustersNum{static_cast<int>(primaryVertexContext->getClusters()[iLayer].size())};
 
-              primaryVertexContext->getTrackletsLookupTable()[iLayer - 1][iCluster] =
-                primaryVertexContext->getTracklets()[iLayer].size();
-            }
+    // as in the GPU traits, the tracklets are found in 2 passes: count the tracklets of every cluster, then fill them
+    // at the offsets given by the exclusive scan of the counts, which reproduces the order of the sequential search
+    auto& offsets = mFoundPerSeed;
+    offsets.resize(currentLayerClustersNum + 1);
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic, ChunkSize)
+#endif
+    for (int iCluster = 0; iCluster < currentLayerClustersNum; ++iCluster) {
+      offsets[iCluster] = forEachTracklet(iLayer, iCluster, [](int, const Cluster&, const Cluster&) {});
+    }
+    offsets[currentLayerClustersNum] = 0;
+    std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), 0);
 
-            primaryVertexContext->getTracklets()[iLayer].emplace_back(iCluster, iNextLayerCluster, currentCluster,
-                                                                      nextCluster);
-          }
-        }
+    auto& tracklets = primaryVertexContext->getTracklets()[iLayer];
+    tracklets.resize(offsets[currentLayerClustersNum]);
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic, ChunkSize)
+#endif
+    for (int iCluster = 0; iCluster < currentLayerClustersNum; ++iCluster) {
+      int iTracklet{offsets[iCluster]};
+      if (iTracklet == offsets[iCluster + 1]) {
+        continue;
       }
+      if (iLayer > 0) {
+        primaryVertexContext->getTrackletsLookupTable()[iLayer - 1][iCluster] = iTracklet;
+      }
+      forEachTracklet(iLayer, iCluster, [&](int iNextLayerCluster, const Cluster& currentCluster, const Cluster& nextCluster) {
+        tracklets[iTracklet++] = Tracklet(iCluster, iNextLayerCluster, currentCluster, nextCluster);
+      });
     }
+
     if (iLayer > 0 && iLayer < mTrkParams.TrackletsPerRoad() - 1 &&
         primaryVertexContext->getTracklets()[iLayer].size() > primaryVertexContext->getCellsLookupTable()[iLayer - 1].size()) {
       throw std::runtime_error(fmt::format("not enough memory in the CellsLookupTable, increase the tracklet memory coefficients: {} tracklets on L{}, lookup table size {} on L{}",
@@ -127,6 +157,107 @@ void TrackerTraitsCPU::computeLayerTracklets()
 #endif
 }
 
+template <typename F>
+int TrackerTraitsCPU::forEachCell(int iLayer, int iTracklet, F&& f)
+{
+  PrimaryVertexContext* primaryVertexContext = mPrimaryVertexContext;
+  const float3& primaryVertex = primaryVertexContext->getPrimaryVertex();
+  const Tracklet& currentTracklet{primaryVertexContext->getTracklets()[iLayer][iTracklet]};
+  const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
+  const int nextLayerFirstTrackletIndex{
+    primaryVertexContext->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex]};
+
+  if (nextLayerFirstTrackletIndex == constants::its::UnusedIndex) {
+    return 0;
+  }
+
+  const Cluster& firstCellCluster{primaryVertexContext->getClusters()[iLayer][currentTracklet.firstClusterIndex]};
+  const Cluster& secondCellCluster{
+    primaryVertexContext->getClusters()[iLayer + 1][currentTracklet.secondClusterIndex]};
+  const float firstCellClusterQuadraticRCoordinate{firstCellCluster.rCoordinate * firstCellCluster.rCoordinate};
+  const float secondCellClusterQuadraticRCoordinate{secondCellCluster.rCoordinate *
+                                                    secondCellCluster.rCoordinate};
+  const float3 firstDeltaVector{secondCellCluster.xCoordinate - firstCellCluster.xCoordinate,
+                                secondCellCluster.yCoordinate - firstCellCluster.yCoordinate,
+                                secondCellClusterQuadraticRCoordinate - firstCellClusterQuadraticRCoordinate};
+  const int nextLayerTrackletsNum{static_cast<int>(primaryVertexContext->getTracklets()[iLayer + 1].size())};
+
+  int nCells{0};
+  for (int iNextLayerTracklet{nextLayerFirstTrackletIndex};
+       iNextLayerTracklet < nextLayerTrackletsNum &&
+       primaryVertexContext->getTracklets()[iLayer + 1][iNextLayerTracklet].firstClusterIndex ==
+         nextLayerClusterIndex;
+       ++iNextLayerTracklet) {
+
+    const Tracklet& nextTracklet{primaryVertexContext->getTracklets()[iLayer + 1][iNextLayerTracklet]};
+    const float deltaTanLambda{std::abs(currentTracklet.tanLambda - nextTracklet.tanLambda)};
+    const float deltaPhi{std::abs(currentTracklet.phiCoordinate - nextTracklet.phiCoordinate)};
+
+    if (deltaTanLambda < mTrkParams.CellMaxDeltaTanLambda &&
+        (deltaPhi < mTrkParams.CellMaxDeltaPhi ||
+         std::abs(deltaPhi - constants::math::TwoPi) < mTrkParams.CellMaxDeltaPhi)) {
+
+      const float averageTanLambda{0.5f * (currentTracklet.tanLambda + nextTracklet.tanLambda)};
+      const float directionZIntersection{-averageTanLambda * firstCellCluster.rCoordinate +
+                                         firstCellCluster.zCoordinate};
+      const float deltaZ{std::abs(directionZIntersection - primaryVertex.z)};
+
+      if (deltaZ < mTrkParams.CellMaxDeltaZ[iLayer]) {
+
+        const Cluster& thirdCellCluster{
+          primaryVertexContext->getClusters()[iLayer + 2][nextTracklet.secondClusterIndex]};
+
+        const float thirdCellClusterQuadraticRCoordinate{thirdCellCluster.rCoordinate *
+                                                         thirdCellCluster.rCoordinate};
+
+        const float3 secondDeltaVector{thirdCellCluster.xCoordinate - firstCellCluster.xCoordinate,
+                                       thirdCellCluster.yCoordinate - firstCellCluster.yCoordinate,
+                                       thirdCellClusterQuadraticRCoordinate -
+                                         firstCellClusterQuadraticRCoordinate};
+
+        float3 cellPlaneNormalVector{math_utils::crossProduct(firstDeltaVector, secondDeltaVector)};
+
+        const float vectorNorm{std::sqrt(cellPlaneNormalVector.x * cellPlaneNormalVector.x +
+                                         cellPlaneNormalVector.y * cellPlaneNormalVector.y +
+                                         cellPlaneNormalVector.z * cellPlaneNormalVector.z)};
+
+        if (vectorNorm < constants::math::FloatMinThreshold ||
+            std::abs(cellPlaneNormalVector.z) < constants::math::FloatMinThreshold) {
+
+          continue;
+        }
+
+        const float inverseVectorNorm{1.0f / vectorNorm};
+        const float3 normalizedPlaneVector{cellPlaneNormalVector.x * inverseVectorNorm,
+                                           cellPlaneNormalVector.y * inverseVectorNorm,
+                                           cellPlaneNormalVector.z * inverseVectorNorm};
+        const float planeDistance{-normalizedPlaneVector.x * (secondCellCluster.xCoordinate - primaryVertex.x) -
+                                  (normalizedPlaneVector.y * secondCellCluster.yCoordinate - primaryVertex.y) -
+                                  normalizedPlaneVector.z * secondCellClusterQuadraticRCoordinate};
+        const float normalizedPlaneVectorQuadraticZCoordinate{normalizedPlaneVector.z * normalizedPlaneVector.z};
+        const float cellTrajectoryRadius{std::sqrt(
+          (1.0f - normalizedPlaneVectorQuadraticZCoordinate - 4.0f * planeDistance * normalizedPlaneVector.z) /
+          (4.0f * normalizedPlaneVectorQuadraticZCoordinate))};
+        const float2 circleCenter{-0.5f * normalizedPlaneVector.x / normalizedPlaneVector.z,
+                                  -0.5f * normalizedPlaneVector.y / normalizedPlaneVector.z};
+        const float distanceOfClosestApproach{std::abs(
+          cellTrajectoryRadius - std::sqrt(circleCenter.x * circleCenter.x + circleCenter.y * circleCenter.y))};
+
+        if (distanceOfClosestApproach >
+            mTrkParams.CellMaxDCA[iLayer]) {
+
+          continue;
+        }
+
+        const float cellTrajectoryCurvature{1.0f / cellTrajectoryRadius};
+        f(currentTracklet, nextTracklet, iNextLayerTracklet, normalizedPlaneVector, cellTrajectoryCurvature);
+        ++nCells;
+      }
+    }
+  }
+  return nCells;
+}
+
 void TrackerTraitsCPU::computeLayerCells()
 {
   PrimaryVertexContext* primaryVertexContext = mPrimaryVertexContext;
@@ -138,111 +269,54 @@ void TrackerTraitsCPU::computeLayerCells()
       return;
     }
 
-    const float3& primaryVertex = primaryVertexContext->getPrimaryVertex();
     const int currentLayerTrackletsNum{static_cast<int>(primaryVertexContext->getTracklets()[iLayer].size())};
 
-    for (int iTracklet{0}; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
-
-      const Tracklet& currentTracklet{primaryVertexContext->getTracklets()[iLayer][iTracklet]};
-      const int nextLayerClusterIndex{currentTracklet.secondClusterIndex};
-      const int nextLayerFirstTrackletIndex{
-        primaryVertexContext->getTrackletsLookupTable()[iLayer][nextLayerClusterIndex]};
-
-      if (nextLayerFirstTrackletIndex == constants::its::UnusedIndex) {
-
-        continue;
+    // count the cells of every tracklet to fill the lookup table and to book the memory
+    auto& offsets = mFoundPerSeed;
+    offsets.resize(currentLayerTrackletsNum + 1);
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic, ChunkSize)
+#endif
+    for (int iTracklet = 0; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
+      offsets[iTracklet] = forEachCell(iLayer, iTracklet, [](const Tracklet&, const Tracklet&, int, const float3&, float) {});
+    }
+    offsets[currentLayerTrackletsNum] = 0;
+    std::exclusive_scan(offsets.begin(), offsets.end(), offsets.begin(), 0);
+    if (iLayer > 0) {
+      auto& lookupTable = primaryVertexContext->getCellsLookupTable()[iLayer - 1];
+      for (int iTracklet = 0; iTracklet < currentLayerTrackletsNum; ++iTracklet) {
+        if (offsets[iTracklet] != offsets[iTracklet + 1]) {
+          lookupTable[iTracklet] = offsets[iTracklet];
+        }
       }
+    }
 
-      const Cluster& firstCellCluster{primaryVertexContext->getClusters()[iLayer][currentTracklet.firstClusterIndex]};
-      const Cluster& secondCellCluster{
-        primaryVertexContext->getClusters()[iLayer + 1][currentTracklet.secondClusterIndex]};
-      const float firstCellClusterQuadraticRCoordinate{firstCellCluster.rCoordinate * firstCellCluster.rCoordinate};
-      const float secondCellClusterQuadraticRCoordinate{secondCellCluster.rCoordinate *
-                                                        secondCellCluster.rCoordinate};
-      const float3 firstDeltaVector{secondCellCluster.xCoordinate - firstCellCluster.xCoordinate,
-                                    secondCellCluster.yCoordinate - firstCellCluster.yCoordinate,
-                                    secondCellClusterQuadraticRCoordinate - firstCellClusterQuadraticRCoordinate};
-      const int nextLayerTrackletsNum{static_cast<int>(primaryVertexContext->getTracklets()[iLayer + 1].size())};
-
-      for (int iNextLayerTracklet{nextLayerFirstTrackletIndex};
-           iNextLayerTracklet < nextLayerTrackletsNum &&
-           primaryVertexContext->getTracklets()[iLayer + 1][iNextLayerTracklet].firstClusterIndex ==
-             nextLayerClusterIndex;
-           ++iNextLayerTracklet) {
-
-        const Tracklet& nextTracklet{primaryVertexContext->getTracklets()[iLayer + 1][iNextLayerTracklet]};
-        const float deltaTanLambda{std::abs(currentTracklet.tanLambda - nextTracklet.tanLambda)};
-        const float deltaPhi{std::abs(currentTracklet.phiCoordinate - nextTracklet.phiCoordinate)};
-
-        if (deltaTanLambda < mTrkParams.CellMaxDeltaTanLambda &&
-            (deltaPhi < mTrkParams.CellMaxDeltaPhi ||
-             std::abs(deltaPhi - constants::math::TwoPi) < mTrkParams.CellMaxDeltaPhi)) {
-
-          const float averageTanLambda{0.5f * (currentTracklet.tanLambda + nextTracklet.tanLambda)};
-          const float directionZIntersection{-averageTanLambda * firstCellCluster.rCoordinate +
-                                             firstCellCluster.zCoordinate};
-          const float deltaZ{std::abs(directionZIntersection - primaryVertex.z)};
-
-          if (deltaZ < mTrkParams.CellMaxDeltaZ[iLayer]) {
-
-            const Cluster& thirdCellCluster{
-              primaryVertexContext->getClusters()[iLayer + 2][nextTracklet.secondClusterIndex]};
-
-            const float thirdCellClusterQuadraticRCoordinate{thirdCellCluster.rCoordinate *
-                                                             thirdCellCluster.rCoordinate};
-
-            const float3 secondDeltaVector{thirdCellCluster.xCoordinate - firstCellCluster.xCoordinate,
-                                           thirdCellCluster.yCoordinate - firstCellCluster.yCoordinate,
-                                           thirdCellClusterQuadraticRCoordinate -
-                                             firstCellClusterQuadraticRCoordinate};
-
-            float3 cellPlaneNormalVector{math_utils::crossProduct(firstDeltaVector, secondDeltaVector)};
-
-            const float vectorNorm{std::sqrt(cellPlaneNormalVector.x * cellPlaneNormalVector.x +
-                                             cellPlaneNormalVector.y * cellPlaneNormalVector.y +
-                                             cellPlaneNormalVector.z * cellPlaneNormalVector.z)};
-
-            if (vectorNorm < constants::math::FloatMinThreshold ||
-                std::abs(cellPlaneNormalVector.z) < constants::math::FloatMinThreshold) {
-
-              continue;
-            }
-
-            const float inverseVectorNorm{1.0f / vectorNorm};
-            const float3 normalizedPlaneVector{cellPlaneNormalVector.x * inverseVectorNorm,
-                                               cellPlaneNormalVector.y * inverseVectorNorm,
-                                               cellPlaneNormalVector.z * inverseVectorNorm};
-            const float planeDistance{-normalizedPlaneVector.x * (secondCellCluster.xCoordinate - primaryVertex.x) -
-                                      (normalizedPlaneVector.y * secondCellCluster.yCoordinate - primaryVertex.y) -
-                                      normalizedPlaneVector.z * secondCellClusterQuadraticRCoordinate};
-            const float normalizedPlaneVectorQuadraticZCoordinate{normalizedPlaneVector.z * normalizedPlaneVector.z};
-            const float cellTrajectoryRadius{std::sqrt(
-              (1.0f - normalizedPlaneVectorQuadraticZCoordinate - 4.0f * planeDistance * normalizedPlaneVector.z) /
-              (4.0f * normalizedPlaneVectorQuadraticZCoordinate))};
-            const float2 circleCenter{-0.5f * normalizedPlaneVector.x / normalizedPlaneVector.z,
-                                      -0.5f * normalizedPlaneVector.y / normalizedPlaneVector.z};
-            const float distanceOfClosestApproach{std::abs(
-              cellTrajectoryRadius - std::sqrt(circleCenter.x * circleCenter.x + circleCenter.y * circleCenter.y))};
-
-            if (distanceOfClosestApproach >
-                mTrkParams.CellMaxDCA[iLayer]) {
-
-              continue;
-            }
-
-            const float cellTrajectoryCurvature{1.0f / cellTrajectoryRadius};
-            if (iLayer > 0 &&
-                primaryVertexContext->getCellsLookupTable()[iLayer - 1][iTracklet] == constants::its::UnusedIndex) {
-
-              primaryVertexContext->getCellsLookupTable()[iLayer - 1][iTracklet] =
-                primaryVertexContext->getCells()[iLayer].size();
-            }
-
-            primaryVertexContext->getCells()[iLayer].emplace_back(
-              currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
-              iTracklet, iNextLayerTracklet, normalizedPlaneVector, cellTrajectoryCurvature);
-          }
+    // cells are immutable, so they are filled to contiguous chunks of tracklets and appended in the chunks order
+    const int nChunks{(currentLayerTrackletsNum + ChunkSize - 1) / ChunkSize};
+    mCellsPerChunk.resize(nChunks);
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+#endif
+    for (int iChunk = 0; iChunk < nChunks; ++iChunk) {
+      const int firstTracklet{iChunk * ChunkSize}, lastTracklet{std::min(firstTracklet + ChunkSize, currentLayerTrackletsNum)};
+      auto& chunkCells = mCellsPerChunk[iChunk];
+      chunkCells.clear();
+      chunkCells.reserve(offsets[lastTracklet] - offsets[firstTracklet]);
+      for (int iTracklet = firstTracklet; iTracklet < lastTracklet; ++iTracklet) {
+        if (offsets[iTracklet] == offsets[iTracklet + 1]) {
+          continue;
         }
+        forEachCell(iLayer, iTracklet, [&](const Tracklet& currentTracklet, const Tracklet& nextTracklet, int iNextLayerTracklet, const float3& normalizedPlaneVector, float curvature) {
+          chunkCells.emplace_back(currentTracklet.firstClusterIndex, nextTracklet.firstClusterIndex, nextTracklet.secondClusterIndex,
+                                  iTracklet, iNextLayerTracklet, normalizedPlaneVector, curvature);
+        });
+      }
+    }
+    auto& cells = primaryVertexContext->getCells()[iLayer];
+    cells.reserve(offsets[currentLayerTrackletsNum]);
+    for (const auto& chunkCells : mCellsPerChunk) {
+      for (const auto& cell : chunkCells) {
+        cells.emplace_back(cell);
       }
     }
   }
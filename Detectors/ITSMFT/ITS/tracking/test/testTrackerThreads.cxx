@@ -0,0 +1,107 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test ITS Tracker threads
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <vector>
+
+#include "CommonConstants/MathConstants.h"
+#include "DetectorsBase/Propagator.h"
+#include "ReconstructionDataFormats/Track.h"
+#include "ITStracking/Constants.h"
+#include "ITStracking/ROframe.h"
+#include "ITStracking/Tracker.h"
+#include "ITStracking/TrackerTraitsCPU.h"
+
+using namespace o2::its;
+
+namespace
+{
+constexpr float Bz = 5.f;
+
+/// Ideal clusters of helices from the origin, one per layer.
+void fillEvent(ROframe& event, int nTracks)
+{
+  std::mt19937 gen(12345);
+  std::uniform_real_distribution<float> phiDist(0.f, o2::constants::math::TwoPI);
+  std::uniform_real_distribution<float> tglDist(-0.5f, 0.5f);
+  std::uniform_real_distribution<float> ptDist(1.f, 5.f);
+
+  event.addPrimaryVertex(0.f, 0.f, 0.f);
+  for (int iTrack{0}; iTrack < nTracks; ++iTrack) {
+    float q2pt = (iTrack % 2 ? 1.f : -1.f) / ptDist(gen);
+    o2::track::TrackPar track(0.f, phiDist(gen), {0.f, 0.f, 0.f, tglDist(gen), q2pt});
+    for (int iLayer{0}; iLayer < constants::its2::LayersNumber; ++iLayer) {
+      if (!track.propagateParamTo(constants::its2::LayersRCoordinate()[iLayer], Bz)) {
+        break;
+      }
+      auto xyz = track.getXYZGlo();
+      float alpha = std::atan2(xyz.Y(), xyz.X());
+      float xTF = std::hypot(xyz.X(), xyz.Y());
+      int index = event.getClustersOnLayer(iLayer).size();
+      event.addClusterToLayer(iLayer, xyz.X(), xyz.Y(), xyz.Z(), index);
+      event.addTrackingFrameInfoToLayer(iLayer, xyz.X(), xyz.Y(), xyz.Z(), xTF, alpha,
+                                        std::array<float, 2>{0.f, xyz.Z()}, std::array<float, 3>{2.5e-7f, 0.f, 2.5e-7f});
+      event.addClusterExternalIndexToLayer(iLayer, index);
+    }
+  }
+}
+
+std::vector<TrackITSExt> runTracker(const ROframe& event, int nThreads)
+{
+  TrackerTraitsCPU traits;
+  Tracker tracker(&traits);
+  tracker.setBz(Bz);
+  tracker.setCorrType(o2::base::PropagatorImpl<float>::MatCorrType::USEMatCorrNONE);
+  tracker.setNThreads(nThreads);
+  std::ostringstream timeBenchmark;
+  tracker.clustersToTracks(event, timeBenchmark);
+  return tracker.getTracks();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TrackerThreads_test)
+{
+  // The tracker only needs the propagator for the field, which is given explicitly
+  o2::base::Propagator::Instance(true);
+
+  ROframe event(0, constants::its2::LayersNumber);
+  fillEvent(event, 200);
+
+  auto tracks = runTracker(event, 1);
+  BOOST_REQUIRE(!tracks.empty());
+
+  for (int nThreads : {2, 4}) {
+    auto tracksMT = runTracker(event, nThreads);
+    BOOST_REQUIRE_EQUAL(tracksMT.size(), tracks.size());
+    for (size_t iTrack{0}; iTrack < tracks.size(); ++iTrack) {
+      const auto& track = tracks[iTrack];
+      const auto& trackMT = tracksMT[iTrack];
+      BOOST_CHECK_EQUAL(trackMT.getNClusters(), track.getNClusters());
+      for (int iLayer{0}; iLayer < constants::its2::LayersNumber; ++iLayer) {
+        BOOST_CHECK_EQUAL(trackMT.getClusterIndex(iLayer), track.getClusterIndex(iLayer));
+      }
+      BOOST_CHECK_EQUAL(trackMT.getX(), track.getX());
+      BOOST_CHECK_EQUAL(trackMT.getAlpha(), track.getAlpha());
+      for (int iPar{0}; iPar < o2::track::kNParams; ++iPar) {
+        BOOST_CHECK_EQUAL(trackMT.getParam(iPar), track.getParam(iPar));
+      }
+      BOOST_CHECK_EQUAL(trackMT.getChi2(), track.getChi2());
+    }
+  }
+}
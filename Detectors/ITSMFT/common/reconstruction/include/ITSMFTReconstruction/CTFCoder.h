@@ -17,6 +17,8 @@
 #define O2_ITSMFT_CTFCODER_H
 
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <iterator>
 #include <string>
 #include "DataFormatsITSMFT/CTF.h"
@@ -94,9 +96,10 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>& rofRecVec, co
 
   ec->setHeader(cc.header);
   ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
-  // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
-#define ENCODEITSMFT(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get());
+  ec->getANSHeader().minorVersion = 2;
+  // the blocks are encoded concurrently, each one to the space booked for it in the buffer
+  CTF::BlockEncoders encoders;
+#define ENCODEITSMFT(part, slot, bits) encoders[int(slot)] = CTF::makeBlockEncoder(part, bits, optField[int(slot)], mCoders[int(slot)].get());
   // clang-format off
   ENCODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF, 0);
   ENCODEITSMFT(cc.bcIncROF, CTF::BLCbcIncROF, 0);
@@ -110,7 +113,8 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>& rofRecVec, co
   ENCODEITSMFT(cc.pattID, CTF::BLCpattID, 0);
   ENCODEITSMFT(cc.pattMap, CTF::BLCpattMap, 0);
   // clang-format on
-  CTF::get(buff.data())->print(getPrefix());
+  // the buffer might be autoexpanded, so we don't work with fixed pointer ec
+  CTF::encodeConcurrently(buff, encoders, mNThreads)->print(getPrefix());
 }
 
 /// decode entropy-encoded clusters to standard compact clusters
@@ -120,7 +124,9 @@ void CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VCLUS& cclusVec, VPA
   CompressedClusters cc;
   cc.header = ec.getHeader();
   ec.print(getPrefix());
-#define DECODEITSMFT(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  // the blocks are independent and can be decoded concurrently
+  std::array<std::function<void()>, CTF::getNBlocks()> decoders;
+#define DECODEITSMFT(part, slot) decoders[int(slot)] = [&]() { ec.decode(part, int(slot), mCoders[int(slot)].get()); }
   // clang-format off
   DECODEITSMFT(cc.firstChipROF, CTF::BLCfirstChipROF);
   DECODEITSMFT(cc.bcIncROF,     CTF::BLCbcIncROF);
@@ -134,6 +140,7 @@ void CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VCLUS& cclusVec, VPA
   DECODEITSMFT(cc.pattID,       CTF::BLCpattID);
   DECODEITSMFT(cc.pattMap,      CTF::BLCpattMap);
   // clang-format on
+  o2::ctf::runConcurrently(CTF::getNBlocks(), mNThreads, [&decoders](int slot) { decoders[slot](); });
   //
   decompress(cc, rofRecVec, cclusVec, pattVec);
 }
@@ -147,6 +147,8 @@ class Clusterer
                                  PatternCont* patternsPtr, const ConstMCTruth* labelsDigPtr, MCTruth* labelsClusPTr);
     void process(uint16_t chip, uint16_t nChips, CompClusCont* compClusPtr, PatternCont* patternsPtr,
                  const ConstMCTruth* labelsDigPtr, MCTruth* labelsClPtr, const ROFRecord& rofPtr);
+    void processChip(ChipPixelData* curChipData, CompClusCont* compClusPtr, PatternCont* patternsPtr,
+                     const ConstMCTruth* labelsDigPtr, MCTruth* labelsClPtr);
 
     ClustererThread(Clusterer* par = nullptr) : parent(par), curr(column2 + 1), prev(column1 + 1)
     {
@@ -163,6 +165,7 @@ class Clusterer
   Clusterer& operator=(const Clusterer&) = delete;
 
   void process(int nThreads, PixelReader& r, CompClusCont* compClus, PatternCont* patterns, ROFRecCont* vecROFRec, MCTruth* labelsCl = nullptr);
+  void process(int nThreads, ChipPixelDataBatch& batch, CompClusCont* compClus, PatternCont* patterns, ROFRecCont* vecROFRec);
 
   bool isContinuousReadOut() const { return mContinuousReadout; }
   void setContinuousReadOut(bool v) { mContinuousReadout = v; }
@@ -208,6 +211,20 @@ class Clusterer
   }
 
   void flushClusters(CompClusCont* compClus, MCTruth* labels);
+  void maskBatch(ChipPixelDataBatch& batch);
+
+  /// block of consecutive chips of a batch and location of its results in the thread that processed it
+  struct BatchBlock {
+    uint32_t firstChip = 0; ///< entry of the 1st chip of the block in the batch
+    uint32_t nChips = 0;    ///< number of chips in the block
+    int thread = 0;         ///< thread which processed the block
+    size_t firstClus = 0;   ///< entry of the 1st cluster of the block in the thread output
+    size_t nClus = 0;       ///< number of clusters of the block
+    size_t firstPatt = 0;   ///< entry of the 1st pattern of the block in the thread output
+    size_t nPatt = 0;       ///< number of patterns of the block
+    size_t destClus = 0;    ///< entry of the 1st cluster of the block in the final output
+    size_t destPatt = 0;    ///< entry of the 1st pattern of the block in the final output
+  };
 
   // clusterization options
   bool mContinuousReadout = true;    ///< flag continuous readout
@@ -220,6 +237,10 @@ class Clusterer
   std::vector<ChipPixelData> mChips;                      // currently processed ROF's chips data
   std::vector<ChipPixelData> mChipsOld;                   // previously processed ROF's chips data (for masking)
   std::vector<ChipPixelData*> mFiredChipsPtr;             // pointers on the fired chips data in the decoder cache
+  std::vector<BatchBlock> mBatchBlocks;                   // blocks of chips of the batch being processed
+  std::vector<uint32_t> mBatchChipNClus;                  // number of clusters of every chip of the batch
+  std::vector<uint32_t> mBatchChipOrder;                  // chips of the batch sorted in chip ID, then ROF
+  std::vector<uint32_t> mBatchChipGroups;                 // entries in mBatchChipOrder where a new chip ID starts
 
   LookUp mPattIdConverter; //! Convert the cluster topology to the corresponding entry in the dictionary.
 
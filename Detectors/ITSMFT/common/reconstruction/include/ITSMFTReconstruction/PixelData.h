@@ -238,6 +238,60 @@ class ChipPixelData
 
   ClassDefNV(ChipPixelData, 1);
 };
+
+///< Transient data of the fired chips of several consecutive ROFs, to be processed in one go.
+///< The chips are stored ROF after ROF, in the order provided by the decoder. The chip containers
+///< are kept from one batch to the next and exchanged (swapped) with those of the decoder.
+class ChipPixelDataBatch
+{
+ public:
+  struct ROFEntry {
+    o2::InteractionRecord ir = {}; // interaction record of the ROF
+    uint32_t rofCounter = 0;       // ROF counter of the decoder
+    uint32_t firstChip = 0;        // entry of the 1st fired chip of the ROF
+    uint32_t nChips = 0;           // number of fired chips in the ROF
+  };
+
+  void clear()
+  {
+    mROFs.clear();
+    mChipROF.clear();
+    mNChips = 0;
+  }
+
+  void addROF(const o2::InteractionRecord& ir, uint32_t rofCounter)
+  {
+    mROFs.push_back(ROFEntry{ir, rofCounter, uint32_t(mNChips), 0});
+  }
+
+  ///< provide an empty container for the next chip of the last ROF
+  ChipPixelData& addChip()
+  {
+    if (mNChips == mChips.size()) {
+      mChips.emplace_back();
+    }
+    mChipROF.push_back(mROFs.size() - 1);
+    mROFs.back().nChips++;
+    auto& chip = mChips[mNChips++];
+    chip.clear();
+    return chip;
+  }
+
+  size_t getNROFs() const { return mROFs.size(); }
+  const std::vector<ROFEntry>& getROFs() const { return mROFs; }
+  const ROFEntry& getROF(int i) const { return mROFs[i]; }
+
+  size_t getNChips() const { return mNChips; }
+  ChipPixelData& getChip(size_t i) { return mChips[i]; }
+  const ChipPixelData& getChip(size_t i) const { return mChips[i]; }
+  int getChipROF(size_t i) const { return mChipROF[i]; }
+
+ private:
+  std::vector<ChipPixelData> mChips; // pool of chip containers, only the 1st mNChips are in use
+  std::vector<int> mChipROF;         // ROF of every chip in use
+  std::vector<ROFEntry> mROFs;       // ROFs of the batch
+  size_t mNChips = 0;                // number of chips in use
+};
 } // namespace itsmft
 } // namespace o2
 
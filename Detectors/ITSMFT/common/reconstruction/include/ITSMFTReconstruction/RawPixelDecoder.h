@@ -64,6 +64,11 @@ class RawPixelDecoder final : public PixelReader
   template <class DigitContainer, class ROFContainer>
   int fillDecodedDigits(DigitContainer& digits, ROFContainer& rofs);
 
+  int decodeNextTriggers(ChipPixelDataBatch& batch, int nMax);
+
+  template <class DigitContainer, class ROFContainer>
+  int fillDecodedDigits(const ChipPixelDataBatch& batch, DigitContainer& digits, ROFContainer& rofs);
+
   template <class CalibContainer>
   void fillCalibData(CalibContainer& calib);
 
@@ -108,6 +113,8 @@ class RawPixelDecoder final : public PixelReader
   RUDecodeData* getRUDecode(int ruSW) { return &mRUDecodeVec[mRUEntry[ruSW]]; }
   GBTLink* getGBTLink(int i) { return i < 0 ? nullptr : &mGBTLinks[i]; }
   RUDecodeData& getCreateRUDecode(int ruSW);
+  size_t setDigitOffsets(const ChipPixelDataBatch& batch);
+  void fillDigits(const ChipPixelDataBatch& batch, Digit* digits) const;
 
   static constexpr uint16_t NORUDECODED = 0xffff; // this must be > than max N RUs
 
@@ -116,6 +123,7 @@ class RawPixelDecoder final : public PixelReader
   std::vector<RUDecodeData> mRUDecodeVec;                   // set of active RUs
   std::array<short, Mapping::getNRUs()> mRUEntry;           // entry of the RU with given SW ID in the mRUDecodeVec
   std::vector<ChipPixelData*> mOrderedChipsPtr;             // special ordering helper used for the MFT (its chipID is not contiguous in RU)
+  std::vector<size_t> mDigitOffsets;                        // offset of the digits of every chip of a batch in the output
   std::string mSelfName;                        // self name
   header::DataOrigin mUserDataOrigin = o2::header::gDataOriginInvalid; // alternative user-provided data origin to pick
   header::DataDescription mUserDataDescription = o2::header::gDataDescriptionInvalid; // alternative user-provided description to pick
@@ -189,6 +197,26 @@ int RawPixelDecoder<ChipMappingMFT>::fillDecodedDigits(DigitContainer& digits, R
   return nFilled;
 }
 
+///______________________________________________________________
+/// Fill digits of a batch of decoded triggers to global vector: the output is resized once and
+/// every chip writes its digits at the offset given by the prefix sum of the number of pixels
+template <class Mapping>
+template <class DigitContainer, class ROFContainer>
+int RawPixelDecoder<Mapping>::fillDecodedDigits(const ChipPixelDataBatch& batch, DigitContainer& digits, ROFContainer& rofs)
+{
+  mTimerFetchData.Start(false);
+  size_t ref = digits.size();
+  size_t nFilled = setDigitOffsets(batch);
+  digits.resize(ref + nFilled);
+  fillDigits(batch, digits.data() + ref);
+  for (const auto& rof : batch.getROFs()) {
+    auto first = mDigitOffsets[rof.firstChip];
+    rofs.emplace_back(rof.ir, rof.rofCounter, ref + first, mDigitOffsets[rof.firstChip + rof.nChips] - first);
+  }
+  mTimerFetchData.Stop();
+  return nFilled;
+}
+
 ///______________________________________________________________
 /// Fill decoded digits to global vector
 template <class Mapping>
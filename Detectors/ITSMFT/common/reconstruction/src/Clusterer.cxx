@@ -12,6 +12,7 @@
 /// \file Clusterer.cxx
 /// \brief Implementation of the ITS cluster finder
 #include <algorithm>
+#include <numeric>
 #include <TTree.h>
 #include "Framework/Logger.h"
 #include "ITSMFTBase/GeometryTGeo.h"
@@ -155,6 +156,172 @@ void Clusterer::process(int nThreads, PixelReader& reader, CompClusCont* compClu
 #endif
 }
 
+//__________________________________________________
+void Clusterer::process(int nThreads, ChipPixelDataBatch& batch, CompClusCont* compClus, PatternCont* patterns, ROFRecCont* vecROFRec)
+{
+  // clusterize all the ROFs of the batch at once: the work is split in blocks of consecutive chips
+  // (in ROF, then chip order) independently of the ROF boundaries. The clusters are then copied to their
+  // final destination at offsets given by the prefix sum of the block outputs, in the order of the blocks
+#ifdef _PERFORM_TIMING_
+  mTimer.Start(kFALSE);
+#endif
+  uint32_t nChips = batch.getNChips();
+  if (nThreads > int(nChips)) {
+    nThreads = nChips;
+  }
+  if (nThreads < 1) {
+    nThreads = 1;
+  }
+#ifdef WITH_OPENMP
+  omp_set_num_threads(nThreads);
+#else
+  nThreads = 1;
+#endif
+  if (nThreads > mThreads.size()) {
+    int oldSz = mThreads.size();
+    mThreads.resize(nThreads);
+    for (int i = oldSz; i < nThreads; i++) {
+      mThreads[i] = std::make_unique<ClustererThread>(this);
+    }
+  }
+
+  if (mMaxBCSeparationToMask > 0) {
+    maskBatch(batch);
+  }
+
+  uint32_t nBlocks = nThreads > 1 ? std::min(nChips, 8u * nThreads) : std::min(nChips, 1u);
+  mBatchBlocks.resize(nBlocks);
+  for (uint32_t ib = 0; ib < nBlocks; ib++) {
+    mBatchBlocks[ib].firstChip = uint64_t(nChips) * ib / nBlocks;
+    mBatchBlocks[ib].nChips = uint64_t(nChips) * (ib + 1) / nBlocks - mBatchBlocks[ib].firstChip;
+  }
+  mBatchChipNClus.resize(nChips);
+  auto clusOffset = compClus->size();
+  auto pattOffset = patterns ? patterns->size() : 0;
+
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  //>> start of MT region
+  for (int ib = 0; ib < int(nBlocks); ib++) {
+#ifdef WITH_OPENMP
+    int ith = omp_get_thread_num();
+#else
+    int ith = 0;
+#endif
+    auto& thread = *mThreads[ith];
+    // with a single thread the clusters are put directly to the destination
+    auto* compClusPtr = nThreads > 1 ? &thread.compClusters : compClus;
+    auto* patternsPtr = patterns ? (nThreads > 1 ? &thread.patterns : patterns) : nullptr;
+    auto& block = mBatchBlocks[ib];
+    block.thread = ith;
+    block.firstClus = compClusPtr->size();
+    block.firstPatt = patternsPtr ? patternsPtr->size() : 0;
+    for (auto ic = block.firstChip; ic < block.firstChip + block.nChips; ic++) {
+      auto nClusBefore = compClusPtr->size();
+      thread.processChip(&batch.getChip(ic), compClusPtr, patternsPtr, nullptr, nullptr);
+      mBatchChipNClus[ic] = compClusPtr->size() - nClusBefore;
+    }
+    block.nClus = compClusPtr->size() - block.firstClus;
+    block.nPatt = patternsPtr ? patternsPtr->size() - block.firstPatt : 0;
+  }
+  //<< end of MT region
+
+  if (mMaxBCSeparationToMask > 0) { // the last data of every chip will be used in the next batch to mask overflow pixels
+    for (size_t ig = 0; ig + 1 < mBatchChipGroups.size(); ig++) {
+      auto& chipData = batch.getChip(mBatchChipOrder[mBatchChipGroups[ig + 1] - 1]);
+      mChipsOld[chipData.getChipID()].swap(chipData);
+    }
+  }
+
+  // copy data of all threads to final destination
+  if (nThreads > 1) {
+#ifdef _PERFORM_TIMING_
+    mTimerMerge.Start(false);
+#endif
+    size_t nClTot = 0, nPattTot = 0;
+    for (auto& block : mBatchBlocks) {
+      block.destClus = clusOffset + nClTot;
+      block.destPatt = pattOffset + nPattTot;
+      nClTot += block.nClus;
+      nPattTot += block.nPatt;
+    }
+    compClus->resize(clusOffset + nClTot);
+    if (patterns) {
+      patterns->resize(pattOffset + nPattTot);
+    }
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int ib = 0; ib < int(nBlocks); ib++) {
+      const auto& block = mBatchBlocks[ib];
+      const auto& thread = *mThreads[block.thread];
+      auto clbeg = thread.compClusters.begin() + block.firstClus;
+      std::copy(clbeg, clbeg + block.nClus, compClus->begin() + block.destClus);
+      if (patterns) {
+        auto ptbeg = thread.patterns.begin() + block.firstPatt;
+        std::copy(ptbeg, ptbeg + block.nPatt, patterns->begin() + block.destPatt);
+      }
+    }
+    for (int ith = 0; ith < nThreads; ith++) {
+      mThreads[ith]->patterns.clear();
+      mThreads[ith]->compClusters.clear();
+    }
+#ifdef _PERFORM_TIMING_
+    mTimerMerge.Stop();
+#endif
+  }
+
+  auto firstClus = clusOffset;
+  for (const auto& rofEntry : batch.getROFs()) {
+    size_t nClus = 0;
+    for (auto ic = rofEntry.firstChip; ic < rofEntry.firstChip + rofEntry.nChips; ic++) {
+      nClus += mBatchChipNClus[ic];
+    }
+    vecROFRec->emplace_back(rofEntry.ir, 0, firstClus, nClus);
+    firstClus += nClus;
+  }
+#ifdef _PERFORM_TIMING_
+  mTimer.Stop();
+#endif
+}
+
+//__________________________________________________
+void Clusterer::maskBatch(ChipPixelDataBatch& batch)
+{
+  // mask the pixels fired in the previous ROF the chip was fired in. The ROFs of a given chip are processed
+  // in order, as in the ROF by ROF processing, but different chips are processed in parallel
+  uint32_t nChips = batch.getNChips();
+  mBatchChipOrder.resize(nChips);
+  std::iota(mBatchChipOrder.begin(), mBatchChipOrder.end(), 0);
+  std::stable_sort(mBatchChipOrder.begin(), mBatchChipOrder.end(), [&batch](uint32_t a, uint32_t b) {
+    return batch.getChip(a).getChipID() < batch.getChip(b).getChipID();
+  });
+  mBatchChipGroups.clear();
+  for (uint32_t i = 0; i < nChips; i++) {
+    if (i == 0 || batch.getChip(mBatchChipOrder[i]).getChipID() != batch.getChip(mBatchChipOrder[i - 1]).getChipID()) {
+      mBatchChipGroups.push_back(i);
+    }
+  }
+  mBatchChipGroups.push_back(nChips);
+
+  int nGroups = mBatchChipGroups.size() - 1;
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for (int ig = 0; ig < nGroups; ig++) {
+    const ChipPixelData* chipInPrevROF = &mChipsOld[batch.getChip(mBatchChipOrder[mBatchChipGroups[ig]]).getChipID()];
+    for (auto i = mBatchChipGroups[ig]; i < mBatchChipGroups[ig + 1]; i++) {
+      auto& curChipData = batch.getChip(mBatchChipOrder[i]);
+      const auto& ir = batch.getROF(batch.getChipROF(mBatchChipOrder[i])).ir;
+      if (std::abs(ir.differenceInBC(chipInPrevROF->getInteractionRecord())) < mMaxBCSeparationToMask) {
+        mMaxRowColDiffToMask ? curChipData.maskFiredInSample(*chipInPrevROF, mMaxRowColDiffToMask) : curChipData.maskFiredInSample(*chipInPrevROF);
+      }
+      chipInPrevROF = &curChipData;
+    }
+  }
+}
+
 //__________________________________________________
 void Clusterer::ClustererThread::process(uint16_t chip, uint16_t nChips, CompClusCont* compClusPtr, PatternCont* patternsPtr,
                                          const ConstMCTruth* labelsDigPtr, MCTruth* labelsClPtr, const ROFRecord& rofPtr)
@@ -172,22 +339,7 @@ void Clusterer::ClustererThread::process(uint16_t chip, uint16_t nChips, CompClu
         parent->mMaxRowColDiffToMask ? curChipData->maskFiredInSample(parent->mChipsOld[chipID], parent->mMaxRowColDiffToMask) : curChipData->maskFiredInSample(parent->mChipsOld[chipID]);
       }
     }
-    auto validPixID = curChipData->getFirstUnmasked();
-    auto npix = curChipData->getData().size();
-    if (validPixID < npix) { // chip data may have all of its pixels masked!
-      auto valp = validPixID++;
-      if (validPixID == npix) { // special case of a single pixel fired on the chip
-        finishChipSingleHitFast(valp, curChipData, compClusPtr, patternsPtr, labelsDigPtr, labelsClPtr);
-      } else {
-        initChip(curChipData, valp);
-        for (; validPixID < npix; validPixID++) {
-          if (!curChipData->getData()[validPixID].isMasked()) {
-            updateChip(curChipData, validPixID);
-          }
-        }
-        finishChip(curChipData, compClusPtr, patternsPtr, labelsDigPtr, labelsClPtr);
-      }
-    }
+    processChip(curChipData, compClusPtr, patternsPtr, labelsDigPtr, labelsClPtr);
     if (parent->mMaxBCSeparationToMask > 0) { // current chip data will be used in the next ROF to mask overflow pixels
       parent->mChipsOld[chipID].swap(*curChipData);
     }
@@ -198,6 +350,28 @@ void Clusterer::ClustererThread::process(uint16_t chip, uint16_t nChips, CompClu
   currStat.nPatt = patternsPtr ? (patternsPtr->size() - currStat.firstPatt) : 0;
 }
 
+//__________________________________________________
+void Clusterer::ClustererThread::processChip(ChipPixelData* curChipData, CompClusCont* compClusPtr, PatternCont* patternsPtr,
+                                             const ConstMCTruth* labelsDigPtr, MCTruth* labelsClPtr)
+{
+  auto validPixID = curChipData->getFirstUnmasked();
+  auto npix = curChipData->getData().size();
+  if (validPixID < npix) { // chip data may have all of its pixels masked!
+    auto valp = validPixID++;
+    if (validPixID == npix) { // special case of a single pixel fired on the chip
+      finishChipSingleHitFast(valp, curChipData, compClusPtr, patternsPtr, labelsDigPtr, labelsClPtr);
+    } else {
+      initChip(curChipData, valp);
+      for (; validPixID < npix; validPixID++) {
+        if (!curChipData->getData()[validPixID].isMasked()) {
+          updateChip(curChipData, validPixID);
+        }
+      }
+      finishChip(curChipData, compClusPtr, patternsPtr, labelsDigPtr, labelsClPtr);
+    }
+  }
+}
+
 //__________________________________________________
 void Clusterer::ClustererThread::finishChip(ChipPixelData* curChipData, CompClusCont* compClusPtr,
                                             PatternCont* patternsPtr, const ConstMCTruth* labelsDigPtr, MCTruth* labelsClusPtr)
@@ -163,6 +163,64 @@ int RawPixelDecoder<Mapping>::decodeNextTrigger(int iru)
   return ndec;
 }
 
+///______________________________________________________________
+/// Decode up to nMax next triggers and move their fired chips to the batch, return number of decoded triggers
+template <class Mapping>
+int RawPixelDecoder<Mapping>::decodeNextTriggers(ChipPixelDataBatch& batch, int nMax)
+{
+  batch.clear();
+  while (int(batch.getNROFs()) < nMax && decodeNextTrigger()) {
+    mTimerFetchData.Start(false);
+    batch.addROF(mInteractionRecord, mROFCounter);
+    // same order as in getNextChipData, the decoder gets back the emptied containers of the batch
+    for (; mCurRUDecodeID < mRUDecodeVec.size(); mCurRUDecodeID++) {
+      auto& ru = mRUDecodeVec[mCurRUDecodeID];
+      while (ru.lastChipChecked < ru.nChipsFired) {
+        batch.addChip().swap(ru.chipsData[ru.lastChipChecked++]);
+      }
+    }
+    while (!mOrderedChipsPtr.empty()) { // MFT chips, ordered by ensureChipOrdering
+      batch.addChip().swap(*mOrderedChipsPtr.back());
+      mOrderedChipsPtr.pop_back();
+    }
+    mTimerFetchData.Stop();
+  }
+  return batch.getNROFs();
+}
+
+///______________________________________________________________
+/// Set the offsets of the digits of every chip of the batch, return the total number of digits
+template <class Mapping>
+size_t RawPixelDecoder<Mapping>::setDigitOffsets(const ChipPixelDataBatch& batch)
+{
+  auto nChips = batch.getNChips();
+  mDigitOffsets.resize(nChips + 1);
+  mDigitOffsets[0] = 0;
+  for (size_t ic = 0; ic < nChips; ic++) {
+    mDigitOffsets[ic + 1] = mDigitOffsets[ic] + batch.getChip(ic).getData().size();
+  }
+  return mDigitOffsets[nChips];
+}
+
+///______________________________________________________________
+/// Write the digits of every chip of the batch at their offset, the chips are processed in parallel
+template <class Mapping>
+void RawPixelDecoder<Mapping>::fillDigits(const ChipPixelDataBatch& batch, Digit* digits) const
+{
+  int nChips = batch.getNChips();
+#ifdef WITH_OPENMP
+  omp_set_num_threads(mNThreads);
+#pragma omp parallel for schedule(dynamic, 16)
+#endif
+  for (int ic = 0; ic < nChips; ic++) {
+    const auto& chip = batch.getChip(ic);
+    auto* dest = digits + mDigitOffsets[ic];
+    for (const auto& hit : chip.getData()) {
+      *dest++ = Digit(chip.getChipID(), hit.getRow(), hit.getCol());
+    }
+  }
+}
+
 ///______________________________________________________________
 /// Setup links checking the very RDH of every input
 template <class Mapping>
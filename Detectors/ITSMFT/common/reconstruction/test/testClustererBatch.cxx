@@ -0,0 +1,189 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testClustererBatch.cxx
+/// \brief Test that the clusterization of batches of ROFs gives the same output as the ROF by ROF one
+
+#define BOOST_TEST_MODULE Test ITSMFT ClustererBatch
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "CommonDataFormat/InteractionRecord.h"
+#include "DataFormatsITSMFT/CompCluster.h"
+#include "DataFormatsITSMFT/Digit.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "ITSMFTReconstruction/ChipMappingITS.h"
+#include "ITSMFTReconstruction/Clusterer.h"
+#include "ITSMFTReconstruction/DigitPixelReader.h"
+#include "ITSMFTReconstruction/PixelData.h"
+
+using namespace o2::itsmft;
+
+namespace
+{
+constexpr int ROFLengthBC = 594;
+
+/// fired pixels of a ROF: (column, row) of every fired chip, ordered as in the decoded data
+struct ROFPixels {
+  o2::InteractionRecord ir;
+  std::map<uint16_t, std::set<std::pair<uint16_t, uint16_t>>> chips;
+};
+
+/// ROFs with a few clusters on random chips. Part of the pixels of a chip fired in the previous ROF
+/// fire again, to be masked
+std::vector<ROFPixels> generateROFs(int nROFs)
+{
+  std::mt19937 gen(1234);
+  std::uniform_int_distribution<int> chipDist(0, 299);
+  std::uniform_int_distribution<int> rowDist(1, 510);
+  std::uniform_int_distribution<int> colDist(1, 1022);
+  std::uniform_int_distribution<int> offsetDist(-1, 1);
+  std::uniform_int_distribution<int> nDist(1, 5);
+  std::bernoulli_distribution repeatDist(0.5);
+
+  std::vector<ROFPixels> rofs(nROFs);
+  std::map<uint16_t, std::set<std::pair<uint16_t, uint16_t>>> lastFired;
+  for (int iROF = 0; iROF < nROFs; iROF++) {
+    auto& rof = rofs[iROF];
+    rof.ir = o2::InteractionRecord(0, 1);
+    rof.ir += int64_t(iROF) * ROFLengthBC;
+    for (int iChip = 0; iChip < 60; iChip++) {
+      uint16_t chipID = chipDist(gen);
+      auto& pixels = rof.chips[chipID];
+      for (int iClus = nDist(gen); iClus--;) {
+        int row = rowDist(gen), col = colDist(gen);
+        for (int iPix = nDist(gen); iPix--;) {
+          pixels.emplace(col + offsetDist(gen), row + offsetDist(gen));
+        }
+      }
+      auto last = lastFired.find(chipID);
+      if (last != lastFired.end() && repeatDist(gen)) {
+        for (const auto& pixel : last->second) {
+          if (repeatDist(gen)) {
+            pixels.insert(pixel);
+          }
+        }
+      }
+    }
+    for (const auto& [chipID, pixels] : rof.chips) {
+      lastFired[chipID] = pixels;
+    }
+  }
+  return rofs;
+}
+
+void configure(Clusterer& clusterer)
+{
+  clusterer.setNChips(ChipMappingITS::getNChips());
+  clusterer.setContinuousReadOut(true);
+  clusterer.setMaxBCSeparationToMask(ROFLengthBC + 10);
+  clusterer.setMaxRowColDiffToMask(0);
+}
+
+struct Output {
+  std::vector<CompClusterExt> clusters;
+  std::vector<unsigned char> patterns;
+  std::vector<ROFRecord> rofs;
+};
+
+/// clusterize ROF by ROF from the digits
+Output clusterizePerROF(const std::vector<ROFPixels>& rofPixels)
+{
+  std::vector<Digit> digits;
+  std::vector<ROFRecord> digitROFs;
+  for (const auto& rof : rofPixels) {
+    int first = digits.size();
+    for (const auto& [chipID, pixels] : rof.chips) {
+      for (const auto& [col, row] : pixels) {
+        digits.emplace_back(chipID, row, col);
+      }
+    }
+    digitROFs.emplace_back(rof.ir, 0, first, digits.size() - first);
+  }
+
+  DigitPixelReader reader;
+  reader.setDigits(digits);
+  reader.setROFRecords(digitROFs);
+  reader.init();
+
+  Output output;
+  Clusterer clusterer;
+  configure(clusterer);
+  clusterer.process(1, reader, &output.clusters, &output.patterns, &output.rofs);
+  return output;
+}
+
+/// clusterize batches of batchSize ROFs, filled as by RawPixelDecoder::decodeNextTriggers
+Output clusterizeBatches(const std::vector<ROFPixels>& rofPixels, int batchSize, int nThreads)
+{
+  Output output;
+  Clusterer clusterer;
+  configure(clusterer);
+  ChipPixelDataBatch batch;
+  for (size_t firstROF = 0; firstROF < rofPixels.size(); firstROF += batchSize) {
+    batch.clear();
+    for (size_t iROF = firstROF; iROF < std::min(rofPixels.size(), firstROF + batchSize); iROF++) {
+      const auto& rof = rofPixels[iROF];
+      batch.addROF(rof.ir, iROF);
+      for (const auto& [chipID, pixels] : rof.chips) {
+        auto& chip = batch.addChip();
+        chip.setChipID(chipID);
+        chip.setROFrame(iROF);
+        chip.setInteractionRecord(rof.ir);
+        for (const auto& [col, row] : pixels) {
+          chip.getData().emplace_back(row, col);
+        }
+      }
+    }
+    clusterer.process(nThreads, batch, &output.clusters, &output.patterns, &output.rofs);
+  }
+  return output;
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ClustererBatch_test)
+{
+  const auto rofPixels = generateROFs(20);
+  const auto reference = clusterizePerROF(rofPixels);
+  BOOST_REQUIRE_EQUAL(reference.rofs.size(), rofPixels.size());
+  BOOST_REQUIRE(!reference.clusters.empty());
+
+  for (int batchSize : {1, 6, 20}) {
+    for (int nThreads : {1, 2, 4}) {
+      const auto output = clusterizeBatches(rofPixels, batchSize, nThreads);
+
+      BOOST_REQUIRE_EQUAL(output.rofs.size(), reference.rofs.size());
+      for (size_t i = 0; i < reference.rofs.size(); i++) {
+        BOOST_CHECK(output.rofs[i].getBCData() == reference.rofs[i].getBCData());
+        BOOST_CHECK_EQUAL(output.rofs[i].getFirstEntry(), reference.rofs[i].getFirstEntry());
+        BOOST_CHECK_EQUAL(output.rofs[i].getNEntries(), reference.rofs[i].getNEntries());
+      }
+      BOOST_REQUIRE_EQUAL(output.clusters.size(), reference.clusters.size());
+      for (size_t i = 0; i < reference.clusters.size(); i++) {
+        BOOST_CHECK_EQUAL(output.clusters[i].getChipID(), reference.clusters[i].getChipID());
+        BOOST_CHECK_EQUAL(output.clusters[i].getRow(), reference.clusters[i].getRow());
+        BOOST_CHECK_EQUAL(output.clusters[i].getCol(), reference.clusters[i].getCol());
+        BOOST_CHECK_EQUAL(output.clusters[i].getPatternID(), reference.clusters[i].getPatternID());
+      }
+      BOOST_CHECK_EQUAL_COLLECTIONS(output.patterns.begin(), output.patterns.end(),
+                                    reference.patterns.begin(), reference.patterns.end());
+    }
+  }
+}
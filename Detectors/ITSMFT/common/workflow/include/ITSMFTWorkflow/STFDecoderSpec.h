@@ -52,6 +52,7 @@ class STFDecoder : public Task
   bool mDoDigits = false;
   bool mDoCalibData = false;
   int mNThreads = 1;
+  int mNROFsBatch = 1; // number of ROFs decoded and clustered in one go
   size_t mTFCounter = 0;
   size_t mEstNDig = 0;
   size_t mEstNClus = 0;
@@ -63,6 +64,7 @@ class STFDecoder : public Task
   std::string mNoiseName;
   std::unique_ptr<RawPixelDecoder<Mapping>> mDecoder;
   std::unique_ptr<Clusterer> mClusterer;
+  ChipPixelDataBatch mROFBatch;
 };
 
 using STFDecoderITS = STFDecoder<ChipMappingITS>;
@@ -36,6 +36,7 @@ EntropyDecoderSpec::EntropyDecoderSpec(o2::header::DataOrigin orig)
 void EntropyDecoderSpec::init(o2::framework::InitContext& ic)
 {
   std::string dictPath = ic.options().get<std::string>("ctf-dict");
+  mCTFCoder.setNThreads(ic.options().get<int>("ctf-threads"));
   if (!dictPath.empty() && dictPath != "none") {
     mCTFCoder.createCoders(dictPath, o2::ctf::CTFCoderBase::OpType::Decoder);
   }
@@ -78,7 +79,8 @@ DataProcessorSpec getEntropyDecoderSpec(o2::header::DataOrigin orig)
     Inputs{InputSpec{"ctf", orig, "CTFDATA", 0, Lifetime::Timeframe}},
     outputs,
     AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>(orig)},
-    Options{{"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF decoding dictionary"}}}};
+    Options{{"ctf-dict", VariantType::String, o2::base::NameConf::getCTFDictFileName(), {"File of CTF decoding dictionary"}},
+            {"ctf-threads", VariantType::Int, 1, {"Number of threads for concurrent entropy decoding of CTF blocks"}}}};
 }
 
 } // namespace itsmft
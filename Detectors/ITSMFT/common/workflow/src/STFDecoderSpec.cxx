@@ -59,6 +59,11 @@ void STFDecoder<Mapping>::init(InitContext& ic)
   auto detID = Mapping::getDetID();
   mNThreads = std::max(1, ic.options().get<int>("nthreads"));
   mDecoder->setNThreads(mNThreads);
+  mNROFsBatch = std::max(1, ic.options().get<int>("rof-batch"));
+  if (mNROFsBatch > 1 && mDoCalibData) {
+    LOG(WARNING) << mSelfName << " Batched ROF processing is not supported with calibration data, imposing 1 ROF per batch";
+    mNROFsBatch = 1;
+  }
   mDecoder->setFormat(ic.options().get<bool>("old-format") ? GBTLink::OldFormat : GBTLink::NewFormat);
   mDecoder->setVerbosity(ic.options().get<int>("decoder-verbosity"));
   mDecoder->setFillCalibData(mDoCalibData);
@@ -132,15 +137,26 @@ void STFDecoder<Mapping>::run(ProcessingContext& pc)
   }
 
   mDecoder->setDecodeNextAuto(false);
-  while (mDecoder->decodeNextTrigger()) {
-    if (mDoDigits) {                                    // call before clusterization, since the latter will hide the digits
-      mDecoder->fillDecodedDigits(digVec, digROFVec);   // lot of copying involved
-      if (mDoCalibData) {
-        mDecoder->fillCalibData(calVec);
+  if (mNROFsBatch > 1) {
+    while (mDecoder->decodeNextTriggers(mROFBatch, mNROFsBatch)) {
+      if (mDoDigits) { // call before clusterization, since the latter will hide the digits
+        mDecoder->fillDecodedDigits(mROFBatch, digVec, digROFVec);
+      }
+      if (mDoClusters) {
+        mClusterer->process(mNThreads, mROFBatch, &clusCompVec, mDoPatterns ? &clusPattVec : nullptr, &clusROFVec);
       }
     }
-    if (mDoClusters) { // !!! THREADS !!!
-      mClusterer->process(mNThreads, *mDecoder.get(), &clusCompVec, mDoPatterns ? &clusPattVec : nullptr, &clusROFVec);
+  } else {
+    while (mDecoder->decodeNextTrigger()) {
+      if (mDoDigits) {                                  // call before clusterization, since the latter will hide the digits
+        mDecoder->fillDecodedDigits(digVec, digROFVec); // lot of copying involved
+        if (mDoCalibData) {
+          mDecoder->fillCalibData(calVec);
+        }
+      }
+      if (mDoClusters) { // !!! THREADS !!!
+        mClusterer->process(mNThreads, *mDecoder.get(), &clusCompVec, mDoPatterns ? &clusPattVec : nullptr, &clusROFVec);
+      }
     }
   }
 
@@ -221,6 +237,7 @@ DataProcessorSpec getSTFDecoderITSSpec(bool doClusters, bool doPatterns, bool do
     AlgorithmSpec{adaptFromTask<STFDecoder<ChipMappingITS>>(doClusters, doPatterns, doDigits, doCalib, dict, noise)},
     Options{
       {"nthreads", VariantType::Int, 1, {"Number of decoding/clustering threads"}},
+      {"rof-batch", VariantType::Int, 1, {"Number of ROFs decoded and clustered in one go (not applied to calibration data)"}},
       {"old-format", VariantType::Bool, false, {"Use old format (1 trigger per CRU page)"}},
       {"decoder-verbosity", VariantType::Int, 0, {"Verbosity level (-1: silent, 0: errors, 1: headers, 2: data)"}}}};
 }
@@ -257,6 +274,7 @@ DataProcessorSpec getSTFDecoderMFTSpec(bool doClusters, bool doPatterns, bool do
     AlgorithmSpec{adaptFromTask<STFDecoder<ChipMappingMFT>>(doClusters, doPatterns, doDigits, doCalib, dict, noise)},
     Options{
       {"nthreads", VariantType::Int, 1, {"Number of decoding/clustering threads"}},
+      {"rof-batch", VariantType::Int, 1, {"Number of ROFs decoded and clustered in one go (not applied to calibration data)"}},
       {"old-format", VariantType::Bool, false, {"Use old format (1 trigger per CRU page)"}},
       {"decoder-verbosity", VariantType::Int, 0, {"Verbosity level (-1: silent, 0: errors, 1: headers, 2: data)"}}}};
 }
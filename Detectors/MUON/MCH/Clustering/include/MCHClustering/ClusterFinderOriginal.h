@@ -20,13 +20,12 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <random>
 #include <utility>
 #include <vector>
 
 #include <gsl/span>
 
-#include <TH2D.h>
-
 #include "DataFormatsMCH/Digit.h"
 #include "MCHBase/ClusterBlock.h"
 #include "MCHMappingInterface/Segmentation.h"
@@ -40,6 +39,8 @@ namespace mch
 class PadOriginal;
 class ClusterOriginal;
 class MathiesonOriginal;
+template <typename T>
+class PixelGrid;
 
 class ClusterFinderOriginal
 {
@@ -74,18 +75,18 @@ class ClusterFinderOriginal
   void processPreCluster();
 
   void buildPixArray();
-  void ProjectPadOverPixels(const PadOriginal& pad, TH2D& hCharges, TH2I& hEntries) const;
+  void ProjectPadOverPixels(const PadOriginal& pad, PixelGrid<double>& charges, PixelGrid<int>& entries) const;
 
-  void findLocalMaxima(std::unique_ptr<TH2D>& histAnode, std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima);
-  void flagLocalMaxima(const TH2D& histAnode, int i0, int j0, std::vector<std::vector<int>>& isLocalMax) const;
-  void restrictPreCluster(const TH2D& histAnode, int i0, int j0);
+  void findLocalMaxima(PixelGrid<double>& gridAnode, std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima);
+  void flagLocalMaxima(const PixelGrid<double>& gridAnode, int i0, int j0, std::vector<int>& isLocalMax) const;
+  void restrictPreCluster(const PixelGrid<double>& gridAnode, int i0, int j0);
 
   void processSimple();
   void process();
   void addVirtualPad();
   void computeCoefficients(std::vector<double>& coef, std::vector<double>& prob) const;
   double mlem(const std::vector<double>& coef, const std::vector<double>& prob, int nIter);
-  void findCOG(const TH2D& histMLEM, double xy[2]) const;
+  void findCOG(const PixelGrid<double>& gridMLEM, double xy[2]) const;
   void refinePixelArray(const double xyCOG[2], size_t nPixMax, double& xMin, double& xMax, double& yMin, double& yMax);
   void cleanPixelArray(double threshold, std::vector<double>& prob);
 
@@ -96,8 +97,8 @@ class ClusterFinderOriginal
   void param2ChargeFraction(const double param[SNFitParamMax], int nParamUsed, double fraction[SNFitClustersMax]) const;
   float chargeIntegration(double x, double y, const PadOriginal& pad) const;
 
-  void split(const TH2D& histMLEM, const std::vector<double>& coef);
-  void addPixel(const TH2D& histMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<std::vector<bool>>& isUsed);
+  void split(const PixelGrid<double>& gridMLEM, const std::vector<double>& coef);
+  void addPixel(const PixelGrid<double>& gridMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<int>& isUsed);
   void addCluster(int iCluster, std::vector<int>& coupledClusters, std::vector<bool>& isClUsed,
                   const std::vector<std::vector<double>>& couplingClCl) const;
   void extractLeastCoupledClusters(std::vector<int>& coupledClusters, std::vector<int>& clustersForFit,
@@ -123,6 +124,22 @@ class ClusterFinderOriginal
   std::unique_ptr<ClusterOriginal> mPreCluster; ///< precluster currently processed
   std::vector<PadOriginal> mPixels;             ///< list of pixels for the current precluster
 
+  /// buffers reused from one precluster to the next to avoid allocations
+  std::unique_ptr<PixelGrid<double>> mGridCharges; ///< pixel charges used to build the pixel array
+  std::unique_ptr<PixelGrid<int>> mGridEntries;    ///< pixel entries used to build the pixel array
+  std::unique_ptr<PixelGrid<double>> mGridAnode;   ///< pixel charges used to find the local maxima
+  std::unique_ptr<PixelGrid<double>> mGridMLEM;    ///< pixel charges after MLEM used to split the precluster
+  std::vector<int> mGridFlags{};                   ///< status of the pixels of the current grid
+  std::vector<double> mCoef{};                     ///< pad-pixel coupling coefficients
+  std::vector<double> mProb{};                     ///< pixel visibilities
+  std::vector<double> mPixelCharges{};             ///< pixel charges during the MLEM iterations
+  std::vector<double> mPixelSums{};                ///< pixel charge expectations during the MLEM iterations
+  std::vector<double> mPixelNorms{};               ///< pixel normalizations during the MLEM iterations
+  std::vector<double> mPadSums{};                  ///< pad charge expectations during the MLEM iterations
+  std::vector<int> mMLEMPads{};                    ///< indices of the pads used in the MLEM iterations
+
+  mutable std::mt19937 mRandom{}; ///< random generator used in the fit, reseeded for every precluster
+
   const mapping::Segmentation* mSegmentation = nullptr; ///< pointer to the DE segmentation for the current precluster
 
   std::vector<ClusterStruct> mClusters{}; ///< list of reconstructed clusters
@@ -0,0 +1,103 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ClusterFinderOriginalParallel.h
+/// \brief Definition of a class to run the original MLEM cluster finder on several threads
+
+#ifndef ALICEO2_MCH_CLUSTERFINDERORIGINALPARALLEL_H_
+#define ALICEO2_MCH_CLUSTERFINDERORIGINALPARALLEL_H_
+
+#include <memory>
+#include <vector>
+
+#include <gsl/span>
+
+#include "DataFormatsMCH/Digit.h"
+#include "MCHBase/ClusterBlock.h"
+#include "MCHBase/PreCluster.h"
+#include "MCHClustering/ClusterFinderOriginal.h"
+
+namespace o2
+{
+namespace mch
+{
+
+/// Clusterize the preclusters of an event in parallel, with one ClusterFinderOriginal per thread.
+/// The preclusters are grouped in consecutive blocks distributed dynamically to the threads and the
+/// clusters are then collected in the order of the blocks, so that the output does not depend on the
+/// number of threads.
+class ClusterFinderOriginalParallel
+{
+ public:
+  ClusterFinderOriginalParallel() = default;
+  ~ClusterFinderOriginalParallel() = default;
+
+  ClusterFinderOriginalParallel(const ClusterFinderOriginalParallel&) = delete;
+  ClusterFinderOriginalParallel& operator=(const ClusterFinderOriginalParallel&) = delete;
+  ClusterFinderOriginalParallel(ClusterFinderOriginalParallel&&) = delete;
+  ClusterFinderOriginalParallel& operator=(ClusterFinderOriginalParallel&&) = delete;
+
+  void init(bool run2Config, int nThreads);
+  void deinit();
+
+  void findClusters(gsl::span<const PreCluster> preClusters, gsl::span<const Digit> digits);
+
+  /// return the number of clusters reconstructed in the last event
+  size_t getNClusters() const { return mNClusters; }
+
+  /// append the clusters reconstructed in the last event and their digits to the output vectors,
+  /// with the references to the digits and the cluster indices updated to their position in these vectors
+  template <typename ClusterVector, typename DigitVector>
+  void appendClusters(ClusterVector& clusters, DigitVector& usedDigits) const;
+
+ private:
+  /// group of consecutive preclusters and location of its results in the cluster finder that processed it
+  struct Block {
+    size_t firstPreCluster = 0; ///< index of the first precluster of the block
+    size_t nPreClusters = 0;    ///< number of preclusters in the block
+    int finder = 0;             ///< index of the cluster finder used
+    size_t firstCluster = 0;    ///< index of the first cluster of the block in the cluster finder
+    size_t nClusters = 0;       ///< number of clusters of the block
+    size_t firstDigit = 0;      ///< index of the first used digit of the block in the cluster finder
+    size_t nDigits = 0;         ///< number of used digits of the block
+  };
+
+  std::vector<std::unique_ptr<ClusterFinderOriginal>> mClusterFinders{}; ///< one cluster finder per thread
+  std::vector<Block> mBlocks{};                                          ///< blocks of preclusters of the last event
+  size_t mNClusters = 0;                                                 ///< number of clusters of the last event
+};
+
+//_________________________________________________________________________________________________
+template <typename ClusterVector, typename DigitVector>
+void ClusterFinderOriginalParallel::appendClusters(ClusterVector& clusters, DigitVector& usedDigits) const
+{
+  clusters.reserve(clusters.size() + mNClusters);
+  auto clusterOffset = clusters.size();
+  for (const auto& block : mBlocks) {
+    const auto& finder = *mClusterFinders[block.finder];
+    auto digitOffset = usedDigits.size();
+    auto itFirstDigit = finder.getUsedDigits().begin() + block.firstDigit;
+    usedDigits.insert(usedDigits.end(), itFirstDigit, itFirstDigit + block.nDigits);
+    auto itFirstCluster = finder.getClusters().begin() + block.firstCluster;
+    for (auto itCluster = itFirstCluster; itCluster < itFirstCluster + block.nClusters; ++itCluster) {
+      int clusterIndex = clusters.size() - clusterOffset;
+      clusters.push_back(*itCluster);
+      auto& cluster = clusters.back();
+      cluster.uid = ClusterStruct::buildUniqueId(cluster.getChamberId(), cluster.getDEId(), clusterIndex);
+      cluster.firstDigit = cluster.firstDigit - block.firstDigit + digitOffset;
+    }
+  }
+}
+
+} // namespace mch
+} // namespace o2
+
+#endif // ALICEO2_MCH_CLUSTERFINDERORIGINALPARALLEL_H_
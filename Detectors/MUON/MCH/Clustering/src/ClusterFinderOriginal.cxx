@@ -28,10 +28,7 @@
 #include <stdexcept>
 #include <string>
 
-#include <TH2I.h>
-#include <TAxis.h>
 #include <TMath.h>
-#include <TRandom.h>
 
 #include <FairMQLogger.h>
 
@@ -39,6 +36,7 @@
 #include "PadOriginal.h"
 #include "ClusterOriginal.h"
 #include "MathiesonOriginal.h"
+#include "PixelGrid.h"
 
 namespace o2
 {
@@ -48,7 +46,11 @@ namespace mch
 //_________________________________________________________________________________________________
 ClusterFinderOriginal::ClusterFinderOriginal()
   : mMathiesons(std::make_unique<MathiesonOriginal[]>(2)),
-    mPreCluster(std::make_unique<ClusterOriginal>())
+    mPreCluster(std::make_unique<ClusterOriginal>()),
+    mGridCharges(std::make_unique<PixelGrid<double>>()),
+    mGridEntries(std::make_unique<PixelGrid<int>>()),
+    mGridAnode(std::make_unique<PixelGrid<double>>()),
+    mGridMLEM(std::make_unique<PixelGrid<double>>())
 {
   /// default constructor
 }
@@ -135,6 +137,9 @@ void ClusterFinderOriginal::findClusters(gsl::span<const Digit> digits)
   // set the Mathieson function to be used
   mMathieson = (digits[0].getDetID() < 300) ? &mMathiesons[0] : &mMathiesons[1];
 
+  // make the result independent of the preclusters processed before
+  mRandom.seed(std::mt19937::default_seed);
+
   // reset the current precluster being processed
   resetPreCluster(digits);
 
@@ -402,9 +407,8 @@ void ClusterFinderOriginal::processPreCluster()
   } else {
 
     // find the local maxima in the pixel array
-    std::unique_ptr<TH2D> histAnode(nullptr);
     std::multimap<double, std::pair<int, int>, std::greater<>> localMaxima{};
-    findLocalMaxima(histAnode, localMaxima);
+    findLocalMaxima(*mGridAnode, localMaxima);
     if (localMaxima.empty()) {
       return;
     }
@@ -420,7 +424,7 @@ void ClusterFinderOriginal::processPreCluster()
       for (const auto& localMaximum : localMaxima) {
 
         // select the part of the precluster that is around the local maximum
-        restrictPreCluster(*histAnode, localMaximum.second.first, localMaximum.second.second);
+        restrictPreCluster(*mGridAnode, localMaximum.second.first, localMaximum.second.second);
 
         // treat it
         process();
@@ -490,23 +494,23 @@ void ClusterFinderOriginal::buildPixArray()
     area[ixy][1] = area[ixy][0] + nbins[ixy] * width[ixy] * 2.;
   }
 
-  // book pixel histograms and fill them
-  TH2D hCharges("Charges", "", nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
-  TH2I hEntries("Entries", "", nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
+  // reset pixel grids and fill them
+  mGridCharges->reset(nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
+  mGridEntries->reset(nbins[0], area[0][0], area[0][1], nbins[1], area[1][0], area[1][1]);
   for (const auto& pad : *mPreCluster) {
-    ProjectPadOverPixels(pad, hCharges, hEntries);
+    ProjectPadOverPixels(pad, *mGridCharges, *mGridEntries);
   }
 
   // store fired pixels with an entry from both planes if both planes are fired
   for (int i = 1; i <= nbins[0]; ++i) {
-    double x = hCharges.GetXaxis()->GetBinCenter(i);
+    double x = mGridCharges->binCenter(0, i);
     for (int j = 1; j <= nbins[1]; ++j) {
-      int entries = hEntries.GetBinContent(i, j);
+      int entries = mGridEntries->content(i, j);
       if (entries == 0 || (plane0 != plane1 && (entries < 1000 || entries % 1000 < 1))) {
         continue;
       }
-      double y = hCharges.GetYaxis()->GetBinCenter(j);
-      double charge = hCharges.GetBinContent(i, j);
+      double y = mGridCharges->binCenter(1, j);
+      double charge = mGridCharges->content(i, j);
       mPixels.emplace_back(x, y, width[0], width[1], charge);
     }
   }
@@ -530,39 +534,36 @@ void ClusterFinderOriginal::buildPixArray()
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::ProjectPadOverPixels(const PadOriginal& pad, TH2D& hCharges, TH2I& hEntries) const
+void ClusterFinderOriginal::ProjectPadOverPixels(const PadOriginal& pad, PixelGrid<double>& charges, PixelGrid<int>& entries) const
 {
-  /// project the pad over pixel histograms
-
-  const TAxis* xaxis = hCharges.GetXaxis();
-  const TAxis* yaxis = hCharges.GetYaxis();
+  /// project the pad over pixel grids
 
-  int iMin = TMath::Max(1, xaxis->FindBin(pad.x() - pad.dx() + SDistancePrecision));
-  int iMax = TMath::Min(hCharges.GetNbinsX(), xaxis->FindBin(pad.x() + pad.dx() - SDistancePrecision));
-  int jMin = TMath::Max(1, yaxis->FindBin(pad.y() - pad.dy() + SDistancePrecision));
-  int jMax = TMath::Min(hCharges.GetNbinsY(), yaxis->FindBin(pad.y() + pad.dy() - SDistancePrecision));
+  int iMin = TMath::Max(1, charges.findBin(0, pad.x() - pad.dx() + SDistancePrecision));
+  int iMax = TMath::Min(charges.nBinsX(), charges.findBin(0, pad.x() + pad.dx() - SDistancePrecision));
+  int jMin = TMath::Max(1, charges.findBin(1, pad.y() - pad.dy() + SDistancePrecision));
+  int jMax = TMath::Min(charges.nBinsY(), charges.findBin(1, pad.y() + pad.dy() - SDistancePrecision));
 
   double charge = pad.charge();
   int entry = 1 + pad.plane() * 999;
 
-  for (int i = iMin; i <= iMax; ++i) {
-    for (int j = jMin; j <= jMax; ++j) {
-      int entries = hEntries.GetBinContent(i, j);
-      hCharges.SetBinContent(i, j, (entries > 0) ? TMath::Min(hCharges.GetBinContent(i, j), charge) : charge);
-      hEntries.SetBinContent(i, j, entries + entry);
+  for (int j = jMin; j <= jMax; ++j) {
+    for (int i = iMin; i <= iMax; ++i) {
+      int nEntries = entries.content(i, j);
+      charges.setContent(i, j, (nEntries > 0) ? TMath::Min(charges.content(i, j), charge) : charge);
+      entries.setContent(i, j, nEntries + entry);
     }
   }
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
+void ClusterFinderOriginal::findLocalMaxima(PixelGrid<double>& gridAnode,
                                             std::multimap<double, std::pair<int, int>, std::greater<>>& localMaxima)
 {
   /// find local maxima in pixel space for large preclusters in order to
   /// try to split them into smaller pieces (to speed up the MLEM procedure)
   /// and tag the corresponding pixels
 
-  // create a 2D histogram from the pixel array
+  // fill a 2D grid from the pixel array
   double xMin(std::numeric_limits<double>::max()), xMax(-std::numeric_limits<double>::max());
   double yMin(std::numeric_limits<double>::max()), yMax(-std::numeric_limits<double>::max());
   double dx(mPixels.front().dx()), dy(mPixels.front().dy());
@@ -574,29 +575,28 @@ void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
   }
   int nBinsX = TMath::Nint((xMax - xMin) / dx / 2.) + 1;
   int nBinsY = TMath::Nint((yMax - yMin) / dy / 2.) + 1;
-  histAnode = std::make_unique<TH2D>("anode", "anode", nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
+  gridAnode.reset(nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
   for (const auto& pixel : mPixels) {
-    histAnode->Fill(pixel.x(), pixel.y(), pixel.charge());
+    gridAnode.fill(pixel.x(), pixel.y(), pixel.charge());
   }
 
   // find the local maxima
-  std::vector<std::vector<int>> isLocalMax(nBinsX, std::vector<int>(nBinsY, 0));
+  std::vector<int>& isLocalMax = mGridFlags;
+  isLocalMax.assign(nBinsX * nBinsY, 0);
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
-      if (isLocalMax[i - 1][j - 1] == 0 && histAnode->GetBinContent(i, j) >= mLowestPixelCharge) {
-        flagLocalMaxima(*histAnode, i, j, isLocalMax);
+      if (isLocalMax[gridAnode.index(i, j)] == 0 && gridAnode.content(i, j) >= mLowestPixelCharge) {
+        flagLocalMaxima(gridAnode, i, j, isLocalMax);
       }
     }
   }
 
   // store local maxima and tag corresponding pixels
-  TAxis* xAxis = histAnode->GetXaxis();
-  TAxis* yAxis = histAnode->GetYaxis();
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
-      if (isLocalMax[i - 1][j - 1] > 0) {
-        localMaxima.emplace(histAnode->GetBinContent(i, j), std::make_pair(i, j));
-        auto itPixel = findPad(mPixels, xAxis->GetBinCenter(i), yAxis->GetBinCenter(j), mLowestPixelCharge);
+      if (isLocalMax[gridAnode.index(i, j)] > 0) {
+        localMaxima.emplace(gridAnode.content(i, j), std::make_pair(i, j));
+        auto itPixel = findPad(mPixels, gridAnode.binCenter(0, i), gridAnode.binCenter(1, j), mLowestPixelCharge);
         itPixel->setStatus(PadOriginal::kMustKeep);
         if (localMaxima.size() > 99) {
           break;
@@ -611,72 +611,68 @@ void ClusterFinderOriginal::findLocalMaxima(std::unique_ptr<TH2D>& histAnode,
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::flagLocalMaxima(const TH2D& histAnode, int i0, int j0, std::vector<std::vector<int>>& isLocalMax) const
+void ClusterFinderOriginal::flagLocalMaxima(const PixelGrid<double>& gridAnode, int i0, int j0, std::vector<int>& isLocalMax) const
 {
   /// flag the bin (i,j) as a local maximum or not by comparing its charge to the one of its neighbours
   /// and flag the neighbours accordingly (recursive procedure in case the charges are equal)
 
-  int idxi0 = i0 - 1;
-  int idxj0 = j0 - 1;
-  int charge0 = TMath::Nint(histAnode.GetBinContent(i0, j0));
+  auto idx0 = gridAnode.index(i0, j0);
+  int charge0 = TMath::Nint(gridAnode.content(i0, j0));
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histAnode.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(gridAnode.nBinsX(), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histAnode.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(gridAnode.nBinsY(), j0 + 1);
 
   for (int j = jMin; j <= jMax; ++j) {
-    int idxj = j - 1;
     for (int i = iMin; i <= iMax; ++i) {
       if (i == i0 && j == j0) {
         continue;
       }
-      int idxi = i - 1;
-      int charge = TMath::Nint(histAnode.GetBinContent(i, j));
+      auto idx = gridAnode.index(i, j);
+      int charge = TMath::Nint(gridAnode.content(i, j));
       if (charge0 < charge) {
-        isLocalMax[idxi0][idxj0] = -1;
+        isLocalMax[idx0] = -1;
         return;
       } else if (charge0 > charge) {
-        isLocalMax[idxi][idxj] = -1;
-      } else if (isLocalMax[idxi][idxj] == -1) {
-        isLocalMax[idxi0][idxj0] = -1;
+        isLocalMax[idx] = -1;
+      } else if (isLocalMax[idx] == -1) {
+        isLocalMax[idx0] = -1;
         return;
-      } else if (isLocalMax[idxi][idxj] == 0) {
-        isLocalMax[idxi0][idxj0] = 1;
-        flagLocalMaxima(histAnode, i, j, isLocalMax);
-        if (isLocalMax[idxi][idxj] == -1) {
-          isLocalMax[idxi0][idxj0] = -1;
+      } else if (isLocalMax[idx] == 0) {
+        isLocalMax[idx0] = 1;
+        flagLocalMaxima(gridAnode, i, j, isLocalMax);
+        if (isLocalMax[idx] == -1) {
+          isLocalMax[idx0] = -1;
           return;
         } else {
-          isLocalMax[idxi][idxj] = -2;
+          isLocalMax[idx] = -2;
         }
       }
     }
   }
-  isLocalMax[idxi0][idxj0] = 1;
+  isLocalMax[idx0] = 1;
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::restrictPreCluster(const TH2D& histAnode, int i0, int j0)
+void ClusterFinderOriginal::restrictPreCluster(const PixelGrid<double>& gridAnode, int i0, int j0)
 {
   /// keep in the pixel array only the ones around the local maximum
   /// and tag the pads in the precluster that overlap with them
 
   // drop all pixels from the array and put back the ones around the local maximum
   mPixels.clear();
-  const TAxis* xAxis = histAnode.GetXaxis();
-  const TAxis* yAxis = histAnode.GetYaxis();
-  double dx = xAxis->GetBinWidth(1) / 2.;
-  double dy = yAxis->GetBinWidth(1) / 2.;
-  double charge0 = histAnode.GetBinContent(i0, j0);
+  double dx = gridAnode.binWidth(0) / 2.;
+  double dy = gridAnode.binWidth(1) / 2.;
+  double charge0 = gridAnode.content(i0, j0);
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histAnode.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(gridAnode.nBinsX(), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histAnode.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(gridAnode.nBinsY(), j0 + 1);
   for (int j = jMin; j <= jMax; ++j) {
     for (int i = iMin; i <= iMax; ++i) {
-      double charge = histAnode.GetBinContent(i, j);
+      double charge = gridAnode.content(i, j);
       if (charge >= mLowestPixelCharge && charge <= charge0) {
-        mPixels.emplace_back(xAxis->GetBinCenter(i), yAxis->GetBinCenter(j), dx, dy, charge);
+        mPixels.emplace_back(gridAnode.binCenter(0, i), gridAnode.binCenter(1, j), dx, dy, charge);
       }
     }
   }
@@ -704,8 +700,8 @@ void ClusterFinderOriginal::processSimple()
   addVirtualPad();
 
   // calculate pad-pixel coupling coefficients and pixel visibilities
-  std::vector<double> coef(0);
-  std::vector<double> prob(0);
+  std::vector<double>& coef = mCoef;
+  std::vector<double>& prob = mProb;
   computeCoefficients(coef, prob);
 
   // discard "invisible" pixels
@@ -768,7 +764,7 @@ void ClusterFinderOriginal::process()
     }
   }
 
-  // compute the limits of the histogram based on the current pixel array
+  // compute the limits of the grid based on the current pixel array
   double xMin(std::numeric_limits<double>::max()), xMax(-std::numeric_limits<double>::max());
   double yMin(std::numeric_limits<double>::max()), yMax(-std::numeric_limits<double>::max());
   for (const auto& pixel : mPixels) {
@@ -778,9 +774,9 @@ void ClusterFinderOriginal::process()
     yMax = TMath::Max(yMax, pixel.y());
   }
 
-  std::vector<double> coef(0);
-  std::vector<double> prob(0);
-  std::unique_ptr<TH2D> histMLEM(nullptr);
+  std::vector<double>& coef = mCoef;
+  std::vector<double>& prob = mProb;
+  PixelGrid<double>& gridMLEM = *mGridMLEM;
   while (true) {
 
     // calculate pad-pixel coupling coefficients and pixel visibilities
@@ -801,14 +797,13 @@ void ClusterFinderOriginal::process()
       return;
     }
 
-    // create a 2D histogram from the pixel array
+    // fill a 2D grid from the pixel array
     double dx(mPixels.front().dx()), dy(mPixels.front().dy());
     int nBinsX = TMath::Nint((xMax - xMin) / dx / 2.) + 1;
     int nBinsY = TMath::Nint((yMax - yMin) / dy / 2.) + 1;
-    histMLEM.reset(nullptr); // delete first to avoid "Replacing existing TH1: mlem (Potential memory leak)"
-    histMLEM = std::make_unique<TH2D>("mlem", "mlem", nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
+    gridMLEM.reset(nBinsX, xMin - dx, xMax + dx, nBinsY, yMin - dy, yMax + dy);
     for (const auto& pixel : mPixels) {
-      histMLEM->Fill(pixel.x(), pixel.y(), pixel.charge());
+      gridMLEM.fill(pixel.x(), pixel.y(), pixel.charge());
     }
 
     // stop here if the pixel size is small enough
@@ -818,14 +813,14 @@ void ClusterFinderOriginal::process()
 
     // calculate the position of the center-of-gravity around the pixel with maximum charge
     double xyCOG[2] = {0., 0.};
-    findCOG(*histMLEM, xyCOG);
+    findCOG(gridMLEM, xyCOG);
 
     // decrease the pixel size and align the array with the position of the center-of-gravity
     refinePixelArray(xyCOG, npadOK, xMin, xMax, yMin, yMax);
   }
 
   // discard pixels with low visibility by moving their charge to their nearest neighbour (cuts are empirical !!!)
-  double threshold = TMath::Min(TMath::Max(histMLEM->GetMaximum() / 100., 2.0 * mLowestPixelCharge), 100.0 * mLowestPixelCharge);
+  double threshold = TMath::Min(TMath::Max(gridMLEM.maximum() / 100., 2.0 * mLowestPixelCharge), 100.0 * mLowestPixelCharge);
   cleanPixelArray(threshold, prob);
 
   // re-run the MLEM algorithm with 2 iterations
@@ -836,13 +831,13 @@ void ClusterFinderOriginal::process()
     return;
   }
 
-  // update the histogram
+  // update the grid
   for (const auto& pixel : mPixels) {
-    histMLEM->SetBinContent(histMLEM->GetXaxis()->FindBin(pixel.x()), histMLEM->GetYaxis()->FindBin(pixel.y()), pixel.charge());
+    gridMLEM.setContent(gridMLEM.findBin(0, pixel.x()), gridMLEM.findBin(1, pixel.y()), pixel.charge());
   }
 
   // split the precluster into clusters
-  split(*histMLEM, coef);
+  split(gridMLEM, coef);
 }
 
 //_________________________________________________________________________________________________
@@ -989,100 +984,118 @@ double ClusterFinderOriginal::mlem(const std::vector<double>& coef, const std::v
 {
   /// use MLEM to update the charge of the pixels (iterative procedure with nIter iteration)
   /// return the total charge of all the pixels
+  /// the pixel charges are processed in flat arrays, pad by pad, so that the loops over
+  /// the pixels run over contiguous coefficients and can be vectorized
 
   double qTot(0.);
   double maxProb = *std::max_element(prob.begin(), prob.end());
-  std::vector<double> padSum(mPreCluster->multiplicity(), 0.);
+  size_t nPixels = mPixels.size();
+
+  // select the pads to be considered
+  mMLEMPads.clear();
+  for (int iPad = 0; iPad < mPreCluster->multiplicity(); ++iPad) {
+    if (mPreCluster->pad(iPad).status() == PadOriginal::kZero) {
+      mMLEMPads.push_back(iPad);
+    }
+  }
+  mPadSums.assign(mMLEMPads.size(), 0.);
+
+  // copy the pixel charges
+  mPixelCharges.resize(nPixels);
+  for (size_t iPix = 0; iPix < nPixels; ++iPix) {
+    mPixelCharges[iPix] = mPixels[iPix].charge();
+  }
+  double* pixelCharges = mPixelCharges.data();
 
   for (int iter = 0; iter < nIter; ++iter) {
 
-    // calculate expectations, ignoring the pads that must not be considered
-    int iCoef(0);
-    for (int iPad = 0; iPad < mPreCluster->multiplicity(); ++iPad) {
-      const auto& pad = mPreCluster->pad(iPad);
-      if (pad.status() != PadOriginal::kZero) {
-        iCoef += mPixels.size();
-        continue;
-      }
-      padSum[iPad] = 0.;
-      for (const auto& pixel : mPixels) {
-        padSum[iPad] += pixel.charge() * coef[iCoef++];
+    // calculate expectations
+    for (size_t i = 0; i < mMLEMPads.size(); ++i) {
+      const double* padCoef = &coef[mMLEMPads[i] * nPixels];
+      double padSum(0.);
+      for (size_t iPix = 0; iPix < nPixels; ++iPix) {
+        padSum += pixelCharges[iPix] * padCoef[iPix];
+      }
+      mPadSums[i] = padSum;
+    }
+
+    // accumulate the pad contributions to every pixels
+    mPixelSums.assign(nPixels, 0.);
+    mPixelNorms.assign(nPixels, maxProb);
+    double* pixelSums = mPixelSums.data();
+    double* pixelNorms = mPixelNorms.data();
+    for (size_t i = 0; i < mMLEMPads.size(); ++i) {
+      const auto& pad = mPreCluster->pad(mMLEMPads[i]);
+      const double* padCoef = &coef[mMLEMPads[i] * nPixels];
+      double padSum = mPadSums[i];
+      double padCharge = pad.charge();
+      if (pad.isSaturated() && padSum > padCharge) {
+        // correct for pad charge overflows
+        for (size_t iPix = 0; iPix < nPixels; ++iPix) {
+          pixelNorms[iPix] -= padCoef[iPix];
+        }
+      } else if (padSum > 1.e-6) {
+        for (size_t iPix = 0; iPix < nPixels; ++iPix) {
+          pixelSums[iPix] += padCharge * padCoef[iPix] / padSum;
+        }
       }
     }
 
     qTot = 0.;
-    for (int iPix = 0; iPix < mPixels.size(); ++iPix) {
+    for (size_t iPix = 0; iPix < nPixels; ++iPix) {
 
       // skip "invisible" pixel
       if (prob[iPix] < 0.01) {
-        mPixels[iPix].setCharge(0.);
+        pixelCharges[iPix] = 0.;
         continue;
       }
 
-      double pixelSum(0.);
-      double pixelNorm(maxProb);
-      for (int iPad = 0; iPad < mPreCluster->multiplicity(); ++iPad) {
-
-        // ignore the pads that must not be considered
-        const auto& pad = mPreCluster->pad(iPad);
-        if (pad.status() != PadOriginal::kZero) {
-          continue;
-        }
-
-        // correct for pad charge overflows
-        int iCoef = iPad * mPixels.size() + iPix;
-        if (pad.isSaturated() && padSum[iPad] > pad.charge()) {
-          pixelNorm -= coef[iCoef];
-          continue;
-        }
-
-        if (padSum[iPad] > 1.e-6) {
-          pixelSum += pad.charge() * coef[iCoef] / padSum[iPad];
-        }
-      }
-
       // correct the pixel charge
-      if (pixelNorm > 1.e-6) {
-        mPixels[iPix].setCharge(mPixels[iPix].charge() * pixelSum / pixelNorm);
-        qTot += mPixels[iPix].charge();
+      if (pixelNorms[iPix] > 1.e-6) {
+        pixelCharges[iPix] = pixelCharges[iPix] * pixelSums[iPix] / pixelNorms[iPix];
+        qTot += pixelCharges[iPix];
       } else {
-        mPixels[iPix].setCharge(0.);
+        pixelCharges[iPix] = 0.;
       }
     }
 
     // can happen in clusters with large number of overflows - speeding up
     if (qTot < 1.e-6) {
-      return qTot;
+      break;
     }
   }
 
+  // update the pixels
+  for (size_t iPix = 0; iPix < nPixels; ++iPix) {
+    mPixels[iPix].setCharge(pixelCharges[iPix]);
+  }
+
   return qTot;
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
+void ClusterFinderOriginal::findCOG(const PixelGrid<double>& gridMLEM, double xy[2]) const
 {
   /// calculate the position of the center-of-gravity around the pixel with maximum charge
 
   // define the range of pixels and the minimum charge to consider
-  int ix0(0), iy0(0), iz0(0);
-  double chargeThreshold = histMLEM.GetBinContent(histMLEM.GetMaximumBin(ix0, iy0, iz0)) / 10.;
+  int ix0(0), iy0(0);
+  gridMLEM.maximumBin(ix0, iy0);
+  double chargeThreshold = gridMLEM.content(ix0, iy0) / 10.;
   int ixMin = TMath::Max(1, ix0 - 1);
-  int ixMax = TMath::Min(histMLEM.GetNbinsX(), ix0 + 1);
+  int ixMax = TMath::Min(gridMLEM.nBinsX(), ix0 + 1);
   int iyMin = TMath::Max(1, iy0 - 1);
-  int iyMax = TMath::Min(histMLEM.GetNbinsY(), iy0 + 1);
+  int iyMax = TMath::Min(gridMLEM.nBinsY(), iy0 + 1);
 
   // first only consider pixels above threshold
-  const TAxis* xAxis = histMLEM.GetXaxis();
-  const TAxis* yAxis = histMLEM.GetYaxis();
   double xq(0.), yq(0.), q(0.);
   bool onePixelWidthX(true), onePixelWidthY(true);
   for (int iy = iyMin; iy <= iyMax; ++iy) {
     for (int ix = ixMin; ix <= ixMax; ++ix) {
-      double charge = histMLEM.GetBinContent(ix, iy);
+      double charge = gridMLEM.content(ix, iy);
       if (charge >= chargeThreshold) {
-        xq += xAxis->GetBinCenter(ix) * charge;
-        yq += yAxis->GetBinCenter(iy) * charge;
+        xq += gridMLEM.binCenter(0, ix) * charge;
+        yq += gridMLEM.binCenter(1, iy) * charge;
         q += charge;
         if (ix != ix0) {
           onePixelWidthX = false;
@@ -1101,10 +1114,10 @@ void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
     for (int iy = iyMin; iy <= iyMax; ++iy) {
       if (iy != iy0) {
         for (int ix = ixMin; ix <= ixMax; ++ix) {
-          double charge = histMLEM.GetBinContent(ix, iy);
+          double charge = gridMLEM.content(ix, iy);
           if (charge > chargePixel) {
-            xPixel = xAxis->GetBinCenter(ix);
-            yPixel = yAxis->GetBinCenter(iy);
+            xPixel = gridMLEM.binCenter(0, ix);
+            yPixel = gridMLEM.binCenter(1, iy);
             chargePixel = charge;
             ixPixel = ix;
           }
@@ -1125,10 +1138,10 @@ void ClusterFinderOriginal::findCOG(const TH2D& histMLEM, double xy[2]) const
     for (int ix = ixMin; ix <= ixMax; ++ix) {
       if (ix != ix0) {
         for (int iy = iyMin; iy <= iyMax; ++iy) {
-          double charge = histMLEM.GetBinContent(ix, iy);
+          double charge = gridMLEM.content(ix, iy);
           if (charge > chargePixel) {
-            xPixel = xAxis->GetBinCenter(ix);
-            yPixel = yAxis->GetBinCenter(iy);
+            xPixel = gridMLEM.binCenter(0, ix);
+            yPixel = gridMLEM.binCenter(1, iy);
             chargePixel = charge;
           }
         }
@@ -1620,7 +1633,7 @@ double ClusterFinderOriginal::fit(double currentParam[SNFitParamMax + 2],
       }
       if (nFail > 10) {
         currentParam[iDerivMax] -= shift[iDerivMax];
-        shift[iDerivMax] = 4. * shiftSave * (gRandom->Rndm(0) - 0.5);
+        shift[iDerivMax] = 4. * shiftSave * (std::generate_canonical<double, 32>(mRandom) - 0.5);
         currentParam[iDerivMax] += shift[iDerivMax];
       }
     }
@@ -1696,7 +1709,7 @@ float ClusterFinderOriginal::chargeIntegration(double x, double y, const PadOrig
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double>& coef)
+void ClusterFinderOriginal::split(const PixelGrid<double>& gridMLEM, const std::vector<double>& coef)
 {
   /// group the pixels in clusters then group together the clusters coupled to the same pads,
   /// split them into sub-groups if they are too many, merge them if they are not coupled to enough pads
@@ -1710,16 +1723,17 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
   }
 
   // find clusters of pixels
-  int nBinsX = histMLEM.GetNbinsX();
-  int nBinsY = histMLEM.GetNbinsY();
+  int nBinsX = gridMLEM.nBinsX();
+  int nBinsY = gridMLEM.nBinsY();
   std::vector<std::vector<int>> clustersOfPixels{};
-  std::vector<std::vector<bool>> isUsed(nBinsX, std::vector<bool>(nBinsY, false));
+  std::vector<int>& isUsed = mGridFlags;
+  isUsed.assign(nBinsX * nBinsY, 0);
   for (int j = 1; j <= nBinsY; ++j) {
     for (int i = 1; i <= nBinsX; ++i) {
-      if (!isUsed[i - 1][j - 1] && histMLEM.GetBinContent(i, j) >= mLowestPixelCharge) {
+      if (!isUsed[gridMLEM.index(i, j)] && gridMLEM.content(i, j) >= mLowestPixelCharge) {
         // add a new cluster of pixels and the associated pixels recursively
         clustersOfPixels.emplace_back();
-        addPixel(histMLEM, i, j, clustersOfPixels.back(), isUsed);
+        addPixel(gridMLEM, i, j, clustersOfPixels.back(), isUsed);
       }
     }
   }
@@ -1762,10 +1776,8 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
   }
 
   // define the fit range
-  const TAxis* xAxis = histMLEM.GetXaxis();
-  const TAxis* yAxis = histMLEM.GetYaxis();
-  double fitRange[2][2] = {{xAxis->GetXmin() - xAxis->GetBinWidth(1), xAxis->GetXmax() + xAxis->GetBinWidth(1)},
-                           {yAxis->GetXmin() - yAxis->GetBinWidth(1), yAxis->GetXmax() + yAxis->GetBinWidth(1)}};
+  double fitRange[2][2] = {{gridMLEM.min(0) - gridMLEM.binWidth(0), gridMLEM.max(0) + gridMLEM.binWidth(0)},
+                           {gridMLEM.min(1) - gridMLEM.binWidth(1), gridMLEM.max(1) + gridMLEM.binWidth(1)}};
 
   std::vector<bool> isClUsed(clustersOfPixels.size(), false);
   std::vector<int> coupledClusters{};
@@ -1831,23 +1843,23 @@ void ClusterFinderOriginal::split(const TH2D& histMLEM, const std::vector<double
 }
 
 //_________________________________________________________________________________________________
-void ClusterFinderOriginal::addPixel(const TH2D& histMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<std::vector<bool>>& isUsed)
+void ClusterFinderOriginal::addPixel(const PixelGrid<double>& gridMLEM, int i0, int j0, std::vector<int>& pixels, std::vector<int>& isUsed)
 {
   /// add a pixel to the cluster of pixels then add recursively its neighbours,
   /// if their charge is higher than mLowestPixelCharge and excluding corners
 
-  auto itPixel = findPad(mPixels, histMLEM.GetXaxis()->GetBinCenter(i0), histMLEM.GetYaxis()->GetBinCenter(j0), mLowestPixelCharge);
+  auto itPixel = findPad(mPixels, gridMLEM.binCenter(0, i0), gridMLEM.binCenter(1, j0), mLowestPixelCharge);
   pixels.push_back(std::distance(mPixels.begin(), itPixel));
-  isUsed[i0 - 1][j0 - 1] = true;
+  isUsed[gridMLEM.index(i0, j0)] = 1;
 
   int iMin = TMath::Max(1, i0 - 1);
-  int iMax = TMath::Min(histMLEM.GetNbinsX(), i0 + 1);
+  int iMax = TMath::Min(gridMLEM.nBinsX(), i0 + 1);
   int jMin = TMath::Max(1, j0 - 1);
-  int jMax = TMath::Min(histMLEM.GetNbinsY(), j0 + 1);
+  int jMax = TMath::Min(gridMLEM.nBinsY(), j0 + 1);
   for (int j = jMin; j <= jMax; ++j) {
     for (int i = iMin; i <= iMax; ++i) {
-      if (!isUsed[i - 1][j - 1] && (i == i0 || j == j0) && histMLEM.GetBinContent(i, j) >= mLowestPixelCharge) {
-        addPixel(histMLEM, i, j, pixels, isUsed);
+      if (!isUsed[gridMLEM.index(i, j)] && (i == i0 || j == j0) && gridMLEM.content(i, j) >= mLowestPixelCharge) {
+        addPixel(gridMLEM, i, j, pixels, isUsed);
       }
     }
   }
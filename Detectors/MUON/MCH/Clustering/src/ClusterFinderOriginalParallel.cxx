@@ -0,0 +1,119 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ClusterFinderOriginalParallel.cxx
+/// \brief Implementation of a class to run the original MLEM cluster finder on several threads
+
+#include "MCHClustering/ClusterFinderOriginalParallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace o2
+{
+namespace mch
+{
+
+//_________________________________________________________________________________________________
+void ClusterFinderOriginalParallel::init(bool run2Config, int nThreads)
+{
+  /// initialize one cluster finder per thread
+
+  mClusterFinders.clear();
+  for (int i = 0; i < std::max(1, nThreads); ++i) {
+    mClusterFinders.emplace_back(std::make_unique<ClusterFinderOriginal>());
+    mClusterFinders.back()->init(run2Config);
+  }
+}
+
+//_________________________________________________________________________________________________
+void ClusterFinderOriginalParallel::deinit()
+{
+  /// deinitialize the cluster finders
+  for (auto& clusterFinder : mClusterFinders) {
+    clusterFinder->deinit();
+  }
+}
+
+//_________________________________________________________________________________________________
+void ClusterFinderOriginalParallel::findClusters(gsl::span<const PreCluster> preClusters, gsl::span<const Digit> digits)
+{
+  /// reconstruct the clusters from the preclusters of one event
+
+  // group the preclusters in blocks, several per thread to balance the load
+  size_t nThreads = mClusterFinders.size();
+  size_t nBlocks = (nThreads > 1) ? std::min(preClusters.size(), 8 * nThreads) : 1;
+  mBlocks.resize(nBlocks);
+  for (size_t iBlock = 0; iBlock < nBlocks; ++iBlock) {
+    mBlocks[iBlock].firstPreCluster = preClusters.size() * iBlock / nBlocks;
+    mBlocks[iBlock].nPreClusters = preClusters.size() * (iBlock + 1) / nBlocks - mBlocks[iBlock].firstPreCluster;
+  }
+
+  // every thread processes the next block not yet processed and records where to find the results
+  std::atomic<size_t> nextBlock(0);
+  auto process = [this, &nextBlock, preClusters, digits, nBlocks](int iFinder) {
+    auto& finder = *mClusterFinders[iFinder];
+    finder.reset();
+    for (size_t iBlock = nextBlock++; iBlock < nBlocks; iBlock = nextBlock++) {
+      auto& block = mBlocks[iBlock];
+      block.finder = iFinder;
+      block.firstCluster = finder.getClusters().size();
+      block.firstDigit = finder.getUsedDigits().size();
+      for (const auto& preCluster : preClusters.subspan(block.firstPreCluster, block.nPreClusters)) {
+        finder.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
+      }
+      block.nClusters = finder.getClusters().size() - block.firstCluster;
+      block.nDigits = finder.getUsedDigits().size() - block.firstDigit;
+    }
+  };
+
+  size_t nWorkers = std::min(nThreads, nBlocks);
+  if (nWorkers <= 1) {
+    process(0);
+  } else {
+    // the current thread is the first worker, exceptions are forwarded to it once all the threads are over
+    std::vector<std::exception_ptr> exceptions(nWorkers);
+    std::vector<std::thread> threads{};
+    threads.reserve(nWorkers - 1);
+    for (size_t iWorker = 1; iWorker < nWorkers; ++iWorker) {
+      threads.emplace_back([&process, &exceptions, iWorker]() {
+        try {
+          process(iWorker);
+        } catch (...) {
+          exceptions[iWorker] = std::current_exception();
+        }
+      });
+    }
+    try {
+      process(0);
+    } catch (...) {
+      exceptions[0] = std::current_exception();
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto& exception : exceptions) {
+      if (exception) {
+        std::rethrow_exception(exception);
+      }
+    }
+  }
+
+  mNClusters = 0;
+  for (const auto& block : mBlocks) {
+    mNClusters += block.nClusters;
+  }
+}
+
+} // namespace mch
+} // namespace o2
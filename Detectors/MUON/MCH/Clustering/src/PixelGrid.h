@@ -0,0 +1,137 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file PixelGrid.h
+/// \brief Definition of the pixel grid used by the original cluster finder algorithm
+
+#ifndef ALICEO2_MCH_PIXELGRID_H_
+#define ALICEO2_MCH_PIXELGRID_H_
+
+#include <cstddef>
+#include <vector>
+
+namespace o2
+{
+namespace mch
+{
+
+/// regular 2D grid of pixels for internal use, stored in a flat array reused from one precluster to the next.
+/// The binning follows the one of a TH2 with fixed bin widths: bins are numbered from 1 to nBins in each
+/// direction, bin i covering [min + (i-1) * width, min + i * width[ with width = (max - min) / nBins
+template <typename T>
+class PixelGrid
+{
+ public:
+  PixelGrid() = default;
+  ~PixelGrid() = default;
+
+  PixelGrid(const PixelGrid&) = delete;
+  PixelGrid& operator=(const PixelGrid&) = delete;
+  PixelGrid(PixelGrid&&) = default;
+  PixelGrid& operator=(PixelGrid&&) = default;
+
+  /// set the binning and reset the content of all bins to 0, without reallocating if the grid is not bigger
+  void reset(int nBinsX, double xMin, double xMax, int nBinsY, double yMin, double yMax)
+  {
+    mAxes[0] = {nBinsX, xMin, xMax};
+    mAxes[1] = {nBinsY, yMin, yMax};
+    mContents.assign(static_cast<size_t>(nBinsX) * nBinsY, T(0));
+  }
+
+  /// return the number of bins in x direction
+  int nBinsX() const { return mAxes[0].nBins; }
+  /// return the number of bins in y direction
+  int nBinsY() const { return mAxes[1].nBins; }
+  /// return the lower edge of the grid in x or y direction
+  double min(int ixy) const { return mAxes[ixy].min; }
+  /// return the upper edge of the grid in x or y direction
+  double max(int ixy) const { return mAxes[ixy].max; }
+  /// return the bin width in x or y direction
+  double binWidth(int ixy) const { return (mAxes[ixy].max - mAxes[ixy].min) / mAxes[ixy].nBins; }
+
+  /// return the bin containing xy in x or y direction, 0 (nBins+1) if below (above) the grid
+  int findBin(int ixy, double xy) const
+  {
+    const auto& axis = mAxes[ixy];
+    if (xy < axis.min) {
+      return 0;
+    }
+    if (!(xy < axis.max)) {
+      return axis.nBins + 1;
+    }
+    return 1 + static_cast<int>(axis.nBins * (xy - axis.min) / (axis.max - axis.min));
+  }
+
+  /// return the center of the bin in x or y direction
+  double binCenter(int ixy, int bin) const
+  {
+    double width = binWidth(ixy);
+    return mAxes[ixy].min + (bin - 1) * width + 0.5 * width;
+  }
+
+  /// return the content of the bin (i,j), with 1 <= i <= nBinsX and 1 <= j <= nBinsY
+  T content(int i, int j) const { return mContents[index(i, j)]; }
+  /// set the content of the bin (i,j), with 1 <= i <= nBinsX and 1 <= j <= nBinsY
+  void setContent(int i, int j, T content) { mContents[index(i, j)] = content; }
+
+  /// add w to the bin containing the position (x,y), if any
+  void fill(double x, double y, T w)
+  {
+    int i = findBin(0, x);
+    int j = findBin(1, y);
+    if (i >= 1 && i <= nBinsX() && j >= 1 && j <= nBinsY()) {
+      mContents[index(i, j)] += w;
+    }
+  }
+
+  /// find the (first) bin with the maximum content, scanning the grid in x direction first
+  void maximumBin(int& i0, int& j0) const
+  {
+    i0 = j0 = 1;
+    T maximum = mContents.empty() ? T(0) : mContents.front();
+    for (int j = 1; j <= nBinsY(); ++j) {
+      for (int i = 1; i <= nBinsX(); ++i) {
+        T value = mContents[index(i, j)];
+        if (value > maximum) {
+          maximum = value;
+          i0 = i;
+          j0 = j;
+        }
+      }
+    }
+  }
+
+  /// return the maximum content of the grid
+  T maximum() const
+  {
+    int i(0), j(0);
+    maximumBin(i, j);
+    return mContents.empty() ? T(0) : content(i, j);
+  }
+
+  /// return the flat index of the bin (i,j) in the grid
+  size_t index(int i, int j) const { return static_cast<size_t>(j - 1) * mAxes[0].nBins + (i - 1); }
+
+ private:
+  struct Axis {
+    int nBins = 0;
+    double min = 0.;
+    double max = 0.;
+  };
+
+  Axis mAxes[2]{};          ///< binning in x and y directions
+  std::vector<T> mContents; ///< contents of the bins, x direction first
+};
+
+} // namespace mch
+} // namespace o2
+
+#endif // ALICEO2_MCH_PIXELGRID_H_
@@ -0,0 +1,112 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchClusterFinderOriginal.cxx
+/// \brief Benchmark of the original MLEM cluster finder on recorded digits
+///
+/// usage: o2-bench-mch-clustering-original [benchmark options] digits.root
+/// The digits are read from the tree "o2sim" (branches "MCHDigit" and "MCHROFRecords") written by the
+/// MCH digit writer, e.g. from Pb-Pb data, and preclusterized once. Each iteration then clusterizes
+/// all the preclusters of all the ROFs, with the number of threads given by the benchmark argument.
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gsl/span>
+
+#include <TFile.h>
+#include <TTreeReader.h>
+#include <TTreeReaderValue.h>
+
+#include "benchmark/benchmark.h"
+
+#include "DataFormatsMCH/Digit.h"
+#include "DataFormatsMCH/ROFRecord.h"
+#include "MCHBase/ClusterBlock.h"
+#include "MCHBase/PreCluster.h"
+#include "MCHClustering/ClusterFinderOriginalParallel.h"
+#include "MCHPreClustering/PreClusterFinder.h"
+
+using namespace o2::mch;
+
+namespace
+{
+std::vector<ROFRecord> gPreClusterROFs{};
+std::vector<PreCluster> gPreClusters{};
+std::vector<Digit> gPreClusterDigits{};
+
+void readPreClusters(const std::string& fileName)
+{
+  /// read the digits and preclusterize them, as done in the preclustering workflow
+  std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+  if (!file || file->IsZombie()) {
+    throw std::runtime_error("cannot open " + fileName);
+  }
+  TTreeReader treeReader("o2sim", file.get());
+  TTreeReaderValue<std::vector<Digit>> digits(treeReader, "MCHDigit");
+  TTreeReaderValue<std::vector<ROFRecord>> rofs(treeReader, "MCHROFRecords");
+
+  PreClusterFinder preClusterFinder{};
+  preClusterFinder.init();
+  while (treeReader.Next()) {
+    gsl::span<const Digit> digitsTF(*digits);
+    for (const auto& rof : *rofs) {
+      preClusterFinder.reset();
+      preClusterFinder.loadDigits(digitsTF.subspan(rof.getFirstIdx(), rof.getNEntries()));
+      int nPreClusters = preClusterFinder.run();
+      gPreClusterROFs.emplace_back(rof.getBCData(), gPreClusters.size(), nPreClusters);
+      preClusterFinder.getPreClusters(gPreClusters, gPreClusterDigits);
+    }
+  }
+  preClusterFinder.deinit();
+}
+} // namespace
+
+static void BM_ClusterFinderOriginal(benchmark::State& state)
+{
+  ClusterFinderOriginalParallel clusterFinder{};
+  clusterFinder.init(false, state.range(0));
+
+  std::vector<ClusterStruct> clusters{};
+  std::vector<Digit> usedDigits{};
+  gsl::span<const PreCluster> preClusters(gPreClusters);
+  for (auto _ : state) {
+    clusters.clear();
+    usedDigits.clear();
+    for (const auto& rof : gPreClusterROFs) {
+      clusterFinder.findClusters(preClusters.subspan(rof.getFirstIdx(), rof.getNEntries()), gPreClusterDigits);
+      clusterFinder.appendClusters(clusters, usedDigits);
+    }
+    benchmark::DoNotOptimize(clusters.data());
+  }
+
+  clusterFinder.deinit();
+  state.SetItemsProcessed(state.iterations() * gPreClusters.size());
+  state.counters["clusters"] = clusters.size();
+}
+
+BENCHMARK(BM_ClusterFinderOriginal)->RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+int main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " [benchmark options] digits.root" << std::endl;
+    return 1;
+  }
+  readPreClusters(argv[1]);
+  std::cout << gPreClusterROFs.size() << " ROFs, " << gPreClusters.size() << " preclusters" << std::endl;
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
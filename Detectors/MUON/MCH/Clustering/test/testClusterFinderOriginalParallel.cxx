@@ -0,0 +1,155 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testClusterFinderOriginalParallel.cxx
+/// \brief Test that the parallel clustering gives the same clusters as the sequential one
+
+#define BOOST_TEST_MODULE Test MCHClustering ClusterFinderOriginalParallel
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <gsl/span>
+
+#include "DataFormatsMCH/Digit.h"
+#include "MCHBase/ClusterBlock.h"
+#include "MCHBase/PreCluster.h"
+#include "MCHClustering/ClusterFinderOriginal.h"
+#include "MCHClustering/ClusterFinderOriginalParallel.h"
+#include "MCHMappingInterface/Segmentation.h"
+#include "MCHPreClustering/PreClusterFinder.h"
+
+using namespace o2::mch;
+
+namespace
+{
+/// deposit a gaussian charge around (x, y) on the pads of both cathodes of the detection element
+void addHit(int deId, double x, double y, double charge, std::map<std::pair<int, int>, uint32_t>& adcs)
+{
+  const auto& segmentation = mapping::segmentation(deId);
+  int bPad(-1), nbPad(-1);
+  segmentation.findPadPairByPosition(x, y, bPad, nbPad);
+  constexpr double sigma = 0.5;
+  auto deposit = [&](int padId) {
+    double dx = segmentation.padPositionX(padId) - x;
+    double dy = segmentation.padPositionY(padId) - y;
+    auto adc = static_cast<uint32_t>(charge * std::exp(-0.5 * (dx * dx + dy * dy) / (sigma * sigma)));
+    if (adc > 5) {
+      adcs[{deId, padId}] += adc;
+    }
+  };
+  for (int padId : {bPad, nbPad}) {
+    deposit(padId);
+    segmentation.forEachNeighbouringPad(padId, deposit);
+  }
+}
+
+/// preclusterize the digits of single and overlapping synthetic clusters in several detection elements
+void createPreClusters(std::vector<PreCluster>& preClusters, std::vector<Digit>& preClusterDigits)
+{
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<double> position(-100., 100.);
+  std::uniform_real_distribution<double> shift(-1.5, 1.5);
+  std::uniform_real_distribution<double> charge(200., 2000.);
+
+  std::map<std::pair<int, int>, uint32_t> adcs{};
+  for (int deId : {100, 300, 500, 505, 700, 819, 1025}) {
+    const auto& segmentation = mapping::segmentation(deId);
+    int nHits = 0;
+    for (int iTry = 0; iTry < 100000 && nHits < 40; ++iTry) {
+      double x = position(gen);
+      double y = position(gen);
+      int bPad(-1), nbPad(-1);
+      if (!segmentation.findPadPairByPosition(x, y, bPad, nbPad)) {
+        continue;
+      }
+      addHit(deId, x, y, charge(gen), adcs);
+      if (nHits % 3 == 0) {
+        // a close-by hit to produce preclusters with several clusters
+        double x2 = x + shift(gen);
+        double y2 = y + shift(gen);
+        if (segmentation.findPadPairByPosition(x2, y2, bPad, nbPad)) {
+          addHit(deId, x2, y2, charge(gen), adcs);
+        }
+      }
+      ++nHits;
+    }
+  }
+
+  std::vector<Digit> digits{};
+  for (const auto& [pad, adc] : adcs) {
+    digits.emplace_back(pad.first, pad.second, adc, 0);
+  }
+
+  PreClusterFinder preClusterFinder{};
+  preClusterFinder.init();
+  preClusterFinder.reset();
+  preClusterFinder.loadDigits(digits);
+  preClusterFinder.run();
+  preClusterFinder.getPreClusters(preClusters, preClusterDigits);
+  preClusterFinder.deinit();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ParallelClusteringMatchesSequential)
+{
+  std::vector<PreCluster> preClusters{};
+  std::vector<Digit> preClusterDigits{};
+  createPreClusters(preClusters, preClusterDigits);
+  BOOST_REQUIRE(preClusters.size() > 50);
+  gsl::span<const Digit> digits(preClusterDigits);
+
+  ClusterFinderOriginal clusterFinder{};
+  clusterFinder.init(false);
+  clusterFinder.reset();
+  for (const auto& preCluster : preClusters) {
+    clusterFinder.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
+  }
+  const auto& clusters = clusterFinder.getClusters();
+  const auto& usedDigits = clusterFinder.getUsedDigits();
+  BOOST_REQUIRE(!clusters.empty());
+
+  for (int nThreads : {1, 2, 4}) {
+    ClusterFinderOriginalParallel parallelClusterFinder{};
+    parallelClusterFinder.init(false, nThreads);
+    parallelClusterFinder.findClusters(preClusters, digits);
+    std::vector<ClusterStruct> parallelClusters{};
+    std::vector<Digit> parallelUsedDigits{};
+    parallelClusterFinder.appendClusters(parallelClusters, parallelUsedDigits);
+    parallelClusterFinder.deinit();
+
+    BOOST_CHECK_EQUAL(parallelClusterFinder.getNClusters(), clusters.size());
+    BOOST_REQUIRE_EQUAL(parallelClusters.size(), clusters.size());
+    for (size_t i = 0; i < clusters.size(); ++i) {
+      BOOST_CHECK_EQUAL(parallelClusters[i].x, clusters[i].x);
+      BOOST_CHECK_EQUAL(parallelClusters[i].y, clusters[i].y);
+      BOOST_CHECK_EQUAL(parallelClusters[i].z, clusters[i].z);
+      BOOST_CHECK_EQUAL(parallelClusters[i].ex, clusters[i].ex);
+      BOOST_CHECK_EQUAL(parallelClusters[i].ey, clusters[i].ey);
+      BOOST_CHECK_EQUAL(parallelClusters[i].uid, clusters[i].uid);
+      BOOST_CHECK_EQUAL(parallelClusters[i].firstDigit, clusters[i].firstDigit);
+      BOOST_CHECK_EQUAL(parallelClusters[i].nDigits, clusters[i].nDigits);
+    }
+    BOOST_REQUIRE_EQUAL(parallelUsedDigits.size(), usedDigits.size());
+    for (size_t i = 0; i < usedDigits.size(); ++i) {
+      BOOST_CHECK(parallelUsedDigits[i] == usedDigits[i]);
+    }
+  }
+
+  clusterFinder.deinit();
+}
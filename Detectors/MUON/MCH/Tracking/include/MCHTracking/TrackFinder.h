@@ -19,12 +19,15 @@
 
 #include <chrono>
 #include <unordered_map>
-#include <unordered_set>
 #include <list>
 #include <array>
+#include <memory>
 #include <vector>
 #include <utility>
 
+#include <gsl/span>
+
+#include "MCHBase/ClusterBlock.h"
 #include "MCHTracking/Cluster.h"
 #include "MCHTracking/Track.h"
 #include "MCHTracking/TrackFitter.h"
@@ -48,15 +51,23 @@ class TrackFinder
 
   void init(float l3Current, float dipoleCurrent);
 
+  const std::list<Track>& findTracks(gsl::span<const ClusterStruct> clusters);
   const std::list<Track>& findTracks(const std::unordered_map<int, std::list<Cluster>>& clusters);
 
-  /// set the debug level defining the verbosity
+  /// set the debug level defining the verbosity (debug printouts are only produced in single-thread mode)
   void debug(int debugLevel) { mDebugLevel = debugLevel; }
 
   void printStats() const;
   void printTimers() const;
 
  private:
+  /// list of unique IDs of the clusters to exclude when looking for compatible clusters
+  using ClusterIds = std::vector<uint32_t>;
+
+  void initTracking(float l3Current, float dipoleCurrent);
+  void setClusterRanges();
+  const std::list<Track>& findTracks();
+
   void findTrackCandidates();
   void findTrackCandidatesInSt5();
   void findTrackCandidatesInSt4();
@@ -66,13 +77,17 @@ class TrackFinder
   std::list<Track>::iterator followTrackInOverlapDE(const std::list<Track>::iterator& itTrack, int currentDE, int plane);
   std::list<Track>::iterator followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                   int chamber, int lastChamber, bool canSkip,
-                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                  ClusterIds& excludedClusters);
   std::list<Track>::iterator followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                   int plane1, int plane2, int lastChamber,
-                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                  ClusterIds& excludedClusters);
   std::list<Track>::iterator addClustersAndFollowTrack(std::list<Track>::iterator& itTrack, const TrackParam& paramAtCluster1,
                                                        const TrackParam* paramAtCluster2, int nextChamber, int lastChamber,
-                                                       std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters);
+                                                       ClusterIds& excludedClusters);
+
+  void followTracks();
+
+  void processInParallel(void (TrackFinder::*process)());
 
   void improveTracks();
 
@@ -93,9 +108,11 @@ class TrackFinder
 
   bool areUsed(const Cluster& cl1, const Cluster& cl2, const std::list<Track>::iterator& itFirstTrack, const std::list<Track>::iterator& itLastTrack);
   void excludeClustersFromIdenticalTracks(const std::list<Track>::iterator& itTrack,
-                                          std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters,
+                                          ClusterIds& excludedClusters,
                                           const std::list<Track>::iterator& itEndTrack);
-  void moveClusters(std::unordered_map<int, std::unordered_set<uint32_t>>& source, std::unordered_map<int, std::unordered_set<uint32_t>>& destination);
+  void excludeCluster(const Cluster& cluster, ClusterIds& excludedClusters);
+  bool isExcluded(const Cluster& cluster, const ClusterIds& excludedClusters) const;
+  void moveClusters(ClusterIds& source, ClusterIds& destination);
 
   bool isCompatible(const TrackParam& param, const Cluster& cluster, TrackParam& paramAtCluster);
   bool tryOneClusterFast(const TrackParam& param, const Cluster& cluster);
@@ -112,6 +129,12 @@ class TrackFinder
 
   /// return the chamber to which this plane belong to
   int getChamberId(int plane) { return (plane < 8) ? plane / 2 : 4 + (plane - 8) / 4; }
+  /// return the internal index (0..SNDEIndices-1) of this DE, or -1 if the DE does not exist
+  static int getDEIndex(int deId)
+  {
+    int chamber = deId / 100 - 1;
+    return (chamber >= 0 && chamber < 10 && deId % 100 < SNDE[chamber]) ? 26 * chamber + deId % 100 : -1;
+  }
 
   ///< maximum distance to the track to search for compatible cluster(s) in non bending direction
   static constexpr double SMaxNonBendingDistanceToTrack = 1.;
@@ -125,13 +148,19 @@ class TrackFinder
   static constexpr double SChamberThicknessInX0[10] = {0.065, 0.065, 0.075, 0.075, 0.035,
                                                        0.035, 0.035, 0.035, 0.035, 0.035};
   static constexpr int SNDE[10] = {4, 4, 4, 4, 18, 18, 26, 26, 26, 26}; ///< number of DE per chamber
+  static constexpr int SNDEIndices = 260;                                 ///< number of internal DE indices
 
   TrackFitter mTrackFitter{}; /// track fitter
 
-  std::array<std::vector<std::pair<const int, const std::list<Cluster>*>>, 32> mClusters{}; ///< array of pointers to the lists of clusters per DE
+  std::vector<Cluster> mClusterBuffer{};                                                   ///< clusters of the current event grouped per DE
+  std::vector<std::size_t> mDEOffsets{};                                                   ///< position of the clusters of each DE in the buffer
+  std::array<std::vector<std::pair<const int, gsl::span<const Cluster>>>, 32> mClusters{}; ///< array of clusters per DE
 
   std::list<Track> mTracks{}; ///< list of reconstructed tracks
 
+  std::vector<std::unique_ptr<TrackFinder>> mHelpers{}; ///< additional track finders used to process the tracks in parallel
+  std::vector<std::list<Track>> mTrackBlocks{};          ///< blocks of consecutive tracks processed in parallel
+
   double mChamberResolutionX2 = 0.;      ///< chamber resolution square (cm^2) in x direction
   double mChamberResolutionY2 = 0.;      ///< chamber resolution square (cm^2) in y direction
   double mBendingVertexDispersion2 = 0.; ///< vertex dispersion square (cm^2) in y direction
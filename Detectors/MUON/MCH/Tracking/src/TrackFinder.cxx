@@ -16,13 +16,19 @@
 
 #include "MCHTracking/TrackFinder.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <exception>
 #include <iostream>
+#include <numeric>
 #include <stdexcept>
+#include <thread>
 
 #include <TGeoGlobalMagField.h>
 #include <TMatrixD.h>
 #include <TMath.h>
+#include <TROOT.h>
 
 #include "Field/MagneticField.h"
 #include "MCHTracking/TrackExtrap.h"
@@ -43,6 +49,24 @@ constexpr int TrackFinder::SNDE[10];
 void TrackFinder::init(float l3Current, float dipoleCurrent)
 {
   /// Prepare to run the algorithm
+  /// Create the additional track finders needed to process the tracks in parallel if requested
+
+  initTracking(l3Current, dipoleCurrent);
+
+  mHelpers.clear();
+  for (int i = 1; i < TrackerParam::Instance().nThreads; ++i) {
+    mHelpers.emplace_back(std::make_unique<TrackFinder>());
+    mHelpers.back()->initTracking(l3Current, dipoleCurrent);
+  }
+  if (!mHelpers.empty()) {
+    ROOT::EnableThreadSafety();
+  }
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::initTracking(float l3Current, float dipoleCurrent)
+{
+  /// Prepare the internal parameters and the magnetic field used by the algorithm
 
   // create the magnetic field map if not already done
   mTrackFitter.initField(l3Current, dipoleCurrent);
@@ -75,91 +99,169 @@ void TrackFinder::init(float l3Current, float dipoleCurrent)
   // grouping DEs in z-planes (2 for chambers 1-4 and 4 for chambers 5-10)
   for (int iCh = 0; iCh < 4; ++iCh) {
     mClusters[2 * iCh].reserve(2);
-    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 3, nullptr);
+    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 1, gsl::span<const Cluster>{});
+    mClusters[2 * iCh].emplace_back(100 * (iCh + 1) + 3, gsl::span<const Cluster>{});
     mClusters[2 * iCh + 1].reserve(2);
-    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1) + 2, nullptr);
+    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1), gsl::span<const Cluster>{});
+    mClusters[2 * iCh + 1].emplace_back(100 * (iCh + 1) + 2, gsl::span<const Cluster>{});
   }
   for (int iCh = 4; iCh < 6; ++iCh) {
     mClusters[8 + 4 * (iCh - 4)].reserve(5);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 14, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 16, nullptr);
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 14, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 16, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 1].reserve(4);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 15, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 17, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 15, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 17, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 2].reserve(4);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 6, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 6, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 3].reserve(5);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 5, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 5, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, gsl::span<const Cluster>{});
   }
   for (int iCh = 6; iCh < 10; ++iCh) {
     mClusters[8 + 4 * (iCh - 4)].reserve(7);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 6, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 20, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 22, nullptr);
-    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 24, nullptr);
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1), gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 2, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 4, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 6, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 20, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 22, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4)].emplace_back(100 * (iCh + 1) + 24, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 1].reserve(6);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 5, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 21, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 23, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 25, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 1, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 3, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 5, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 21, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 23, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 1].emplace_back(100 * (iCh + 1) + 25, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 2].reserve(6);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 14, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 16, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 18, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 8, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 10, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 12, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 14, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 16, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 2].emplace_back(100 * (iCh + 1) + 18, gsl::span<const Cluster>{});
     mClusters[8 + 4 * (iCh - 4) + 3].reserve(7);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 15, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 17, nullptr);
-    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 19, nullptr);
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 7, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 9, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 11, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 13, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 15, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 17, gsl::span<const Cluster>{});
+    mClusters[8 + 4 * (iCh - 4) + 3].emplace_back(100 * (iCh + 1) + 19, gsl::span<const Cluster>{});
+  }
+}
+
+//_________________________________________________________________________________________________
+const std::list<Track>& TrackFinder::findTracks(gsl::span<const ClusterStruct> clusters)
+{
+  /// Run the track finder algorithm on the clusters of one event
+  /// The clusters are copied in an internal buffer, grouped per DE, that remains valid until the next call
+
+  // count the clusters per DE and compute the index of the first cluster of each DE in the buffer
+  mDEOffsets.assign(SNDEIndices + 1, 0);
+  for (const auto& cluster : clusters) {
+    int iDE = getDEIndex(cluster.getDEId());
+    if (iDE >= 0) {
+      ++mDEOffsets[iDE + 1];
+    }
+  }
+  std::partial_sum(mDEOffsets.begin(), mDEOffsets.end(), mDEOffsets.begin());
+
+  // copy the clusters, keeping their order within each DE
+  mClusterBuffer.resize(mDEOffsets.back());
+  for (const auto& cluster : clusters) {
+    int iDE = getDEIndex(cluster.getDEId());
+    if (iDE >= 0) {
+      mClusterBuffer[mDEOffsets[iDE]++] = Cluster(cluster);
+    }
   }
+
+  setClusterRanges();
+
+  return findTracks();
 }
 
 //_________________________________________________________________________________________________
 const std::list<Track>& TrackFinder::findTracks(const std::unordered_map<int, std::list<Cluster>>& clusters)
 {
-  /// Run the track finder algorithm
+  /// Run the track finder algorithm on the clusters of one event, given per DE
+  /// The clusters are copied in an internal buffer, grouped per DE, that remains valid until the next call
+
+  // count the clusters per DE and compute the index of the first cluster of each DE in the buffer
+  mDEOffsets.assign(SNDEIndices + 1, 0);
+  for (const auto& de : clusters) {
+    int iDE = getDEIndex(de.first);
+    if (iDE >= 0) {
+      mDEOffsets[iDE + 1] = de.second.size();
+    }
+  }
+  std::partial_sum(mDEOffsets.begin(), mDEOffsets.end(), mDEOffsets.begin());
 
-  mTracks.clear();
+  // copy the clusters, keeping their order within each DE
+  mClusterBuffer.resize(mDEOffsets.back());
+  for (const auto& de : clusters) {
+    int iDE = getDEIndex(de.first);
+    if (iDE >= 0) {
+      std::copy(de.second.begin(), de.second.end(), mClusterBuffer.begin() + mDEOffsets[iDE]);
+      mDEOffsets[iDE] += de.second.size();
+    }
+  }
+
+  setClusterRanges();
+
+  return findTracks();
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::setClusterRanges()
+{
+  /// Fill the internal array of clusters per DE, for this track finder and its helpers
+  /// At this stage, mDEOffsets[iDE] points to the end of the clusters of the DE with index iDE in the buffer
 
-  // fill the internal array of pointers to the list of clusters per DE
   for (auto& plane : mClusters) {
     for (auto& de : plane) {
-      auto itDE = clusters.find(de.first);
-      if (itDE == clusters.end()) {
-        de.second = nullptr;
-      } else {
-        de.second = &(itDE->second);
+      int iDE = getDEIndex(de.first);
+      std::size_t first = (iDE > 0) ? mDEOffsets[iDE - 1] : 0;
+      de.second = gsl::span<const Cluster>(mClusterBuffer.data() + first, mDEOffsets[iDE] - first);
+    }
+  }
+
+  for (auto& helper : mHelpers) {
+    for (int iPlane = 0; iPlane < 32; ++iPlane) {
+      for (std::size_t iDE = 0; iDE < mClusters[iPlane].size(); ++iDE) {
+        helper->mClusters[iPlane][iDE].second = mClusters[iPlane][iDE].second;
       }
     }
   }
+}
+
+//_________________________________________________________________________________________________
+const std::list<Track>& TrackFinder::findTracks()
+{
+  /// Run the track finder algorithm on the clusters attached to the internal array
+
+  mTracks.clear();
+
+  // the processing of the tracks is distributed among the helpers if any, except in debug mode
+  bool runInParallel = !mHelpers.empty() && mDebugLevel < 1;
 
   // use the chamber resolution when fitting the tracks during the tracking
   mTrackFitter.useChamberResolution();
+  for (auto& helper : mHelpers) {
+    helper->mTrackFitter.useChamberResolution();
+  }
 
   // find track candidates on stations 4 and 5
   auto tStart = std::chrono::high_resolution_clock::now();
@@ -178,11 +280,10 @@ const std::list<Track>& TrackFinder::findTracks(const std::unordered_map<int, st
 
   // track each candidate down to chamber 1 and remove it
   tStart = std::chrono::high_resolution_clock::now();
-  for (auto itTrack = mTracks.begin(); itTrack != mTracks.end();) {
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
-    followTrackInChamber(itTrack, 5, 0, false, excludedClusters);
-    print("findTracks: removing candidate at position #", getTrackIndex(itTrack));
-    itTrack = mTracks.erase(itTrack);
+  if (runInParallel) {
+    processInParallel(&TrackFinder::followTracks);
+  } else {
+    followTracks();
   }
   tEnd = std::chrono::high_resolution_clock::now();
   mTimeFollowTracks += tEnd - tStart;
@@ -191,7 +292,11 @@ const std::list<Track>& TrackFinder::findTracks(const std::unordered_map<int, st
 
   // improve the reconstructed tracks
   tStart = std::chrono::high_resolution_clock::now();
-  improveTracks();
+  if (runInParallel) {
+    processInParallel(&TrackFinder::improveTracks);
+  } else {
+    improveTracks();
+  }
   tEnd = std::chrono::high_resolution_clock::now();
   mTimeImproveTracks += tEnd - tStart;
 
@@ -205,7 +310,14 @@ const std::list<Track>& TrackFinder::findTracks(const std::unordered_map<int, st
   if (TrackerParam::Instance().refineTracks) {
     tStart = std::chrono::high_resolution_clock::now();
     mTrackFitter.useClusterResolution();
-    refineTracks();
+    if (runInParallel) {
+      for (auto& helper : mHelpers) {
+        helper->mTrackFitter.useClusterResolution();
+      }
+      processInParallel(&TrackFinder::refineTracks);
+    } else {
+      refineTracks();
+    }
     tEnd = std::chrono::high_resolution_clock::now();
     mTimeRefineTracks += tEnd - tStart;
   } else {
@@ -233,7 +345,7 @@ void TrackFinder::findTrackCandidates()
     }
 
     // look for compatible clusters on station 4
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
+    ClusterIds excludedClusters{};
     auto itNewTrack = followTrackInChamber(itTrack, 7, 6, false, excludedClusters);
 
     // keep the current candidate only if no compatible cluster is found and the station is not requested
@@ -271,7 +383,7 @@ void TrackFinder::findTrackCandidates()
     // look for compatible clusters on each chamber of station 5 separately,
     // exluding those already attached to an identical candidate on station 4
     // (cases where both chambers of station 5 are fired should have been found in the first step)
-    std::unordered_map<int, std::unordered_set<uint32_t>> excludedClusters{};
+    ClusterIds excludedClusters{};
     if (itLastCandidateFromSt5 != mTracks.end()) {
       excludeClustersFromIdenticalTracks(itTrack, excludedClusters, std::next(itLastCandidateFromSt5));
     }
@@ -622,22 +734,22 @@ std::list<Track>::iterator TrackFinder::findTrackCandidates(int plane1, int plan
   for (auto& de1 : mClusters[plane1]) {
 
     // skip DE without cluster
-    if (de1.second == nullptr) {
+    if (de1.second.empty()) {
       continue;
     }
 
-    for (const auto& cluster1 : *de1.second) {
+    for (const auto& cluster1 : de1.second) {
 
       double z1 = cluster1.getZ();
 
       for (auto& de2 : mClusters[plane2]) {
 
         // skip DE without cluster
-        if (de2.second == nullptr) {
+        if (de2.second.empty()) {
           continue;
         }
 
-        for (const auto& cluster2 : *de2.second) {
+        for (const auto& cluster2 : de2.second) {
 
           // skip combinations of clusters already part of a track if requested
           if (skipUsedPairs && itTrack != mTracks.end() && areUsed(cluster1, cluster2, itFirstTrack, std::next(itTrack))) {
@@ -710,7 +822,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
   for (auto& de : mClusters[plane]) {
 
     // skip DE without cluster
-    if (de.second == nullptr) {
+    if (de.second.empty()) {
       continue;
     }
 
@@ -720,7 +832,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
     }
 
     // look for cluster candidate in this DE
-    for (const auto& cluster : *de.second) {
+    for (const auto& cluster : de.second) {
 
       // try to add the current cluster
       if (!isCompatible(currentParam, cluster, paramAtCluster)) {
@@ -745,7 +857,7 @@ std::list<Track>::iterator TrackFinder::followTrackInOverlapDE(const std::list<T
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                              int chamber, int lastChamber, bool canSkip,
-                                                             std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                             ClusterIds& excludedClusters)
 {
   /// Follow the track candidate pointed to by "itTrack" to the given "chamber"
   /// The tracking starts from the current parameters, which must have already been set
@@ -837,7 +949,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::iterator& itTrack,
                                                              int plane1, int plane2, int lastChamber,
-                                                             std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                             ClusterIds& excludedClusters)
 {
   /// Follow the track candidate pointed to by "itTrack" to the (half)chamber formed by "plane1" and "plane2"
   /// The tracking starts from the current parameters, which must have already been set
@@ -888,23 +1000,19 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
   TrackParam paramAtCluster1{};
   TrackParam currentParamAtCluster1{};
   TrackParam paramAtCluster2{};
-  std::unordered_map<int, std::unordered_set<uint32_t>> newExcludedClusters{};
+  ClusterIds newExcludedClusters{};
   for (auto& de1 : mClusters[plane1]) {
 
     // skip DE without cluster
-    if (de1.second == nullptr) {
+    if (de1.second.empty()) {
       continue;
     }
 
-    // get the list of excluded clusters for the DE
-    auto itExcludedClusters = excludedClusters.find(de1.first);
-    bool hasExcludedClusters = (itExcludedClusters != excludedClusters.end());
-
     // look for cluster candidate in this DE
-    for (const auto& cluster1 : *de1.second) {
+    for (const auto& cluster1 : de1.second) {
 
       // skip excluded clusters
-      if (hasExcludedClusters && itExcludedClusters->second.count(cluster1.getUniqueId()) > 0) {
+      if (isExcluded(cluster1, excludedClusters)) {
         continue;
       }
 
@@ -914,7 +1022,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       }
 
       // add it to the list of excluded clusters for this candidate
-      excludedClusters[de1.first].emplace(cluster1.getUniqueId());
+      excludeCluster(cluster1, excludedClusters);
 
       // skip tracks out of limits, but after checking for overlaps
       bool isAcceptableAtCluster1 = isAcceptable(paramAtCluster1);
@@ -929,7 +1037,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       for (auto& de2 : mClusters[plane2]) {
 
         // skip DE without cluster
-        if (de2.second == nullptr) {
+        if (de2.second.empty()) {
           continue;
         }
 
@@ -939,7 +1047,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
         }
 
         // look for cluster candidate in this DE
-        for (const auto& cluster2 : *de2.second) {
+        for (const auto& cluster2 : de2.second) {
 
           // try to add the current cluster
           if (!isCompatible(currentParamAtCluster1, cluster2, paramAtCluster2)) {
@@ -949,7 +1057,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
           cluster2Found = true;
 
           // add it to the list of excluded clusters for this candidate
-          excludedClusters[de2.first].emplace(cluster2.getUniqueId());
+          excludeCluster(cluster2, excludedClusters);
 
           // skip tracks out of limits
           if (!isAcceptableAtCluster1 || !isAcceptable(paramAtCluster2)) {
@@ -985,19 +1093,15 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
   for (auto& de2 : mClusters[plane2]) {
 
     // skip DE without cluster
-    if (de2.second == nullptr) {
+    if (de2.second.empty()) {
       continue;
     }
 
-    // get the list of excluded clusters for the DE
-    auto itExcludedClusters = excludedClusters.find(de2.first);
-    bool hasExcludedClusters = (itExcludedClusters != excludedClusters.end());
-
     // look for cluster candidate in this DE
-    for (const auto& cluster2 : *de2.second) {
+    for (const auto& cluster2 : de2.second) {
 
       // skip excluded clusters (in particular the ones already attached together with a cluster on plane1)
-      if (hasExcludedClusters && itExcludedClusters->second.count(cluster2.getUniqueId()) > 0) {
+      if (isExcluded(cluster2, excludedClusters)) {
         continue;
       }
 
@@ -1007,7 +1111,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
       }
 
       // add it to the list of excluded clusters for this candidate
-      excludedClusters[de2.first].emplace(cluster2.getUniqueId());
+      excludeCluster(cluster2, excludedClusters);
 
       // skip tracks out of limits
       if (!isAcceptable(paramAtCluster2)) {
@@ -1036,7 +1140,7 @@ std::list<Track>::iterator TrackFinder::followTrackInChamber(std::list<Track>::i
 //_________________________________________________________________________________________________
 std::list<Track>::iterator TrackFinder::addClustersAndFollowTrack(std::list<Track>::iterator& itTrack, const TrackParam& paramAtCluster1,
                                                                   const TrackParam* paramAtCluster2, int nextChamber, int lastChamber,
-                                                                  std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters)
+                                                                  ClusterIds& excludedClusters)
 {
   /// If "nextChamber" >= 0: continue the tracking of "itTrack" up to "lastChamber", attach the two clusters
   /// to every new tracks found and return an iterator to the first of them (or mTracks.end() if none is found)
@@ -1101,6 +1205,100 @@ std::list<Track>::iterator TrackFinder::addClustersAndFollowTrack(std::list<Trac
   return itFirstNewTrack;
 }
 
+//_________________________________________________________________________________________________
+void TrackFinder::followTracks()
+{
+  /// Track each candidate down to chamber 1 and remove it
+  /// The new tracks found from each candidate replace it in the list
+  for (auto itTrack = mTracks.begin(); itTrack != mTracks.end();) {
+    ClusterIds excludedClusters{};
+    followTrackInChamber(itTrack, 5, 0, false, excludedClusters);
+    print("followTracks: removing candidate at position #", getTrackIndex(itTrack));
+    itTrack = mTracks.erase(itTrack);
+  }
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::processInParallel(void (TrackFinder::*process)())
+{
+  /// Split the list of tracks in blocks of consecutive tracks and apply the given processing to each block,
+  /// distributing the blocks dynamically between this track finder and its helpers running in parallel
+  /// The processing must treat every track independently of the others. The resulting tracks of each block
+  /// are then moved back in the list in the order of the blocks, so that the output is the same as in one thread
+
+  std::size_t nTracks = mTracks.size();
+  std::size_t nFinders = mHelpers.size() + 1;
+  std::size_t nBlocks = std::min(nTracks, 8 * nFinders);
+  if (nBlocks < 2) {
+    (this->*process)();
+    return;
+  }
+
+  // move the tracks into the blocks without copying them
+  mTrackBlocks.resize(nBlocks);
+  for (std::size_t iBlock = 0; iBlock < nBlocks; ++iBlock) {
+    std::size_t nTracksInBlock = nTracks * (iBlock + 1) / nBlocks - nTracks * iBlock / nBlocks;
+    mTrackBlocks[iBlock].splice(mTrackBlocks[iBlock].end(), mTracks, mTracks.begin(), std::next(mTracks.begin(), nTracksInBlock));
+  }
+
+  // every finder processes the next block not yet processed, the tracks being exchanged with its own (empty) list
+  std::atomic<std::size_t> nextBlock(0);
+  auto processBlocks = [this, process, &nextBlock, nBlocks](TrackFinder& finder) {
+    for (std::size_t iBlock = nextBlock++; iBlock < nBlocks; iBlock = nextBlock++) {
+      finder.mTracks.swap(mTrackBlocks[iBlock]);
+      (finder.*process)();
+      finder.mTracks.swap(mTrackBlocks[iBlock]);
+    }
+  };
+
+  // the current thread runs this finder, exceptions are forwarded to it once all the threads are over
+  std::size_t nWorkers = std::min(nFinders, nBlocks);
+  std::vector<std::exception_ptr> exceptions(nWorkers);
+  std::vector<std::thread> threads{};
+  threads.reserve(nWorkers - 1);
+  for (std::size_t iWorker = 1; iWorker < nWorkers; ++iWorker) {
+    threads.emplace_back([this, &processBlocks, &exceptions, iWorker]() {
+      try {
+        processBlocks(*mHelpers[iWorker - 1]);
+      } catch (...) {
+        exceptions[iWorker] = std::current_exception();
+      }
+    });
+  }
+  try {
+    processBlocks(*this);
+  } catch (...) {
+    exceptions[0] = std::current_exception();
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // collect the counters of the helpers
+  for (auto& helper : mHelpers) {
+    mNCallTryOneCluster += helper->mNCallTryOneCluster;
+    mNCallTryOneClusterFast += helper->mNCallTryOneClusterFast;
+    helper->mNCallTryOneCluster = 0;
+    helper->mNCallTryOneClusterFast = 0;
+  }
+
+  // in case of failure, drop all the tracks so that every finder starts from an empty list at the next call
+  for (const auto& exception : exceptions) {
+    if (exception) {
+      for (auto& helper : mHelpers) {
+        helper->mTracks.clear();
+      }
+      mTracks.clear();
+      mTrackBlocks.clear();
+      std::rethrow_exception(exception);
+    }
+  }
+
+  for (auto& block : mTrackBlocks) {
+    mTracks.splice(mTracks.end(), block);
+  }
+}
+
 //_________________________________________________________________________________________________
 void TrackFinder::improveTracks()
 {
@@ -1455,7 +1653,7 @@ bool TrackFinder::areUsed(const Cluster& cl1, const Cluster& cl2, const std::lis
 
 //_________________________________________________________________________________________________
 void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::iterator& itTrack,
-                                                     std::unordered_map<int, std::unordered_set<uint32_t>>& excludedClusters,
+                                                     ClusterIds& excludedClusters,
                                                      const std::list<Track>::iterator& itEndTrack)
 {
   /// Find tracks in the range [mTracks.begin(), itEndTrack[ that contain all the clusters of itTrack
@@ -1465,7 +1663,7 @@ void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::ite
       for (auto itParam = itTrack2->rbegin(); itParam != itTrack2->rend(); ++itParam) {
         const Cluster* cluster = itParam->getClusterPtr();
         if (cluster->getChamberId() > 7) {
-          excludedClusters[cluster->getDEId()].emplace(cluster->getUniqueId());
+          excludeCluster(*cluster, excludedClusters);
         } else {
           break;
         }
@@ -1475,11 +1673,30 @@ void TrackFinder::excludeClustersFromIdenticalTracks(const std::list<Track>::ite
 }
 
 //_________________________________________________________________________________________________
-void TrackFinder::moveClusters(std::unordered_map<int, std::unordered_set<uint32_t>>& source, std::unordered_map<int, std::unordered_set<uint32_t>>& destination)
+void TrackFinder::excludeCluster(const Cluster& cluster, ClusterIds& excludedClusters)
+{
+  /// Add the cluster Id to the list of excluded clusters if not already there
+  if (!isExcluded(cluster, excludedClusters)) {
+    excludedClusters.push_back(cluster.getUniqueId());
+  }
+}
+
+//_________________________________________________________________________________________________
+bool TrackFinder::isExcluded(const Cluster& cluster, const ClusterIds& excludedClusters) const
+{
+  /// Return true if the cluster Id is in the list of excluded clusters
+  /// The list only contains the few clusters compatible with one candidate, so a linear search is the fastest
+  return std::find(excludedClusters.begin(), excludedClusters.end(), cluster.getUniqueId()) != excludedClusters.end();
+}
+
+//_________________________________________________________________________________________________
+void TrackFinder::moveClusters(ClusterIds& source, ClusterIds& destination)
 {
   /// Move cluster Ids listed in source into destination then clear source
-  for (auto& sourceDE : source) {
-    destination[sourceDE.first].insert(sourceDE.second.begin(), sourceDE.second.end());
+  for (auto uid : source) {
+    if (std::find(destination.begin(), destination.end(), uid) == destination.end()) {
+      destination.push_back(uid);
+    }
   }
   source.clear();
 }
@@ -39,7 +39,7 @@
 #include "DataFormatsMCH/Digit.h"
 #include "MCHBase/PreCluster.h"
 #include "MCHBase/ClusterBlock.h"
-#include "MCHClustering/ClusterFinderOriginal.h"
+#include "MCHClustering/ClusterFinderOriginalParallel.h"
 
 namespace o2
 {
@@ -63,7 +63,8 @@ class ClusterFinderOriginalTask
       o2::conf::ConfigurableParam::updateFromFile(config, "MCHClustering", true);
     }
     bool run2Config = ic.options().get<bool>("run2-config");
-    mClusterFinder.init(run2Config);
+    auto nThreads = ic.options().get<int>("n-threads");
+    mClusterFinder.init(run2Config, nThreads);
 
     /// Print the timer and clear the clusterizer when the processing is over
     ic.services().get<CallbackService>().set(CallbackService::Id::Stop, [this]() {
@@ -96,39 +97,18 @@ class ClusterFinderOriginalTask
 
       // clusterize every preclusters
       auto tStart = std::chrono::high_resolution_clock::now();
-      mClusterFinder.reset();
-      for (const auto& preCluster : preClusters.subspan(preClusterROF.getFirstIdx(), preClusterROF.getNEntries())) {
-        mClusterFinder.findClusters(digits.subspan(preCluster.firstDigit, preCluster.nDigits));
-      }
+      mClusterFinder.findClusters(preClusters.subspan(preClusterROF.getFirstIdx(), preClusterROF.getNEntries()), digits);
       auto tEnd = std::chrono::high_resolution_clock::now();
       mTimeClusterFinder += tEnd - tStart;
 
-      // fill the ouput messages
-      clusterROFs.emplace_back(preClusterROF.getBCData(), clusters.size(), mClusterFinder.getClusters().size());
-      writeClusters(clusters, usedDigits);
+      // fill the ouput messages with clusters and attached digits of the current event
+      clusterROFs.emplace_back(preClusterROF.getBCData(), clusters.size(), mClusterFinder.getNClusters());
+      mClusterFinder.appendClusters(clusters, usedDigits);
     }
   }
 
  private:
-  //_________________________________________________________________________________________________
-  void writeClusters(std::vector<ClusterStruct, o2::pmr::polymorphic_allocator<ClusterStruct>>& clusters,
-                     std::vector<Digit, o2::pmr::polymorphic_allocator<Digit>>& usedDigits) const
-  {
-    /// fill the output messages with clusters and attached digits of the current event
-    /// modify the references to the attached digits according to their position in the global vector
-
-    auto clusterOffset = clusters.size();
-    clusters.insert(clusters.end(), mClusterFinder.getClusters().begin(), mClusterFinder.getClusters().end());
-
-    auto digitOffset = usedDigits.size();
-    usedDigits.insert(usedDigits.end(), mClusterFinder.getUsedDigits().begin(), mClusterFinder.getUsedDigits().end());
-
-    for (auto itCluster = clusters.begin() + clusterOffset; itCluster < clusters.end(); ++itCluster) {
-      itCluster->firstDigit += digitOffset;
-    }
-  }
-
-  ClusterFinderOriginal mClusterFinder{};             ///< clusterizer
+  ClusterFinderOriginalParallel mClusterFinder{};     ///< clusterizer
   std::chrono::duration<double> mTimeClusterFinder{}; ///< timer
 };
 
@@ -145,7 +125,8 @@ o2::framework::DataProcessorSpec getClusterFinderOriginalSpec()
             OutputSpec{{"clusterdigits"}, "MCH", "CLUSTERDIGITS", 0, Lifetime::Timeframe}},
     AlgorithmSpec{adaptFromTask<ClusterFinderOriginalTask>()},
     Options{{"config", VariantType::String, "", {"JSON or INI file with clustering parameters"}},
-            {"run2-config", VariantType::Bool, false, {"setup for run2 data"}}}};
+            {"run2-config", VariantType::Bool, false, {"setup for run2 data"}},
+            {"n-threads", VariantType::Int, 1, {"number of threads used to clusterize the preclusters of an event"}}}};
 }
 
 } // end namespace mch
@@ -17,7 +17,6 @@
 #include "TrackFinderSpec.h"
 
 #include <chrono>
-#include <unordered_map>
 #include <list>
 #include <stdexcept>
 #include <string>
@@ -100,15 +99,9 @@ class TrackFinderTask
 
       //LOG(INFO) << "processing interaction: " << clusterROF.getBCData() << "...";
 
-      // get the input clusters of the current event
-      std::unordered_map<int, std::list<Cluster>> clusters{};
-      for (const auto& cluster : clustersIn.subspan(clusterROF.getFirstIdx(), clusterROF.getNEntries())) {
-        clusters[cluster.getDEId()].emplace_back(cluster);
-      }
-
-      // run the track finder
+      // run the track finder on the input clusters of the current event
       auto tStart = std::chrono::high_resolution_clock::now();
-      const auto& tracks = mTrackFinder.findTracks(clusters);
+      const auto& tracks = mTrackFinder.findTracks(clustersIn.subspan(clusterROF.getFirstIdx(), clusterROF.getNEntries()));
       auto tEnd = std::chrono::high_resolution_clock::now();
       mElapsedTime += tEnd - tStart;
 
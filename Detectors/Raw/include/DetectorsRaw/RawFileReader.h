@@ -23,6 +23,7 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <memory>
 #include <Rtypes.h>
 #include "Headers/RAWDataHeader.h"
 #include "Headers/DataHeader.h"
@@ -48,6 +49,7 @@ struct ReaderInp {
   uint32_t maxTF = 0xffffffff;
   bool partPerSP = true;
   bool cache = false;
+  bool mapFiles = false;
   bool autodetectTF0 = false;
   bool preferCalcTF = false;
 };
@@ -202,6 +204,7 @@ class RawFileReader
     size_t readNextHBF(char* buff);
     size_t readNextTF(char* buff);
     size_t readNextSuperPage(char* buff, const PartStat* pstat = nullptr);
+    size_t mapNextSuperPage(const char*& ptr, const PartStat* pstat = nullptr);
     size_t skipNextHBF();
     size_t skipNextTF();
 
@@ -264,6 +267,13 @@ class RawFileReader
   bool getCacheData() const { return mCacheData; }
   void setCacheData(bool v) { mCacheData = v; }
 
+  // memory-map the input files at initialization, the data are then read w/o syscalls and the superpages can be accessed in place
+  bool getMapFiles() const { return mMapFiles; }
+  void setMapFiles(bool v) { mMapFiles = v; }
+  bool isFileMapped(int fileID) const { return fileID < int(mFileMaps.size()) && mFileMaps[fileID]; }
+  const std::shared_ptr<const char>& getFileMapping(int fileID) const { return mFileMaps[fileID]; }
+  void prefetchTF(uint32_t tf) const;
+
   o2::header::DataOrigin getDefaultDataOrigin() const { return mDefDataOrigin; }
   o2::header::DataDescription getDefaultDataSpecification() const { return mDefDataDescription; }
   ReadoutCardType getDefaultReadoutCardType() const { return mDefCardType; }
@@ -284,6 +294,8 @@ class RawFileReader
  private:
   int getLinkLocalID(const RDHAny& rdh, int fileID);
   bool preprocessFile(int ifl);
+  bool mapFile(int ifl);
+  bool readFromFile(int fileID, size_t offset, char* buff, size_t size);
   static LinkSpec_t createSpec(o2::header::DataOrigin orig, LinkSubSpec_t ss) { return (LinkSpec_t(orig) << 32) | ss; }
 
   static constexpr o2::header::DataOrigin DEFDataOrigin = o2::header::gDataOriginFLP;
@@ -295,6 +307,8 @@ class RawFileReader
   std::vector<std::string> mFileNames;                                  //! input file names
   std::vector<FILE*> mFiles;                                            //! input file handlers
   std::vector<std::unique_ptr<char[]>> mFileBuffers;                    //! buffers for input files
+  std::vector<std::shared_ptr<const char>> mFileMaps;                   //! memory mappings of input files (if requested)
+  std::vector<size_t> mFileSizes;                                       //! sizes of the mapped input files
   std::vector<OrigDescCard> mDataSpecs;                                 //! data origin and description for every input file + readout card type
   bool mInitDone = false;
   bool mEmpty = true;
@@ -312,6 +326,7 @@ class RawFileReader
   long int mPosInFile = 0;                                          //! current position in the file
   bool mMultiLinkFile = false;                                      //! was > than 1 link seen in the file?
   bool mCacheData = false;                                          //! cache data to block after 1st scan (may require excessive memory, use with care)
+  bool mMapFiles = false;                                           //! memory-map input files instead of reading them
   uint32_t mCheckErrors = 0;                                        //! mask for errors to check
   FirstTFDetection mFirstTFAutodetect = FirstTFDetection::Disabled; //!
   bool mPreferCalculatedTFStart = false;                            //! prefer TFstart calculated via HBFUtils
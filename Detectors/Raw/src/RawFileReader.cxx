@@ -30,6 +30,9 @@
 #include <Common/Configuration.h>
 #include <TStopwatch.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace o2::raw;
 namespace o2h = o2::header;
@@ -134,8 +137,7 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
     if (blc.dataCache) {
       memcpy(buff + sz, blc.dataCache.get(), blc.size);
     } else {
-      auto fl = reader->mFiles[blc.fileID];
-      if (fseek(fl, blc.offset, SEEK_SET) || fread(buff + sz, 1, blc.size, fl) != blc.size) {
+      if (!reader->readFromFile(blc.fileID, blc.offset, buff + sz, blc.size)) {
         LOGF(ERROR, "Failed to read for the %s a bloc:", describe());
         blc.print();
         error = true;
@@ -288,8 +290,7 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
     if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
       memcpy(buff, blocks[nextBlock2Read].dataCache.get(), sz);
     } else {
-      auto fl = reader->mFiles[blocks[nextBlock2Read].fileID];
-      if (fseek(fl, blocks[nextBlock2Read].offset, SEEK_SET) || fread(buff, 1, sz, fl) != sz) {
+      if (!reader->readFromFile(blocks[nextBlock2Read].fileID, blocks[nextBlock2Read].offset, buff, sz)) {
         LOGF(ERROR, "Failed to read for the %s a bloc:", describe());
         blocks[nextBlock2Read].print();
         error = true;
@@ -303,6 +304,45 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   return error ? 0 : sz; // in case of the error we ignore the data
 }
 
+//____________________________________________
+size_t RawFileReader::LinkData::mapNextSuperPage(const char*& ptr, const RawFileReader::PartStat* pstat)
+{
+  // provide pointer on the data of the next superpage in the memory-mapped file, w/o copying
+  // The blocks of the superpage are contiguous in the file, see readNextSuperPage
+  ptr = nullptr;
+  if (nextBlock2Read < 0 || nextBlock2Read >= int(blocks.size()) || !reader->isFileMapped(blocks[nextBlock2Read].fileID)) {
+    return 0;
+  }
+  const auto& blc = blocks[nextBlock2Read];
+  size_t sz = 0;
+  int ibl = nextBlock2Read, nbl = blocks.size();
+  if (pstat) {
+    sz = pstat->size;
+    ibl += pstat->nBlocks;
+  } else {
+    while (ibl < nbl) {
+      const auto& blcn = blocks[ibl];
+      if (ibl > nextBlock2Read && (blcn.tfID != blc.tfID ||
+                                   blcn.testFlag(LinkBlock::StartSP) ||
+                                   (sz + blcn.size) > reader->mNominalSPageSize ||
+                                   blocks[ibl - 1].offset + blocks[ibl - 1].size < blcn.offset)) { // new superpage or TF
+        break;
+      }
+      ibl++;
+      sz += blcn.size;
+    }
+  }
+  if (blc.offset + sz > reader->mFileSizes[blc.fileID]) {
+    // the superpage is left for readNextSuperPage
+    LOGF(ERROR, "Failed to map for the %s a bloc:", describe());
+    blc.print();
+    return 0;
+  }
+  nextBlock2Read = ibl;
+  ptr = reader->mFileMaps[blc.fileID].get() + blc.offset;
+  return sz;
+}
+
 //____________________________________________
 size_t RawFileReader::LinkData::getLargestSuperPage() const
 {
@@ -564,7 +604,9 @@ int RawFileReader::getLinkLocalID(const RDHAny& rdh, int fileID)
 bool RawFileReader::preprocessFile(int ifl)
 {
   // preprocess file, check RDH data, build statistics
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(mBufferSize);
+  // for the memory-mapped file the RDHs are inspected in place
+  std::unique_ptr<char[]> readBuffer = isFileMapped(ifl) ? nullptr : std::make_unique<char[]>(mBufferSize);
+  const char* buffer = readBuffer.get();
   FILE* fl = mFiles[ifl];
   mCurrentFileID = ifl;
   LinkSpec_t specPrev = 0xffffffffffffffff;
@@ -575,10 +617,21 @@ bool RawFileReader::preprocessFile(int ifl)
   mPosInFile = 0;
   size_t nRDHread = 0, boffs;
   bool readMore = true;
-  while (readMore && (nr = fread(buffer.get(), 1, mBufferSize, fl))) {
+  while (readMore) {
+    if (readBuffer) {
+      if (!(nr = fread(readBuffer.get(), 1, mBufferSize, fl))) {
+        break;
+      }
+    } else {
+      if (mPosInFile + sizeof(RDHUtils::RDHAny) > mFileSizes[ifl]) {
+        break;
+      }
+      buffer = mFileMaps[ifl].get() + mPosInFile;
+      nr = mFileSizes[ifl] - mPosInFile;
+    }
     boffs = 0;
     while (1) {
-      auto& rdh = *reinterpret_cast<RDHUtils::RDHAny*>(&buffer[boffs]);
+      auto& rdh = *reinterpret_cast<const RDHUtils::RDHAny*>(&buffer[boffs]);
       nRDHread++;
       LinkSpec_t spec = createSpec(std::get<0>(mDataSpecs[mCurrentFileID]), RDHUtils::getSubSpec(rdh));
       int lID = lIDPrev;
@@ -608,7 +661,7 @@ bool RawFileReader::preprocessFile(int ifl)
       mPosInFile += RDHUtils::getOffsetToNext(rdh);
       lIDPrev = lID;
       if (boffs + sizeof(RDHUtils::RDHAny) >= nr) {
-        if (fseek(fl, mPosInFile, SEEK_SET)) {
+        if (readBuffer && fseek(fl, mPosInFile, SEEK_SET)) {
           readMore = false;
           break;
         }
@@ -621,6 +674,59 @@ bool RawFileReader::preprocessFile(int ifl)
   return nRDHread > 0;
 }
 
+//_____________________________________________________________________
+bool RawFileReader::mapFile(int ifl)
+{
+  // memory-map the input file, in case of failure the file will be read
+  struct stat st;
+  int fd = fileno(mFiles[ifl]);
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    LOGF(WARNING, "Failed to map file %s, will read it", mFileNames[ifl]);
+    return false;
+  }
+  size_t size = st.st_size;
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    LOGF(WARNING, "Failed to map file %s, will read it", mFileNames[ifl]);
+    return false;
+  }
+  mFileMaps[ifl] = std::shared_ptr<const char>(reinterpret_cast<const char*>(addr), [size](const char* ptr) { munmap(const_cast<char*>(ptr), size); });
+  mFileSizes[ifl] = size;
+  return true;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::readFromFile(int fileID, size_t offset, char* buff, size_t size)
+{
+  // copy the data from the mapped file or read them, e.g. if they are beyond the mapped size
+  if (isFileMapped(fileID) && offset + size <= mFileSizes[fileID]) {
+    memcpy(buff, mFileMaps[fileID].get() + offset, size);
+    return true;
+  }
+  auto fl = mFiles[fileID];
+  return !fseek(fl, offset, SEEK_SET) && fread(buff, 1, size, fl) == size;
+}
+
+//_____________________________________________________________________
+void RawFileReader::prefetchTF(uint32_t tf) const
+{
+  // ask the kernel to start reading asynchronously the mapped pages of given TF
+  static const size_t pageSize = sysconf(_SC_PAGESIZE);
+  for (const auto& link : mLinksData) {
+    if (tf >= link.tfStartBlock.size()) {
+      continue;
+    }
+    for (int ibl = link.tfStartBlock[tf].first, nbl = link.blocks.size(); ibl < nbl && link.blocks[ibl].tfID == link.blocks[link.tfStartBlock[tf].first].tfID; ibl++) {
+      const auto& blc = link.blocks[ibl];
+      if (!isFileMapped(blc.fileID)) {
+        break;
+      }
+      size_t start = blc.offset / pageSize * pageSize;
+      madvise(const_cast<char*>(mFileMaps[blc.fileID].get()) + start, blc.offset + blc.size - start, MADV_WILLNEED);
+    }
+  }
+}
+
 //_____________________________________________________________________
 void RawFileReader::printStat(bool verbose) const
 {
@@ -639,6 +745,8 @@ void RawFileReader::clear()
   mLinkEntries.clear();
   mOrderedIDs.clear();
   mLinksData.clear();
+  mFileMaps.clear();
+  mFileSizes.clear();
   for (auto fl : mFiles) {
     fclose(fl);
   }
@@ -701,7 +809,14 @@ bool RawFileReader::init()
 
   int nf = mFiles.size();
   mEmpty = true;
+  mFileMaps.clear();
+  mFileMaps.resize(nf);
+  mFileSizes.clear();
+  mFileSizes.resize(nf);
   for (int i = 0; i < nf; i++) {
+    if (mMapFiles) {
+      mapFile(i);
+    }
     if (preprocessFile(i)) {
       mEmpty = false;
     }
@@ -92,10 +92,15 @@ class RawReaderSpecs : public o2f::Task
 RawReaderSpecs::RawReaderSpecs(const ReaderInp& rinp)
   : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mPartPerSP(rinp.partPerSP), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, 0, rinp.bufferSize)), mRawChannelName(rinp.rawChannelConfig)
 {
+  if (rinp.cache && rinp.mapFiles) {
+    // the superpages of the mapped files are sent w/o copying, there is nothing to cache
+    throw std::runtime_error("cache-data and map-files options cannot be used together");
+  }
   mReader->setCheckErrors(rinp.errMap);
   mReader->setMaxTFToRead(rinp.maxTF);
   mReader->setNominalSPageSize(rinp.spSize);
   mReader->setCacheData(rinp.cache);
+  mReader->setMapFiles(rinp.mapFiles);
   mReader->setTFAutodetect(rinp.autodetectTF0 ? RawFileReader::FirstTFDetection::Pending : RawFileReader::FirstTFDetection::Disabled);
   mReader->setPreferCalculatedTFStart(rinp.preferCalcTF);
   LOG(INFO) << "Will preprocess files with buffer size of " << rinp.bufferSize << " bytes";
@@ -255,9 +260,26 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     while (hdrTmpl.splitPayloadIndex < hdrTmpl.splitPayloadParts) {
       hdrTmpl.payloadSize = mPartPerSP ? partsSP[hdrTmpl.splitPayloadIndex].size : link.getNextHBFSize();
       auto hdMessage = fmqFactory->CreateMessage(hstackSize, fair::mq::Alignment{64});
-      auto plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+      FairMQMessagePtr plMessage;
+      size_t bread = 0;
       mTimer[TimerIO].Start(false);
-      auto bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      if (mPartPerSP && mReader->isFileMapped(link.blocks[link.nextBlock2Read].fileID)) {
+        // superpage is sent from the mapped file, the message keeps the mapping alive until it is released by the transport
+        const char* spData = nullptr;
+        auto fileID = link.blocks[link.nextBlock2Read].fileID;
+        bread = link.mapNextSuperPage(spData, &partsSP[hdrTmpl.splitPayloadIndex]);
+        if (spData) {
+          auto mapping = new std::shared_ptr<const char>(mReader->getFileMapping(fileID));
+          plMessage = fmqFactory->CreateMessage(
+            const_cast<char*>(spData), bread, [](void*, void* hint) { delete static_cast<std::shared_ptr<const char>*>(hint); }, mapping);
+        } else {
+          LOG(WARNING) << "Link " << il << " failed to map the superpage of TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex << ", reading it";
+        }
+      }
+      if (!plMessage) {
+        plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
+        bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
+      }
       if (bread != hdrTmpl.payloadSize) {
         LOG(ERROR) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
                    << " expected in TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex;
@@ -314,6 +336,9 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
   mSentMessages += tfNParts;
 
   mReader->setNextTFToRead(++tfID);
+  if (tfID <= mMaxTFID) {
+    mReader->prefetchTF(tfID); // let the kernel read the mapped data of the next TF while this one is processed
+  }
   ++mTFCounter;
 }
 
@@ -388,3 +388,41 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_RORC)
 }
 
 } // namespace o2
+
+BOOST_AUTO_TEST_CASE(RawReaderWriter_Mapped)
+{
+  TestRawWriter dw{"TST", true, "test_raw_conf_GBT.cfg"};
+  dw.init();
+  dw.run(); // write output
+
+  // the superpages provided in place by the memory-mapped reader must be identical to those read by the standard one
+  RawFileReader reader("test_raw_conf_GBT.cfg"), readerMapped("test_raw_conf_GBT.cfg");
+  readerMapped.setMapFiles(true);
+  reader.init();
+  readerMapped.init();
+  BOOST_REQUIRE(readerMapped.getNLinks() == reader.getNLinks() && readerMapped.getNTimeFrames() == reader.getNTimeFrames());
+  std::vector<RawFileReader::PartStat> parts, partsMapped;
+  std::vector<char> buff;
+  size_t nSP = 0;
+  for (uint32_t tf = 0; tf < reader.getNTimeFrames(); tf++) {
+    readerMapped.prefetchTF(tf);
+    for (int il = 0; il < reader.getNLinks(); il++) {
+      auto& lnk = reader.getLink(il);
+      auto& lnkMapped = readerMapped.getLink(il);
+      BOOST_REQUIRE(lnk.rewindToTF(tf) && lnkMapped.rewindToTF(tf));
+      BOOST_REQUIRE(readerMapped.isFileMapped(lnkMapped.blocks[lnkMapped.nextBlock2Read].fileID));
+      lnk.getNextTFSuperPagesStat(parts);
+      lnkMapped.getNextTFSuperPagesStat(partsMapped);
+      BOOST_REQUIRE(parts.size() == partsMapped.size());
+      for (size_t isp = 0; isp < parts.size(); isp++) {
+        buff.resize(parts[isp].size);
+        const char* ptr = nullptr;
+        BOOST_CHECK(lnk.readNextSuperPage(buff.data(), &parts[isp]) == buff.size());
+        BOOST_CHECK(lnkMapped.mapNextSuperPage(ptr, &partsMapped[isp]) == buff.size());
+        BOOST_CHECK(ptr && !memcmp(ptr, buff.data(), buff.size()));
+        nSP++;
+      }
+    }
+  }
+  BOOST_CHECK(nSP > 0);
+}
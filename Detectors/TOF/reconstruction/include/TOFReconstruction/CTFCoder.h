@@ -17,6 +17,8 @@
 #define O2_TOF_CTFCODER_H
 
 #include <algorithm>
+#include <array>
+#include <functional>
 #include <iterator>
 #include <string>
 #include "DataFormatsTOF/CTF.h"
@@ -94,9 +96,10 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ReadoutWindowData>& rofRe
 
   ec->setHeader(cc.header);
   ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
-  // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
-#define ENCODETOF(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)].get());
+  ec->getANSHeader().minorVersion = 2;
+  // the blocks are encoded concurrently, each one to the space booked for it in the buffer
+  CTF::BlockEncoders encoders;
+#define ENCODETOF(part, slot, bits) encoders[int(slot)] = CTF::makeBlockEncoder(part, bits, optField[int(slot)], mCoders[int(slot)].get());
   // clang-format off
   ENCODETOF(cc.bcIncROF,     CTF::BLCbcIncROF,     0);
   ENCODETOF(cc.orbitIncROF,  CTF::BLCorbitIncROF,  0);
@@ -110,7 +113,8 @@ void CTFCoder::encode(VEC& buff, const gsl::span<const ReadoutWindowData>& rofRe
   ENCODETOF(cc.tot,          CTF::BLCtot,          0);
   ENCODETOF(cc.pattMap,      CTF::BLCpattMap,      0);
   // clang-format on
-  CTF::get(buff.data())->print(getPrefix());
+  // the buffer might be autoexpanded, so we don't work with fixed pointer ec
+  CTF::encodeConcurrently(buff, encoders, mNThreads)->print(getPrefix());
 }
 
 ///___________________________________________________________________________________
@@ -121,7 +125,9 @@ void CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VDIG& cdigVec, VPAT&
   CompressedInfos cc;
   ec.print(getPrefix());
   cc.header = ec.getHeader();
-#define DECODETOF(part, slot) ec.decode(part, int(slot), mCoders[int(slot)].get())
+  // the blocks are independent and can be decoded concurrently
+  std::array<std::function<void()>, CTF::getNBlocks()> decoders;
+#define DECODETOF(part, slot) decoders[int(slot)] = [&]() { ec.decode(part, int(slot), mCoders[int(slot)].get()); }
   // clang-format off
   DECODETOF(cc.bcIncROF,     CTF::BLCbcIncROF);
   DECODETOF(cc.orbitIncROF,  CTF::BLCorbitIncROF);
@@ -136,6 +142,7 @@ void CTFCoder::decode(const CTF::base& ec, VROF& rofRecVec, VDIG& cdigVec, VPAT&
   DECODETOF(cc.tot,          CTF::BLCtot);
   DECODETOF(cc.pattMap,      CTF::BLCpattMap);
   // clang-format on
+  o2::ctf::runConcurrently(CTF::getNBlocks(), mNThreads, [&decoders](int slot) { decoders[slot](); });
   //
   decompress(cc, rofRecVec, cdigVec, pattVec);
 }
@@ -30,6 +30,7 @@
 #include "DataFormatsTPC/Defs.h"
 #include "SpacePoints/SpacePointsCalibParam.h"
 #include "SpacePoints/TrackInterpolation.h"
+#include "SpacePoints/VoxelResidualStore.h"
 
 #include "TTree.h"
 #include "TFile.h"
@@ -151,6 +152,20 @@ class TrackResiduals
   /// \param scP Scale factor to increase smoothing bandwidth at sector edges in Y/X
   /// \param scZ Scale factor to increase smoothing bandwidth at sector edges in Z
   void setKernelType(KernelType kernel = KernelType::Epanechnikov, float bwX = 2.1f, float bwP = 2.1f, float bwZ = 1.7f, float scX = 1.f, float scP = 1.f, float scZ = 1.f);
+  /// Sets the number of threads used to process the sectors and, for a single sector, its voxels (needs OpenMP).
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+  /// Keeps the local residuals in the in-memory voxel residual store instead of the temporary per-sector trees.
+  void setUseInMemoryResiduals(bool flag = true) { mUseInMemoryResiduals = flag; }
+  bool getUseInMemoryResiduals() const { return mUseInMemoryResiduals; }
+  /// Maps a file written with VoxelResidualStore::writeToFile read-only and uses it as input for processResiduals().
+  /// \param fileName Name of the flat residual file
+  /// \return false if the file could not be mapped or its binning does not match the current one
+  bool mapLocalResiduals(const std::string& fileName);
+  /// Access to the in-memory store of the local residuals, e.g. to write it to a flat file
+  VoxelResidualStore& getResidualStore() { return mResidualStore; }
+  /// Results of the processing of the given sector, one entry per voxel
+  const std::vector<VoxRes>& getVoxelResults(int iSec) const { return mVoxelResults[iSec]; }
 
   // -------------------------------------- steering functions --------------------------------------------------
 
@@ -173,9 +188,11 @@ class TrackResiduals
   void convertToLocalResiduals();
 
   /// Steers the processing of the residuals for all sectors.
+  /// With more than one thread the sectors are processed concurrently.
   void processResiduals();
 
   /// Processes residuals for given sector.
+  /// The voxels are processed concurrently if more than one thread is set and we are not inside processResiduals().
   /// \param iSec Sector to process
   void processSectorResiduals(Int_t iSec);
 
@@ -259,7 +276,7 @@ class TrackResiduals
   /// \param res Array to store the results
   /// \param whichDim Integer value with bits set for the dimensions which need to be smoothed
   /// \return Flag if the estimate was successfull
-  bool getSmoothEstimate(int iSec, float x, float p, float z, std::array<float, ResDim>& res, int whichDim = 0);
+  bool getSmoothEstimate(int iSec, float x, float p, float z, std::array<float, ResDim>& res, int whichDim = 0) const;
 
   /// Calculates the weight of the given point used for the kernel smoothing.
   /// Takes into account the defined kernel in mKernelType.
@@ -510,6 +527,23 @@ class TrackResiduals
   void closeOutputFile();
 
  private:
+  /// Adds mLocalResid to the in-memory residual store, applying the same cuts as when reading the residual trees
+  /// \param iSec Sector of the residual
+  void storeLocalResidual(int iSec);
+
+  /// Fills the in-memory residual store for given sector from its temporary residual tree
+  /// \param iSec Sector to load
+  /// \return false if no data is available for this sector
+  bool loadSectorResiduals(int iSec);
+
+  /// Unpacks the residuals of one voxel from the residual store
+  /// \param iSec Sector of the voxel
+  /// \param voxBin Global voxel bin
+  /// \param dy Vector to store the residuals in y
+  /// \param dz Vector to store the residuals in z (skipped if nullptr)
+  /// \param tg Vector to store tan(phi) of the tracks
+  void getVoxelResiduals(int iSec, int voxBin, std::vector<float>& dy, std::vector<float>* dz, std::vector<float>& tg) const;
+
   // names of input files / trees
   std::string mInputFileNameResiduals{"residuals_tpc.root"}; ///< name of file with track residuals
   // some constants
@@ -533,6 +567,7 @@ class TrackResiduals
   // status flags
   bool mIsInitialized{}; ///< initialize only once
   bool mPrintMem{};      ///< turn on to print memory usage at certain points
+  int mNThreads{1};      ///< number of threads for the sector / voxel processing
   // binning
   int mNXBins{param::NPadRows};            ///< number of bins in radial direction
   int mNY2XBins{param::NY2XBins};          ///< number of y/x bins per sector
@@ -558,6 +593,9 @@ class TrackResiduals
   std::array<std::unique_ptr<TTree>, SECTORSPERSIDE * SIDES> mTmpTree{}; ///< I/O tree per sector
   LocalResid mLocalResid{};                                              ///< data exchange structure for filling mTmpTree
   LocalResid* mLocalResidPtr{&mLocalResid};                              ///< pointer to mLocalResid
+  bool mUseInMemoryResiduals{false};                                     ///< keep local residuals in mResidualStore instead of mTmpTree
+  VoxelResidualStore mResidualStore{};                                   //!< local residuals bucketed by voxel
+  std::array<int, SECTORSPERSIDE * SIDES> mNLocalResiduals{};            //!< local residuals passed to mResidualStore per sector, for the mMaxPointsPerSector limit
   // settings
   std::string mLocalResFileName{"deltasSect"};   ///< filename for local residuals input
   std::string mLocalResTreeName{"treeSec"};      ///< name for tree with local residuals
@@ -584,7 +622,6 @@ class TrackResiduals
   std::array<int, VoxDim> mStepKern{};                             ///< N bins to consider with given kernel settings
   std::array<float, VoxDim> mKernelScaleEdge{};                    ///< optional scaling factors for kernel width on the edge
   std::array<float, VoxDim> mKernelWInv{};                         ///< inverse kernel width in bins
-  std::array<double, ResDim * sMaxSmtDim> mLastSmoothingRes{};     ///< results of last smoothing operation
   // (intermediate) results
   std::array<std::bitset<param::NPadRows>, SECTORSPERSIDE * SIDES> mXBinsIgnore{};          ///< flags which X bins to ignore
   std::array<std::array<float, param::NPadRows>, SECTORSPERSIDE * SIDES> mValidFracXBins{}; ///< for each sector for each X-bin the fraction of validated voxels
@@ -0,0 +1,132 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file VoxelResidualStore.h
+/// \brief Definition of the VoxelResidualStore class, an in-memory container of the local TPC residuals
+
+#ifndef ALICEO2_TPC_VOXELRESIDUALSTORE_H_
+#define ALICEO2_TPC_VOXELRESIDUALSTORE_H_
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "DataFormatsTPC/Defs.h"
+
+namespace o2
+{
+namespace tpc
+{
+
+/// \class VoxelResidualStore
+/// Columnar in-memory store of the local residuals (dy, dz, tgSlp as short, like in the compact trees) of all TPC sectors.
+/// The points are appended per sector in any voxel order. finalize() buckets them such that the points of each voxel
+/// occupy a contiguous range [getFirstPoint(), getFirstPoint() + getNPoints()) of the columns of their sector, keeping
+/// the fill order within a voxel.
+/// A finalized store can be written to a flat binary file and mapped back read-only, in which case the columns
+/// point directly into the mapped file.
+class VoxelResidualStore
+{
+ public:
+  static constexpr int NSectors = SECTORSPERSIDE * SIDES;
+  static constexpr uint32_t Magic = 0x53525654; ///< "TVRS"
+  static constexpr uint32_t Version = 1;
+  static constexpr int MaxVoxPerSector = 1 << 16; ///< the voxel bins are stored as unsigned short until the finalization
+
+  /// Header of the flat file, followed by the number of points per sector (uint64_t), the voxel offsets of all
+  /// sectors (uint32_t, nVoxPerSector + 1 each) and finally the dy, dz and tgSlp columns of each sector
+  struct FileHeader {
+    uint32_t magic{Magic};
+    uint32_t version{Version};
+    uint32_t nSectors{NSectors};
+    uint32_t nVoxPerSector{0};
+  };
+
+  VoxelResidualStore() = default;
+
+  /// Resets the store and sets the number of voxels per sector, at most MaxVoxPerSector
+  void init(int nVoxPerSector);
+  /// Drops all data, also releasing a mapped file
+  void clear();
+  /// Drops the data of a single sector which is not mapped from a file
+  void clearSector(int iSec);
+  /// Reserves space for nPoints in the given sector
+  void reserve(int iSec, size_t nPoints);
+
+  /// Appends a point to a sector which is not finalized yet, voxBin must be below the number of voxels per sector
+  void addPoint(int iSec, unsigned short voxBin, short dy, short dz, short tgSlp)
+  {
+    auto& sec = mSectors[iSec];
+    sec.voxel.push_back(voxBin);
+    sec.dy.push_back(dy);
+    sec.dz.push_back(dz);
+    sec.tgSlp.push_back(tgSlp);
+  }
+
+  /// Buckets the points of the given sector by voxel, no-op if this is already done
+  void finalize(int iSec);
+  /// Buckets the points of all sectors by voxel
+  void finalize();
+
+  int getNVoxPerSector() const { return mNVoxPerSector; }
+  bool isFinalized(int iSec) const { return mViews[iSec].offsets != nullptr; }
+  bool isMapped() const { return mMapping != nullptr; }
+
+  /// Number of points in the sector (also before the finalization)
+  size_t getNPoints(int iSec) const { return isFinalized(iSec) ? mViews[iSec].nPoints : mSectors[iSec].dy.size(); }
+  /// Number of points in the voxel of a finalized sector
+  size_t getNPoints(int iSec, int voxBin) const { return mViews[iSec].offsets[voxBin + 1] - mViews[iSec].offsets[voxBin]; }
+  /// Index of the first point of the voxel of a finalized sector
+  size_t getFirstPoint(int iSec, int voxBin) const { return mViews[iSec].offsets[voxBin]; }
+
+  /// Columns of a finalized sector
+  const short* getDY(int iSec) const { return mViews[iSec].dy; }
+  const short* getDZ(int iSec) const { return mViews[iSec].dz; }
+  const short* getTgSlp(int iSec) const { return mViews[iSec].tgSlp; }
+
+  /// Writes the finalized store to a flat binary file
+  /// \return false if the store is not finalized or the file could not be written
+  bool writeToFile(const std::string& fileName) const;
+  /// Maps a file created by writeToFile read-only into memory, replacing the current content
+  /// \return false if the file could not be mapped or is not compatible
+  bool mapFile(const std::string& fileName);
+
+ private:
+  /// Owned data of a sector; the voxel column is only needed until the finalization
+  struct SectorColumns {
+    std::vector<unsigned short> voxel{};
+    std::vector<short> dy{};
+    std::vector<short> dz{};
+    std::vector<short> tgSlp{};
+    std::vector<uint32_t> offsets{};
+  };
+
+  /// Read access to the finalized data of a sector, pointing either to the owned or to the mapped columns
+  struct SectorView {
+    size_t nPoints{0};
+    const uint32_t* offsets{nullptr};
+    const short* dy{nullptr};
+    const short* dz{nullptr};
+    const short* tgSlp{nullptr};
+  };
+
+  int mNVoxPerSector{0};                          ///< number of voxels per sector
+  std::array<SectorColumns, NSectors> mSectors{}; ///< owned columns per sector
+  std::array<SectorView, NSectors> mViews{};      ///< access to finalized sectors
+  std::shared_ptr<const char> mMapping{};         ///< mapped file, if any
+};
+
+} // namespace tpc
+} // namespace o2
+
+#endif
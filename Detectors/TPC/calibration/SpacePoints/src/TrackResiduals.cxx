@@ -32,6 +32,7 @@
 // for debugging
 #include "TStopwatch.h"
 #include "TSystem.h"
+#include "TROOT.h"
 #include <iostream>
 #include <fstream>
 #include <limits>
@@ -39,6 +40,10 @@
 
 #include <fairlogger/Logger.h>
 
+#ifdef WITH_OPENMP
+#include <omp.h>
+#endif
+
 //#define TPC_RUN2 // if defined, use run 2 geometry for TPC
 
 #define LOCAL_RESIDUAL_FORMAT_OLD // if defined, data in compact trees is stored as Double32_t, otherwise as short
@@ -66,6 +71,8 @@ void TrackResiduals::init()
   for (int i = 0; i < SECTORSPERSIDE * SIDES; i++) {
     mVoxelResults[i].resize(mNVoxPerSector);
   }
+  mResidualStore.init(mNVoxPerSector);
+  mNLocalResiduals.fill(0);
   mSmoothPol2[VoxX] = true;
   mSmoothPol2[VoxF] = true;
   setKernelType();
@@ -532,8 +539,12 @@ void TrackResiduals::fillLocalResidualsTrees()
     mLocalResid.dy = static_cast<short>(mArrDY[iCl] * 0x7fff / param::MaxResid);
     mLocalResid.dz = static_cast<short>(mArrDZ[iCl] * 0x7fff / param::MaxResid);
     mLocalResid.tgSlp = static_cast<short>(mArrTgSlp[iCl] * 0x7fff / param::MaxTgSlp);
-    // fill tree
-    mTmpTree[secId]->Fill();
+    // fill tree or in-memory store
+    if (mUseInMemoryResiduals) {
+      storeLocalResidual(secId);
+    } else {
+      mTmpTree[secId]->Fill();
+    }
     // TODO: fill statistics distribution within the voxel
   }
 }
@@ -691,6 +702,15 @@ void TrackResiduals::prepareDeltaTreeBranches()
 
 void TrackResiduals::prepareLocalResidualTrees()
 {
+  if (mUseInMemoryResiduals) {
+    // no temporary files, the residuals are collected in memory
+    if (!mIsInitialized) {
+      init();
+    }
+    mResidualStore.init(mNVoxPerSector);
+    mNLocalResiduals.fill(0);
+    return;
+  }
   // prepare tree structure
   for (int iSec = 0; iSec < SECTORSPERSIDE * SIDES; ++iSec) {
     mTmpFile[iSec] = std::make_unique<TFile>(Form("%s%d.root", mLocalResFileName.c_str(), iSec), "recreate");
@@ -714,6 +734,37 @@ void TrackResiduals::writeLocalResidualTreesToFile()
   }
 }
 
+void TrackResiduals::storeLocalResidual(int iSec)
+{
+  // same selection as when reading the trees: only the first mMaxPointsPerSector residuals are considered,
+  // including those which are then rejected because of their slope
+  if (mNLocalResiduals[iSec] >= mMaxPointsPerSector) {
+    return;
+  }
+  ++mNLocalResiduals[iSec];
+  if (std::abs(mLocalResid.tgSlp * param::MaxTgSlp / 0x7fff) >= param::MaxTgSlp) {
+    return;
+  }
+  mResidualStore.addPoint(iSec, getGlbVoxBin(mLocalResid.bvox), mLocalResid.dy, mLocalResid.dz, mLocalResid.tgSlp);
+}
+
+bool TrackResiduals::mapLocalResiduals(const std::string& fileName)
+{
+  if (!mIsInitialized) {
+    init();
+  }
+  if (!mResidualStore.mapFile(fileName)) {
+    return false;
+  }
+  if (mResidualStore.getNVoxPerSector() != mNVoxPerSector) {
+    LOG(error) << "binning of " << fileName << " (" << mResidualStore.getNVoxPerSector() << " voxels per sector) does not match the current one (" << mNVoxPerSector << ")";
+    mResidualStore.clear();
+    return false;
+  }
+  mUseInMemoryResiduals = true;
+  return true;
+}
+
 void TrackResiduals::convertToLocalResiduals()
 {
   // When using data generated with o2 without distortions the residuals can easily be converted
@@ -763,7 +814,11 @@ void TrackResiduals::convertToLocalResiduals()
       mLocalResid.dz = mClRes[clIdx].dz;
       mLocalResid.tgSlp = mClRes[clIdx].phi;
       mLocalResid.bvox = bvox;
-      mTmpTree[sec]->Fill();
+      if (mUseInMemoryResiduals) {
+        storeLocalResidual(sec);
+      } else {
+        mTmpTree[sec]->Fill();
+      }
       // TODO calculate mean position of clusters in each voxel (can be updated each time a new measurement is found inside voxel)
     }
   }
@@ -778,34 +833,32 @@ void TrackResiduals::processResiduals()
   if (!mIsInitialized) {
     init();
   }
+#ifdef WITH_OPENMP
+  if (mNThreads > 1) {
+    ROOT::EnableThreadSafety();
+  }
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+#endif
   for (int iSec = 0; iSec < SECTORSPERSIDE * SIDES; ++iSec) {
     processSectorResiduals(iSec);
   }
 }
 
 //______________________________________________________________________________
-void TrackResiduals::processSectorResiduals(int iSec)
+bool TrackResiduals::loadSectorResiduals(int iSec)
 {
-  if (iSec < 0 || iSec > 35) {
-    LOG(error) << "wrong sector: " << iSec;
-    return;
-  }
-  LOG(info) << "processing sector residuals for sector " << iSec;
-  if (!mIsInitialized) {
-    init();
-  }
   // open file and retrieve data tree (only local files are supported at the moment)
   std::string filename = mLocalResFileName + std::to_string(iSec) + ".root";
   std::unique_ptr<TFile> flin = std::make_unique<TFile>(filename.c_str());
   if (!flin || flin->IsZombie()) {
     LOG(error) << "failed to open " << filename.c_str();
-    return;
+    return false;
   }
   std::string treename = mLocalResTreeName + std::to_string(iSec);
   std::unique_ptr<TTree> tree((TTree*)flin->Get(treename.c_str()));
   if (!tree) {
     LOG(error) << "did not find the data tree " << treename.c_str();
-    return;
+    return false;
   }
   // read compact delte trees created with AliRoot or o2
   LocResStruct trkRes;
@@ -815,49 +868,36 @@ void TrackResiduals::processSectorResiduals(int iSec)
   if (!nPoints) {
     LOG(warning) << "no entries found for sector " << iSec;
     flin->Close();
-    return;
+    return false;
   }
   if (nPoints > mMaxPointsPerSector) {
     nPoints = mMaxPointsPerSector;
   }
-  // initialize container holding results
-  initResultsContainer(iSec);
-
   LOG(info) << "extracted " << nPoints << " of unbinned data";
 
-  std::vector<VoxRes>& secData = mVoxelResults[iSec];
-
-  unsigned int nAccepted = 0;
-
-  std::vector<float> dyData(nPoints);
-  std::vector<float> dzData(nPoints);
-  std::vector<float> tgSlpData(nPoints);
-  std::vector<unsigned short> binData(nPoints);
-
   if (mPrintMem) {
     printMem();
   }
 
-  // read input data into internal vectors
+  // read input data into the residual store
+  mResidualStore.clearSector(iSec);
+  mResidualStore.reserve(iSec, nPoints);
   for (int i = 0; i < nPoints; ++i) {
     tree->GetEntry(i);
 #ifdef LOCAL_RESIDUAL_FORMAT_OLD
     if (fabs(trkRes.tgSlp) >= param::MaxTgSlp) {
       continue;
     }
-    dyData[nAccepted] = trkRes.dy;
-    dzData[nAccepted] = trkRes.dz;
-    tgSlpData[nAccepted] = trkRes.tgSlp;
+    // convert to short to be compatible with AliRoot version
+    float dy = trkRes.dy, dz = trkRes.dz, tgSlp = trkRes.tgSlp;
+    mResidualStore.addPoint(iSec, getGlbVoxBin(trkRes.bvox[VoxX], trkRes.bvox[VoxF], trkRes.bvox[VoxZ]),
+                            short(dy * 0x7fff / param::MaxResid), short(dz * 0x7fff / param::MaxResid), short(tgSlp * 0x7fff / param::MaxTgSlp));
 #else
     if (fabs(trkRes.tgSlp * param::MaxTgSlp / 0x7fff) >= param::MaxTgSlp) {
       continue;
     }
-    dyData[nAccepted] = trkRes.dy * param::MaxResid / 0x7fff;
-    dzData[nAccepted] = trkRes.dz * param::MaxResid / 0x7fff;
-    tgSlpData[nAccepted] = trkRes.tgSlp * param::MaxTgSlp / 0x7fff;
+    mResidualStore.addPoint(iSec, getGlbVoxBin(trkRes.bvox[VoxX], trkRes.bvox[VoxF], trkRes.bvox[VoxZ]), trkRes.dy, trkRes.dz, trkRes.tgSlp);
 #endif
-    binData[nAccepted] = getGlbVoxBin(trkRes.bvox[VoxX], trkRes.bvox[VoxF], trkRes.bvox[VoxZ]);
-    nAccepted++;
   }
 
   tree.release();
@@ -867,72 +907,87 @@ void TrackResiduals::processSectorResiduals(int iSec)
     printMem();
   }
 
-  LOG(info) << "Done reading input data (accepted " << nAccepted << " points)";
-
-  std::vector<size_t> binIndices(nAccepted);
+  LOG(info) << "Done reading input data (accepted " << mResidualStore.getNPoints(iSec) << " points)";
+  return true;
+}
 
-  dyData.resize(nAccepted);
-  dzData.resize(nAccepted);
-  tgSlpData.resize(nAccepted);
-  binData.resize(nAccepted);
+//______________________________________________________________________________
+void TrackResiduals::getVoxelResiduals(int iSec, int voxBin, std::vector<float>& dy, std::vector<float>* dz, std::vector<float>& tg) const
+{
+  size_t first = mResidualStore.getFirstPoint(iSec, voxBin);
+  size_t nPoints = mResidualStore.getNPoints(iSec, voxBin);
+  const short* dyStored = mResidualStore.getDY(iSec) + first;
+  const short* tgStored = mResidualStore.getTgSlp(iSec) + first;
+  dy.resize(nPoints);
+  tg.resize(nPoints);
+  for (size_t i = 0; i < nPoints; ++i) {
+    dy[i] = dyStored[i] * param::MaxResid / 0x7fff;
+    tg[i] = tgStored[i] * param::MaxTgSlp / 0x7fff;
+  }
+  if (dz) {
+    const short* dzStored = mResidualStore.getDZ(iSec) + first;
+    dz->resize(nPoints);
+    for (size_t i = 0; i < nPoints; ++i) {
+      (*dz)[i] = dzStored[i] * param::MaxResid / 0x7fff;
+    }
+  }
+}
 
-#ifdef LOCAL_RESIDUAL_FORMAT_OLD
-  // convert to short and back to float to be compatible with AliRoot version
-  std::vector<short> dyDataShort(nAccepted);
-  std::vector<short> dzDataShort(nAccepted);
-  std::vector<short> tgSlpDataShort(nAccepted);
-  for (unsigned int i = 0; i < nAccepted; ++i) {
-    dyDataShort[i] = short(dyData[i] * 0x7fff / param::MaxResid);
-    dzDataShort[i] = short(dzData[i] * 0x7fff / param::MaxResid);
-    tgSlpDataShort[i] = short(tgSlpData[i] * 0x7fff / param::MaxTgSlp);
-
-    dyData[i] = dyDataShort[i] * param::MaxResid / 0x7fff;
-    dzData[i] = dzDataShort[i] * param::MaxResid / 0x7fff;
-    tgSlpData[i] = tgSlpDataShort[i] * param::MaxTgSlp / 0x7fff;
+//______________________________________________________________________________
+void TrackResiduals::processSectorResiduals(int iSec)
+{
+  if (iSec < 0 || iSec > 35) {
+    LOG(error) << "wrong sector: " << iSec;
+    return;
+  }
+  LOG(info) << "processing sector residuals for sector " << iSec;
+  if (!mIsInitialized) {
+    init();
   }
+  if (!mUseInMemoryResiduals) {
+    bool loaded = false;
+    // ROOT I/O is not thread safe, the residual trees are read one at a time
+#ifdef WITH_OPENMP
+#pragma omp critical(tpc_residuals_io)
 #endif
-
-  // sort in voxel increasing order
-  o2::math_utils::SortData(binData, binIndices);
+    loaded = loadSectorResiduals(iSec);
+    if (!loaded) {
+      return;
+    }
+  }
+  // bucket the points by voxel (no-op for already finalized or mapped data)
+  mResidualStore.finalize(iSec);
+  if (!mResidualStore.getNPoints(iSec)) {
+    LOG(warning) << "no entries found for sector " << iSec;
+    return;
+  }
   if (mPrintMem) {
     printMem();
   }
+  // initialize container holding results
+  initResultsContainer(iSec);
 
-  // vectors holding the data for one voxel at a time
-  std::vector<float> dyVec;
-  std::vector<float> dzVec;
-  std::vector<float> tgVec;
-  // assuming we will always have around 1000 entries per voxel
-  dyVec.reserve(1e3);
-  dzVec.reserve(1e3);
-  tgVec.reserve(1e3);
-  int currVoxBin = -1;
-  unsigned int nPointsInVox = 0;
-  unsigned int nProcessed = 0;
-  while (nProcessed < nAccepted) {
-    // read all points, voxel by voxel
-    int idx = binIndices[nProcessed];
-    if (currVoxBin != binData[idx]) {
-      if (nPointsInVox) {
-        VoxRes& resVox = secData[currVoxBin];
-        processVoxelResiduals(dyVec, dzVec, tgVec, resVox);
-      }
-      currVoxBin = binData[idx];
-      nPointsInVox = 0;
-      dyVec.clear();
-      dzVec.clear();
-      tgVec.clear();
-    }
-    dyVec.push_back(dyData[idx]);
-    dzVec.push_back(dzData[idx]);
-    tgVec.push_back(tgSlpData[idx]);
-    ++nPointsInVox;
-    ++nProcessed;
-  }
-  if (nPointsInVox) {
-    // process last voxel
-    VoxRes& resVox = secData[currVoxBin];
-    processVoxelResiduals(dyVec, dzVec, tgVec, resVox);
+  std::vector<VoxRes>& secData = mVoxelResults[iSec];
+
+#ifdef WITH_OPENMP
+  // the voxels are only processed concurrently if we are not already running one thread per sector
+  const int nThreads = omp_in_parallel() ? 1 : mNThreads;
+  if (nThreads > 1) {
+    ROOT::EnableThreadSafety();
+  }
+#endif
+
+  // the points of each voxel are contiguous in the store, so that the voxels can be processed independently
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int voxBin = 0; voxBin < mNVoxPerSector; ++voxBin) {
+    if (!mResidualStore.getNPoints(iSec, voxBin)) {
+      continue;
+    }
+    std::vector<float> dyVec, dzVec, tgVec;
+    getVoxelResiduals(iSec, voxBin, dyVec, &dzVec, tgVec);
+    processVoxelResiduals(dyVec, dzVec, tgVec, secData[voxBin]);
   }
   LOG(info) << "extracted residuals for sector " << iSec;
 
@@ -940,6 +995,9 @@ void TrackResiduals::processSectorResiduals(int iSec)
   LOG(info) << "number of validated X rows: " << nRowsOK;
   if (!nRowsOK) {
     LOG(warning) << "sector " << iSec << ": all X-bins disabled, abandon smoothing";
+    if (!mUseInMemoryResiduals) {
+      mResidualStore.clearSector(iSec);
+    }
     return;
   } else {
     smooth(iSec);
@@ -948,49 +1006,31 @@ void TrackResiduals::processSectorResiduals(int iSec)
   //return;
 
   // process dispersions
-  dyVec.clear();
-  tgVec.clear();
-  currVoxBin = -1;
-  nProcessed = 0;
-  nPointsInVox = 0;
-  while (nProcessed < nAccepted) {
-    int idx = binIndices[nProcessed];
-    if (currVoxBin != binData[idx]) {
-      if (nPointsInVox) {
-        VoxRes& resVox = secData[currVoxBin];
-        if (!getXBinIgnored(iSec, resVox.bvox[VoxX])) {
-          processVoxelDispersions(tgVec, dyVec, resVox);
-        }
-      }
-      currVoxBin = binData[idx];
-      nPointsInVox = 0;
-      dyVec.clear();
-      tgVec.clear();
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int voxBin = 0; voxBin < mNVoxPerSector; ++voxBin) {
+    VoxRes& resVox = secData[voxBin];
+    if (!mResidualStore.getNPoints(iSec, voxBin) || getXBinIgnored(iSec, resVox.bvox[VoxX])) {
+      continue;
     }
-    dyVec.push_back(dyData[idx]);
-    tgVec.push_back(tgSlpData[idx]);
-    ++nPointsInVox;
-    ++nProcessed;
+    std::vector<float> dyVec, tgVec;
+    getVoxelResiduals(iSec, voxBin, dyVec, nullptr, tgVec);
+    processVoxelDispersions(tgVec, dyVec, resVox);
   }
-  if (nPointsInVox) {
-    // process last voxel
-    VoxRes& resVox = secData[currVoxBin];
-    if (!getXBinIgnored(iSec, resVox.bvox[VoxX])) {
-      processVoxelDispersions(tgVec, dyVec, resVox);
-    }
+  if (!mUseInMemoryResiduals) {
+    mResidualStore.clearSector(iSec);
   }
-  // smooth dispersions
-  for (int ix = 0; ix < mNXBins; ++ix) {
-    if (getXBinIgnored(iSec, ix)) {
+  // smooth dispersions, the estimate only uses the unsmoothed dispersions of the neighbours
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int voxBin = 0; voxBin < mNVoxPerSector; ++voxBin) {
+    VoxRes& resVox = secData[voxBin];
+    if (getXBinIgnored(iSec, resVox.bvox[VoxX])) {
       continue;
     }
-    for (int iz = 0; iz < mNZ2XBins; ++iz) {
-      for (int ip = 0; ip < mNY2XBins; ++ip) {
-        int voxBin = getGlbVoxBin(ix, ip, iz);
-        VoxRes& resVox = secData[voxBin];
-        getSmoothEstimate(iSec, resVox.stat[VoxX], resVox.stat[VoxF], resVox.stat[VoxZ], resVox.DS, 0x1 << VoxV);
-      }
-    }
+    getSmoothEstimate(iSec, resVox.stat[VoxX], resVox.stat[VoxF], resVox.stat[VoxZ], resVox.DS, 0x1 << VoxV);
   }
   LOG(info) << "Done processing residuals for sector " << iSec;
   dumpResults(iSec);
@@ -1185,22 +1225,30 @@ int TrackResiduals::validateVoxels(int iSec)
 void TrackResiduals::smooth(int iSec)
 {
   std::vector<VoxRes>& secData = mVoxelResults[iSec];
-  for (int ix = 0; ix < mNXBins; ++ix) {
-    if (getXBinIgnored(iSec, ix)) {
+  // the estimates only read the unsmoothed results of the neighbours, so they are computed concurrently
+  // and the flags are updated afterwards
+  std::vector<char> smoothOK(mNVoxPerSector, 0);
+#ifdef WITH_OPENMP
+  const int nThreads = omp_in_parallel() ? 1 : mNThreads;
+#pragma omp parallel for schedule(dynamic) num_threads(nThreads)
+#endif
+  for (int voxBin = 0; voxBin < mNVoxPerSector; ++voxBin) {
+    VoxRes& resVox = secData[voxBin];
+    if (getXBinIgnored(iSec, resVox.bvox[VoxX])) {
       continue;
     }
-    for (int ip = 0; ip < mNY2XBins; ++ip) {
-      for (int iz = 0; iz < mNZ2XBins; ++iz) {
-        int voxBin = getGlbVoxBin(ix, ip, iz);
-        VoxRes& resVox = secData[voxBin];
-        resVox.flags &= ~SmoothDone;
-        bool res = getSmoothEstimate(resVox.bsec, resVox.stat[VoxX], resVox.stat[VoxF], resVox.stat[VoxZ], resVox.DS, (0x1 << VoxX | 0x1 << VoxF | 0x1 << VoxZ));
-        if (!res) {
-          mNSmoothingFailedBins[iSec]++;
-        } else {
-          resVox.flags |= SmoothDone;
-        }
-      }
+    smoothOK[voxBin] = getSmoothEstimate(resVox.bsec, resVox.stat[VoxX], resVox.stat[VoxF], resVox.stat[VoxZ], resVox.DS, (0x1 << VoxX | 0x1 << VoxF | 0x1 << VoxZ));
+  }
+  for (int voxBin = 0; voxBin < mNVoxPerSector; ++voxBin) {
+    VoxRes& resVox = secData[voxBin];
+    if (getXBinIgnored(iSec, resVox.bvox[VoxX])) {
+      continue;
+    }
+    resVox.flags &= ~SmoothDone;
+    if (!smoothOK[voxBin]) {
+      mNSmoothingFailedBins[iSec]++;
+    } else {
+      resVox.flags |= SmoothDone;
     }
   }
   // substract dX contribution to dZ
@@ -1222,7 +1270,7 @@ void TrackResiduals::smooth(int iSec)
   }
 }
 
-bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std::array<float, ResDim>& res, int whichDim)
+bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std::array<float, ResDim>& res, int whichDim) const
 {
   // get smooth estimate for distortions for point in sector coordinates
   /// \todo correct use of the symmetric matrix should speed up the code
@@ -1248,19 +1296,18 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
 
   int ix0, ip0, iz0;
   findVoxel(x, p, iSec < SECTORSPERSIDE ? z : -z, ix0, ip0, iz0); // find nearest voxel
-  std::vector<VoxRes>& secData = mVoxelResults[iSec];
-  int binCenter = getGlbVoxBin(ix0, ip0, iz0); // global bin of nearest voxel
-  VoxRes& voxCenter = secData[binCenter];      // nearest voxel
+  const std::vector<VoxRes>& secData = mVoxelResults[iSec];
+  int binCenter = getGlbVoxBin(ix0, ip0, iz0);  // global bin of nearest voxel
+  const VoxRes& voxCenter = secData[binCenter]; // nearest voxel
   LOG(debug) << "getting smooth estimate around voxel " << binCenter;
 
   // cache
   // \todo maybe a 1-D cache would be more efficient?
   std::array<std::array<double, sMaxSmtDim*(sMaxSmtDim + 1) / 2>, ResDim> cmat;
+  std::array<double, ResDim * sMaxSmtDim> rhs; // right hand sides, local such that voxels can be smoothed concurrently
   int maxNeighb = 10 * 10 * 10;
-  std::vector<VoxRes*> currVox;
-  currVox.reserve(maxNeighb);
-  std::vector<float> currCache;
-  currCache.reserve(maxNeighb * VoxHDim);
+  std::vector<const VoxRes*> currVox(maxNeighb);
+  std::vector<float> currCache(maxNeighb * VoxHDim);
 
   std::array<int, VoxDim> maxTrials;
   maxTrials[VoxZ] = mNZ2XBins / 2;
@@ -1270,7 +1317,7 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
   std::array<int, VoxDim> trial{0};
 
   while (true) {
-    std::fill(mLastSmoothingRes.begin(), mLastSmoothingRes.end(), 0);
+    rhs.fill(0);
     memset(&cmat[0][0], 0, sizeof(cmat));
 
     int nbOK = 0; // accounted neighbours
@@ -1339,8 +1386,8 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
     int nbCheck = (ixMax - ixMin + 1) * (ipMax - ipMin + 1) * (izMax - izMin + 1);
     if (nbCheck >= maxNeighb) {
       maxNeighb = nbCheck + 100;
-      currCache.reserve(maxNeighb * VoxHDim);
-      currVox.reserve(maxNeighb);
+      currCache.resize(maxNeighb * VoxHDim);
+      currVox.resize(maxNeighb);
     }
     std::array<double, 3> u2Vec;
 
@@ -1349,7 +1396,7 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
       for (int ip = ipMin; ip <= ipMax; ++ip) {
         for (int iz = izMin; iz <= izMax; ++iz) {
           int binNb = getGlbVoxBin(ix, ip, iz);
-          VoxRes& voxNb = secData[binNb];
+          const VoxRes& voxNb = secData[binNb];
           if (!(voxNb.flags & DistDone) ||
               (voxNb.flags & Masked) ||
               getXBinIgnored(iSec, ix)) {
@@ -1456,7 +1503,7 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
           wi /= (voxNb->E[iDim] * voxNb->E[iDim]);
         }
         std::array<double, sMaxSmtDim*(sMaxSmtDim + 1) / 2>& cmatD = cmat[iDim];
-        double* rhsD = &mLastSmoothingRes[iDim * sMaxSmtDim];
+        double* rhsD = &rhs[iDim * sMaxSmtDim];
         unsigned short iMat = 0;
         unsigned short iRhs = 0;
         // linear part
@@ -1522,7 +1569,7 @@ bool TrackResiduals::getSmoothEstimate(int iSec, float x, float p, float z, std:
       }
       matrix.Zero(); // reset matrix
       std::array<double, sMaxSmtDim*(sMaxSmtDim + 1) / 2>& cmatD = cmat[iDim];
-      double* rhsD = &mLastSmoothingRes[iDim * sMaxSmtDim];
+      double* rhsD = &rhs[iDim * sMaxSmtDim];
       short iMat = -1;
       short iRhs = -1;
       short row = -1;
@@ -1858,14 +1905,18 @@ float TrackResiduals::roFunc(int nPoints, int offset, const std::vector<float>&
     }
     //aa = (nPoints & 0x1) ? selectKthMin(nPointsHalf, vecTmp) : .5f * (selectKthMin(nPointsHalf - 1, vecTmp) + selectKthMin(nPointsHalf, vecTmp));
   }
+  // the signed contributions are evaluated without branches such that the loop can be vectorized,
+  // they are summed in the same order as in the AliRoot version such that the result is identical
+  const float* xv = x.data() + offset;
+  const float* yv = y.data() + offset;
+  for (int j = 0; j < nPoints; ++j) {
+    float absY = std::abs(yv[j]);
+    float d = (yv[j] - (b * xv[j] + aa)) / (absY != 0.f ? absY : 1.f);
+    float contrib = d >= 0.f ? xv[j] : -xv[j];
+    vecTmp[j] = std::abs(d) > sFloatEps ? contrib : 0.f;
+  }
   for (int j = nPoints; j-- > 0;) {
-    float d = y[j + offset] - (b * x[j + offset] + aa);
-    if (y[j + offset] != 0.f) {
-      d /= fabs(y[j + offset]);
-    }
-    if (fabs(d) > sFloatEps) {
-      sum += (d >= 0.f ? x[j + offset] : -x[j + offset]);
-    }
+    sum += vecTmp[j];
   }
   return sum;
 }
@@ -2221,6 +2272,9 @@ void TrackResiduals::dumpTracks(const std::vector<DebugOutliers>& vec)
 
 void TrackResiduals::dumpResults(int iSec)
 {
+#ifdef WITH_OPENMP
+#pragma omp critical(tpc_residuals_dump)
+#endif
   if (mTreeOut) {
     printf("Dumping results for sector %i. Don't forget the call to closeOutputFile() in the end...\n", iSec);
     for (int i = 0; i < mNVoxPerSector; ++i) {
@@ -2232,17 +2286,23 @@ void TrackResiduals::dumpResults(int iSec)
 
 void TrackResiduals::printMem() const
 {
-  static float mres = 0, mvir = 0, mres0 = 0, mvir0 = 0;
-  static ProcInfo_t procInfo;
-  static TStopwatch sw;
-  const Long_t kMB = 1024;
-  gSystem->GetProcInfo(&procInfo);
-  mres = float(procInfo.fMemResident) / kMB;
-  mvir = float(procInfo.fMemVirtual) / kMB;
-  sw.Stop();
-  printf("RSS: %.3f(%.3f) VMEM: %.3f(%.3f) MB | CpuTime:%.3f RealTime:%.3f s\n",
-         mres, mres - mres0, mvir, mvir - mvir0, sw.CpuTime(), sw.RealTime());
-  mres0 = mres;
-  mvir0 = mvir;
-  sw.Start();
+  // the statistics are shared by all callers
+#ifdef WITH_OPENMP
+#pragma omp critical(tpc_residuals_mem)
+#endif
+  {
+    static float mres = 0, mvir = 0, mres0 = 0, mvir0 = 0;
+    static ProcInfo_t procInfo;
+    static TStopwatch sw;
+    const Long_t kMB = 1024;
+    gSystem->GetProcInfo(&procInfo);
+    mres = float(procInfo.fMemResident) / kMB;
+    mvir = float(procInfo.fMemVirtual) / kMB;
+    sw.Stop();
+    printf("RSS: %.3f(%.3f) VMEM: %.3f(%.3f) MB | CpuTime:%.3f RealTime:%.3f s\n",
+           mres, mres - mres0, mvir, mvir - mvir0, sw.CpuTime(), sw.RealTime());
+    mres0 = mres;
+    mvir0 = mvir;
+    sw.Start();
+  }
 }
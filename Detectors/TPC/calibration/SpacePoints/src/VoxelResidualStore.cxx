@@ -0,0 +1,216 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file VoxelResidualStore.cxx
+/// \brief Implementation of the VoxelResidualStore class
+
+#include "SpacePoints/VoxelResidualStore.h"
+
+#include <fstream>
+#include <numeric>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fairlogger/Logger.h>
+
+using namespace o2::tpc;
+
+//______________________________________________________________________________
+void VoxelResidualStore::init(int nVoxPerSector)
+{
+  clear();
+  if (nVoxPerSector > MaxVoxPerSector) {
+    LOG(fatal) << nVoxPerSector << " voxels per sector exceed the maximum of " << MaxVoxPerSector << " supported by the voxel residual store";
+  }
+  mNVoxPerSector = nVoxPerSector;
+}
+
+//______________________________________________________________________________
+void VoxelResidualStore::clear()
+{
+  for (int iSec = 0; iSec < NSectors; ++iSec) {
+    mSectors[iSec] = SectorColumns{};
+    mViews[iSec] = SectorView{};
+  }
+  mMapping.reset();
+}
+
+//______________________________________________________________________________
+void VoxelResidualStore::clearSector(int iSec)
+{
+  if (isMapped()) {
+    return;
+  }
+  mSectors[iSec] = SectorColumns{};
+  mViews[iSec] = SectorView{};
+}
+
+//______________________________________________________________________________
+void VoxelResidualStore::reserve(int iSec, size_t nPoints)
+{
+  auto& sec = mSectors[iSec];
+  sec.voxel.reserve(nPoints);
+  sec.dy.reserve(nPoints);
+  sec.dz.reserve(nPoints);
+  sec.tgSlp.reserve(nPoints);
+}
+
+//______________________________________________________________________________
+void VoxelResidualStore::finalize(int iSec)
+{
+  if (isFinalized(iSec)) {
+    return;
+  }
+  auto& sec = mSectors[iSec];
+  size_t nPoints = sec.voxel.size();
+  // counting sort by voxel, stable w.r.t. the fill order
+  sec.offsets.assign(mNVoxPerSector + 1, 0);
+  for (auto voxBin : sec.voxel) {
+    ++sec.offsets[voxBin + 1];
+  }
+  std::partial_sum(sec.offsets.begin(), sec.offsets.end(), sec.offsets.begin());
+  std::vector<uint32_t> fillPos(sec.offsets.begin(), sec.offsets.end() - 1);
+  std::vector<short> dy(nPoints), dz(nPoints), tgSlp(nPoints);
+  for (size_t i = 0; i < nPoints; ++i) {
+    auto pos = fillPos[sec.voxel[i]]++;
+    dy[pos] = sec.dy[i];
+    dz[pos] = sec.dz[i];
+    tgSlp[pos] = sec.tgSlp[i];
+  }
+  sec.dy.swap(dy);
+  sec.dz.swap(dz);
+  sec.tgSlp.swap(tgSlp);
+  std::vector<unsigned short>().swap(sec.voxel);
+
+  auto& view = mViews[iSec];
+  view.nPoints = nPoints;
+  view.offsets = sec.offsets.data();
+  view.dy = sec.dy.data();
+  view.dz = sec.dz.data();
+  view.tgSlp = sec.tgSlp.data();
+}
+
+//______________________________________________________________________________
+void VoxelResidualStore::finalize()
+{
+  for (int iSec = 0; iSec < NSectors; ++iSec) {
+    finalize(iSec);
+  }
+}
+
+//______________________________________________________________________________
+bool VoxelResidualStore::writeToFile(const std::string& fileName) const
+{
+  for (int iSec = 0; iSec < NSectors; ++iSec) {
+    if (!isFinalized(iSec)) {
+      LOG(error) << "residuals of sector " << iSec << " are not finalized, cannot write " << fileName;
+      return false;
+    }
+  }
+  std::ofstream out(fileName, std::ios::binary | std::ios::out | std::ios::trunc);
+  if (!out.is_open()) {
+    LOG(error) << "failed to open " << fileName;
+    return false;
+  }
+  FileHeader header;
+  header.nVoxPerSector = mNVoxPerSector;
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (const auto& view : mViews) {
+    uint64_t nPoints = view.nPoints;
+    out.write(reinterpret_cast<const char*>(&nPoints), sizeof(nPoints));
+  }
+  for (const auto& view : mViews) {
+    out.write(reinterpret_cast<const char*>(view.offsets), (mNVoxPerSector + 1) * sizeof(uint32_t));
+  }
+  for (const auto& view : mViews) {
+    out.write(reinterpret_cast<const char*>(view.dy), view.nPoints * sizeof(short));
+    out.write(reinterpret_cast<const char*>(view.dz), view.nPoints * sizeof(short));
+    out.write(reinterpret_cast<const char*>(view.tgSlp), view.nPoints * sizeof(short));
+  }
+  out.close();
+  if (!out) {
+    LOG(error) << "failed to write " << fileName;
+    return false;
+  }
+  return true;
+}
+
+//______________________________________________________________________________
+bool VoxelResidualStore::mapFile(const std::string& fileName)
+{
+  clear();
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(FileHeader)) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+    LOG(error) << "failed to open " << fileName;
+    return false;
+  }
+  size_t size = st.st_size;
+  void* addr = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping stays valid
+  if (addr == MAP_FAILED) {
+    LOG(error) << "failed to memory-map " << fileName;
+    return false;
+  }
+  madvise(addr, size, MADV_WILLNEED);
+  std::shared_ptr<const char> mapping(reinterpret_cast<const char*>(addr), [size](const char* ptr) { munmap(const_cast<char*>(ptr), size); });
+
+  const auto* header = reinterpret_cast<const FileHeader*>(mapping.get());
+  if (header->magic != Magic || header->version != Version || header->nSectors != NSectors) {
+    LOG(error) << fileName << " is not a voxel residual store file of version " << Version;
+    return false;
+  }
+  size_t nVoxPerSector = header->nVoxPerSector;
+  const auto* nPoints = reinterpret_cast<const uint64_t*>(mapping.get() + sizeof(FileHeader));
+  size_t expSize = sizeof(FileHeader) + NSectors * (sizeof(uint64_t) + (nVoxPerSector + 1) * sizeof(uint32_t));
+  bool sizeOK = size >= expSize;
+  for (int iSec = 0; sizeOK && iSec < NSectors; ++iSec) {
+    // compare before adding up, such that a corrupted number of points cannot overflow the expected size
+    sizeOK = nPoints[iSec] <= (size - expSize) / (3 * sizeof(short));
+    if (sizeOK) {
+      expSize += 3 * nPoints[iSec] * sizeof(short);
+    }
+  }
+  if (!sizeOK || size != expSize) {
+    LOG(error) << "size of " << fileName << " (" << size << ") does not match its content (" << expSize << ")";
+    return false;
+  }
+
+  const auto* offsets = reinterpret_cast<const uint32_t*>(nPoints + NSectors);
+  const auto* columns = reinterpret_cast<const short*>(offsets + NSectors * (nVoxPerSector + 1));
+  for (int iSec = 0; iSec < NSectors; ++iSec) {
+    auto& view = mViews[iSec];
+    view.nPoints = nPoints[iSec];
+    view.offsets = offsets + iSec * (nVoxPerSector + 1);
+    view.dy = columns;
+    view.dz = view.dy + view.nPoints;
+    view.tgSlp = view.dz + view.nPoints;
+    columns = view.tgSlp + view.nPoints;
+    // the voxels have to cover all the points of the sector, each one a (possibly empty) range following the previous one
+    bool offsetsOK = view.offsets[0] == 0 && view.offsets[nVoxPerSector] == view.nPoints;
+    for (size_t voxBin = 0; offsetsOK && voxBin < nVoxPerSector; ++voxBin) {
+      offsetsOK = view.offsets[voxBin] <= view.offsets[voxBin + 1];
+    }
+    if (!offsetsOK) {
+      LOG(error) << "inconsistent voxel offsets for sector " << iSec << " in " << fileName;
+      mViews.fill(SectorView{});
+      return false;
+    }
+  }
+  mNVoxPerSector = nVoxPerSector;
+  mMapping = std::move(mapping);
+  return true;
+}
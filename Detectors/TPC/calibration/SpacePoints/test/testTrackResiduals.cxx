@@ -0,0 +1,194 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTrackResiduals.cxx
+/// \brief Test that the parallel processing of the local residuals gives the same results as the sequential one
+
+#define BOOST_TEST_MODULE Test TPC TrackResiduals
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TFile.h"
+#include "TTree.h"
+
+#include "SpacePoints/SpacePointsCalibParam.h"
+#include "SpacePoints/TrackResiduals.h"
+
+namespace o2
+{
+namespace tpc
+{
+
+namespace
+{
+const std::string FilePrefix = "testTrackResidualsSect";
+const std::array<int, 3> Sectors{0, 5, 20};
+constexpr int NXBins = 20;
+
+void configure(TrackResiduals& residuals, int nThreads)
+{
+  residuals.setNXBins(NXBins);
+  residuals.setLocalResFileName(FilePrefix);
+  residuals.init();
+  residuals.setNThreads(nThreads);
+}
+
+/// Writes trees with random residuals for the selected sectors, in random voxel order and in the format expected by
+/// TrackResiduals::loadSectorResiduals
+void writeResidualTrees()
+{
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> nDist(20, 40);
+  std::uniform_real_distribution<float> tgDist(-1.5f, 1.5f);
+  std::normal_distribution<float> resDist(0.f, 0.3f);
+  for (int iSec : Sectors) {
+    std::vector<AliTPCDcalibRes::dts_t> points;
+    for (int ix = 0; ix < NXBins; ++ix) {
+      for (int ip = 0; ip < param::NY2XBins; ++ip) {
+        for (int iz = 0; iz < param::NZ2XBins; ++iz) {
+          // smooth distortions varying with the voxel
+          const float dyVox = 0.01f * ix - 0.02f * ip;
+          const float dzVox = 0.05f * iz;
+          for (int i = nDist(gen); i--;) {
+            auto& point = points.emplace_back();
+            point.tgSlp = tgDist(gen);
+            point.dy = dyVox + 0.1f * point.tgSlp + resDist(gen);
+            point.dz = dzVox + resDist(gen);
+            point.bvox[TrackResiduals::VoxX] = ix;
+            point.bvox[TrackResiduals::VoxF] = ip;
+            point.bvox[TrackResiduals::VoxZ] = iz;
+          }
+        }
+      }
+    }
+    std::shuffle(points.begin(), points.end(), gen);
+
+    auto file = std::make_unique<TFile>(Form("%s%d.root", FilePrefix.c_str(), iSec), "recreate");
+    auto tree = std::make_unique<TTree>(Form("treeSec%d", iSec), "TPC local residuals");
+    AliTPCDcalibRes::dts_t point;
+    auto* pointPtr = &point;
+    tree->Branch("localResid", &pointPtr);
+    for (const auto& p : points) {
+      point = p;
+      tree->Fill();
+    }
+    file->cd();
+    tree->Write();
+    tree.reset();
+    file->Close();
+  }
+}
+
+/// Fills the in-memory residual store with the content of the trees, converted as when reading the trees
+void fillResidualStore(TrackResiduals& residuals)
+{
+  residuals.setUseInMemoryResiduals(true);
+  for (int iSec : Sectors) {
+    auto file = std::make_unique<TFile>(Form("%s%d.root", FilePrefix.c_str(), iSec));
+    BOOST_REQUIRE(file && !file->IsZombie());
+    std::unique_ptr<TTree> tree(static_cast<TTree*>(file->Get(Form("treeSec%d", iSec))));
+    BOOST_REQUIRE(tree);
+    AliTPCDcalibRes::dts_t point;
+    auto* pointPtr = &point;
+    tree->SetBranchAddress("localResid", &pointPtr);
+    for (int i = 0; i < tree->GetEntries(); ++i) {
+      tree->GetEntry(i);
+      float dy = point.dy, dz = point.dz, tgSlp = point.tgSlp;
+      residuals.getResidualStore().addPoint(iSec, residuals.getGlbVoxBin(point.bvox[TrackResiduals::VoxX], point.bvox[TrackResiduals::VoxF], point.bvox[TrackResiduals::VoxZ]),
+                                            short(dy * 0x7fff / param::MaxResid), short(dz * 0x7fff / param::MaxResid), short(tgSlp * 0x7fff / param::MaxTgSlp));
+    }
+    tree.reset();
+    file->Close();
+  }
+}
+
+template <size_t N>
+void checkEqual(const std::array<float, N>& a, const std::array<float, N>& b)
+{
+  BOOST_CHECK_EQUAL_COLLECTIONS(a.begin(), a.end(), b.begin(), b.end());
+}
+
+void checkResults(const TrackResiduals& residuals, const TrackResiduals& reference)
+{
+  for (int iSec : Sectors) {
+    const auto& results = residuals.getVoxelResults(iSec);
+    const auto& expected = reference.getVoxelResults(iSec);
+    BOOST_REQUIRE_EQUAL(results.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      checkEqual(results[i].D, expected[i].D);
+      checkEqual(results[i].E, expected[i].E);
+      checkEqual(results[i].DS, expected[i].DS);
+      checkEqual(results[i].DC, expected[i].DC);
+      checkEqual(results[i].stat, expected[i].stat);
+      BOOST_CHECK_EQUAL(results[i].EXYCorr, expected[i].EXYCorr);
+      BOOST_CHECK_EQUAL(results[i].dYSigMAD, expected[i].dYSigMAD);
+      BOOST_CHECK_EQUAL(results[i].dZSigLTM, expected[i].dZSigLTM);
+      BOOST_CHECK_EQUAL(int(results[i].flags), int(expected[i].flags));
+    }
+  }
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TrackResiduals_parallel)
+{
+  writeResidualTrees();
+
+  // sequential processing of the residual trees
+  TrackResiduals reference;
+  configure(reference, 1);
+  reference.processResiduals();
+  int nValid = 0;
+  for (int iSec : Sectors) {
+    for (const auto& res : reference.getVoxelResults(iSec)) {
+      nValid += (res.flags & TrackResiduals::DistDone) != 0;
+    }
+  }
+  BOOST_REQUIRE(nValid > 0);
+
+  // one thread per sector
+  TrackResiduals perSector;
+  configure(perSector, 4);
+  perSector.processResiduals();
+  checkResults(perSector, reference);
+
+  // threads sharing the voxels of a sector
+  TrackResiduals perVoxel;
+  configure(perVoxel, 4);
+  for (int iSec : Sectors) {
+    perVoxel.processSectorResiduals(iSec);
+  }
+  checkResults(perVoxel, reference);
+
+  // residuals collected in memory
+  for (int nThreads : {1, 4}) {
+    TrackResiduals inMemory;
+    configure(inMemory, nThreads);
+    fillResidualStore(inMemory);
+    inMemory.processResiduals();
+    checkResults(inMemory, reference);
+  }
+
+  for (int iSec : Sectors) {
+    std::remove(Form("%s%d.root", FilePrefix.c_str(), iSec));
+  }
+}
+
+} // namespace tpc
+} // namespace o2
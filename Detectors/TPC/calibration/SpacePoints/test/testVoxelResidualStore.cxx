@@ -0,0 +1,189 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testVoxelResidualStore.cxx
+/// \brief Tests of the bucketing by voxel and of the flat file I/O of the VoxelResidualStore
+
+#define BOOST_TEST_MODULE Test TPC VoxelResidualStore
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "SpacePoints/VoxelResidualStore.h"
+
+namespace o2
+{
+namespace tpc
+{
+
+namespace
+{
+constexpr int NVox = 50;
+
+struct Point {
+  int voxBin;
+  short dy, dz, tgSlp;
+};
+
+/// Random points in random voxel order, the residuals are unique such that their order can be checked
+std::vector<std::vector<Point>> generatePoints()
+{
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> voxDist(0, NVox - 1);
+  std::uniform_int_distribution<int> nDist(0, 500);
+  std::vector<std::vector<Point>> points(VoxelResidualStore::NSectors);
+  for (int iSec = 0; iSec < VoxelResidualStore::NSectors; ++iSec) {
+    // leave a sector empty
+    int nPoints = iSec == 7 ? 0 : nDist(gen);
+    for (int i = 0; i < nPoints; ++i) {
+      points[iSec].push_back(Point{voxDist(gen), short(i), short(-i), short(iSec)});
+    }
+  }
+  return points;
+}
+
+void fillStore(VoxelResidualStore& store, const std::vector<std::vector<Point>>& points)
+{
+  store.init(NVox);
+  for (int iSec = 0; iSec < VoxelResidualStore::NSectors; ++iSec) {
+    store.reserve(iSec, points[iSec].size());
+    for (const auto& point : points[iSec]) {
+      store.addPoint(iSec, point.voxBin, point.dy, point.dz, point.tgSlp);
+    }
+  }
+}
+
+/// Checks that the points of every voxel are contiguous and in fill order
+void checkStore(const VoxelResidualStore& store, const std::vector<std::vector<Point>>& points)
+{
+  BOOST_CHECK_EQUAL(store.getNVoxPerSector(), NVox);
+  for (int iSec = 0; iSec < VoxelResidualStore::NSectors; ++iSec) {
+    BOOST_REQUIRE(store.isFinalized(iSec));
+    BOOST_REQUIRE_EQUAL(store.getNPoints(iSec), points[iSec].size());
+    size_t expFirst = 0;
+    for (int voxBin = 0; voxBin < NVox; ++voxBin) {
+      std::vector<short> expDY, expDZ, expTgSlp;
+      for (const auto& point : points[iSec]) {
+        if (point.voxBin == voxBin) {
+          expDY.push_back(point.dy);
+          expDZ.push_back(point.dz);
+          expTgSlp.push_back(point.tgSlp);
+        }
+      }
+      BOOST_CHECK_EQUAL(store.getFirstPoint(iSec, voxBin), expFirst);
+      BOOST_REQUIRE_EQUAL(store.getNPoints(iSec, voxBin), expDY.size());
+      auto first = store.getFirstPoint(iSec, voxBin);
+      auto n = store.getNPoints(iSec, voxBin);
+      BOOST_CHECK_EQUAL_COLLECTIONS(store.getDY(iSec) + first, store.getDY(iSec) + first + n, expDY.begin(), expDY.end());
+      BOOST_CHECK_EQUAL_COLLECTIONS(store.getDZ(iSec) + first, store.getDZ(iSec) + first + n, expDZ.begin(), expDZ.end());
+      BOOST_CHECK_EQUAL_COLLECTIONS(store.getTgSlp(iSec) + first, store.getTgSlp(iSec) + first + n, expTgSlp.begin(), expTgSlp.end());
+      expFirst += n;
+    }
+  }
+}
+
+std::vector<char> readFile(const std::string& fileName)
+{
+  std::ifstream in(fileName, std::ios::binary);
+  return std::vector<char>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& fileName, const std::vector<char>& content)
+{
+  std::ofstream out(fileName, std::ios::binary | std::ios::trunc);
+  out.write(content.data(), content.size());
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(VoxelResidualStore_finalize)
+{
+  const auto points = generatePoints();
+  VoxelResidualStore store;
+  fillStore(store, points);
+  for (int iSec = 0; iSec < VoxelResidualStore::NSectors; ++iSec) {
+    BOOST_CHECK(!store.isFinalized(iSec));
+    BOOST_CHECK_EQUAL(store.getNPoints(iSec), points[iSec].size());
+  }
+  store.finalize();
+  checkStore(store, points);
+  // finalizing again does not change anything
+  store.finalize(3);
+  checkStore(store, points);
+}
+
+BOOST_AUTO_TEST_CASE(VoxelResidualStore_fileRoundTrip)
+{
+  const std::string fileName = "testVoxelResidualStore.bin";
+  const auto points = generatePoints();
+  VoxelResidualStore store;
+  fillStore(store, points);
+  // only finalized stores can be written
+  BOOST_CHECK(!store.writeToFile(fileName));
+  store.finalize();
+  BOOST_REQUIRE(store.writeToFile(fileName));
+
+  VoxelResidualStore mapped;
+  BOOST_REQUIRE(mapped.mapFile(fileName));
+  BOOST_CHECK(mapped.isMapped());
+  checkStore(mapped, points);
+
+  // corrupted files are rejected
+  const auto content = readFile(fileName);
+  const size_t nPointsPos = sizeof(VoxelResidualStore::FileHeader);
+  const size_t offsetsPos = nPointsPos + VoxelResidualStore::NSectors * sizeof(uint64_t);
+  const size_t sectorPos = offsetsPos + (NVox + 1) * sizeof(uint32_t); // offsets of the 2nd sector
+  auto checkRejected = [&](const std::vector<char>& corrupted) {
+    writeFile(fileName, corrupted);
+    BOOST_CHECK(!mapped.mapFile(fileName));
+    BOOST_CHECK(!mapped.isMapped());
+  };
+  {
+    // truncated
+    checkRejected(std::vector<char>(content.begin(), content.end() - 2));
+  }
+  {
+    // number of points overflowing the expected size
+    auto corrupted = content;
+    uint64_t nPoints = ~uint64_t(0) / 2;
+    std::copy_n(reinterpret_cast<const char*>(&nPoints), sizeof(nPoints), corrupted.begin() + nPointsPos);
+    checkRejected(corrupted);
+  }
+  {
+    // first voxel not starting at 0
+    auto corrupted = content;
+    uint32_t offset = 1;
+    std::copy_n(reinterpret_cast<const char*>(&offset), sizeof(offset), corrupted.begin() + sectorPos);
+    checkRejected(corrupted);
+  }
+  {
+    // decreasing offsets
+    auto corrupted = content;
+    uint32_t offset = points[1].size() + 1;
+    std::copy_n(reinterpret_cast<const char*>(&offset), sizeof(offset), corrupted.begin() + sectorPos + sizeof(uint32_t));
+    checkRejected(corrupted);
+  }
+  // the original file is still fine
+  writeFile(fileName, content);
+  BOOST_CHECK(mapped.mapFile(fileName));
+  std::remove(fileName.c_str());
+}
+
+} // namespace tpc
+} // namespace o2
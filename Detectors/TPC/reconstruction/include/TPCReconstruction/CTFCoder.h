@@ -17,6 +17,7 @@
 #define O2_TPC_CTFCODER_H
 
 #include <algorithm>
+#include <functional>
 #include <iterator>
 #include <string>
 #include <cassert>
@@ -214,12 +215,13 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
   }
   ec->setHeader(CTFHeader{reinterpret_cast<const CompressedClustersCounters&>(ccl), flags});
   ec->getANSHeader().majorVersion = 0;
-  ec->getANSHeader().minorVersion = 1;
+  ec->getANSHeader().minorVersion = 2;
 
-  auto encodeTPC = [&buff, &optField, &coders = mCoders](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
-    // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
+  // the blocks are encoded concurrently, each one to the space booked for it in the buffer
+  CTF::BlockEncoders encoders;
+  auto encodeTPC = [&encoders, &optField, &coders = mCoders](auto begin, auto end, CTF::Slots slot, size_t probabilityBits) {
     const auto slotVal = static_cast<int>(slot);
-    CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal].get());
+    encoders[slotVal] = CTF::makeBlockEncoder(begin, end, probabilityBits, optField[slotVal], coders[slotVal].get());
   };
 
   if (mCombineColumns) {
@@ -284,7 +286,8 @@ void CTFCoder::encode(VEC& buff, const CompressedClusters& ccl)
 
   encodeTPC(ccl.nTrackClusters, ccl.nTrackClusters + ccl.nTracks, CTF::BLCnTrackClusters, 0);
   encodeTPC(ccl.nSliceRowClusters, ccl.nSliceRowClusters + ccl.nSliceRows, CTF::BLCnSliceRowClusters, 0);
-  CTF::get(buff.data())->print(getPrefix());
+  // the buffer might be autoexpanded, so we don't work with fixed pointer ec
+  CTF::encodeConcurrently(buff, encoders, mNThreads)->print(getPrefix());
 }
 
 /// decode entropy-encoded bloks to TPC CompressedClusters into the externally provided vector (e.g. PMR vector from DPL)
@@ -309,10 +312,11 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
   ccFlat->set(sz, cc); // set offsets
   ec.print(getPrefix());
 
-  // decode encoded data directly to destination buff
-  auto decodeTPC = [&ec, &coders = mCoders](auto begin, CTF::Slots slot) {
+  // decode encoded data directly to destination buff, the blocks are independent and can be decoded concurrently
+  std::vector<std::function<void()>> decoders;
+  auto decodeTPC = [&ec, &decoders, &coders = mCoders](auto begin, CTF::Slots slot) {
     const auto slotVal = static_cast<int>(slot);
-    ec.decode(begin, slotVal, coders[slotVal].get());
+    decoders.emplace_back([&ec, &coders, begin, slotVal]() { ec.decode(begin, slotVal, coders[slotVal].get()); });
   };
 
   if (mCombineColumns) {
@@ -367,6 +371,7 @@ void CTFCoder::decode(const CTF::base& ec, VEC& buffVec)
 
   decodeTPC(cc.nTrackClusters, CTF::BLCnTrackClusters);
   decodeTPC(cc.nSliceRowClusters, CTF::BLCnSliceRowClusters);
+  o2::ctf::runConcurrently(decoders.size(), mNThreads, [&decoders](int i) { decoders[i](); });
 }
 
 } // namespace tpc
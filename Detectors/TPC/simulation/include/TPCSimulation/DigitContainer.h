@@ -59,6 +59,7 @@ class DigitContainer
   void setStartTime(TimeBin time) { mFirstTimeBin = time; }
 
   /// Add digit to the container
+  /// Digits of different GEM stacks can be added concurrently
   /// \param eventID MC Event ID
   /// \param trackID MC Track ID
   /// \param cru CRU of the digit
@@ -82,10 +83,10 @@ class DigitContainer
 
  private:
   TimeBin mFirstTimeBin = 0;       ///< First time bin to consider
-  TimeBin mEffectiveTimeBin = 0;   ///< Effective time bin of that digit
   TimeBin mTmaxTriggered = 0;      ///< Maximum time bin in case of triggered mode (hard cut at average drift speed with additional margin)
   TimeBin mOffset;                 ///< Size of the container for one event
   std::deque<DigitTime> mTimeBins; ///< Time bin Container for the ADC value
+  DigitTime::SlabPool mSlabPool;   ///< Pad slabs of the written out time bins, to be reused
 };
 
 inline DigitContainer::DigitContainer()
@@ -103,9 +104,8 @@ inline DigitContainer::DigitContainer()
 inline void DigitContainer::reset()
 {
   mFirstTimeBin = 0;
-  mEffectiveTimeBin = 0;
   for (auto& time : mTimeBins) {
-    time.reset();
+    time.reset(mSlabPool);
   }
 }
 
@@ -119,8 +119,7 @@ inline void DigitContainer::reserve(TimeBin eventTimeBin)
 inline void DigitContainer::addDigit(const MCCompLabel& label, const CRU& cru, TimeBin timeBin, GlobalPadNumber globalPad,
                                      float signal)
 {
-  mEffectiveTimeBin = timeBin - mFirstTimeBin;
-  mTimeBins[mEffectiveTimeBin].addDigit(label, cru, globalPad, signal);
+  mTimeBins[timeBin - mFirstTimeBin].addDigit(label, cru, globalPad, signal, mSlabPool);
 }
 
 } // namespace tpc
@@ -16,6 +16,9 @@
 #ifndef ALICEO2_TPC_DigitTime_H_
 #define ALICEO2_TPC_DigitTime_H_
 
+#include <algorithm>
+#include <array>
+#include <vector>
 #include "TPCBase/Mapper.h"
 #include "TPCSimulation/DigitGlobalPad.h"
 #include "SimulationDataFormat/LabelContainer.h"
@@ -33,19 +36,25 @@ class DigitMCMetaData;
 /// This is the second class of the intermediate Digit Containers, in which all incoming electrons from the hits are
 /// sorted into after amplification
 /// The structure assures proper sorting of the Digits when later on written out for further processing.
-/// This class holds the individual Pad Row containers and is contained within the CRU Container.
+/// The pads of each GEM stack are held in a slab, which is taken from a pool at the first signal in the stack and
+/// returned to it at reset, only the occupied pads are visited when writing out and resetting.
+/// The GEM stacks are independent, so that the signals of different stacks can be added concurrently.
 
 class DigitTime
 {
  public:
+  using PadSlab = std::vector<DigitGlobalPad>;                           ///< pads of one GEM stack
+  using SlabPool = std::array<std::vector<PadSlab>, GEMSTACKSPERSECTOR>; ///< recycled pad slabs per GEM stack
+
   /// Constructor
-  DigitTime();
+  DigitTime() = default;
 
   /// Destructor
   ~DigitTime() = default;
 
   /// Resets the container
-  void reset();
+  /// \param pool Pool to return the pad slabs to
+  void reset(SlabPool& pool);
 
   /// Get common mode for a given GEM stack
   /// \param gemstack GEM stack of the digit
@@ -63,7 +72,8 @@ class DigitTime
   /// \param cru CRU of the digit
   /// \param globalPad Global pad number of the digit
   /// \param signal Charge of the digit in ADC counts
-  void addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal);
+  /// \param pool Pool to take the pad slab from
+  void addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal, SlabPool& pool);
 
   /// Fill output vector
   /// \param output Output container
@@ -76,39 +86,65 @@ class DigitTime
   void fillOutputContainer(std::vector<Digit>& output, dataformats::MCTruthContainer<MCCompLabel>& mcTruth,
                            std::vector<CommonMode>& commonModeOutput, const Sector& sector, TimeBin timeBin, float commonMode = 0.f);
 
- private:
-  std::array<float, GEMSTACKSPERSECTOR> mCommonMode;                 ///< Common mode container - 4 GEM ROCs per sector
-  std::array<DigitGlobalPad, Mapper::getPadsInSector()> mGlobalPads; ///< Pad Container for the ADC value
-  int mDigitCounter = 0;                                             ///< counts the number of digits in this timebin
+  /// Global pad number of the first pad of the GEM stack
+  static constexpr GlobalPadNumber getStackPadOffset(int gemstack)
+  {
+    return gemstack == IROCgem ? 0 : (gemstack == OROC1gem ? Mapper::getPadsInIROC() : (gemstack == OROC2gem ? Mapper::getPadsInIROC() + Mapper::getPadsInOROC1() : Mapper::getPadsInIROC() + Mapper::getPadsInOROC1() + Mapper::getPadsInOROC2()));
+  }
 
-  o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false> mLabels;
-  // std::deque<int> mOccupiedPads; // iterable container of occupied pads
+ private:
+  struct StackData {
+    PadSlab pads;                                                               ///< Pad Container for the ADC value, empty if no signal
+    std::vector<GlobalPadNumber> occupiedPads;                                  ///< Pads with signal, in order of their 1st signal
+    o2::dataformats::LabelContainer<std::pair<MCCompLabel, int>, false> labels; ///< MC labels of the digits
+    int digitCounter = 0;                                                       ///< counts the number of digits in this stack
+    float commonMode = 0.f;                                                     ///< Common mode container
+  };
+  std::array<StackData, GEMSTACKSPERSECTOR> mStacks; //! 4 GEM ROCs per sector
 };
 
-inline DigitTime::DigitTime() : mCommonMode(), mGlobalPads()
-{
-  mCommonMode.fill(0.f);
-  mLabels.reserve(Mapper::getPadsInSector() / 3);
-}
-
-inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal)
+inline void DigitTime::addDigit(const MCCompLabel& label, const CRU& cru, GlobalPadNumber globalPad, float signal, SlabPool& pool)
 {
-  auto& paddigit = mGlobalPads[globalPad];
+  const auto gemstack = cru.gemStack();
+  auto& stack = mStacks[gemstack];
+  if (stack.pads.empty()) {
+    auto& stackPool = pool[gemstack];
+    if (stackPool.empty()) {
+      static const Mapper& mapper = Mapper::instance();
+      stack.pads.resize(mapper.getNumberOfPads(gemstack));
+    } else {
+      stack.pads = std::move(stackPool.back());
+      stackPool.pop_back();
+    }
+  }
+  auto& paddigit = stack.pads[globalPad - getStackPadOffset(gemstack)];
   if (paddigit.getID() == -1) {
     // this means we have a new digit
-    paddigit.setID(mDigitCounter++);
-    // could also register this pad in a vector of digits
+    paddigit.setID(stack.digitCounter++);
+    stack.occupiedPads.push_back(globalPad);
   }
-  paddigit.addDigit(label, signal, mLabels);
-  mCommonMode[cru.gemStack()] += signal;
+  paddigit.addDigit(label, signal, stack.labels);
+  stack.commonMode += signal;
 }
 
-inline void DigitTime::reset()
+inline void DigitTime::reset(SlabPool& pool)
 {
-  for (auto& pad : mGlobalPads) {
-    pad.reset();
+  for (int gemstack = 0; gemstack < GEMSTACKSPERSECTOR; ++gemstack) {
+    auto& stack = mStacks[gemstack];
+    if (!stack.pads.empty()) {
+      for (auto globalPad : stack.occupiedPads) {
+        auto& pad = stack.pads[globalPad - getStackPadOffset(gemstack)];
+        pad.reset();
+        pad.setID(-1);
+      }
+      pool[gemstack].emplace_back(std::move(stack.pads));
+      stack.pads.clear();
+    }
+    stack.occupiedPads.clear();
+    stack.labels.clear();
+    stack.digitCounter = 0;
+    stack.commonMode = 0.f;
   }
-  mCommonMode.fill(0.f);
 }
 
 inline float DigitTime::getCommonMode(const GEMstack& gemstack) const
@@ -116,7 +152,7 @@ inline float DigitTime::getCommonMode(const GEMstack& gemstack) const
   /// simple case when there is no external capacitance on the ROC
   static const Mapper& mapper = Mapper::instance();
   const auto nPads = mapper.getNumberOfPads(gemstack);
-  return mCommonMode[gemstack] / static_cast<float>(nPads);
+  return mStacks[gemstack].commonMode / static_cast<float>(nPads);
 }
 
 template <DigitzationMode MODE>
@@ -125,19 +161,23 @@ inline void DigitTime::fillOutputContainer(std::vector<Digit>& output, dataforma
                                            float commonMode)
 {
   static Mapper& mapper = Mapper::instance();
-  GlobalPadNumber globalPad = 0;
-  for (size_t i = 0; i < mCommonMode.size(); ++i) {
+  for (size_t i = 0; i < mStacks.size(); ++i) {
     const float cm = getCommonMode(GEMstack(i));
     if (cm > 0.) {
       commonModeOutput.push_back({cm, timeBin, static_cast<unsigned char>(i)});
     }
   }
-  for (auto& pad : mGlobalPads) {
-    if (pad.getChargePad() > 0.) {
-      const CRU cru = mapper.getCRU(sector, globalPad);
-      pad.fillOutputContainer<MODE>(output, mcTruth, cru, timeBin, globalPad, mLabels, getCommonMode(cru));
+  // the stacks cover consecutive ranges of pads, the digits are written ordered in the global pad number
+  for (int gemstack = 0; gemstack < GEMSTACKSPERSECTOR; ++gemstack) {
+    auto& stack = mStacks[gemstack];
+    std::sort(stack.occupiedPads.begin(), stack.occupiedPads.end());
+    for (auto globalPad : stack.occupiedPads) {
+      auto& pad = stack.pads[globalPad - getStackPadOffset(gemstack)];
+      if (pad.getChargePad() > 0.) {
+        const CRU cru = mapper.getCRU(sector, globalPad);
+        pad.fillOutputContainer<MODE>(output, mcTruth, cru, timeBin, globalPad, stack.labels, getCommonMode(cru));
+      }
     }
-    ++globalPad;
   }
 }
 } // namespace tpc
@@ -23,6 +23,7 @@
 
 #include "TPCBase/Mapper.h"
 
+#include <algorithm>
 #include <cmath>
 
 using std::vector;
@@ -109,6 +110,12 @@ class Digitizer
   /// Option to retrieve triggered / continuous readout
   static bool isContinuousReadout() { return mIsContinuous; }
 
+  /// Set the number of threads used to shape and sort the signals into the digit container
+  /// The electron transport and amplification stay sequential, so that the output does not depend on the number of threads
+  /// \param n Number of threads, at most one per GEM stack is used
+  void setNThreads(int n) { mNThreads = std::clamp(n, 1, int(GEMSTACKSPERSECTOR)); }
+  int getNThreads() const { return mNThreads; }
+
   /// Enable the use of space-charge distortions and provide space-charge density histogram as input
   /// \param distortionType select the type of space-charge distortions (constant or realistic)
   /// \param hisInitialSCDensity optional space-charge density histogram to use at the beginning of the simulation
@@ -126,14 +133,28 @@ class Digitizer
   void setUseSCDistortions(TFile& finp);
 
  private:
-  DigitContainer mDigitContainer;    ///< Container for the Digits
-  std::unique_ptr<SC> mSpaceCharge;  ///< Handler of space-charge distortions
-  Sector mSector = -1;               ///< ID of the currently processed sector
-  double mEventTime = 0.f;           ///< Time of the currently processed event
-  double mOutputDigitTimeOffset = 0; ///< Time of the first IR sampled in the digitizer
+  /// Amplified signal of a single electron, to be shaped and added to the digit container
+  struct ElectronSignal {
+    MCCompLabel label;
+    CRU cru;
+    GlobalPadNumber globalPad;
+    float signal;
+    float time;
+  };
+
+  /// Shape the signals and add them to the digit container, each thread processing the signals of its GEM stacks
+  void addSignals();
+
+  DigitContainer mDigitContainer;       ///< Container for the Digits
+  std::vector<ElectronSignal> mSignals; //!< Signals of the processed hits in case of multithreading
+  std::unique_ptr<SC> mSpaceCharge;     ///< Handler of space-charge distortions
+  Sector mSector = -1;                  ///< ID of the currently processed sector
+  double mEventTime = 0.f;              ///< Time of the currently processed event
+  double mOutputDigitTimeOffset = 0;    ///< Time of the first IR sampled in the digitizer
   // FIXME: whats the reason for hving this static?
   static bool mIsContinuous;      ///< Switch for continuous readout
   bool mUseSCDistortions = false; ///< Flag to switch on the use of space-charge distortions
+  int mNThreads = 1;              //!< Number of threads to fill the digit container
   ClassDefNV(Digitizer, 1);
 };
 } // namespace tpc
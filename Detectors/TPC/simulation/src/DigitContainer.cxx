@@ -55,6 +55,7 @@ void DigitContainer::fillOutputContainer(std::vector<Digit>& output,
           break;
         }
       }
+      time.reset(mSlabPool);
     } else {
       break;
     }
@@ -31,6 +31,8 @@
 
 #include "FairLogger.h"
 
+#include <thread>
+
 ClassImp(o2::tpc::Digitizer);
 
 using namespace o2::tpc;
@@ -143,6 +145,10 @@ void Digitizer::process(const std::vector<o2::tpc::HitGroup>& hits,
         const GlobalPadNumber globalPad = mapper.globalPadNumber(digiPadPos.getGlobalPadPos());
         const float ADCsignal = sampaProcessing.getADCvalue(static_cast<float>(nElectronsGEM));
         const MCCompLabel label(MCTrackID, eventID, sourceID, false);
+        if (mNThreads > 1) {
+          mSignals.push_back({label, digiPadPos.getCRU(), globalPad, ADCsignal, absoluteTime});
+          continue;
+        }
         sampaProcessing.getShapedSignal(ADCsignal, absoluteTime, signalArray);
         for (float i = 0; i < nShapedPoints; ++i) {
           const float time = absoluteTime + i * eleParam.ZbinWidth;
@@ -154,6 +160,41 @@ void Digitizer::process(const std::vector<o2::tpc::HitGroup>& hits,
       /// end of loop over electrons
     }
   }
+  if (mNThreads > 1) {
+    addSignals();
+  }
+}
+
+void Digitizer::addSignals()
+{
+  const static SAMPAProcessing& sampaProcessing = SAMPAProcessing::instance();
+  auto& eleParam = ParameterElectronics::Instance();
+  const int nShapedPoints = eleParam.NShapedPoints;
+
+  // the signals of a GEM stack are added by a single thread in the original order, hence the result is
+  // identical to the sequential processing
+  auto worker = [this, nShapedPoints, &eleParam](int thread) {
+    std::vector<float> signalArray(nShapedPoints);
+    for (const auto& sig : mSignals) {
+      if (sig.cru.gemStack() % mNThreads != thread) {
+        continue;
+      }
+      sampaProcessing.getShapedSignal(sig.signal, sig.time, signalArray);
+      for (float i = 0; i < nShapedPoints; ++i) {
+        const float time = sig.time + i * eleParam.ZbinWidth;
+        mDigitContainer.addDigit(sig.label, sig.cru, sampaProcessing.getTimeBinFromTime(time), sig.globalPad, signalArray[i]);
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int thread = 1; thread < mNThreads; ++thread) {
+    threads.emplace_back(worker, thread);
+  }
+  worker(0);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  mSignals.clear();
 }
 
 void Digitizer::flush(std::vector<o2::tpc::Digit>& digits,
@@ -167,5 +167,45 @@ BOOST_AUTO_TEST_CASE(DigitContainer_test2)
     BOOST_CHECK_CLOSE(commonMode[i].getCommonMode(), chargeSum[i] / nPads, 1E-6);
   }
 }
+
+/// \brief Test of the DigitContainer
+/// Digits added in arbitrary pad order are written out ordered in the global pad number, and the pad slabs
+/// recycled from the written out time bins give the same result as new ones
+BOOST_AUTO_TEST_CASE(DigitContainer_test3)
+{
+  auto& cdb = CDBInterface::instance();
+  cdb.setUseDefaults();
+  o2::conf::ConfigurableParam::updateFromString("TPCEleParam.DigiMode=3");
+  const Mapper& mapper = Mapper::instance();
+  DigitContainer digitContainer;
+  digitContainer.reset();
+
+  const std::vector<int> cru = {9, 7, 5, 3, 1, 0};
+  const int Time = 10, Row = 5, Pad = 3;
+
+  std::vector<std::vector<Digit>> digits(2);
+  std::vector<dataformats::MCTruthContainer<MCCompLabel>> mcTruth(2);
+  for (int iter = 0; iter < 2; ++iter) {
+    digitContainer.reset();
+    digitContainer.reserve(0);
+    for (size_t i = 0; i < cru.size(); ++i) {
+      const DigitPos digiPadPos(CRU(cru[i]), PadPos(Row, Pad));
+      const GlobalPadNumber globalPad = mapper.globalPadNumber(digiPadPos.getGlobalPadPos());
+      digitContainer.addDigit(MCCompLabel(i, iter, 0, false), cru[i], Time, globalPad, 10.f * (i + 1));
+    }
+    std::vector<o2::tpc::CommonMode> commonMode;
+    digitContainer.fillOutputContainer(digits[iter], mcTruth[iter], commonMode, 0, 0, true, true);
+    BOOST_REQUIRE(digits[iter].size() == cru.size());
+    for (size_t i = 0; i < cru.size(); ++i) {
+      BOOST_CHECK(digits[iter][i].getCRU() == cru[cru.size() - 1 - i]);
+      BOOST_CHECK(mcTruth[iter].getLabels(i).size() == 1);
+      BOOST_CHECK(mcTruth[iter].getLabels(i)[0].getTrackID() == int(cru.size() - 1 - i));
+    }
+  }
+  for (size_t i = 0; i < cru.size(); ++i) {
+    BOOST_CHECK(digits[0][i].getChargeFloat() == digits[1][i].getChargeFloat());
+    BOOST_CHECK(digits[0][i].getRow() == digits[1][i].getRow() && digits[0][i].getPad() == digits[1][i].getPad());
+  }
+}
 } // namespace tpc
 } // namespace o2
@@ -0,0 +1,141 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCDigitizerThreads.cxx
+/// \brief This task tests that the output of the TPC Digitizer does not depend on the number of threads
+
+#define BOOST_TEST_MODULE Test TPC Digitizer threads
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "DataFormatsTPC/Digit.h"
+#include "SimulationDataFormat/MCCompLabel.h"
+#include "SimulationDataFormat/MCTruthContainer.h"
+#include "TPCBase/CDBInterface.h"
+#include "TPCBase/Mapper.h"
+#include "TPCSimulation/Digitizer.h"
+#include "TPCSimulation/ElectronTransport.h"
+#include "TPCSimulation/GEMAmplification.h"
+#include "TPCSimulation/Point.h"
+#include "TPCSimulation/SAMPAProcessing.h"
+
+namespace o2
+{
+namespace tpc
+{
+
+/// Straight tracks in sector 0, crossing the pad rows of all GEM stacks
+std::vector<HitGroup> createHits()
+{
+  std::vector<HitGroup> hits;
+  const float phi = 10.f * M_PI / 180.f;
+  for (int iTrack = 0; iTrack < 5; ++iTrack) {
+    HitGroup& hitGroup = hits.emplace_back(iTrack);
+    const float dPhi = (iTrack - 2) * 0.02f;
+    const float z = 20.f + 40.f * iTrack;
+    for (float r = 86.f; r < 245.f; r += 1.f) {
+      hitGroup.addHit(r * std::cos(phi + dPhi), r * std::sin(phi + dPhi), z, 0.f, 30);
+    }
+  }
+  return hits;
+}
+
+/// Digitize the hits with the given number of threads in a child process and pass the digits and their labels
+/// back through a pipe. All the children start from the random state of the parent, so that the random numbers
+/// drawn for the electron transport and the amplification are the same
+std::vector<int> digitizeInChild(const std::vector<HitGroup>& hits, int nThreads)
+{
+  int fds[2];
+  BOOST_REQUIRE_EQUAL(pipe(fds), 0);
+  const pid_t pid = fork();
+  BOOST_REQUIRE(pid >= 0);
+  if (pid == 0) {
+    close(fds[0]);
+    Digitizer digitizer;
+    digitizer.setSector(Sector(0));
+    digitizer.setStartTime(0.);
+    digitizer.setEventTime(0.);
+    digitizer.setNThreads(nThreads);
+    digitizer.init();
+    digitizer.process(hits, 0);
+
+    std::vector<Digit> digits;
+    dataformats::MCTruthContainer<MCCompLabel> labels;
+    std::vector<CommonMode> commonMode;
+    digitizer.flush(digits, labels, commonMode, true);
+
+    std::vector<int> output;
+    for (size_t iDigit = 0; iDigit < digits.size(); ++iDigit) {
+      const auto& digit = digits[iDigit];
+      const auto digitLabels = labels.getLabels(iDigit);
+      output.insert(output.end(), {digit.getCRU(), digit.getRow(), digit.getPad(), int(digit.getTimeStamp()), digit.getCharge(), int(digitLabels.size())});
+      for (const auto& label : digitLabels) {
+        output.insert(output.end(), {label.getTrackID(), label.getEventID()});
+      }
+    }
+    const size_t size = output.size();
+    bool ok = write(fds[1], &size, sizeof(size)) == sizeof(size);
+    ok = ok && write(fds[1], output.data(), size * sizeof(int)) == ssize_t(size * sizeof(int));
+    close(fds[1]);
+    _exit(ok ? 0 : 1);
+  }
+
+  close(fds[1]);
+  std::vector<int> output;
+  size_t size = 0;
+  if (read(fds[0], &size, sizeof(size)) == sizeof(size)) {
+    output.resize(size);
+    size_t nRead = 0;
+    const auto buffer = reinterpret_cast<char*>(output.data());
+    while (nRead < size * sizeof(int)) {
+      const ssize_t n = read(fds[0], buffer + nRead, size * sizeof(int) - nRead);
+      if (n <= 0) {
+        break;
+      }
+      nRead += n;
+    }
+    BOOST_CHECK_EQUAL(nRead, size * sizeof(int));
+  }
+  close(fds[0]);
+  int status = 0;
+  waitpid(pid, &status, 0);
+  BOOST_REQUIRE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  return output;
+}
+
+/// \brief Test that the multithreaded digitization gives the same digits and labels as the single threaded one
+BOOST_AUTO_TEST_CASE(DigitizerThreads_test)
+{
+  auto& cdb = CDBInterface::instance();
+  cdb.setUseDefaults();
+
+  // Set up the singletons before forking, so that they are not constructed separately in each child
+  Mapper::instance();
+  ElectronTransport::instance();
+  GEMAmplification::instance();
+  SAMPAProcessing::instance();
+
+  const auto hits = createHits();
+  const auto reference = digitizeInChild(hits, 1);
+  BOOST_REQUIRE(!reference.empty());
+
+  for (int nThreads : {2, 4}) {
+    const auto output = digitizeInChild(hits, nThreads);
+    BOOST_CHECK_EQUAL_COLLECTIONS(output.begin(), output.end(), reference.begin(), reference.end());
+  }
+}
+
+} // namespace tpc
+} // namespace o2
@@ -97,9 +97,19 @@ class PVertexer
     mITSROFrameLengthMUS = v;
   }
 
+  void setNThreads(int n);
+  int getNThreads() const { return mNThreads; }
+
  private:
   static constexpr int DBS_UNDEF = -2, DBS_NOISE = -1, DBS_INCHECK = -10;
 
+  ///< vertices and their contributors found in a single group of tracks
+  struct VerticesSlot {
+    std::vector<PVertex> vertices;
+    std::vector<uint32_t> trackIDs;
+    std::vector<V2TRef> v2tRefs;
+  };
+
   SeedHistoTZ buildHistoTZ(const VertexingInput& input);
   int runVertexing(gsl::span<o2d::GlobalTrackID> gids, const gsl::span<o2::InteractionRecord> bcData,
                    std::vector<PVertex>& vertices, std::vector<o2d::VtxTrackIndex>& vertexTrackIDs, std::vector<V2TRef>& v2tRefs,
@@ -123,6 +133,8 @@ class PVertexer
 
   int findVertices(const VertexingInput& input, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs);
   void reAttach(std::vector<PVertex>& vertices, std::vector<int>& timeSort, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs);
+  template <typename F>
+  void processGroups(int nGroups, F&& fit, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs);
 
   std::pair<int, int> getBestIR(const PVertex& vtx, const gsl::span<o2::InteractionRecord> bcData, int& currEntry) const;
 
@@ -142,6 +154,8 @@ class PVertexer
   float mITSROFrameLengthMUS = 0;           ///< ITS readout time span in \mus
   float mBz = 0.;                          ///< mag.field at beam line
   bool mValidateWithIR = false;            ///< require vertex validation with InteractionRecords (if available)
+  int mNThreads = 1;                       ///< number of threads fitting the time-Z clusters concurrently
+  std::vector<VerticesSlot> mSlots;        ///< per-cluster output of the concurrent fit
 
   o2::InteractionRecord mStartIR{0, 0}; ///< IR corresponding to the start of the TF
 
@@ -28,6 +28,50 @@ constexpr float PVertexer::kAlmost0F;
 constexpr double PVertexer::kAlmost0D;
 constexpr float PVertexer::kHugeF;
 
+//___________________________________________________________________
+template <typename F>
+void PVertexer::processGroups(int nGroups, F&& fit, std::vector<PVertex>& vertices, std::vector<uint32_t>& trackIDs, std::vector<V2TRef>& v2tRefs)
+{
+  // apply the vertex finding/fitting method fit(i, vertices, trackIDs, v2tRefs) to every group of tracks
+  // (either time-Z cluster or tracks reattached to the vertex), which must not share the tracks.
+  // With mNThreads > 1 the groups are processed concurrently into the separate slots, which are then merged in the
+  // order of the groups, so that the output is identical to that of the sequential processing
+#ifndef _PV_DEBUG_TREE_
+  if (mNThreads > 1 && nGroups > 1) {
+    if (int(mSlots.size()) < nGroups) {
+      mSlots.resize(nGroups);
+    }
+#ifdef WITH_OPENMP
+#pragma omp parallel for num_threads(mNThreads) schedule(dynamic)
+#endif
+    for (int ig = 0; ig < nGroups; ig++) {
+      auto& slot = mSlots[ig];
+      slot.vertices.clear();
+      slot.trackIDs.clear();
+      slot.v2tRefs.clear();
+      fit(ig, slot.vertices, slot.trackIDs, slot.v2tRefs);
+    }
+    for (int ig = 0; ig < nGroups; ig++) {
+      const auto& slot = mSlots[ig];
+      int nvSlot = slot.vertices.size(), firstVtx = vertices.size(), firstTrack = trackIDs.size();
+      for (int iv = 0; iv < nvSlot; iv++) {
+        vertices.push_back(slot.vertices[iv]);
+        const auto& ref = slot.v2tRefs[iv];
+        v2tRefs.emplace_back(firstTrack + ref.getFirstEntry(), ref.getEntries());
+        for (int it = ref.getFirstEntry(); it < ref.getFirstEntry() + ref.getEntries(); it++) {
+          mTracksPool[slot.trackIDs[it]].vtxID = firstVtx + iv; // convert slot-local vertex ID to global one
+        }
+      }
+      trackIDs.insert(trackIDs.end(), slot.trackIDs.begin(), slot.trackIDs.end());
+    }
+    return;
+  }
+#endif
+  for (int ig = 0; ig < nGroups; ig++) {
+    fit(ig, vertices, trackIDs, v2tRefs);
+  }
+}
+
 //___________________________________________________________________
 int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl::span<o2::InteractionRecord> bcData,
                             std::vector<PVertex>& vertices, std::vector<o2d::VtxTrackIndex>& vertexTrackIDs, std::vector<V2TRef>& v2tRefs,
@@ -40,7 +84,9 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
   std::vector<float> validationTimes;
   std::vector<o2::MCEventLabel> lblVtxLoc;
 
-  for (auto tc : mTimeZClusters) {
+  // time-Z clusters share no tracks, so they can be fitted independently
+  auto fitCluster = [&](int icl, std::vector<PVertex>& verticesNew, std::vector<uint32_t>& trackIDsNew, std::vector<V2TRef>& v2tRefsNew) {
+    auto& tc = mTimeZClusters[icl];
     VertexingInput inp;
     inp.idRange = gsl::span<int>(tc.trackIDs);
     inp.scaleSigma2 = mPVParams->iniScale2;
@@ -48,8 +94,9 @@ int PVertexer::runVertexing(const gsl::span<o2d::GlobalTrackID> gids, const gsl:
 #ifdef _PV_DEBUG_TREE_
     doDBScanDump(inp, lblTracks);
 #endif
-    findVertices(inp, verticesLoc, trackIDs, v2tRefsLoc);
-  }
+    findVertices(inp, verticesNew, trackIDsNew, v2tRefsNew);
+  };
+  processGroups(mTimeZClusters.size(), fitCluster, verticesLoc, trackIDs, v2tRefsLoc);
 
   // sort in time
   std::vector<int> vtTimeSortID(verticesLoc.size());
@@ -446,11 +493,11 @@ void PVertexer::reAttach(std::vector<PVertex>& vertices, std::vector<int>& timeS
   v2tRefs.clear();
   trackIDs.clear();
   std::vector<PVertex> verticesUpd;
-  for (int ivt = 0; ivt < nvtOrig; ivt++) {
+  auto refitVertex = [this, &vertices](int ivt, std::vector<PVertex>& verticesNew, std::vector<uint32_t>& trackIDsNew, std::vector<V2TRef>& v2tRefsNew) {
     auto& clusZT = mTimeZClusters[ivt];
     auto& vtx = vertices[ivt];
     if (clusZT.trackIDs.size() < mPVParams->minTracksPerVtx) {
-      continue;
+      return;
     }
     VertexingInput inp;
     inp.idRange = gsl::span<int>(clusZT.trackIDs);
@@ -458,10 +505,11 @@ void PVertexer::reAttach(std::vector<PVertex>& vertices, std::vector<int>& timeS
     inp.timeEst = vtx.getTimeStamp();
     if (!findVertex(inp, vtx)) {
       vtx.setNContributors(0);
-      continue;
+      return;
     }
-    finalizeVertex(inp, vtx, verticesUpd, v2tRefs, trackIDs);
-  }
+    finalizeVertex(inp, vtx, verticesNew, v2tRefsNew, trackIDsNew);
+  };
+  processGroups(nvtOrig, refitVertex, verticesUpd, trackIDs, v2tRefs);
   // reorder in time since the time-stamp of vertices might have been changed
   vertices.swap(verticesUpd);
   timeSort.resize(vertices.size());
@@ -954,6 +1002,16 @@ SeedHistoTZ PVertexer::buildHistoTZ(const VertexingInput& input)
   return std::move(seedHistoTZ);
 }
 
+//______________________________________________
+void PVertexer::setNThreads(int n)
+{
+#ifdef WITH_OPENMP
+  mNThreads = n > 0 ? n : 1;
+#else
+  mNThreads = 1;
+#endif
+}
+
 //______________________________________________
 bool PVertexer::relateTrackToMeanVertex(o2::track::TrackParCov& trc, float vtxErr2) const
 {
@@ -0,0 +1,189 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file bench_PVertexer.cxx
+/// \brief Benchmark of the primary vertexer replaying the input recorded by the primary-vertexing workflow
+///
+/// The input is produced by o2-primary-vertexing-workflow --dump-input pvInput.root (the file name can be
+/// changed with the O2_PVERTEXER_BENCH_INPUT environment variable), the o2sim_grp.root and, if available,
+/// the material LUT are taken from the current directory.
+/// Every TF is vertexed with the requested number of threads and the output is required to be identical
+/// to that of the single-threaded vertexer.
+
+#include "benchmark/benchmark.h"
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include <TFile.h>
+#include <TTree.h>
+#include "CommonDataFormat/BunchFilling.h"
+#include "CommonUtils/StringUtils.h"
+#include "DetectorsBase/Propagator.h"
+#include "DetectorsCommonDataFormats/NameConf.h"
+#include "DetectorsVertexing/PVertexer.h"
+#include "Framework/Logger.h"
+
+using namespace o2::vertexing;
+namespace o2d = o2::dataformats;
+
+struct PVInput {
+  std::vector<TrackWithTimeStamp> tracks;
+  std::vector<o2d::GlobalTrackID> gids;
+  std::vector<o2::InteractionRecord> ft0IR;
+  o2::InteractionRecord startIR;
+};
+
+struct PVOutput {
+  std::vector<PVertex> vertices;
+  std::vector<GIndex> vertexTrackIDs;
+  std::vector<V2TRef> v2tRefs;
+  std::vector<o2::MCEventLabel> lblVtx;
+};
+
+struct PVReplay {
+  std::vector<PVInput> tfs;
+  std::vector<PVOutput> reference;
+  o2::BunchFilling bunchFilling;
+  float itsROFrameLengthMUS = 0.;
+  bool validateWithIR = false;
+  bool ok = false;
+
+  PVReplay();
+  void configure(PVertexer& vertexer, int nThreads) const;
+  void run(PVertexer& vertexer, size_t itf, PVOutput& out);
+};
+
+PVReplay::PVReplay()
+{
+  const char* envName = std::getenv("O2_PVERTEXER_BENCH_INPUT");
+  std::string inpName = envName ? envName : "pvInput.root";
+  std::unique_ptr<TFile> inpFile(TFile::Open(inpName.c_str()));
+  if (!inpFile || inpFile->IsZombie()) {
+    LOG(ERROR) << "Failed to open input file " << inpName;
+    return;
+  }
+  auto bf = reinterpret_cast<o2::BunchFilling*>(inpFile->GetObjectChecked("bunchFilling", o2::BunchFilling::Class()));
+  auto tree = (TTree*)inpFile->Get("pvInput");
+  if (!bf || !tree) {
+    LOG(ERROR) << "No bunch filling or input tree in " << inpName;
+    return;
+  }
+  bunchFilling = *bf;
+
+  PVInput tf;
+  auto tracksPtr = &tf.tracks;
+  auto gidsPtr = &tf.gids;
+  auto ft0IRPtr = &tf.ft0IR;
+  auto startIRPtr = &tf.startIR;
+  tree->SetBranchAddress("tracks", &tracksPtr);
+  tree->SetBranchAddress("gids", &gidsPtr);
+  tree->SetBranchAddress("ft0IR", &ft0IRPtr);
+  tree->SetBranchAddress("startIR", &startIRPtr);
+  tree->SetBranchAddress("itsROFrameLengthMUS", &itsROFrameLengthMUS);
+  tree->SetBranchAddress("validateWithIR", &validateWithIR);
+  for (int i = 0; i < tree->GetEntries(); i++) {
+    tree->GetEntry(i);
+    tfs.push_back(tf);
+  }
+
+  o2::base::Propagator::initFieldFromGRP();
+  auto matLUTFile = o2::base::NameConf::getMatLUTFileName();
+  if (o2::utils::Str::pathExists(matLUTFile)) {
+    o2::base::Propagator::Instance()->setMatLUT(o2::base::MatLayerCylSet::loadFromFile(matLUTFile));
+  }
+
+  PVertexer vertexer;
+  configure(vertexer, 1);
+  reference.resize(tfs.size());
+  for (size_t itf = 0; itf < tfs.size(); itf++) {
+    run(vertexer, itf, reference[itf]);
+  }
+  LOG(INFO) << "Loaded " << tfs.size() << " TFs from " << inpName;
+  ok = !tfs.empty();
+}
+
+void PVReplay::configure(PVertexer& vertexer, int nThreads) const
+{
+  vertexer.setITSROFrameLength(itsROFrameLengthMUS);
+  vertexer.setValidateWithIR(validateWithIR);
+  vertexer.setBunchFilling(bunchFilling);
+  vertexer.setNThreads(nThreads);
+  vertexer.init();
+}
+
+void PVReplay::run(PVertexer& vertexer, size_t itf, PVOutput& out)
+{
+  auto& tf = tfs[itf];
+  vertexer.setStartIR(tf.startIR);
+  out.lblVtx.clear();
+  vertexer.process(tf.tracks, tf.gids, tf.ft0IR, out.vertices, out.vertexTrackIDs, out.v2tRefs, gsl::span<const o2::MCCompLabel>{}, out.lblVtx);
+}
+
+bool isIdentical(const PVOutput& a, const PVOutput& b)
+{
+  if (a.vertices.size() != b.vertices.size() || a.vertexTrackIDs.size() != b.vertexTrackIDs.size() || a.v2tRefs.size() != b.v2tRefs.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.vertices.size(); i++) {
+    const auto &va = a.vertices[i], &vb = b.vertices[i];
+    if (va.getX() != vb.getX() || va.getY() != vb.getY() || va.getZ() != vb.getZ() || va.getCov() != vb.getCov() ||
+        va.getChi2() != vb.getChi2() || va.getNContributors() != vb.getNContributors() || va.getFlags() != vb.getFlags() ||
+        va.getTimeStamp().getTimeStamp() != vb.getTimeStamp().getTimeStamp() ||
+        va.getTimeStamp().getTimeStampError() != vb.getTimeStamp().getTimeStampError() ||
+        va.getIRMin() != vb.getIRMin() || va.getIRMax() != vb.getIRMax()) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < a.vertexTrackIDs.size(); i++) {
+    if (a.vertexTrackIDs[i].getRaw() != b.vertexTrackIDs[i].getRaw()) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < a.v2tRefs.size(); i++) {
+    if (a.v2tRefs[i].getFirstEntry() != b.v2tRefs[i].getFirstEntry() || a.v2tRefs[i].getEntries() != b.v2tRefs[i].getEntries()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void BM_PVertexer(benchmark::State& state)
+{
+  static PVReplay replay;
+  if (!replay.ok) {
+    state.SkipWithError("no recorded input for the primary vertexer");
+    return;
+  }
+  int nThreads = state.range(0);
+  PVertexer vertexer;
+  replay.configure(vertexer, nThreads);
+  PVOutput out;
+  size_t nVertices = 0;
+  for (auto _ : state) {
+    for (size_t itf = 0; itf < replay.tfs.size(); itf++) {
+      replay.run(vertexer, itf, out);
+      state.PauseTiming();
+      if (!isIdentical(out, replay.reference[itf])) {
+        state.SkipWithError(o2::utils::Str::concat_string("output differs from the single-threaded one in TF ", std::to_string(itf)).c_str());
+        return;
+      }
+      nVertices += out.vertices.size();
+      state.ResumeTiming();
+    }
+  }
+  state.counters["TFs"] = benchmark::Counter(state.iterations() * replay.tfs.size(), benchmark::Counter::kIsRate);
+  state.counters["vertices"] = benchmark::Counter(nVertices, benchmark::Counter::kIsRate);
+}
+
+BENCHMARK(BM_PVertexer)->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -39,6 +39,8 @@
 #include <arrow/table.h>
 #include <arrow/util/key_value_metadata.h>
 
+#include <map>
+#include <sstream>
 #include <thread>
 
 using namespace o2;
@@ -87,19 +89,37 @@ struct RuntimeWatchdog {
   }
 };
 
-template <typename... C>
-static constexpr auto columnNamesTrait(framework::pack<C...>)
+// the columns to read per table, from the aod-columns option
+// ORIGIN/DESCRIPTION:column,column;ORIGIN/DESCRIPTION:...
+std::map<std::string, std::vector<std::string>> parseColumnNames(std::string const& option)
 {
-  return std::vector<std::string>{C::columnLabel()...};
+  std::map<std::string, std::vector<std::string>> result;
+  std::stringstream tables(option);
+  std::string table;
+  while (std::getline(tables, table, ';')) {
+    auto sep = table.find(':');
+    if (sep == std::string::npos) {
+      LOGP(ERROR, "Malformed column specification {}, all columns will be read", table);
+      continue;
+    }
+    std::stringstream columns(table.substr(sep + 1));
+    std::string column;
+    auto& names = result[table.substr(0, sep)];
+    while (std::getline(columns, column, ',')) {
+      names.push_back(column);
+    }
+  }
+  return result;
 }
 
-std::vector<std::string> getColumnNames(header::DataHeader dh)
+std::vector<std::string> getColumnNames(std::map<std::string, std::vector<std::string>> const& columnNames, header::DataHeader dh)
 {
-  auto description = std::string(dh.dataDescription.str);
-  auto origin = std::string(dh.dataOrigin.str);
+  auto description = dh.dataDescription.as<std::string>();
+  auto origin = dh.dataOrigin.as<std::string>();
 
-  // default: column names = {}
-  return std::vector<std::string>({});
+  // default: column names = {}, all columns are read
+  auto names = columnNames.find(origin + "/" + description);
+  return names == columnNames.end() ? std::vector<std::string>({}) : names->second;
 }
 
 using o2::monitoring::Metric;
@@ -177,20 +197,32 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
       }
     }
 
+    // read the next time frame in the background
+    if (options.isSet("aod-prefetch") && options.get<bool>("aod-prefetch")) {
+      didir->setPrefetching(true);
+    }
+
     // get the run time watchdog
     auto* watchdog = new RuntimeWatchdog(options.get<int64_t>("time-limit"));
 
     // selected the TFN input and
     // create list of requested tables
+    // with the columns to read
+    auto columnNames = parseColumnNames(options.isSet("aod-columns") ? options.get<std::string>("aod-columns") : "");
     header::DataHeader TFNumberHeader;
-    std::vector<OutputRoute> requestedTables;
+    std::vector<TableRequest> requestedTables;
     std::vector<OutputRoute> routes(spec.outputs);
     for (auto route : routes) {
+      auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+      auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
       if (DataSpecUtils::partialMatch(route.matcher, header::DataOrigin("TFN"))) {
-        auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
-        TFNumberHeader = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
+        TFNumberHeader = dh;
       } else {
-        requestedTables.emplace_back(route);
+        auto columns = getColumnNames(columnNames, dh);
+        if (columns.size()) {
+          LOGP(INFO, "Reading {} columns of table {}/{}", columns.size(), concrete.origin.as<std::string>(), concrete.description.as<std::string>());
+        }
+        requestedTables.push_back(TableRequest{dh, columns});
       }
     }
 
@@ -238,15 +270,12 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
 
       auto ioStart = uv_hrtime();
 
-      for (auto route : requestedTables) {
+      for (auto& request : requestedTables) {
+        auto& dh = request.dh;
 
-        // create header
-        auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
-        auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
-
-        // create a TreeToTable object
-        TTree* tr = didir->getDataTree(dh, fcnt, ntf);
-        if (!tr) {
+        // read the table, it was possibly prefetched while the previous time frame was processed
+        auto readout = didir->readTable(request, fcnt, ntf);
+        if (!readout.table) {
           if (first) {
             // dump metrics of file which is done for reading
             dumpFileMetrics(monitoring, currentFile, currentFileStartedAt, currentFileIOTime, tfCurrentFile, ntf);
@@ -265,13 +294,13 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
             }
             // get first folder of next file
             ntf = 0;
-            tr = didir->getDataTree(dh, fcnt, ntf);
-            if (!tr) {
-              LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin, fcnt, ntf);
+            readout = didir->readTable(request, fcnt, ntf);
+            if (!readout.table) {
+              LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", dh.dataOrigin.as<std::string>(), fcnt, ntf);
               throw std::runtime_error("Processing is stopped!");
             }
           } else {
-            LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin, fcnt, ntf);
+            LOGP(FATAL, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", dh.dataOrigin.as<std::string>(), fcnt, ntf);
             throw std::runtime_error("Processing is stopped!");
           }
         }
@@ -282,27 +311,10 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
           outputs.make<uint64_t>(o) = timeFrameNumber;
         }
 
-        // create table output
-        auto o = Output(dh);
-        auto& t2t = outputs.make<TreeToTable>(o);
-
-        // add branches to read
-        // fill the table
-        auto colnames = getColumnNames(dh);
-        if (colnames.size() == 0) {
-          totalSizeCompressed += tr->GetZipBytes();
-          totalSizeUncompressed += tr->GetTotBytes();
-          t2t.addAllColumns(tr);
-        } else {
-          for (auto& colname : colnames) {
-            TBranch* branch = tr->GetBranch(colname.c_str());
-            totalSizeCompressed += branch->GetZipBytes("*");
-            totalSizeUncompressed += branch->GetTotBytes("*");
-            t2t.addColumn(colname.c_str());
-          }
-        }
-        t2t.fill(tr);
-        delete tr;
+        // send the table
+        totalSizeCompressed += readout.compressedBytes;
+        totalSizeUncompressed += readout.uncompressedBytes;
+        outputs.adopt(Output(dh), readout.table);
 
         // needed for metrics dumping (upon next file read, or terminate due to watchdog)
         if (currentFile == nullptr) {
@@ -312,6 +324,11 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback()
 
         first = false;
       }
+
+      // start reading the next time frame of the file while this one is processed
+      if (didir->isPrefetching() && !requestedTables.empty() && ntf + 1 < didir->getTimeFramesInFile(requestedTables.front().dh, fcnt)) {
+        didir->prefetch(requestedTables, fcnt, ntf + 1);
+      }
       monitoring.send(Metric{(uint64_t)ntf, "tf-sent"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
       monitoring.send(Metric{(uint64_t)totalSizeUncompressed / 1000, "aod-bytes-read-uncompressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
       monitoring.send(Metric{(uint64_t)totalSizeCompressed / 1000, "aod-bytes-read-compressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
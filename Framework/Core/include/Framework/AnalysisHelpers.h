@@ -480,6 +480,17 @@ struct Service {
   }
 };
 
+/// This helper allows you to declare the persistent columns a task reads
+/// through the iterators of the tables it subscribes to, e.g.
+///   Uses<aod::track::X, aod::track::Alpha> columns;
+/// For the tables with declared columns, only these columns, the index columns
+/// and the columns used by the Filters and Partitions of the task are read
+/// from file by the AOD reader, the other ones are null. The tables without
+/// declared columns are read completely.
+template <typename... C>
+struct Uses {
+};
+
 template <typename T>
 o2::soa::Filtered<T>* getTableFromFilter(const T& table, const expressions::Filter& filter)
 {
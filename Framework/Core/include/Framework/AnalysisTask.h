@@ -37,6 +37,8 @@
 #include <memory>
 #include <sstream>
 #include <iomanip>
+#include <set>
+#include <string>
 namespace o2::framework
 {
 /// A more familiar task API for the DPL analysis framework.
@@ -80,6 +82,45 @@ struct AnalysisDataProcessorBuilder {
     return getInputSpecs(typename T::sources_t{});
   }
 
+  /// The persistent columns of a table, restricted by restrictColumns to the ones used by
+  /// the task. The AOD reader reads only the columns used by some task from file
+  template <typename... C>
+  static ConfigParamSpec getColumnsSpec(framework::pack<C...>)
+  {
+    std::string columns;
+    ((columns += (columns.empty() ? "" : ",") + std::string{C::columnLabel()}), ...);
+    return ConfigParamSpec{"aod-columns", VariantType::String, columns, {"Columns used by the task"}};
+  }
+
+  /// Keep in the "aod-columns" of the inputs the columns declared with Uses, the index columns
+  /// and the columns of the filters and partitions. The tables without declared columns are
+  /// read completely, as the columns accessed through their iterators are not known.
+  static void restrictColumns(std::vector<InputSpec>& inputs, std::set<std::string> const& declared, std::set<std::string> const& filtered)
+  {
+    for (auto& input : inputs) {
+      auto spec = std::find_if(input.metadata.begin(), input.metadata.end(), [](ConfigParamSpec const& meta) { return meta.name == "aod-columns"; });
+      if (spec == input.metadata.end()) {
+        continue;
+      }
+      std::vector<std::string> columns;
+      std::stringstream ss(spec->defaultValue.get<std::string>());
+      for (std::string column; std::getline(ss, column, ',');) {
+        columns.push_back(column);
+      }
+      if (std::none_of(columns.begin(), columns.end(), [&declared](std::string const& column) { return declared.count(column) > 0; })) {
+        input.metadata.erase(spec);
+        continue;
+      }
+      std::string used;
+      for (auto& column : columns) {
+        if (declared.count(column) > 0 || filtered.count(column) > 0 || column.rfind("fIndex", 0) == 0) {
+          used += (used.empty() ? "" : ",") + column;
+        }
+      }
+      spec->defaultValue = used;
+    }
+  }
+
   template <typename Arg>
   static void doAppendInputWithMetadata(std::vector<InputSpec>& inputs)
   {
@@ -93,7 +134,8 @@ struct AnalysisDataProcessorBuilder {
       inputSources.erase(last, inputSources.end());
       inputs.push_back(InputSpec{metadata::tableLabel(), metadata::origin(), metadata::description(), Lifetime::Timeframe, inputSources});
     } else {
-      inputs.push_back({metadata::tableLabel(), metadata::origin(), metadata::description()});
+      inputs.push_back(InputSpec{metadata::tableLabel(), metadata::origin(), metadata::description(), Lifetime::Timeframe,
+                                 {getColumnsSpec(typename std::decay_t<Arg>::persistent_columns_t{})}});
     }
   }
 
@@ -728,6 +770,15 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
   auto last = std::unique(inputs.begin(), inputs.end(), [](InputSpec const& a, InputSpec const& b) { return a.binding == b.binding; });
   inputs.erase(last, inputs.end());
 
+  // read from file only the columns used by the task
+  std::set<std::string> declaredColumns;
+  std::set<std::string> filteredColumns;
+  homogeneous_apply_refs([&declaredColumns, &filteredColumns](auto& x) {
+    return ColumnManager<std::decay_t<decltype(x)>>::appendColumns(declaredColumns, filteredColumns, x);
+  },
+                         *task.get());
+  AnalysisDataProcessorBuilder::restrictColumns(inputs, declaredColumns, filteredColumns);
+
   //request base tables for spawnable extended tables
   homogeneous_apply_refs([&inputs](auto& x) {
     return SpawnManager<std::decay_t<decltype(x)>>::requestInputs(inputs, x);
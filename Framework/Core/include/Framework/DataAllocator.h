@@ -18,6 +18,7 @@
 #include "Framework/OutputRef.h"
 #include "Framework/OutputRoute.h"
 #include "Framework/DataChunk.h"
+#include "Framework/DataRef.h"
 #include "Framework/FairMQDeviceProxy.h"
 #include "Framework/TimingInfo.h"
 #include "Framework/TMessageSerializer.h"
@@ -376,6 +377,11 @@ class DataAllocator
   void snapshot(const Output& spec, const char* payload, size_t payloadSize,
                 o2::header::SerializationMethod serializationMethod = o2::header::gSerializationMethodNone);
 
+  /// Send the payload of an input of the current computation with a new header. The payload message
+  /// is shared with the input by reference count when the transport allows it, instead of being copied.
+  /// Other payloads are copied as in snapshot. The serialization method of the input is kept.
+  void forward(const Output& spec, const DataRef& input);
+
   /// make an object of type T and route to output specified by OutputRef
   /// The object is owned by the framework, returned reference can be used to fill the object.
   ///
@@ -446,6 +452,12 @@ class DataAllocator
     return snapshot(getOutputByBind(std::move(ref)), std::forward<Args>(args)...);
   }
 
+  /// forward the payload of an input to the output specified by OutputRef, see forward(const Output&, const DataRef&)
+  void forward(OutputRef&& ref, const DataRef& input)
+  {
+    forward(getOutputByBind(std::move(ref)), input);
+  }
+
   /// check if a certain output is allowed
   bool isAllowed(Output const& query);
 
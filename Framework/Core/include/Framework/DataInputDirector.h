@@ -16,9 +16,17 @@
 
 #include "Framework/DataDescriptorMatcher.h"
 
+#include <future>
+#include <map>
+#include <memory>
 #include <regex>
 #include "rapidjson/fwd.h"
 
+namespace arrow
+{
+class Table;
+}
+
 namespace o2::framework
 {
 
@@ -35,6 +43,20 @@ struct FileAndFolder {
   std::string folderName = "";
 };
 
+/// A table to be read by the DataInputDirector, restricted to the given columns (all if empty)
+struct TableRequest {
+  header::DataHeader dh;
+  std::vector<std::string> columns;
+};
+
+/// A table read by the DataInputDirector together with the size of the branches it was read from
+struct TableReadout {
+  header::DataHeader dh;
+  std::shared_ptr<arrow::Table> table;
+  size_t compressedBytes = 0;
+  size_t uncompressedBytes = 0;
+};
+
 struct DataInputDescriptor {
   /// Holds information concerning the reading of an aod table.
   /// The information includes the table specification, treename,
@@ -71,6 +93,7 @@ struct DataInputDescriptor {
   uint64_t getTimeFrameNumber(int counter, int numTF);
   FileAndFolder getFileFolder(int counter, int numTF);
   int getTimeFramesInFile(int counter);
+  std::string getFileName(int counter) { return mfilenames.at(counter)->fileName; }
 
   void closeInputFile();
   bool isAlienSupportOn() { return mAlienSupport; }
@@ -118,6 +141,18 @@ struct DataInputDirector {
   FileAndFolder getFileFolder(header::DataHeader dh, int counter, int numTF);
   int getTimeFramesInFile(header::DataHeader dh, int counter);
 
+  /// Read the table of the time frame numTF of file counter, only the requested columns are
+  /// read from the tree. The table is taken from the prefetched ones if available.
+  /// Returns an empty table if the time frame does not exist.
+  TableReadout readTable(TableRequest const& request, int counter, int numTF);
+
+  /// Start reading the tables of the time frame numTF of file counter in the background, using a
+  /// separate handle of the input file, while the current time frame is being processed
+  void prefetch(std::vector<TableRequest> const& requests, int counter, int numTF);
+  /// Enable the prefetching of the tables, this makes ROOT thread-safe
+  void setPrefetching(bool prefetching);
+  bool isPrefetching() const { return mPrefetching; }
+
  private:
   std::string minputfilesFile;
   std::string* const minputfilesFilePtr = &minputfilesFile;
@@ -130,8 +165,20 @@ struct DataInputDirector {
   bool mDebugMode = false;
   bool mAlienSupport = false;
 
+  // state of the prefetching, the files are used by the prefetching thread only and
+  // must outlive it
+  bool mPrefetching = false;
+  int mPrefetchCounter = -1;
+  int mPrefetchTF = -1;
+  std::map<std::string, std::unique_ptr<TFile>> mPrefetchFiles;
+  std::vector<TableRequest> mPrefetchRequests;
+  std::vector<TableReadout> mPrefetchedTables;
+  std::future<std::vector<TableReadout>> mPrefetched;
+
   bool readJsonDocument(rapidjson::Document* doc);
   bool isValid();
+  DataInputDescriptor* getDataInputDescriptorOrDefault(header::DataHeader dh, std::string& treename);
+  void waitForPrefetch();
 };
 
 } // namespace o2::framework
@@ -18,8 +18,10 @@
 #include "Framework/CompletionPolicy.h"
 #include "Framework/MessageSet.h"
 #include "Framework/TimesliceIndex.h"
+#include "Framework/LockFreeBoundedQueue.h"
 #include "Framework/Tracing.h"
 
+#include <atomic>
 #include <cstddef>
 #include <mutex>
 #include <vector>
@@ -52,9 +54,14 @@ enum struct CacheEntryStatus : int {
 class DataRelayer
 {
  public:
-  /// DataRelayer is thread safe because we have a lock around
-  /// each method and there is no particular order in which
-  /// methods need to be called.
+  /// DataRelayer is thread safe and there is no particular order in which
+  /// methods need to be called. The TimesliceIndex is only locked while an
+  /// incoming message is matched to a slot. The cacheline of each slot has
+  /// its own lock, the state of the cache entries is atomic and the slots
+  /// which received data are handed to getReadyToProcess via a lock-free
+  /// queue, so that different timeslices can be relayed and dispatched
+  /// concurrently by several processing streams.
+  /// Changing the pipeline length is not thread safe.
   constexpr static ServiceKind service_kind = ServiceKind::Global;
   enum RelayChoice {
     WillRelay,     /// Ownership of the data has been taken
@@ -140,6 +147,10 @@ class DataRelayer
   void clear();
 
  private:
+  /// Mark @a slot as updated, so that the next getReadyToProcess
+  /// checks its completion.
+  void markAsDirty(TimesliceSlot slot);
+
   monitoring::Monitoring& mMetrics;
 
   /// This is the actual cache of all the parts in flight.
@@ -156,13 +167,23 @@ class DataRelayer
   std::vector<size_t> mDistinctRoutesIndex;
   std::vector<data_matcher::DataDescriptorMatcher> mInputMatchers;
   std::vector<data_matcher::VariableContext> mVariableContextes;
-  std::vector<CacheEntryStatus> mCachedStateMetrics;
+  std::vector<std::atomic<CacheEntryStatus>> mCachedStateMetrics;
+
+  /// One lock per slot, protecting the associated cacheline in mCache.
+  /// When both are needed, mMutex is always taken first.
+  std::vector<std::mutex> mSlotMutexes;
+  /// Whether a slot was updated since its completion was last checked.
+  std::vector<std::atomic<bool>> mDirtySlots;
+  /// The dirty slots, in the order they were marked. A slot is queued
+  /// only when its dirty flag is raised, hence at most once.
+  LockFreeBoundedQueue<size_t> mCompletionQueue;
 
   static std::vector<std::string> sMetricsNames;
   static std::vector<std::string> sVariablesMetricsNames;
   static std::vector<std::string> sQueriesMetricsNames;
 
   DataRelayerStats mStats;
+  /// Protects the TimesliceIndex and the stats.
   TracyLockableN(std::recursive_mutex, mMutex, "data relayer mutex");
 };
 
@@ -16,6 +16,8 @@
 #include "Framework/DeviceState.h"
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 // For pid_t
@@ -26,6 +28,8 @@
 namespace o2::framework
 {
 
+class DeviceMetricsChannel;
+
 struct DeviceInfo {
   /// The pid of the device associated to this device
   pid_t pid;
@@ -74,6 +78,12 @@ struct DeviceInfo {
   short tracyPort;
   /// Timestamp of the last signal received
   size_t lastSignal;
+  /// Binary channel for the numeric metrics of the device, if any.
+  std::shared_ptr<DeviceMetricsChannel> metricsChannel;
+  /// Number of metrics dropped by the device when last reported.
+  size_t droppedMetrics = 0;
+  /// Time of the last report of dropped metrics.
+  uint64_t lastDroppedMetricsReport = 0;
 };
 
 } // namespace o2::framework
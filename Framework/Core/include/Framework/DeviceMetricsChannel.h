@@ -0,0 +1,151 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_DEVICEMETRICSCHANNEL_H_
+#define O2_FRAMEWORK_DEVICEMETRICSCHANNEL_H_
+
+#include "Framework/DeviceMetricsInfo.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace o2::framework
+{
+
+/// Binary channel for the numeric metrics of a device, so that they do not
+/// need to be formatted by the device and parsed by the driver as text.
+///
+/// The channel lives in a POSIX shared memory segment, created by the driver
+/// for each device it spawns, which holds:
+/// - a table of metric labels, to which the device appends a metric the first
+///   time it is sent. Records refer to the label by its index afterwards.
+/// - a bounded ring of fixed size records, written by any thread of the device
+///   and read in bulk by the driver. As in LockFreeBoundedQueue, writers reserve
+///   a record with a compare-and-swap on the write position and publish it via
+///   its sequence number, so no lock is shared between the two processes.
+///
+/// When the ring is full send() fails and the metric is counted in failed().
+/// It must not go through the text protocol instead, as it would overtake the
+/// metrics still queued in the ring. A metric which does not fit in the label
+/// table any more has nothing queued, so it goes through the text protocol.
+class DeviceMetricsChannel
+{
+ public:
+  static constexpr uint32_t Magic = 0x4d4c5044; ///< "DPLM"
+  static constexpr size_t MaxLabels = 8192;
+  static constexpr size_t Capacity = 16384; ///< Records in the ring, power of two.
+  static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+  static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory atomics must be lock free");
+
+  /// Outcome of send().
+  enum struct SendResult : char {
+    Sent,     ///< The metric was queued.
+    RingFull, ///< The metric was dropped and counted in failed().
+    NoLabel   ///< The label table is full, the metric was not queued.
+  };
+
+  struct Record {
+    std::atomic<uint64_t> sequence;
+    uint64_t timestamp;
+    uint32_t labelIndex;
+    MetricType type;
+    union {
+      int intValue;
+      float floatValue;
+      uint64_t uint64Value;
+    };
+  };
+
+  /// Layout of the shared memory segment.
+  struct Segment {
+    uint32_t magic;
+    alignas(64) std::atomic<uint64_t> writePos;
+    alignas(64) std::atomic<uint32_t> labelsCount;
+    std::atomic<uint64_t> failed;
+    MetricLabel labels[MaxLabels];
+    Record records[Capacity];
+  };
+
+  ~DeviceMetricsChannel();
+
+  /// Create the segment @a name. To be used by the driver before spawning
+  /// the device. The segment is unlinked when the channel is destroyed.
+  /// @return nullptr if the segment could not be created.
+  static std::unique_ptr<DeviceMetricsChannel> create(std::string const& name);
+  /// Attach to the segment @a name created by the driver. To be used by the
+  /// device. The name is unlinked right away, so that nothing is left behind
+  /// if any of the two processes dies.
+  /// @return nullptr if the segment could not be attached.
+  static std::unique_ptr<DeviceMetricsChannel> attach(std::string const& name);
+
+  /// Queue a metric. Device side, thread safe.
+  /// @return whether the metric was queued, or why it was not.
+  SendResult send(std::string const& name, int value, size_t timestamp);
+  SendResult send(std::string const& name, float value, size_t timestamp);
+  SendResult send(std::string const& name, uint64_t value, size_t timestamp);
+
+  /// Invoke @a callback(MetricLabel const&, size_t labelIndex, Record const&)
+  /// for all the queued metrics, in the order they were sent. Driver side,
+  /// there must be only one reader.
+  /// @return the number of metrics which were read.
+  template <typename F>
+  size_t consume(F&& callback);
+
+  /// @return the number of metrics dropped so far because the ring was full.
+  size_t failed() const { return mSegment->failed.load(std::memory_order_relaxed); }
+
+ private:
+  DeviceMetricsChannel(Segment* segment, std::string name, bool owner);
+
+  template <typename T>
+  SendResult sendValue(std::string const& name, T value, size_t timestamp);
+
+  Segment* mSegment;
+  std::string mName;
+  bool mOwner;
+  /// Position of the next record to read, driver side.
+  uint64_t mReadPos = 0;
+  /// Index in the label table of the metrics already sent, device side.
+  std::unordered_map<std::string, uint32_t> mLabelIndices;
+  std::mutex mLabelsMutex;
+};
+
+template <typename F>
+size_t DeviceMetricsChannel::consume(F&& callback)
+{
+  size_t count = 0;
+  // The label of a record is always added before the record is published.
+  size_t labelsCount = mSegment->labelsCount.load(std::memory_order_acquire);
+  while (true) {
+    auto& record = mSegment->records[mReadPos & (Capacity - 1)];
+    if (record.sequence.load(std::memory_order_acquire) != mReadPos + 1) {
+      break;
+    }
+    if (record.labelIndex >= labelsCount) {
+      labelsCount = mSegment->labelsCount.load(std::memory_order_acquire);
+    }
+    if (record.labelIndex < labelsCount) {
+      callback(mSegment->labels[record.labelIndex], record.labelIndex, record);
+    }
+    record.sequence.store(mReadPos + Capacity, std::memory_order_release);
+    ++mReadPos;
+    ++count;
+  }
+  return count;
+}
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_DEVICEMETRICSCHANNEL_H_
@@ -25,6 +25,8 @@
 namespace o2::framework
 {
 
+class DeviceMetricsChannel;
+
 struct DeviceMetricsHelper {
   /// Type of the callback which can be provided to be invoked every time a new
   /// metric is found by the system.
@@ -41,6 +43,25 @@ struct DeviceMetricsHelper {
   static bool processMetric(ParsedMetricMatch& results,
                             DeviceMetricsInfo& info,
                             NewMetricCallback newMetricCallback = nullptr);
+
+  /// Processes all the metrics queued in a binary @a channel and stores them
+  /// in the backend store, like processMetric does for a parsed one.
+  /// @return the number of metrics read from the channel.
+  static size_t processMetrics(DeviceMetricsChannel& channel,
+                               DeviceMetricsInfo& info,
+                               NewMetricCallback newMetricCallback = nullptr);
+
+  /// @return the index in metrics of the metric named like @a results,
+  /// which is created if needed, or -1 if its type is not supported.
+  static size_t findOrCreateMetric(ParsedMetricMatch const& results,
+                                   DeviceMetricsInfo& info,
+                                   NewMetricCallback newMetricCallback = nullptr);
+
+  /// Stores the value of @a results for the metric at @a metricIndex.
+  static bool storeMetric(ParsedMetricMatch const& results,
+                          size_t metricIndex,
+                          DeviceMetricsInfo& info);
+
   /// @return the index in metrics for the information of given metric
   static size_t metricIdxByName(const std::string& name,
                                 const DeviceMetricsInfo& info);
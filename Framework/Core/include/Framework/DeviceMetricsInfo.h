@@ -89,6 +89,8 @@ struct DeviceMetricsInfo {
   std::vector<MetricLabelIndex> metricLabelsAlphabeticallySortedIdx;
   std::vector<MetricInfo> metrics;
   std::vector<bool> changed;
+  /// Index in metrics of each label of the binary metrics channel, if any.
+  std::vector<size_t> channelMetricIndices;
 };
 
 } // namespace o2::framework
@@ -331,26 +331,38 @@ using Projector = Filter;
 using Selection = std::shared_ptr<gandiva::SelectionVector>;
 /// Function for creating gandiva selection from our internal filter tree
 Selection createSelection(std::shared_ptr<arrow::Table> table, Filter const& expression);
-/// Function for creating gandiva selection from prepared gandiva expressions tree
+/// Function for creating gandiva selection from prepared gandiva expressions tree,
+/// large tables are evaluated in slices by getSelectionThreads() threads
 Selection createSelection(std::shared_ptr<arrow::Table> table, std::shared_ptr<gandiva::Filter> gfilter);
+/// Set the number of threads evaluating the filters in createSelection, the default
+/// is taken from the O2_GANDIVA_THREADS environment variable or 1 if it is not set
+void setSelectionThreads(int nThreads);
+int getSelectionThreads();
 
 struct ColumnOperationSpec;
 using Operations = std::vector<ColumnOperationSpec>;
 
 /// Function to create an internal operation sequence from a filter tree
 Operations createOperations(Filter const& expression);
+/// Function to collect the names of the columns used in a filter tree
+void collectColumnNames(Filter const& expression, std::set<std::string>& names);
 
 /// Function to check compatibility of a given arrow schema with operation sequence
 bool isSchemaCompatible(gandiva::SchemaPtr const& Schema, Operations const& opSpecs);
 /// Function to create gandiva expression tree from operation sequence
 gandiva::NodePtr createExpressionTree(Operations const& opSpecs,
                                       gandiva::SchemaPtr const& Schema);
-/// Function to create gandiva filter from gandiva condition
+/// Function to create gandiva filter from gandiva condition, the compiled filters
+/// are cached process-wide by condition and schema
 std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
                                               gandiva::ConditionPtr condition);
 /// Function to create gandiva filter from operation sequence
 std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
                                               Operations const& opSpecs);
+/// Function to create gandiva projector from gandiva expressions, the compiled
+/// projectors are cached process-wide by expressions and schema
+std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
+                                                    gandiva::ExpressionVector const& expressions);
 /// Function to create gandiva projector from operation sequence
 std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
                                                     Operations const& opSpecs,
@@ -371,20 +383,13 @@ void updatePlaceholders(Filter& filter, InitContext& context);
 template <typename... C>
 std::shared_ptr<gandiva::Projector> createProjectors(framework::pack<C...>, gandiva::SchemaPtr schema)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(
+  return createProjector(
     schema,
     {makeExpression(
       framework::expressions::createExpressionTree(
         framework::expressions::createOperations(C::Projector()),
         schema),
-      C::asArrowField())...},
-    &projector);
-  if (s.ok()) {
-    return projector;
-  } else {
-    throw o2::framework::runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
+      C::asArrowField())...});
 }
 } // namespace o2::framework::expressions
 
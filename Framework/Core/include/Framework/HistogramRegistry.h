@@ -26,7 +26,9 @@
 #include <TDataMember.h>
 #include <TDataType.h>
 
+#include <atomic>
 #include <deque>
+#include <mutex>
 
 class TList;
 
@@ -53,6 +55,40 @@ struct HistFiller {
   static double getSize(std::shared_ptr<T>& hist, double fillFraction = 1.);
 
  private:
+  // sequential access to the values of a numeric arrow column, the rows must be accessed in increasing order
+  template <typename V>
+  struct ColumnChunkReader {
+    static constexpr bool supported = std::is_arithmetic_v<V> && !std::is_same_v<V, bool>;
+
+    ColumnChunkReader(std::shared_ptr<arrow::ChunkedArray> column) : mColumn{std::move(column)} {}
+
+    V get(int64_t row)
+    {
+      while (row >= mChunkEnd) {
+        auto const& chunk = mColumn->chunk(mChunk++);
+        mChunkBegin = mChunkEnd;
+        mChunkEnd += chunk->length();
+        mValues = chunk->data()->template GetValues<V>(1);
+      }
+      return mValues[row - mChunkBegin];
+    }
+
+    std::shared_ptr<arrow::ChunkedArray> mColumn;
+    int mChunk = 0;
+    int64_t mChunkBegin = 0;
+    int64_t mChunkEnd = 0;
+    V const* mValues = nullptr;
+  };
+
+  template <typename C>
+  static constexpr bool isChunkReadable()
+  {
+    if constexpr (C::persistent::value) {
+      return ColumnChunkReader<typename C::type>::supported;
+    }
+    return false;
+  }
+
   // helper function to determine base element size of histograms (in bytes)
   template <typename T>
   static int getBaseElementSize(T* ptr);
@@ -123,6 +159,14 @@ class HistogramRegistry
   template <typename... Cs, typename T>
   void fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // enable filling from up to nThreads threads concurrently: every filling thread gets its own empty copy (shard)
+  // of all histograms, the histograms must be added before; the shards are merged when the output is created.
+  // Any further thread fills a shared overflow shard under a lock
+  void setConcurrentFills(int nThreads);
+
+  // add the content of the shards to the histograms of the registry and reset the shards
+  void mergeShards();
+
   // get rough estimate for size of histogram stored in registry
   double getSize(const HistName& histName, double fillFraction = 1.);
 
@@ -177,6 +221,35 @@ class HistogramRegistry
   static constexpr uint32_t MAX_REGISTRY_SIZE{REGISTRY_BITMASK + 1};
   std::array<uint32_t, MAX_REGISTRY_SIZE> mRegistryKey{};
   std::array<HistPtr, MAX_REGISTRY_SIZE> mRegistryValue{};
+
+  // shards of the histograms for concurrent filling, a thread takes the next free shard at its first fill,
+  // the last one is the overflow shard shared by the threads which find no free shard
+  struct Shards {
+    uint64_t id{};
+    std::atomic<int> next{0};
+    std::vector<std::array<HistPtr, MAX_REGISTRY_SIZE>> values;
+    std::mutex overflowMutex;
+    int overflow() const { return values.size() - 1; }
+  };
+  std::shared_ptr<Shards> mShards{};
+
+  // helper function applying the filler to the histogram slot of the current thread
+  template <typename F>
+  void visitFillTarget(uint32_t idx, F&& filler)
+  {
+    if (O2_BUILTIN_LIKELY(!mShards)) {
+      std::visit(filler, mRegistryValue[idx]);
+      return;
+    }
+    int shard = getShardIndex();
+    if (O2_BUILTIN_UNLIKELY(shard == mShards->overflow())) {
+      std::scoped_lock<std::mutex> lock(mShards->overflowMutex);
+      std::visit(filler, mShards->values[shard][idx]);
+    } else {
+      std::visit(filler, mShards->values[shard][idx]);
+    }
+  }
+  int getShardIndex();
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -228,9 +301,20 @@ void HistFiller::fillHistAny(std::shared_ptr<R>& hist, const T& table, const o2:
     LOGF(FATAL, "Table filling is not (yet?) supported for StepTHn.");
     return;
   }
-  auto filtered = o2::soa::Filtered<T>{{table.asArrowTable()}, o2::framework::expressions::createSelection(table.asArrowTable(), filter)};
-  for (auto& t : filtered) {
-    fillHistAny(hist, (*(static_cast<Cs>(t).getIterator()))...);
+  auto arrowTable = table.asArrowTable();
+  auto selection = o2::framework::expressions::createSelection(arrowTable, filter);
+  if constexpr ((isChunkReadable<Cs>() && ...)) {
+    // read the values directly from the arrow column chunks
+    std::tuple<ColumnChunkReader<typename Cs::type>...> readers{ColumnChunkReader<typename Cs::type>{arrowTable->GetColumnByName(Cs::columnLabel())}...};
+    for (int64_t i = 0; i < selection->GetNumSlots(); ++i) {
+      auto row = selection->GetIndex(i);
+      std::apply([&hist, row](auto&... reader) { fillHistAny(hist, reader.get(row)...); }, readers);
+    }
+  } else {
+    auto filtered = o2::soa::Filtered<T>{{arrowTable}, selection};
+    for (auto& t : filtered) {
+      fillHistAny(hist, (*(static_cast<Cs>(t).getIterator()))...);
+    }
   }
 }
 
@@ -347,6 +431,9 @@ auto& HistogramRegistry::operator()(const HistName& histName)
 template <typename T>
 void HistogramRegistry::insertClone(const HistName& histName, const std::shared_ptr<T>& originalHist)
 {
+  if (mShards) {
+    LOGF(FATAL, R"(Cannot add histogram "%s" to HistogramRegistry "%s" after enabling concurrent fills.)", histName.str, mName);
+  }
   validateHistName(histName.str, histName.hash);
   for (auto i = 0u; i < MAX_REGISTRY_SIZE; ++i) {
     TObject* rawPtr = nullptr;
@@ -379,13 +466,13 @@ uint32_t HistogramRegistry::getHistIndex(const T& histName)
 template <typename... Ts>
 void HistogramRegistry::fill(const HistName& histName, Ts&&... positionAndWeight)
 {
-  std::visit([&positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, std::forward<Ts>(positionAndWeight)...); }, mRegistryValue[getHistIndex(histName)]);
+  visitFillTarget(getHistIndex(histName), [&positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, std::forward<Ts>(positionAndWeight)...); });
 }
 
 template <typename... Cs, typename T>
 void HistogramRegistry::fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter)
 {
-  std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, mRegistryValue[getHistIndex(histName)]);
+  visitFillTarget(getHistIndex(histName), [&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); });
 }
 
 } // namespace o2::framework
@@ -0,0 +1,110 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_LOCKFREEBOUNDEDQUEUE_H_
+#define O2_FRAMEWORK_LOCKFREEBOUNDEDQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace o2::framework
+{
+
+/// Bounded multi-producer / multi-consumer FIFO which does not take any lock.
+/// Every cell carries a sequence number which tells producers whether the cell
+/// can be written and consumers whether it can be read, so that both sides
+/// only need a compare-and-swap on their own position (D. Vyukov's algorithm).
+/// The capacity is rounded up to the next power of two.
+template <typename T>
+class LockFreeBoundedQueue
+{
+ public:
+  explicit LockFreeBoundedQueue(size_t capacity = 1)
+  {
+    reset(capacity);
+  }
+
+  /// Drop the content and change the capacity. Not thread safe.
+  void reset(size_t capacity)
+  {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    mCells = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; ++i) {
+      mCells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    mMask = size - 1;
+    mEnqueuePos.store(0, std::memory_order_relaxed);
+    mDequeuePos.store(0, std::memory_order_relaxed);
+  }
+
+  /// @return false if the queue is full.
+  bool push(T const& value)
+  {
+    size_t pos = mEnqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = mCells[pos & mMask];
+      auto diff = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (mEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value = value;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = mEnqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @return false if the queue is empty.
+  bool pop(T& value)
+  {
+    size_t pos = mDequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = mCells[pos & mMask];
+      auto diff = static_cast<intptr_t>(cell.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (mDequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          value = std::move(cell.value);
+          cell.sequence.store(pos + mMask + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = mDequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_t capacity() const { return mMask + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Cell[]> mCells;
+  size_t mMask = 0;
+  alignas(64) std::atomic<size_t> mEnqueuePos{0};
+  alignas(64) std::atomic<size_t> mDequeuePos{0};
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_LOCKFREEBOUNDEDQUEUE_H_
@@ -37,6 +37,7 @@ namespace o2
 namespace framework
 {
 class Output;
+struct MessageSet;
 
 class MessageContext
 {
@@ -544,12 +545,24 @@ class MessageContext
   /// mMessages then in mScheduledMessages
   o2::header::DataHeader* findMessageHeader(const Output& spec);
 
+  /// Register the input messages of the computation being processed, so that their payloads can be
+  /// forwarded without copying them. nullptr when no computation is being processed.
+  void setInputMessages(std::vector<MessageSet> const* inputs)
+  {
+    mInputMessages = inputs;
+  }
+
+  /// return the input message owning the given payload buffer, nullptr if it is not an input of
+  /// the current computation
+  FairMQMessage* findInputPayload(const char* payload) const;
+
  private:
   FairMQDeviceProxy mProxy;
   Messages mMessages;
   Messages mScheduledMessages;
   DispatchControl mDispatchControl;
   std::unordered_map<std::string, std::unique_ptr<std::string>> mChannelRefs;
+  std::vector<MessageSet> const* mInputMessages = nullptr;
 };
 } // namespace framework
 } // namespace o2
@@ -59,6 +59,7 @@ class StepTHn : public TNamed
 
   TAxis* GetAxis(int i) { return mPrototype->GetAxis(i); }
   void Sumw2(){}; // TODO: added for compatibiltiy with registry, but maybe it would be useful also in StepTHn as toggle for error weights
+  void Reset() { deleteContainers(); } // clear the content of all steps
 
  protected:
   void init();
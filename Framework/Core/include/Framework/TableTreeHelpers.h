@@ -122,11 +122,16 @@ class TreeToTable
  private:
   std::shared_ptr<arrow::Table> mTable;
   std::vector<std::string> mColumnNames;
+  std::vector<std::string> mNullColumnNames;
 
  public:
   // add a column to be included in the arrow::table
   void addColumn(const char* colname);
 
+  // add a column to be included in the arrow::table without reading its
+  // branch, all its values are null
+  void addNullColumn(const char* colname);
+
   // add all branches in @a tree as columns
   bool addAllColumns(TTree* tree);
 
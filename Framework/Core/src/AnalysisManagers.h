@@ -24,6 +24,9 @@
 #include "Framework/RootConfigParamHelpers.h"
 #include "../src/ExpressionHelpers.h"
 
+#include <set>
+#include <string>
+
 namespace o2::framework
 {
 
@@ -385,6 +388,52 @@ struct OptionManager<Configurable<T, K, IP>> {
   }
 };
 
+/// Manager template to collect the columns used by a task, the columns declared
+/// with Uses and the ones used by the filters and partitions
+template <typename T>
+struct ColumnManager {
+  static bool appendColumns(std::set<std::string>&, std::set<std::string>&, T const&) { return false; }
+};
+
+template <typename... C>
+struct ColumnManager<Uses<C...>> {
+  static bool appendColumns(std::set<std::string>& declared, std::set<std::string>&, Uses<C...> const&)
+  {
+    (declared.insert(C::columnLabel()), ...);
+    return true;
+  }
+};
+
+template <>
+struct ColumnManager<expressions::Filter> {
+  static bool appendColumns(std::set<std::string>&, std::set<std::string>& filtered, expressions::Filter const& filter)
+  {
+    expressions::collectColumnNames(filter, filtered);
+    return true;
+  }
+};
+
+template <typename T>
+struct ColumnManager<Partition<T>> {
+  static bool appendColumns(std::set<std::string>&, std::set<std::string>& filtered, Partition<T> const& partition)
+  {
+    expressions::collectColumnNames(partition.filter, filtered);
+    return true;
+  }
+};
+
+/// The tables used to spawn extended tables or to build indices are read completely
+static inline void requestCompleteInput(std::vector<InputSpec>& inputs, InputSpec const& base_spec)
+{
+  auto spec = std::find_if(inputs.begin(), inputs.end(), [&](InputSpec const& spec) { return base_spec.binding == spec.binding; });
+  if (spec == inputs.end()) {
+    inputs.emplace_back(base_spec);
+    return;
+  }
+  auto& metadata = spec->metadata;
+  metadata.erase(std::remove_if(metadata.begin(), metadata.end(), [](ConfigParamSpec const& meta) { return meta.name == "aod-columns"; }), metadata.end());
+}
+
 /// Manager template to facilitate extended tables spawning
 template <typename T>
 struct SpawnManager {
@@ -397,9 +446,7 @@ struct SpawnManager<Spawns<TABLE>> {
   {
     auto base_specs = spawns.base_specs();
     for (auto& base_spec : base_specs) {
-      if (std::find_if(inputs.begin(), inputs.end(), [&](InputSpec const& spec) { return base_spec.binding == spec.binding; }) == inputs.end()) {
-        inputs.emplace_back(base_spec);
-      }
+      requestCompleteInput(inputs, base_spec);
     }
     return true;
   }
@@ -417,9 +464,7 @@ struct IndexManager<Builds<IDX, P>> {
   {
     auto base_specs = builds.base_specs();
     for (auto& base_spec : base_specs) {
-      if (std::find_if(inputs.begin(), inputs.end(), [&](InputSpec const& spec) { return base_spec.binding == spec.binding; }) == inputs.end()) {
-        inputs.emplace_back(base_spec);
-      }
+      requestCompleteInput(inputs, base_spec);
     }
     return true;
   }
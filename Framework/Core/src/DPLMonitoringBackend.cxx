@@ -10,10 +10,13 @@
 // or submit itself to any jurisdiction.
 
 #include "DPLMonitoringBackend.h"
+#include "Framework/DeviceMetricsChannel.h"
 #include "Framework/DriverClient.h"
 #include "Framework/ServiceRegistry.h"
 #include <fmt/format.h>
+#include <cstdlib>
 #include <sstream>
+#include <type_traits>
 
 namespace o2::framework
 {
@@ -35,8 +38,14 @@ inline unsigned long DPLMonitoringBackend::convertTimestamp(const std::chrono::t
 DPLMonitoringBackend::DPLMonitoringBackend(ServiceRegistry& registry)
   : mRegistry{registry}
 {
+  // Set by the driver when it spawns us.
+  if (char const* channelName = getenv("DPL_METRICS_CHANNEL")) {
+    mChannel = DeviceMetricsChannel::attach(channelName);
+  }
 }
 
+DPLMonitoringBackend::~DPLMonitoringBackend() = default;
+
 void DPLMonitoringBackend::addGlobalTag(std::string_view name, std::string_view value)
 {
   // FIXME: tags are ignored by DPL in any case...
@@ -52,6 +61,32 @@ void DPLMonitoringBackend::send(std::vector<o2::monitoring::Metric>&& metrics)
 
 void DPLMonitoringBackend::send(o2::monitoring::Metric const& metric)
 {
+  // Single numeric values are sent in binary form. When the ring is full they
+  // are dropped (and counted in DeviceMetricsChannel::failed()) rather than
+  // sent as text, which could overtake the values still queued. Values which
+  // did not get a label have nothing queued, so they go through the text
+  // protocol, as well as strings.
+  if (mChannel && metric.getValuesSize() == 1) {
+    using SendResult = DeviceMetricsChannel::SendResult;
+    auto timestamp = convertTimestamp(metric.getTimestamp());
+    SendResult sent = std::visit(overloaded{
+                                   [](const std::string&) -> SendResult { return SendResult::NoLabel; },
+                                   [&](auto value) -> SendResult {
+                                     using T = decltype(value);
+                                     if constexpr (std::is_floating_point_v<T>) {
+                                       return mChannel->send(metric.getName(), static_cast<float>(value), timestamp);
+                                     } else if constexpr (std::is_same_v<T, int>) {
+                                       return mChannel->send(metric.getName(), value, timestamp);
+                                     } else {
+                                       return mChannel->send(metric.getName(), static_cast<uint64_t>(value), timestamp);
+                                     }
+                                   }},
+                                 metric.getValues().begin()->second);
+    if (sent != SendResult::NoLabel) {
+      return;
+    }
+  }
+
   std::ostringstream mStream;
   mStream << "[METRIC] " << metric.getName();
   for (auto& value : metric.getValues()) {
@@ -12,14 +12,17 @@
 #define O2_FRAMEWORK_DPLMONITORINGBACKEND_H_
 
 #include "Monitoring/Backend.h"
+#include <memory>
 #include <string>
 
 namespace o2::framework
 {
 
 struct ServiceRegistry;
+class DeviceMetricsChannel;
 
-/// \brief Prints metrics to standard output via std::cout
+/// \brief Sends metrics to the driver, numeric ones via the binary
+/// DeviceMetricsChannel when the driver provided one, the others as text
 class DPLMonitoringBackend final : public o2::monitoring::Backend
 {
  public:
@@ -27,7 +30,7 @@ class DPLMonitoringBackend final : public o2::monitoring::Backend
   DPLMonitoringBackend(ServiceRegistry& registry);
 
   /// Default destructor
-  ~DPLMonitoringBackend() override = default;
+  ~DPLMonitoringBackend() override;
 
   /// Prints metric
   /// \param metric           reference to metric object
@@ -51,6 +54,7 @@ class DPLMonitoringBackend final : public o2::monitoring::Backend
   std::string mTagString;    ///< Global tagset (common for each metric)
   const std::string mPrefix; ///< Metric prefix
   ServiceRegistry& mRegistry;
+  std::unique_ptr<DeviceMetricsChannel> mChannel; ///< Binary channel to the driver, if any
 };
 
 } // namespace o2::framework
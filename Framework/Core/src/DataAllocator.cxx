@@ -256,6 +256,29 @@ void DataAllocator::snapshot(const Output& spec, const char* payload, size_t pay
   addPartToContext(std::move(payloadMessage), spec, serializationMethod);
 }
 
+void DataAllocator::forward(const Output& spec, const DataRef& input)
+{
+  const auto* inputHeader = o2::header::get<DataHeader*>(input.header);
+  if (inputHeader == nullptr) {
+    throw runtime_error("Cannot forward an input without DataHeader");
+  }
+  std::string const& channel = matchDataHeader(spec, mTimingInfo->timeslice);
+  auto& context = mRegistry->get<MessageContext>();
+  auto* transport = context.proxy().getTransport(channel);
+  FairMQMessage* inputMessage = context.findInputPayload(input.payload);
+
+  FairMQMessagePtr payloadMessage;
+  if (inputMessage != nullptr && inputMessage->GetType() == transport->GetType() && inputMessage->GetSize() == inputHeader->payloadSize) {
+    // the new message refers to the same buffer, which is released when the last of the messages is
+    payloadMessage = transport->CreateMessage();
+    payloadMessage->Copy(*inputMessage);
+  } else {
+    payloadMessage = context.proxy().createMessage(inputHeader->payloadSize);
+    memcpy(payloadMessage->GetData(), input.payload, inputHeader->payloadSize);
+  }
+  addPartToContext(std::move(payloadMessage), spec, inputHeader->payloadSerializationMethod);
+}
+
 Output DataAllocator::getOutputByBind(OutputRef&& ref)
 {
   if (ref.label.empty()) {
@@ -11,6 +11,7 @@
 #include "Framework/DataInputDirector.h"
 #include "Framework/DataDescriptorQueryBuilder.h"
 #include "Framework/Logger.h"
+#include "Framework/TableTreeHelpers.h"
 #include "AnalysisDataModelHelpers.h"
 
 #include "rapidjson/document.h"
@@ -19,6 +20,10 @@
 
 #include "TGrid.h"
 #include "TObjString.h"
+#include "TROOT.h"
+#include "TTree.h"
+
+#include <algorithm>
 
 namespace o2
 {
@@ -26,6 +31,52 @@ namespace framework
 {
 using namespace rapidjson;
 
+namespace
+{
+// read the requested columns of the tree into a table, all of them if none is
+// requested or if one of them is missing in the tree
+void readTree(TTree* tree, std::vector<std::string> const& columns, TableReadout& readout)
+{
+  TreeToTable t2t;
+  bool allColumns = columns.empty();
+  for (auto& column : columns) {
+    if (!tree->GetBranch(column.c_str())) {
+      LOGP(WARNING, "Column {} not found in tree {}, reading all columns", column, tree->GetName());
+      allColumns = true;
+      break;
+    }
+  }
+  if (allColumns) {
+    readout.compressedBytes = tree->GetZipBytes();
+    readout.uncompressedBytes = tree->GetTotBytes();
+    t2t.addAllColumns(tree);
+  } else {
+    for (auto& column : columns) {
+      auto branch = tree->GetBranch(column.c_str());
+      readout.compressedBytes += branch->GetZipBytes("*");
+      readout.uncompressedBytes += branch->GetTotBytes("*");
+      t2t.addColumn(column.c_str());
+    }
+    // the other columns are not used, but the consumers bind all the
+    // columns of the table
+    auto branches = tree->GetListOfBranches();
+    for (int ib = 0; ib < branches->GetEntries(); ib++) {
+      std::string name = branches->At(ib)->GetName();
+      if (std::find(columns.begin(), columns.end(), name) == columns.end()) {
+        t2t.addNullColumn(name.c_str());
+      }
+    }
+  }
+  t2t.fill(tree);
+  readout.table = t2t.finalize();
+}
+
+bool sameTable(header::DataHeader const& a, header::DataHeader const& b)
+{
+  return a.dataOrigin == b.dataOrigin && a.dataDescription == b.dataDescription && a.subSpecification == b.subSpecification;
+}
+} // namespace
+
 FileNameHolder* makeFileNameHolder(std::string fileName)
 {
   auto fileNameHolder = new FileNameHolder();
@@ -554,11 +605,8 @@ uint64_t DataInputDirector::getTimeFrameNumber(header::DataHeader dh, int counte
   return didesc->getTimeFrameNumber(counter, numTF);
 }
 
-TTree* DataInputDirector::getDataTree(header::DataHeader dh, int counter, int numTF)
+DataInputDescriptor* DataInputDirector::getDataInputDescriptorOrDefault(header::DataHeader dh, std::string& treename)
 {
-  std::string treename;
-  TTree* tree = nullptr;
-
   auto didesc = getDataInputDescriptor(dh);
   if (didesc) {
     // if match then use filename and treename from DataInputDescriptor
@@ -570,6 +618,15 @@ TTree* DataInputDirector::getDataTree(header::DataHeader dh, int counter, int nu
     didesc = mdefaultDataInputDescriptor;
     treename = aod::datamodel::getTreeName(dh);
   }
+  return didesc;
+}
+
+TTree* DataInputDirector::getDataTree(header::DataHeader dh, int counter, int numTF)
+{
+  std::string treename;
+  TTree* tree = nullptr;
+
+  auto didesc = getDataInputDescriptorOrDefault(dh, treename);
 
   auto fileAndFolder = didesc->getFileFolder(counter, numTF);
   if (fileAndFolder.file) {
@@ -583,8 +640,106 @@ TTree* DataInputDirector::getDataTree(header::DataHeader dh, int counter, int nu
   return tree;
 }
 
+TableReadout DataInputDirector::readTable(TableRequest const& request, int counter, int numTF)
+{
+  if (mPrefetched.valid() || !mPrefetchedTables.empty()) {
+    if (counter == mPrefetchCounter && numTF == mPrefetchTF) {
+      waitForPrefetch();
+      for (size_t i = 0; i < mPrefetchedTables.size(); i++) {
+        auto& prefetched = mPrefetchedTables[i];
+        if (prefetched.table && sameTable(prefetched.dh, request.dh) && mPrefetchRequests[i].columns == request.columns) {
+          return std::move(prefetched);
+        }
+      }
+    } else {
+      // another time frame is requested, the prefetched one is not needed anymore
+      waitForPrefetch();
+      mPrefetchedTables.clear();
+    }
+  }
+
+  TableReadout readout;
+  readout.dh = request.dh;
+  std::unique_ptr<TTree> tree(getDataTree(request.dh, counter, numTF));
+  if (tree) {
+    readTree(tree.get(), request.columns, readout);
+  }
+  return readout;
+}
+
+void DataInputDirector::prefetch(std::vector<TableRequest> const& requests, int counter, int numTF)
+{
+  waitForPrefetch();
+  mPrefetchedTables.clear();
+
+  // the files and trees are located here, the DataInputDescriptors are not thread-safe
+  std::vector<std::pair<std::string, std::string>> trees;
+  for (auto& request : requests) {
+    std::string treename;
+    auto didesc = getDataInputDescriptorOrDefault(request.dh, treename);
+    auto fileAndFolder = didesc->getFileFolder(counter, numTF);
+    if (!fileAndFolder.file) {
+      return; // the time frame does not exist
+    }
+    trees.emplace_back(didesc->getFileName(counter), fileAndFolder.folderName + "/" + treename);
+  }
+
+  mPrefetchCounter = counter;
+  mPrefetchTF = numTF;
+  mPrefetchRequests = requests;
+  mPrefetched = std::async(std::launch::async, [this, requests, trees]() {
+    // the input files are opened a second time, so that the reading does not interfere with the main thread
+    for (auto it = mPrefetchFiles.begin(); it != mPrefetchFiles.end();) {
+      bool used = std::any_of(trees.begin(), trees.end(), [&it](auto const& tree) { return tree.first == it->first; });
+      it = used ? std::next(it) : mPrefetchFiles.erase(it);
+    }
+    std::vector<TableReadout> readouts(requests.size());
+    for (size_t i = 0; i < requests.size(); i++) {
+      auto& [filename, treename] = trees[i];
+      auto& file = mPrefetchFiles[filename];
+      if (!file) {
+        file.reset(TFile::Open(filename.c_str()));
+        if (!file) {
+          throw std::runtime_error(fmt::format("Couldn't open file \"{}\"!", filename));
+        }
+      }
+      std::unique_ptr<TTree> tree((TTree*)file->Get(treename.c_str()));
+      if (!tree) {
+        throw std::runtime_error(fmt::format(R"(Couldn't get TTree "{}" from "{}")", treename, filename));
+      }
+      readouts[i].dh = requests[i].dh;
+      readTree(tree.get(), requests[i].columns, readouts[i]);
+    }
+    return readouts;
+  });
+}
+
+void DataInputDirector::waitForPrefetch()
+{
+  if (!mPrefetched.valid()) {
+    return;
+  }
+  try {
+    mPrefetchedTables = mPrefetched.get();
+  } catch (std::exception const& e) {
+    LOGP(WARNING, "Prefetching of time frame {} of file {} failed, it will be read again: {}", mPrefetchTF, mPrefetchCounter, e.what());
+    mPrefetchedTables.clear();
+  }
+}
+
+void DataInputDirector::setPrefetching(bool prefetching)
+{
+  if (prefetching && !mPrefetching) {
+    ROOT::EnableThreadSafety();
+  }
+  mPrefetching = prefetching;
+}
+
 void DataInputDirector::closeInputFiles()
 {
+  waitForPrefetch();
+  mPrefetchedTables.clear();
+  mPrefetchFiles.clear();
   mdefaultDataInputDescriptor->closeInputFile();
   for (auto didesc : mdataInputDescriptors) {
     didesc->closeInputFile();
@@ -32,6 +32,7 @@
 #include "Framework/TMessageSerializer.h"
 #include "Framework/InputRecord.h"
 #include "Framework/InputSpan.h"
+#include "Framework/MessageContext.h"
 #include "Framework/Signpost.h"
 #include "Framework/SourceInfoHeader.h"
 #include "Framework/Logger.h"
@@ -955,6 +956,11 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
   // move these to some thread local store and the rest of the lambdas
   // should work just fine.
   std::vector<MessageSet> currentSetOfInputs;
+  // The input messages are registered for forwarding while being processed. Make sure they are
+  // unregistered when leaving, also when an exception is let through.
+  auto unregisterInputs = detail::make_scope_guard([&messageContext = context.registry->get<MessageContext>()]() noexcept {
+    messageContext.setInputMessages(nullptr);
+  });
 
   auto reportError = [&registry = *context.registry, &context](const char* message) {
     registry.get<DataProcessingStats>().errorCount++;
@@ -984,8 +990,11 @@ bool DataProcessingDevice::tryDispatchComputation(DataProcessorContext& context,
 
   //
   auto getInputSpan = [&relayer = context.relayer,
+                       &messageContext = context.registry->get<MessageContext>(),
                        &currentSetOfInputs](TimesliceSlot slot) {
     currentSetOfInputs = std::move(relayer->getInputsForTimeslice(slot));
+    // the payloads can be forwarded to the outputs by reference, see DataAllocator::forward
+    messageContext.setInputMessages(&currentSetOfInputs);
     auto getter = [&currentSetOfInputs](size_t i, size_t partindex) -> DataRef {
       if (currentSetOfInputs[i].size() > partindex) {
         return DataRef{nullptr,
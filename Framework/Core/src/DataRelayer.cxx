@@ -33,6 +33,7 @@
 
 #include <fmt/format.h>
 #include <gsl/span>
+#include <algorithm>
 #include <numeric>
 #include <string>
 
@@ -104,6 +105,16 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
   if (slotsCreatedByHandlers.empty() == false) {
     activity.newSlots++;
   }
+  // The creators flag the slots they associate as dirty in the index,
+  // hand them over to the completion queue.
+  for (size_t ti = 0; ti < mTimesliceIndex.size(); ++ti) {
+    TimesliceSlot slot{ti};
+    if (mTimesliceIndex.isDirty(slot)) {
+      mTimesliceIndex.markAsDirty(slot, false);
+      std::scoped_lock<std::mutex> slotLock(mSlotMutexes[ti]);
+      markAsDirty(slot);
+    }
+  }
   // Outer loop, we process all the records because the fact that the record
   // expires is independent from having received data for it.
   for (size_t ti = 0; ti < mTimesliceIndex.size(); ++ti) {
@@ -112,6 +123,7 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
       continue;
     }
     assert(mDistinctRoutesIndex.empty() == false);
+    std::scoped_lock<std::mutex> slotLock(mSlotMutexes[ti]);
     auto timestamp = mTimesliceIndex.getTimesliceForSlot(slot);
     auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
     // We iterate on all the hanlders checking if they need to be expired.
@@ -146,7 +158,7 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
       expirator.handler(services, part[0], timestamp.value, variables);
       activity.expiredSlots++;
 
-      mTimesliceIndex.markAsDirty(slot, true);
+      markAsDirty(slot);
       assert(part[0].header != nullptr);
       assert(part[0].payload != nullptr);
     }
@@ -207,11 +219,10 @@ DataRelayer::RelayChoice
                      std::unique_ptr<FairMQMessage>* restOfParts,
                      size_t restOfPartsSize)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::unique_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
   // STATE HOLDING VARIABLES
-  // This is the class level state of the relaying. If we start supporting
-  // multithreading this will have to be made thread safe before we can invoke
-  // relay concurrently.
+  // This is the class level state of the relaying. The index is protected by
+  // mMutex, each cacheline by the lock of its slot.
   auto& index = mTimesliceIndex;
 
   auto& cache = mCache;
@@ -294,6 +305,23 @@ DataRelayer::RelayChoice
     }
   };
 
+  // Only the cacheline is needed to store the parts, so the index is released
+  // as soon as we hold the lock of the slot. Other messages can then be matched
+  // while the parts are moved in and the obsolete ones are deleted.
+  auto storeInSlot = [&lock, &pruneCache, &saveInSlot,
+                      &slotMutexes = mSlotMutexes,
+                      this](TimesliceId timeslice, int input, TimesliceSlot slot, bool needsCleaning) {
+    std::unique_lock<std::mutex> slotLock(slotMutexes[slot.index]);
+    lock.unlock();
+    if (needsCleaning) {
+      pruneCache(slot);
+    }
+    saveInSlot(timeslice, input, slot);
+    // Still under the lock of the slot, so that a stream cannot see the
+    // stored parts, consume the slot and then be handed it a second time.
+    markAsDirty(slot);
+  };
+
   auto updateStatistics = [& stats = mStats](TimesliceIndex::ActionTaken action) {
     // Update statistics for what happened
     switch (action) {
@@ -357,13 +385,9 @@ DataRelayer::RelayChoice
   /// If we get a valid result, we can store the message in cache.
   if (input != INVALID_INPUT && TimesliceId::isValid(timeslice) && TimesliceSlot::isValid(slot)) {
     O2_SIGNPOST(O2_PROBE_DATARELAYER, timeslice.value, 0, 0, 0);
-    if (needsCleaning) {
-      pruneCache(slot);
-    }
-    saveInSlot(timeslice, input, slot);
     index.publishSlot(slot);
-    index.markAsDirty(slot, true);
     mStats.relayedMessages++;
+    storeInSlot(timeslice, input, slot, needsCleaning);
     return WillRelay;
   }
 
@@ -439,10 +463,8 @@ DataRelayer::RelayChoice
     case TimesliceIndex::ActionTaken::ReplaceObsolete:
       // At this point the variables match the new input but the
       // cache still holds the old data, so we prune it.
-      pruneCache(slot);
-      saveInSlot(timeslice, input, slot);
       index.publishSlot(slot);
-      index.markAsDirty(slot, true);
+      storeInSlot(timeslice, input, slot, true);
       return WillRelay;
   }
   O2_BUILTIN_UNREACHABLE();
@@ -450,8 +472,6 @@ DataRelayer::RelayChoice
 
 void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& completed)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
-
   // THE STATE
   const auto& cache = mCache;
   const auto numInputTypes = mDistinctRoutesIndex.size();
@@ -489,16 +509,27 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   if (numInputTypes == 0) {
     return;
   }
-  size_t cacheLines = cache.size() / numInputTypes;
-  assert(cacheLines * numInputTypes == cache.size());
+  assert((cache.size() / numInputTypes) * numInputTypes == cache.size());
+
+  // We only check the cachelines which have been updated by an incoming
+  // message. They are taken from the completion queue and looked at in slot
+  // order, like a scan of the whole cache would do.
+  std::vector<size_t> dirtySlots;
+  size_t queued;
+  while (mCompletionQueue.pop(queued)) {
+    dirtySlots.push_back(queued);
+  }
+  std::sort(dirtySlots.begin(), dirtySlots.end());
 
-  for (size_t li = 0; li < cacheLines; ++li) {
+  for (auto li : dirtySlots) {
     TimesliceSlot slot{li};
-    // We only check the cachelines which have been updated by an incoming
-    // message.
-    if (mTimesliceIndex.isDirty(slot) == false) {
-      continue;
-    }
+    // Given we are creating an action for this cacheline, we need to wait for
+    // a new message before we look again into it. The slot is marked as dirty
+    // while holding its lock, so the flag is only cleared once the parts
+    // stored so far are visible, and a message relayed from now on queues
+    // the slot again.
+    std::scoped_lock<std::mutex> slotLock(mSlotMutexes[li]);
+    mDirtySlots[li] = false;
     auto partial = getPartialRecord(li);
     auto getter = [&partial](size_t idx, size_t part) {
       if (partial[idx].size() > 0 && partial[idx].at(part).header && partial[idx].at(part).payload) {
@@ -522,24 +553,18 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
       case CompletionPolicy::CompletionOp::Wait:
         break;
     }
-    // Given we have created an action for this cacheline, we need to wait for
-    // a new message before we look again into the given cacheline.
-    mTimesliceIndex.markAsDirty(slot, false);
   }
 }
 
 void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStatus, CacheEntryStatus newStatus)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  // The entries are atomic, no lock needed.
   const auto numInputTypes = mDistinctRoutesIndex.size();
-  auto& index = mTimesliceIndex;
 
   auto markInputDone = [&cachedStateMetrics = mCachedStateMetrics,
-                        &index, &numInputTypes](TimesliceSlot s, size_t arg, CacheEntryStatus oldStatus, CacheEntryStatus newStatus) {
+                        &numInputTypes](TimesliceSlot s, size_t arg, CacheEntryStatus oldStatus, CacheEntryStatus newStatus) {
     auto cacheId = s.index * numInputTypes + arg;
-    if (cachedStateMetrics[cacheId] == oldStatus) {
-      cachedStateMetrics[cacheId] = newStatus;
-    }
+    cachedStateMetrics[cacheId].compare_exchange_strong(oldStatus, newStatus);
   };
 
   for (size_t ai = 0, ae = numInputTypes; ai != ae; ++ai) {
@@ -549,14 +574,13 @@ void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStat
 
 std::vector<o2::framework::MessageSet> DataRelayer::getInputsForTimeslice(TimesliceSlot slot)
 {
-  std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
+  std::unique_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
 
   const auto numInputTypes = mDistinctRoutesIndex.size();
   // State of the computation
   std::vector<MessageSet> messages(numInputTypes);
   auto& cache = mCache;
   auto& index = mTimesliceIndex;
-  auto& metrics = mMetrics;
 
   // Nothing to see here, this is just to make the outer loop more understandable.
   auto jumpToCacheEntryAssociatedWith = [](TimesliceSlot) {
@@ -569,7 +593,7 @@ std::vector<o2::framework::MessageSet> DataRelayer::getInputsForTimeslice(Timesl
   // cache where to put them.
   auto moveHeaderPayloadToOutput = [&messages,
                                     &cachedStateMetrics = mCachedStateMetrics,
-                                    &cache, &index, &numInputTypes, &metrics](TimesliceSlot s, size_t arg) {
+                                    &cache, &numInputTypes](TimesliceSlot s, size_t arg) {
     auto cacheId = s.index * numInputTypes + arg;
     cachedStateMetrics[cacheId] = CacheEntryStatus::RUNNING;
     // TODO: in the original implementation of the cache, there have been only two messages per entry,
@@ -577,21 +601,26 @@ std::vector<o2::framework::MessageSet> DataRelayer::getInputsForTimeslice(Timesl
     if (cache[cacheId].size() > 0) {
       messages[arg] = std::move(cache[cacheId]);
     }
-    index.markAsInvalid(s);
   };
 
   // An invalid set of arguments is a set of arguments associated to an invalid
   // timeslice, so I can simply do that. I keep the assertion there because in principle
   // we should have dispatched the timeslice already!
   // FIXME: what happens when we have enough timeslices to hit the invalid one?
-  auto invalidateCacheFor = [&numInputTypes, &cachedStateMetrics = mCachedStateMetrics, &index, &cache](TimesliceSlot s) {
+  auto invalidateCacheFor = [&numInputTypes, &cache](TimesliceSlot s) {
     for (size_t ai = s.index * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
       assert(std::accumulate(cache[ai].begin(), cache[ai].end(), true, [](bool result, auto const& element) { return result && element.header.get() == nullptr && element.payload.get() == nullptr; }));
       cache[ai].clear();
     }
-    index.markAsInvalid(s);
   };
 
+  // The slot is invalidated in the index right away, so that no other message
+  // gets matched to it, and only the cacheline stays locked while the parts
+  // are moved out.
+  index.markAsInvalid(slot);
+  std::unique_lock<std::mutex> slotLock(mSlotMutexes[slot.index]);
+  lock.unlock();
+
   // Outer loop here.
   jumpToCacheEntryAssociatedWith(slot);
   for (size_t ai = 0, ae = numInputTypes; ai != ae; ++ai) {
@@ -606,10 +635,12 @@ void DataRelayer::clear()
 {
   std::scoped_lock<LockableBase(std::recursive_mutex)> lock(mMutex);
 
-  for (auto& cache : mCache) {
-    cache.clear();
-  }
+  const auto numInputTypes = mDistinctRoutesIndex.size();
   for (size_t s = 0; s < mTimesliceIndex.size(); ++s) {
+    std::scoped_lock<std::mutex> slotLock(mSlotMutexes[s]);
+    for (size_t ai = s * numInputTypes, ae = ai + numInputTypes; ai != ae; ++ai) {
+      mCache[ai].clear();
+    }
     mTimesliceIndex.markAsInvalid(TimesliceSlot{s});
   }
 }
@@ -642,7 +673,22 @@ void DataRelayer::publishMetrics()
   mMetrics.send({(int)numInputTypes, "data_relayer/h"});
   mMetrics.send({(int)mTimesliceIndex.size(), "data_relayer/w"});
   sMetricsNames.resize(mCache.size());
-  mCachedStateMetrics.resize(mCache.size());
+  if (mCachedStateMetrics.size() != mCache.size()) {
+    std::vector<std::atomic<CacheEntryStatus>> states(mCache.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+      states[i] = i < mCachedStateMetrics.size() ? mCachedStateMetrics[i].load() : CacheEntryStatus::EMPTY;
+    }
+    mCachedStateMetrics.swap(states);
+  }
+  if (mSlotMutexes.size() != mTimesliceIndex.size()) {
+    std::vector<std::mutex>(mTimesliceIndex.size()).swap(mSlotMutexes);
+    std::vector<std::atomic<bool>> dirtySlots(mTimesliceIndex.size());
+    for (auto& dirty : dirtySlots) {
+      dirty = false;
+    }
+    mDirtySlots.swap(dirtySlots);
+    mCompletionQueue.reset(mTimesliceIndex.size());
+  }
   for (size_t i = 0; i < sMetricsNames.size(); ++i) {
     sMetricsNames[i] = std::string("data_relayer/") + std::to_string(i);
   }
@@ -693,15 +739,25 @@ void DataRelayer::sendContextState()
                                mMetrics, sVariablesMetricsNames);
   }
   for (size_t si = 0; si < mCachedStateMetrics.size(); ++si) {
-    mMetrics.send({static_cast<int>(mCachedStateMetrics[si]), sMetricsNames[si]});
+    auto state = mCachedStateMetrics[si].load();
+    mMetrics.send({static_cast<int>(state), sMetricsNames[si]});
     // Anything which is done is actually already empty,
     // so after we report it we mark it as such.
-    if (mCachedStateMetrics[si] == CacheEntryStatus::DONE) {
-      mCachedStateMetrics[si] = CacheEntryStatus::EMPTY;
+    if (state == CacheEntryStatus::DONE) {
+      mCachedStateMetrics[si].compare_exchange_strong(state, CacheEntryStatus::EMPTY);
     }
   }
 }
 
+void DataRelayer::markAsDirty(TimesliceSlot slot)
+{
+  if (mDirtySlots[slot.index].exchange(true) == false) {
+    // A slot is only queued when its flag is raised, so the queue cannot be full.
+    [[maybe_unused]] bool queued = mCompletionQueue.push(slot.index);
+    assert(queued);
+  }
+}
+
 std::vector<std::string> DataRelayer::sMetricsNames;
 std::vector<std::string> DataRelayer::sVariablesMetricsNames;
 std::vector<std::string> DataRelayer::sQueriesMetricsNames;
@@ -0,0 +1,161 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/DeviceMetricsChannel.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace o2::framework
+{
+
+DeviceMetricsChannel::DeviceMetricsChannel(Segment* segment, std::string name, bool owner)
+  : mSegment{segment},
+    mName{std::move(name)},
+    mOwner{owner}
+{
+}
+
+DeviceMetricsChannel::~DeviceMetricsChannel()
+{
+  munmap(mSegment, sizeof(Segment));
+  if (mOwner) {
+    // The device might never have attached to it.
+    shm_unlink(mName.c_str());
+  }
+}
+
+std::unique_ptr<DeviceMetricsChannel> DeviceMetricsChannel::create(std::string const& name)
+{
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  if (ftruncate(fd, sizeof(Segment)) != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  void* addr = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd); // the mapping stays valid
+  if (addr == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    return nullptr;
+  }
+  // The segment is zero filled, only the sequence numbers of the records
+  // need to be set up.
+  auto* segment = new (addr) Segment;
+  segment->writePos.store(0, std::memory_order_relaxed);
+  segment->labelsCount.store(0, std::memory_order_relaxed);
+  segment->failed.store(0, std::memory_order_relaxed);
+  for (size_t i = 0; i < Capacity; ++i) {
+    segment->records[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  segment->magic = Magic;
+  return std::unique_ptr<DeviceMetricsChannel>(new DeviceMetricsChannel(segment, name, true));
+}
+
+std::unique_ptr<DeviceMetricsChannel> DeviceMetricsChannel::attach(std::string const& name)
+{
+  int fd = shm_open(name.c_str(), O_RDWR, 0600);
+  if (fd < 0) {
+    return nullptr;
+  }
+  shm_unlink(name.c_str());
+  void* addr = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    return nullptr;
+  }
+  auto* segment = reinterpret_cast<Segment*>(addr);
+  if (segment->magic != Magic) {
+    munmap(addr, sizeof(Segment));
+    return nullptr;
+  }
+  return std::unique_ptr<DeviceMetricsChannel>(new DeviceMetricsChannel(segment, name, false));
+}
+
+template <typename T>
+DeviceMetricsChannel::SendResult DeviceMetricsChannel::sendValue(std::string const& name, T value, size_t timestamp)
+{
+  uint32_t labelIndex;
+  {
+    std::scoped_lock<std::mutex> lock(mLabelsMutex);
+    auto li = mLabelIndices.find(name);
+    if (li != mLabelIndices.end()) {
+      labelIndex = li->second;
+    } else {
+      labelIndex = mSegment->labelsCount.load(std::memory_order_relaxed);
+      if (labelIndex == MaxLabels) {
+        return SendResult::NoLabel;
+      }
+      auto& label = mSegment->labels[labelIndex];
+      auto size = std::min(name.size(), MetricLabel::MAX_METRIC_LABEL_SIZE - 1);
+      memcpy(label.label, name.data(), size);
+      label.label[size] = '\0';
+      label.size = size;
+      mSegment->labelsCount.store(labelIndex + 1, std::memory_order_release);
+      mLabelIndices.emplace(name, labelIndex);
+    }
+  }
+
+  uint64_t pos = mSegment->writePos.load(std::memory_order_relaxed);
+  while (true) {
+    auto& record = mSegment->records[pos & (Capacity - 1)];
+    auto diff = static_cast<int64_t>(record.sequence.load(std::memory_order_acquire)) - static_cast<int64_t>(pos);
+    if (diff == 0) {
+      if (mSegment->writePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+        record.timestamp = timestamp;
+        record.labelIndex = labelIndex;
+        if constexpr (std::is_same_v<T, int>) {
+          record.type = MetricType::Int;
+          record.intValue = value;
+        } else if constexpr (std::is_same_v<T, float>) {
+          record.type = MetricType::Float;
+          record.floatValue = value;
+        } else {
+          record.type = MetricType::Uint64;
+          record.uint64Value = value;
+        }
+        record.sequence.store(pos + 1, std::memory_order_release);
+        return SendResult::Sent;
+      }
+    } else if (diff < 0) {
+      // The driver did not catch up yet.
+      mSegment->failed.fetch_add(1, std::memory_order_relaxed);
+      return SendResult::RingFull;
+    } else {
+      pos = mSegment->writePos.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+DeviceMetricsChannel::SendResult DeviceMetricsChannel::send(std::string const& name, int value, size_t timestamp)
+{
+  return sendValue(name, value, timestamp);
+}
+
+DeviceMetricsChannel::SendResult DeviceMetricsChannel::send(std::string const& name, float value, size_t timestamp)
+{
+  return sendValue(name, value, timestamp);
+}
+
+DeviceMetricsChannel::SendResult DeviceMetricsChannel::send(std::string const& name, uint64_t value, size_t timestamp)
+{
+  return sendValue(name, value, timestamp);
+}
+
+} // namespace o2::framework
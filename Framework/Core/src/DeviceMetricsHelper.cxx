@@ -10,6 +10,7 @@
 // or submit itself to any jurisdiction.
 
 #include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsChannel.h"
 #include "Framework/RuntimeError.h"
 #include <cassert>
 #include <cinttypes>
@@ -172,24 +173,57 @@ bool DeviceMetricsHelper::processMetric(ParsedMetricMatch& match,
                                         DeviceMetricsInfo& info,
                                         DeviceMetricsHelper::NewMetricCallback newMetricsCallback)
 {
-  // get the type
-  size_t metricIndex = -1;
+  size_t metricIndex = findOrCreateMetric(match, info, newMetricsCallback);
+  if (metricIndex == (size_t)-1) {
+    return false;
+  }
+  return storeMetric(match, metricIndex, info);
+}
 
-  StringMetric stringValue;
-  switch (match.type) {
-    case MetricType::Float:
-    case MetricType::Int:
-    case MetricType::Uint64:
-      break;
-    case MetricType::String: {
-      auto lastChar = std::min(match.endStringValue - match.beginStringValue, StringMetric::MAX_SIZE - 1);
-      memcpy(stringValue.data, match.beginStringValue, lastChar);
-      stringValue.data[lastChar] = '\0';
-    } break;
-    default:
-      return false;
-      break;
-  };
+size_t DeviceMetricsHelper::processMetrics(DeviceMetricsChannel& channel,
+                                           DeviceMetricsInfo& info,
+                                           DeviceMetricsHelper::NewMetricCallback newMetricsCallback)
+{
+  auto& metricIndices = info.channelMetricIndices;
+  return channel.consume([&info, &metricIndices, &newMetricsCallback](MetricLabel const& label, size_t labelIndex, DeviceMetricsChannel::Record const& record) {
+    ParsedMetricMatch match;
+    match.beginKey = label.label;
+    match.endKey = label.label + label.size;
+    match.timestamp = record.timestamp;
+    match.type = record.type;
+    match.intValue = 0;
+    switch (record.type) {
+      case MetricType::Int:
+        match.intValue = record.intValue;
+        break;
+      case MetricType::Float:
+        match.floatValue = record.floatValue;
+        break;
+      case MetricType::Uint64:
+        match.uint64Value = record.uint64Value;
+        break;
+      default:
+        return;
+    }
+    // The label is only looked up the first time we see it.
+    if (labelIndex >= metricIndices.size()) {
+      metricIndices.resize(labelIndex + 1, (size_t)-1);
+    }
+    if (metricIndices[labelIndex] == (size_t)-1) {
+      metricIndices[labelIndex] = findOrCreateMetric(match, info, newMetricsCallback);
+      if (metricIndices[labelIndex] == (size_t)-1) {
+        return;
+      }
+    }
+    storeMetric(match, metricIndices[labelIndex], info);
+  });
+}
+
+size_t DeviceMetricsHelper::findOrCreateMetric(ParsedMetricMatch const& match,
+                                               DeviceMetricsInfo& info,
+                                               DeviceMetricsHelper::NewMetricCallback newMetricsCallback)
+{
+  size_t metricIndex = -1;
 
   // Find the metric based on the label. Create it if not found.
   auto cmpFn = [namePtr = match.beginKey,
@@ -231,7 +265,7 @@ bool DeviceMetricsHelper::processMetric(ParsedMetricMatch& match,
         break;
 
       default:
-        return false;
+        return -1;
     };
     // Add the timestamp buffer for it
     info.timestamps.emplace_back(std::array<size_t, 1024>{});
@@ -266,7 +300,13 @@ bool DeviceMetricsHelper::processMetric(ParsedMetricMatch& match,
     metricIndex = mi->index;
   }
   assert(metricIndex != -1);
-  // We are now guaranteed our metric is present at metricIndex.
+  return metricIndex;
+}
+
+bool DeviceMetricsHelper::storeMetric(ParsedMetricMatch const& match,
+                                      size_t metricIndex,
+                                      DeviceMetricsInfo& info)
+{
   MetricInfo& metricInfo = info.metrics[metricIndex];
 
   //  auto mod = info.timestamps[metricIndex].size();
@@ -286,6 +326,10 @@ bool DeviceMetricsHelper::processMetric(ParsedMetricMatch& match,
       ++metricInfo.filledMetrics;
     } break;
     case MetricType::String: {
+      StringMetric stringValue;
+      auto lastChar = std::min(match.endStringValue - match.beginStringValue, StringMetric::MAX_SIZE - 1);
+      memcpy(stringValue.data, match.beginStringValue, lastChar);
+      stringValue.data[lastChar] = '\0';
       info.stringMetrics[metricInfo.storeIdx][metricInfo.pos] = stringValue;
       // Save the timestamp for the current metric we do it here
       // so that we do not update timestamps for broken metrics
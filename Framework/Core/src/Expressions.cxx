@@ -21,6 +21,10 @@
 #include <unordered_map>
 #include <set>
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
 
 using namespace o2::framework;
 
@@ -55,6 +59,58 @@ struct PlaceholderNodeHelper {
     return DatumSpec{node.value, node.type};
   }
 };
+
+/// Process-wide cache of the compiled gandiva filters and projectors, keyed by the
+/// textual representation of the expressions and of the schema they are compiled for.
+/// Compilation happens outside of the lock, if two threads race for the same key the
+/// first inserted object is kept.
+template <typename T>
+class GandivaCache
+{
+ public:
+  template <typename F>
+  std::shared_ptr<T> get(std::string const& key, F&& make)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto it = mCache.find(key);
+      if (it != mCache.end()) {
+        return it->second;
+      }
+    }
+    auto object = make();
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mCache.emplace(key, std::move(object)).first->second;
+  }
+
+ private:
+  std::mutex mMutex;
+  std::unordered_map<std::string, std::shared_ptr<T>> mCache;
+};
+
+GandivaCache<gandiva::Filter>& filterCache()
+{
+  static GandivaCache<gandiva::Filter> cache;
+  return cache;
+}
+
+GandivaCache<gandiva::Projector>& projectorCache()
+{
+  static GandivaCache<gandiva::Projector> cache;
+  return cache;
+}
+
+/// Minimal number of rows in the slice of a table evaluated by one thread
+constexpr int64_t MinRowsPerThread = 1 << 16;
+
+int& selectionThreads()
+{
+  static int nThreads = []() {
+    auto env = getenv("O2_GANDIVA_THREADS");
+    return env ? std::max(1, atoi(env)) : 1;
+  }();
+  return nThreads;
+}
 } // namespace
 
 std::shared_ptr<arrow::DataType> concreteArrowType(atype::type type)
@@ -304,6 +360,25 @@ Operations createOperations(Filter const& expression)
   return OperationSpecs;
 }
 
+void collectColumnNames(Filter const& expression, std::set<std::string>& names)
+{
+  std::stack<Node const*> path;
+  path.push(expression.node.get());
+  while (path.empty() == false) {
+    auto node = path.top();
+    path.pop();
+    if (auto binding = std::get_if<BindingNode>(&node->self)) {
+      names.insert(binding->name);
+    }
+    if (node->left != nullptr) {
+      path.push(node->left.get());
+    }
+    if (node->right != nullptr) {
+      path.push(node->right.get());
+    }
+  }
+}
+
 gandiva::ConditionPtr makeCondition(gandiva::NodePtr node)
 {
   return gandiva::TreeExprBuilder::MakeCondition(node);
@@ -317,40 +392,47 @@ gandiva::ExpressionPtr makeExpression(gandiva::NodePtr node, gandiva::FieldPtr r
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, Operations const& opSpecs)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 makeCondition(createExpressionTree(opSpecs, Schema)),
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
-  }
-  return filter;
+  return createFilter(Schema, makeCondition(createExpressionTree(opSpecs, Schema)));
 }
 
 std::shared_ptr<gandiva::Filter>
   createFilter(gandiva::SchemaPtr const& Schema, gandiva::ConditionPtr condition)
 {
-  std::shared_ptr<gandiva::Filter> filter;
-  auto s = gandiva::Filter::Make(Schema,
-                                 condition,
-                                 &filter);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+  return filterCache().get(Schema->ToString() + "\n" + condition->ToString(), [&]() {
+    std::shared_ptr<gandiva::Filter> filter;
+    auto s = gandiva::Filter::Make(Schema,
+                                   condition,
+                                   &filter);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create filter: %s", s.ToString().c_str());
+    }
+    return filter;
+  });
+}
+
+std::shared_ptr<gandiva::Projector>
+  createProjector(gandiva::SchemaPtr const& Schema, gandiva::ExpressionVector const& expressions)
+{
+  std::string key = Schema->ToString();
+  for (auto& expression : expressions) {
+    key += "\n" + expression->ToString();
   }
-  return filter;
+  return projectorCache().get(key, [&]() {
+    std::shared_ptr<gandiva::Projector> projector;
+    auto s = gandiva::Projector::Make(Schema,
+                                      expressions,
+                                      &projector);
+    if (!s.ok()) {
+      throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
+    }
+    return projector;
+  });
 }
 
 std::shared_ptr<gandiva::Projector>
   createProjector(gandiva::SchemaPtr const& Schema, Operations const& opSpecs, gandiva::FieldPtr result)
 {
-  std::shared_ptr<gandiva::Projector> projector;
-  auto s = gandiva::Projector::Make(Schema,
-                                    {makeExpression(createExpressionTree(opSpecs, Schema), result)},
-                                    &projector);
-  if (!s.ok()) {
-    throw runtime_error_f("Failed to create projector: %s", s.ToString().c_str());
-  }
-  return projector;
+  return createProjector(Schema, {makeExpression(createExpressionTree(opSpecs, Schema), result)});
 }
 
 std::shared_ptr<gandiva::Projector>
@@ -359,6 +441,16 @@ std::shared_ptr<gandiva::Projector>
   return createProjector(Schema, createOperations(std::move(p)), std::move(result));
 }
 
+void setSelectionThreads(int nThreads)
+{
+  selectionThreads() = std::max(1, nThreads);
+}
+
+int getSelectionThreads()
+{
+  return selectionThreads();
+}
+
 Selection createSelection(std::shared_ptr<arrow::Table> table, std::shared_ptr<gandiva::Filter> gfilter)
 {
   Selection selection;
@@ -371,7 +463,17 @@ Selection createSelection(std::shared_ptr<arrow::Table> table, std::shared_ptr<g
   if (table->num_rows() == 0) {
     return selection;
   }
+
+  // split the table in zero-copy batches of at most rowsPerBatch rows, so that
+  // even single-chunk tables can be evaluated by several threads
+  int nThreads = std::min<int64_t>(selectionThreads(), std::max<int64_t>(1, table->num_rows() / MinRowsPerThread));
   arrow::TableBatchReader reader(*table);
+  if (nThreads > 1) {
+    reader.set_chunksize((table->num_rows() + nThreads - 1) / nThreads);
+  }
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  std::vector<int64_t> offsets;
+  int64_t offset = 0;
   std::shared_ptr<arrow::RecordBatch> batch;
   while (true) {
     s = reader.ReadNext(&batch);
@@ -381,11 +483,51 @@ Selection createSelection(std::shared_ptr<arrow::Table> table, std::shared_ptr<g
     if (batch == nullptr) {
       break;
     }
-    s = gfilter->Evaluate(*batch, selection);
-    if (!s.ok()) {
-      throw runtime_error_f("Cannot apply filter %s", s.ToString().c_str());
+    offsets.push_back(offset);
+    offset += batch->num_rows();
+    batches.push_back(std::move(batch));
+  }
+
+  // the indices selected in every batch are relative to its first row
+  std::vector<Selection> batchSelections(batches.size());
+  std::vector<arrow::Status> statuses(batches.size());
+  auto evaluate = [&](size_t ib) {
+    statuses[ib] = gandiva::SelectionVector::MakeInt64(batches[ib]->num_rows(), arrow::default_memory_pool(), &batchSelections[ib]);
+    if (statuses[ib].ok()) {
+      statuses[ib] = gfilter->Evaluate(*batches[ib], batchSelections[ib]);
+    }
+  };
+  if (nThreads > 1 && batches.size() > 1) {
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    for (int i = 0; i < std::min<int>(nThreads, batches.size()); i++) {
+      workers.emplace_back([&]() {
+        size_t ib;
+        while ((ib = next++) < batches.size()) {
+          evaluate(ib);
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  } else {
+    for (size_t ib = 0; ib < batches.size(); ib++) {
+      evaluate(ib);
+    }
+  }
+
+  int64_t nSelected = 0;
+  for (size_t ib = 0; ib < batches.size(); ib++) {
+    if (!statuses[ib].ok()) {
+      throw runtime_error_f("Cannot apply filter %s", statuses[ib].ToString().c_str());
+    }
+    auto& batchSelection = batchSelections[ib];
+    for (int64_t i = 0; i < batchSelection->GetNumSlots(); i++) {
+      selection->SetIndex(nSelected++, batchSelection->GetIndex(i) + offsets[ib]);
     }
   }
+  selection->SetNumSlots(nSelected);
 
   return selection;
 }
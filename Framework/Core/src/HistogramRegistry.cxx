@@ -59,6 +59,9 @@ void HistogramRegistry::setHash(uint32_t hash)
 // create histogram from specification and insert it into the registry
 void HistogramRegistry::insert(const HistogramSpec& histSpec)
 {
+  if (mShards) {
+    LOGF(FATAL, R"(Cannot add histogram "%s" to HistogramRegistry "%s" after enabling concurrent fills.)", histSpec.name, mName);
+  }
   validateHistName(histSpec.name.data(), histSpec.hash);
   const uint32_t idx = imask(histSpec.hash);
   for (auto i = 0u; i < MAX_REGISTRY_SIZE; ++i) {
@@ -139,6 +142,76 @@ void HistogramRegistry::addClone(const std::string& source, const std::string& t
   }
 }
 
+void HistogramRegistry::setConcurrentFills(int nThreads)
+{
+  if (mShards) {
+    LOGF(FATAL, R"(Concurrent fills are already enabled for HistogramRegistry "%s".)", mName);
+  }
+  static std::atomic<uint64_t> nextId{1};
+  auto shards = std::make_shared<Shards>();
+  shards->id = nextId++;
+  shards->values.resize(std::max(nThreads, 1) + 1);
+  for (auto& shard : shards->values) {
+    for (auto i = 0u; i < MAX_REGISTRY_SIZE; ++i) {
+      std::visit([&shard, i](const auto& sharedPtr) {
+        using T = std::decay_t<decltype(*sharedPtr)>;
+        if (sharedPtr) {
+          auto clone = std::shared_ptr<T>(static_cast<T*>(sharedPtr->Clone()));
+          if constexpr (std::is_base_of_v<TH1, T>) {
+            clone->SetDirectory(nullptr);
+          }
+          clone->Reset();
+          shard[i] = clone;
+        }
+      },
+                 mRegistryValue[i]);
+    }
+  }
+  mShards = shards;
+}
+
+// the shard of the current thread, taken at the first fill of the thread
+int HistogramRegistry::getShardIndex()
+{
+  thread_local std::vector<std::pair<uint64_t, int>> assigned;
+  for (auto& [id, index] : assigned) {
+    if (id == mShards->id) {
+      return index;
+    }
+  }
+  int index = mShards->next++;
+  if (index >= mShards->overflow()) {
+    if (index == mShards->overflow()) {
+      LOGF(WARNING, R"(HistogramRegistry "%s" is filled from more than the %d threads it was configured for, the further threads share a locked shard.)", mName, mShards->overflow());
+    }
+    index = mShards->overflow();
+  }
+  assigned.emplace_back(mShards->id, index);
+  return index;
+}
+
+void HistogramRegistry::mergeShards()
+{
+  if (!mShards) {
+    return;
+  }
+  for (auto& shard : mShards->values) {
+    for (auto i = 0u; i < MAX_REGISTRY_SIZE; ++i) {
+      std::visit([&shard, i](const auto& sharedPtr) {
+        using T = std::decay_t<decltype(*sharedPtr)>;
+        if (sharedPtr) {
+          auto& shardPtr = std::get<std::shared_ptr<T>>(shard[i]);
+          TList list;
+          list.Add(shardPtr.get());
+          sharedPtr->Merge(&list);
+          shardPtr->Reset();
+        }
+      },
+                 mRegistryValue[i]);
+    }
+  }
+}
+
 // function to query if name is already in use
 bool HistogramRegistry::contains(const HistName& histName)
 {
@@ -265,6 +338,8 @@ void HistogramRegistry::print(bool showAxisDetails)
 // create output structure will be propagated to file-sink
 TList* HistogramRegistry::operator*()
 {
+  mergeShards();
+
   TList* list = new TList();
   list->SetName(mName.data());
 
@@ -12,6 +12,7 @@
 #include <stdexcept>
 #include "Framework/Logger.h"
 
+#include "arrow/array/util.h"
 #include "arrow/type_traits.h"
 
 namespace o2::framework
@@ -104,6 +105,64 @@ class ColumnIterator
   // with this mArray is prepared to be used in arrow::Table::Make
   void finish();
 };
+
+// the field of a column which is not read from its branch
+std::shared_ptr<arrow::Field> nullColumnField(TTree* tree, const char* colname)
+{
+  auto br = tree->GetBranch(colname);
+  if (!br) {
+    throw std::runtime_error(std::string("Can not locate branch ") + colname);
+  }
+  TClass* cl;
+  EDataType elementType;
+  br->GetExpectedType(cl, elementType);
+  std::shared_ptr<arrow::DataType> type;
+  switch (elementType) {
+    case EDataType::kBool_t:
+      type = arrow::boolean();
+      break;
+    case EDataType::kUChar_t:
+      type = arrow::uint8();
+      break;
+    case EDataType::kUShort_t:
+      type = arrow::uint16();
+      break;
+    case EDataType::kUInt_t:
+      type = arrow::uint32();
+      break;
+    case EDataType::kULong64_t:
+      type = arrow::uint64();
+      break;
+    case EDataType::kChar_t:
+      type = arrow::int8();
+      break;
+    case EDataType::kShort_t:
+      type = arrow::int16();
+      break;
+    case EDataType::kInt_t:
+      type = arrow::int32();
+      break;
+    case EDataType::kLong64_t:
+      type = arrow::int64();
+      break;
+    case EDataType::kFloat_t:
+      type = arrow::float32();
+      break;
+    case EDataType::kDouble_t:
+      type = arrow::float64();
+      break;
+    default:
+      throw std::runtime_error(fmt::format("Type {} of column {} not handled!", elementType, colname));
+  }
+  // single-value or single-array branches, as in ColumnIterator
+  std::string branchTitle = br->GetTitle();
+  auto pos0 = branchTitle.find("[");
+  auto pos1 = branchTitle.find("]");
+  if (pos0 != std::string::npos && pos1 != std::string::npos && pos0 > 0) {
+    type = arrow::fixed_size_list(type, atoi(branchTitle.substr(pos0 + 1, pos1 - pos0 - 1).c_str()));
+  }
+  return std::make_shared<arrow::Field>(colname, type);
+}
 } // namespace
 
 // is used in TableToTree
@@ -842,6 +901,11 @@ void TreeToTable::addColumn(const char* colname)
   mColumnNames.push_back(colname);
 }
 
+void TreeToTable::addNullColumn(const char* colname)
+{
+  mNullColumnNames.push_back(colname);
+}
+
 bool TreeToTable::addAllColumns(TTree* tree)
 {
   auto branchList = tree->GetListOfBranches();
@@ -898,6 +962,15 @@ void TreeToTable::fill(TTree* tree)
     array_vector.push_back(colit->getArray());
     schema_vector.push_back(colit->getSchema());
   }
+  for (auto&& columnName : mNullColumnNames) {
+    auto field = nullColumnField(tree, columnName.c_str());
+    auto array = arrow::MakeArrayOfNull(field->type(), numEntries);
+    if (!array.ok()) {
+      throw std::runtime_error("Unable to create null column " + columnName);
+    }
+    array_vector.push_back(array.ValueOrDie());
+    schema_vector.push_back(field);
+  }
   auto fields = std::make_shared<arrow::Schema>(schema_vector);
 
   // create the final table
@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <list>
 #include <set>
+#include <sstream>
 #include <utility>
 #include <vector>
 #include <climits>
@@ -160,6 +161,47 @@ void addMissingOutputsToReader(std::vector<OutputSpec> const& providedOutputs,
   }
 }
 
+/// The columns of the tables read from file which are used by their consumers, formatted
+/// as ORIGIN/DESCRIPTION:column,column;... A table is not listed, i.e. it is read completely,
+/// if one of its consumers does not declare the columns it uses or if it is written out again.
+std::string aodColumnsForReader(DataProcessorSpec const& reader,
+                                std::vector<InputSpec> const& requestedInputs,
+                                std::vector<InputSpec> const& writtenInputs)
+{
+  std::string result;
+  for (auto& output : reader.outputs) {
+    bool complete = std::any_of(writtenInputs.begin(), writtenInputs.end(), [&output](InputSpec const& written) { return DataSpecUtils::match(written, output); });
+    std::set<std::string> columns;
+    for (auto& requested : requestedInputs) {
+      if (complete) {
+        break;
+      }
+      if (!DataSpecUtils::match(requested, output)) {
+        continue;
+      }
+      auto spec = std::find_if(requested.metadata.begin(), requested.metadata.end(), [](ConfigParamSpec const& meta) { return meta.name == "aod-columns"; });
+      if (spec == requested.metadata.end()) {
+        complete = true;
+        break;
+      }
+      std::stringstream ss(spec->defaultValue.get<std::string>());
+      std::string column;
+      while (std::getline(ss, column, ',')) {
+        columns.insert(column);
+      }
+    }
+    if (complete || columns.empty()) {
+      continue;
+    }
+    auto concrete = DataSpecUtils::asConcreteDataMatcher(output);
+    result += (result.empty() ? "" : ";") + concrete.origin.as<std::string>() + "/" + concrete.description.as<std::string>() + ":";
+    for (auto column = columns.begin(); column != columns.end(); ++column) {
+      result += (column == columns.begin() ? "" : ",") + *column;
+    }
+  }
+  return result;
+}
+
 void addMissingOutputsToSpawner(std::vector<InputSpec>&& requestedDYNs,
                                 std::vector<InputSpec>& requestedAODs,
                                 DataProcessorSpec& publisher)
@@ -265,6 +307,8 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
     {ConfigParamSpec{"aod-file", VariantType::String, {"Input AOD file"}},
      ConfigParamSpec{"aod-reader-json", VariantType::String, {"json configuration file"}},
      ConfigParamSpec{"time-limit", VariantType::Int64, 0ll, {"Maximum run time limit in seconds"}},
+     ConfigParamSpec{"aod-columns", VariantType::String, "", {"Columns to read per table (ORIGIN/DESCRIPTION:column,...;...), all if not listed"}},
+     ConfigParamSpec{"aod-prefetch", VariantType::Bool, false, {"Read the next time frame in the background while the current one is processed"}},
      ConfigParamSpec{"orbit-offset-enumeration", VariantType::Int64, 0ll, {"initial value for the orbit"}},
      ConfigParamSpec{"orbit-multiplier-enumeration", VariantType::Int64, 0ll, {"multiplier to get the orbit from the counter"}},
      ConfigParamSpec{"start-value-enumeration", VariantType::Int64, 0ll, {"initial value for the enumeration"}},
@@ -499,6 +543,18 @@ void WorkflowHelpers::injectServiceDevices(WorkflowSpec& workflow, ConfigContext
     extraSpecs.push_back(fileSink);
   }
 
+  // restrict the reading of the AOD tables to the columns which are used, now that
+  // it is known which tables are written out again
+  auto reader = std::find_if(workflow.begin(), workflow.end(), [](DataProcessorSpec const& spec) { return spec.name == "internal-dpl-aod-reader"; });
+  if (reader != workflow.end()) {
+    auto columns = aodColumnsForReader(*reader, requestedAODs, outputsInputsAOD);
+    for (auto& option : reader->options) {
+      if (option.name == "aod-columns") {
+        option.defaultValue = columns;
+      }
+    }
+  }
+
   workflow.insert(workflow.end(), extraSpecs.begin(), extraSpecs.end());
   extraSpecs.clear();
 
@@ -24,6 +24,7 @@
 #include "Framework/DeviceInfo.h"
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsChannel.h"
 #include "Framework/DeviceConfigInfo.h"
 #include "Framework/DeviceSpec.h"
 #include "Framework/DeviceState.h"
@@ -805,6 +806,11 @@ void spawnDevice(DeviceRef ref,
       service.preFork(serviceRegistry, varmap);
     }
   }
+  // The numeric metrics of the device are sent via shared memory. If the
+  // segment cannot be created, they go through the text output.
+  auto metricsChannelName = fmt::format("/dpl-metrics-{}-{}", getpid(), deviceInfos.size());
+  std::shared_ptr<DeviceMetricsChannel> metricsChannel = DeviceMetricsChannel::create(metricsChannelName);
+
   // If we have a framework id, it means we have already been respawned
   // and that we are in a child. If not, we need to fork and re-exec, adding
   // the framework-id as one of the options.
@@ -841,6 +847,9 @@ void spawnDevice(DeviceRef ref,
 
     auto portS = std::to_string(driverInfo.tracyPort);
     setenv("TRACY_PORT", portS.c_str(), 1);
+    if (metricsChannel) {
+      setenv("DPL_METRICS_CHANNEL", metricsChannelName.c_str(), 1);
+    }
     for (auto& service : spec.services) {
       if (service.postForkChild != nullptr) {
         service.postForkChild(serviceRegistry);
@@ -897,6 +906,7 @@ void spawnDevice(DeviceRef ref,
   info.queriesViewIndex = Metric2DViewIndex{"data_queries", 0, 0, {}};
   info.tracyPort = driverInfo.tracyPort;
   info.lastSignal = uv_hrtime() - 10000000;
+  info.metricsChannel = metricsChannel;
 
   deviceInfos.emplace_back(info);
   // Let's add also metrics information for the given device
@@ -939,6 +949,34 @@ LogProcessingState processChildrenOutput(DriverInfo& driverInfo,
     assert(specs.size() == infos.size());
     DeviceSpec const& spec = specs[di];
 
+    auto updateMetricsViews =
+      Metric2DViewIndex::getUpdater({&info.dataRelayerViewIndex,
+                                     &info.variablesViewIndex,
+                                     &info.queriesViewIndex});
+
+    auto newMetricCallback = [&updateMetricsViews, &driverInfo, &metricsInfos, &hasNewMetric](std::string const& name, MetricInfo const& metric, int value, size_t metricIndex) {
+      updateMetricsViews(name, metric, value, metricIndex);
+      hasNewMetric = true;
+    };
+
+    // Numeric metrics are read in bulk from the binary channel, only
+    // the rest goes through the text output.
+    if (info.metricsChannel) {
+      if (DeviceMetricsHelper::processMetrics(*info.metricsChannel, metrics, newMetricCallback) > 0) {
+        result.didProcessMetric = true;
+      }
+      // The device drops the metrics it cannot queue while the channel is
+      // full. Report them, at most every 10 seconds per device.
+      size_t droppedMetrics = info.metricsChannel->failed();
+      uint64_t now = uv_hrtime();
+      if (droppedMetrics > info.droppedMetrics && now - info.lastDroppedMetricsReport > 10000000000) {
+        LOGP(warning, "{} ({}): {} metrics dropped because the driver did not keep up, {} in total",
+             spec.id, info.pid, droppedMetrics - info.droppedMetrics, droppedMetrics);
+        info.droppedMetrics = droppedMetrics;
+        info.lastDroppedMetricsReport = now;
+      }
+    }
+
     if (info.unprinted.empty()) {
       continue;
     }
@@ -950,16 +988,6 @@ LogProcessingState processChildrenOutput(DriverInfo& driverInfo,
     info.history.resize(info.historySize);
     info.historyLevel.resize(info.historySize);
 
-    auto updateMetricsViews =
-      Metric2DViewIndex::getUpdater({&info.dataRelayerViewIndex,
-                                     &info.variablesViewIndex,
-                                     &info.queriesViewIndex});
-
-    auto newMetricCallback = [&updateMetricsViews, &driverInfo, &metricsInfos, &hasNewMetric](std::string const& name, MetricInfo const& metric, int value, size_t metricIndex) {
-      updateMetricsViews(name, metric, value, metricIndex);
-      hasNewMetric = true;
-    };
-
     while ((pos = s.find(delimiter)) != std::string::npos) {
       std::string token{s.substr(0, pos)};
       auto logLevel = LogParsingHelpers::parseTokenLevel(token);
@@ -1195,6 +1223,12 @@ void single_step_callback(uv_timer_s* ctx)
   killChildren(*infos, SIGUSR1);
 }
 
+/// Nothing to do here, the timer only wakes up the loop so that the
+/// metrics sent via shared memory are processed even without any output.
+void metrics_wakeup_callback(uv_timer_s*)
+{
+}
+
 // This is the handler for the parent inner loop.
 int runStateMachine(DataProcessorSpecs const& workflow,
                     WorkflowInfo const& workflowInfo,
@@ -1349,6 +1383,9 @@ int runStateMachine(DataProcessorSpecs const& workflow,
   uv_timer_t force_step_timer;
   uv_timer_init(loop, &force_step_timer);
 
+  uv_timer_t metrics_timer;
+  uv_timer_init(loop, &metrics_timer);
+
   bool guiDeployedOnce = false;
   bool once = false;
 
@@ -1638,6 +1675,7 @@ int runStateMachine(DataProcessorSpecs const& workflow,
         }
         handleSignals();
         handleChildrenStdio(loop, forwardedStdin.str(), infos, childFds, pollHandles);
+        uv_timer_start(&metrics_timer, metrics_wakeup_callback, 0, 100);
         for (auto& callback : postScheduleCallbacks) {
           callback(serviceRegistry, varmap);
         }
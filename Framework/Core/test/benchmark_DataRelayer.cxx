@@ -18,7 +18,10 @@
 #include "../src/DataRelayerHelpers.h"
 #include <Monitoring/Monitoring.h>
 #include <fairmq/FairMQTransportFactory.h>
+#include <atomic>
 #include <cstring>
+#include <string>
+#include <thread>
 
 using Monitoring = o2::monitoring::Monitoring;
 using namespace o2::framework;
@@ -303,4 +306,124 @@ static void BM_RelaySplitParts(benchmark::State& state)
 
 BENCHMARK(BM_RelaySplitParts);
 
+/// Several producer threads relay the parts of a record with many routes,
+/// while several stream threads pick up the complete timeslices, so that
+/// the contention on the relayer is measured.
+/// state.range(0) is the number of producers, state.range(1) the number of streams.
+static void BM_RelayConcurrentStreams(benchmark::State& state)
+{
+  constexpr size_t nRoutes = 8;
+  constexpr size_t nTimeslices = 256;
+  const size_t nProducers = state.range(0);
+  const size_t nStreams = state.range(1);
+
+  Monitoring metrics;
+  std::vector<InputRoute> inputs;
+  for (size_t ri = 0; ri < nRoutes; ++ri) {
+    InputSpec spec{"in" + std::to_string(ri), "TST", "DATA", static_cast<DataHeader::SubSpecificationType>(ri)};
+    inputs.push_back(InputRoute{spec, ri, "Fake" + std::to_string(ri), 0});
+  }
+
+  TimesliceIndex index;
+  auto policy = CompletionPolicyHelpers::consumeWhenAll();
+  DataRelayer relayer(policy, inputs, metrics, index);
+  relayer.setPipelineLength(16);
+
+  DataHeader dh;
+  dh.dataDescription = "DATA";
+  dh.dataOrigin = "TST";
+
+  auto transport = FairMQTransportFactory::CreateTransportFactory("zeromq");
+  size_t firstTimeslice = 0;
+  size_t relayedParts = 0;
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    // Each producer sends the routes ri % nProducers == pi of all the timeslices.
+    std::vector<std::vector<std::pair<FairMQMessagePtr, FairMQMessagePtr>>> parts(nProducers);
+    for (size_t ts = firstTimeslice; ts < firstTimeslice + nTimeslices; ++ts) {
+      for (size_t ri = 0; ri < nRoutes; ++ri) {
+        dh.subSpecification = ri;
+        DataProcessingHeader dph{ts, 1};
+        Stack stack{dh, dph};
+        FairMQMessagePtr header = transport->CreateMessage(stack.size());
+        memcpy(header->GetData(), stack.data(), stack.size());
+        parts[ri % nProducers].emplace_back(std::move(header), transport->CreateMessage(1000));
+      }
+    }
+    // Every timeslice must be consumed exactly once, by any of the streams.
+    std::vector<std::atomic<int>> consumed(nTimeslices);
+    std::atomic<int> invalidRecords{0};
+    const size_t batchStart = firstTimeslice;
+    firstTimeslice += nTimeslices;
+    state.ResumeTiming();
+
+    std::atomic<size_t> activeProducers{nProducers};
+    std::vector<std::thread> threads;
+    for (size_t pi = 0; pi < nProducers; ++pi) {
+      threads.emplace_back([&relayer, &activeProducers, &myParts = parts[pi]]() {
+        for (auto& [header, payload] : myParts) {
+          while (relayer.relay(header, payload) == DataRelayer::Backpressured) {
+            std::this_thread::yield();
+          }
+        }
+        activeProducers--;
+      });
+    }
+    for (size_t si = 0; si < nStreams; ++si) {
+      threads.emplace_back([&relayer, &activeProducers, &consumed, &invalidRecords, batchStart]() {
+        std::vector<RecordAction> ready;
+        while (true) {
+          bool producing = activeProducers.load() != 0;
+          ready.clear();
+          relayer.getReadyToProcess(ready);
+          for (auto& action : ready) {
+            if (action.op == CompletionPolicy::CompletionOp::Consume) {
+              auto result = relayer.getInputsForTimeslice(action.slot);
+              benchmark::DoNotOptimize(result);
+              if (result.size() != nRoutes || result[0].size() == 0 || !result[0][0].header) {
+                invalidRecords++;
+                continue;
+              }
+              size_t ts = o2::header::get<DataProcessingHeader*>(result[0][0].header->GetData())->startTime;
+              if (ts < batchStart || ts >= batchStart + nTimeslices) {
+                invalidRecords++;
+                continue;
+              }
+              consumed[ts - batchStart]++;
+            }
+          }
+          if (ready.empty()) {
+            if (producing == false) {
+              break;
+            }
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    if (invalidRecords != 0) {
+      state.SkipWithError((std::to_string(invalidRecords.load()) + " consumed records without the parts of a timeslice").c_str());
+      return;
+    }
+    for (size_t ti = 0; ti < nTimeslices; ++ti) {
+      if (consumed[ti] != 1) {
+        state.SkipWithError(("timeslice " + std::to_string(batchStart + ti) + " consumed " + std::to_string(consumed[ti].load()) + " times").c_str());
+        return;
+      }
+    }
+    relayedParts += nTimeslices * nRoutes;
+
+    state.PauseTiming();
+    relayer.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(relayedParts);
+}
+
+BENCHMARK(BM_RelayConcurrentStreams)->Args({1, 1})->Args({2, 2})->Args({4, 4})->Args({8, 4})->UseRealTime();
+
 BENCHMARK_MAIN();
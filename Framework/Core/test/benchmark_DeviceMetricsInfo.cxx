@@ -10,9 +10,11 @@
 // or submit itself to any jurisdiction.
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsChannel.h"
 
 #include <benchmark/benchmark.h>
 #include <regex>
+#include <unistd.h>
 
 // This is the fastest we could ever get.
 static void BM_MemcmpBaseline(benchmark::State& state)
@@ -96,6 +98,27 @@ static void BM_ProcessIntMetric(benchmark::State& state)
 
 BENCHMARK(BM_ProcessIntMetric);
 
+// Same as above, but the metrics go through the binary channel.
+static void BM_ProcessIntMetricChannel(benchmark::State& state)
+{
+  using namespace o2::framework;
+  DeviceMetricsInfo info;
+
+  auto name = "/dpl-metrics-bench-" + std::to_string(getpid());
+  auto driverSide = DeviceMetricsChannel::create(name);
+  auto deviceSide = DeviceMetricsChannel::attach(name);
+  std::string key = "bkey";
+  for (auto _ : state) {
+    for (size_t i = 0; i < 1000; ++i) {
+      deviceSide->send(key, 12, 1789372894);
+    }
+    DeviceMetricsHelper::processMetrics(*driverSide, info);
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+BENCHMARK(BM_ProcessIntMetricChannel);
+
 static void BM_ParseFloatMetric(benchmark::State& state)
 {
   using namespace o2::framework;
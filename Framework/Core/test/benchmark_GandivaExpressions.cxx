@@ -68,7 +68,71 @@ static void BM_GandivaExpression(benchmark::State& state)
   benchmark::DoNotOptimize(tt);
 }
 
+auto createLargeTable(size_t nrows)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float, float>({"x", "y", "z"});
+  for (auto i = 0u; i < nrows; ++i) {
+    rowWriter(0, G(e), G(e), G(e));
+  }
+  return builder.finalize();
+}
+
+auto createCondition()
+{
+  expressions::Filter f = ((test::x > 0.f) && (test::y < 1.f)) || (expressions::nsqrt(test::x * test::x + test::z * test::z) < 0.5f);
+  return expressions::createExpressionTree(expressions::createOperations(std::move(f)), createLargeTable(1)->schema());
+}
+
+// compiling the filter from scratch, as it was done for every dataframe before caching
+static void BM_FilterCompilation(benchmark::State& state)
+{
+  auto schema = createLargeTable(1)->schema();
+  auto condition = expressions::makeCondition(createCondition());
+  for (auto _ : state) {
+    std::shared_ptr<gandiva::Filter> filter;
+    auto s = gandiva::Filter::Make(schema, condition, gandiva::ConfigurationBuilder::DefaultConfiguration(), &filter);
+    benchmark::DoNotOptimize(filter);
+  }
+}
+
+// same filter requested again, as done by every task for every dataframe
+static void BM_FilterCached(benchmark::State& state)
+{
+  auto schema = createLargeTable(1)->schema();
+  auto tree = createCondition();
+  for (auto _ : state) {
+    auto filter = expressions::createFilter(schema, expressions::makeCondition(tree));
+    benchmark::DoNotOptimize(filter);
+  }
+}
+
+static void BM_Selection(benchmark::State& state)
+{
+  auto table = createLargeTable(state.range(0));
+  auto filter = expressions::createFilter(table->schema(), expressions::makeCondition(createCondition()));
+  expressions::setSelectionThreads(state.range(1));
+  for (auto _ : state) {
+    auto selection = expressions::createSelection(table, filter);
+    benchmark::DoNotOptimize(selection);
+  }
+  expressions::setSelectionThreads(1);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void selectionArguments(benchmark::internal::Benchmark* b)
+{
+  for (int nrows : {1 << 16, 1 << 20, 1 << 23}) {
+    for (int nThreads : {1, 2, 4, 8}) {
+      b->Args({nrows, nThreads});
+    }
+  }
+}
+
 BENCHMARK(BM_DirectCalculation)->Arg(maxrows);
 BENCHMARK(BM_GandivaExpression)->Arg(maxrows);
+BENCHMARK(BM_FilterCompilation)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FilterCached)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Selection)->Apply(selectionArguments)->Unit(benchmark::kMicrosecond)->UseRealTime();
 
 BENCHMARK_MAIN();
@@ -16,6 +16,7 @@
 
 #include <benchmark/benchmark.h>
 #include <boost/format.hpp>
+#include <thread>
 
 using namespace o2::framework;
 using namespace arrow;
@@ -62,7 +63,37 @@ static void BM_StandardNameLookup(benchmark::State& state)
     }
   }
 }
+/// Number of fills per thread
+const int nFills = 1000000;
+
+/// Fill a histogram from several threads, every thread filling its own shard which are merged at the end
+static void BM_ConcurrentFill(benchmark::State& state)
+{
+  int nThreads = state.range(0);
+  for (auto _ : state) {
+    state.PauseTiming();
+    HistogramRegistry registry{"registry", {{"pt", "p_{T}", {HistType::kTH2F, {{200, 0, 20}, {100, -1, 1}}}}}};
+    registry.setConcurrentFills(nThreads);
+    state.ResumeTiming();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; ++t) {
+      threads.emplace_back([&registry, t]() {
+        for (int i = 0; i < nFills; ++i) {
+          registry.fill(HIST("pt"), (i % 2000) * 0.01f, ((i + t) % 200) * 0.01f - 1.f);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    registry.mergeShards();
+  }
+  state.counters["fills"] = benchmark::Counter(double(state.iterations()) * nThreads * nFills, benchmark::Counter::kIsRate);
+}
+
 BENCHMARK(BM_HashedNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 BENCHMARK(BM_StandardNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
+BENCHMARK(BM_ConcurrentFill)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
 
 BENCHMARK_MAIN();
@@ -137,6 +137,28 @@ struct ITask {
   }
 };
 
+struct KTask {
+  Uses<aod::test::Foo> columns;
+  void process(o2::aod::FooBars const& foobars)
+  {
+    for (auto& foobar : foobars) {
+      foobar.foo();
+    }
+  }
+};
+
+struct LTask {
+  Uses<aod::test::X> columns;
+  expressions::Filter flt = aod::test::bar > 0.;
+  Partition<o2::aod::XYZ> positive = aod::test::z > 0.;
+  void process(soa::Filtered<o2::aod::FooBars> const&, o2::aod::XYZ const& xyzs)
+  {
+    for (auto& xyz : xyzs) {
+      xyz.x();
+    }
+  }
+};
+
 struct JTask {
   Configurable<o2::test::SimplePODClass> cfg{"someConfigurable", {}, "Some Configurable Object"};
   void process(o2::aod::Collision const&)
@@ -199,6 +221,39 @@ BOOST_AUTO_TEST_CASE(AdaptorCompilation)
   auto task10 = adaptAnalysisTask<JTask>(*cfgc, TaskName{"test10"});
 }
 
+namespace
+{
+std::string columnsOf(InputSpec const& input)
+{
+  auto spec = std::find_if(input.metadata.begin(), input.metadata.end(), [](ConfigParamSpec const& meta) { return meta.name == "aod-columns"; });
+  return spec == input.metadata.end() ? "all" : spec->defaultValue.get<std::string>();
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestUsedColumns)
+{
+  auto cfgc = makeEmptyConfigContext();
+
+  // no declared columns, the table is read completely
+  auto task5 = adaptAnalysisTask<ETask>(*cfgc, TaskName{"test5"});
+  BOOST_REQUIRE_EQUAL(task5.inputs.size(), 1);
+  BOOST_CHECK_EQUAL(columnsOf(task5.inputs[0]), "all");
+
+  // only the used column is read
+  auto task11 = adaptAnalysisTask<KTask>(*cfgc, TaskName{"test11"});
+  BOOST_REQUIRE_EQUAL(task11.inputs.size(), 1);
+  BOOST_CHECK_EQUAL(columnsOf(task11.inputs[0]), "fFoo");
+
+  // the columns of the filters and partitions are read with the used ones,
+  // a table without used columns is read completely
+  auto task12 = adaptAnalysisTask<LTask>(*cfgc, TaskName{"test12"});
+  BOOST_REQUIRE_EQUAL(task12.inputs.size(), 2);
+  BOOST_CHECK_EQUAL(task12.inputs[0].binding, "FooBars");
+  BOOST_CHECK_EQUAL(columnsOf(task12.inputs[0]), "all");
+  BOOST_CHECK_EQUAL(task12.inputs[1].binding, "XYZ");
+  BOOST_CHECK_EQUAL(columnsOf(task12.inputs[1]), "fX,fZ");
+}
+
 BOOST_AUTO_TEST_CASE(TestPartitionIteration)
 {
   TableBuilder builderA;
@@ -303,6 +303,8 @@ DataProcessorSpec getSinkSpec()
     ASSERT_ERROR((object12[1] == o2::test::TriviallyCopyable{10, 20, 0xacdc}));
     // forward the read-only span on a different route
     pc.outputs().snapshot(Output{"TST", "MSGABLVECTORCPY", 0, Lifetime::Timeframe}, object12);
+    // forward the input message itself, the payload is shared and not copied
+    pc.outputs().forward(Output{"TST", "MSGABLVECTORFWD", 0, Lifetime::Timeframe}, pc.inputs().get("input12"));
 
     LOG(INFO) << "extracting TNamed object from input13";
     auto object13 = pc.inputs().get<TNamed*>("input13");
@@ -355,7 +357,8 @@ DataProcessorSpec getSinkSpec()
                             InputSpec{"inputPMR", "TST", "PMRTESTVECTOR", 0, Lifetime::Timeframe},
                             InputSpec{"inputPODvector", "TST", "PODVECTOR", 0, Lifetime::Timeframe},
                             InputSpec{"inputMP", ConcreteDataTypeMatcher{"TST", "MULTIPARTS"}, Lifetime::Timeframe}},
-                           Outputs{OutputSpec{"TST", "MSGABLVECTORCPY", 0, Lifetime::Timeframe}},
+                           Outputs{OutputSpec{"TST", "MSGABLVECTORCPY", 0, Lifetime::Timeframe},
+                                   OutputSpec{"TST", "MSGABLVECTORFWD", 0, Lifetime::Timeframe}},
                            AlgorithmSpec(processingFct)};
 }
 
@@ -392,12 +395,19 @@ DataProcessorSpec getSpectatorSinkSpec()
     ASSERT_ERROR((object12[0] == o2::test::TriviallyCopyable{42, 23, 0xdead}));
     ASSERT_ERROR((object12[1] == o2::test::TriviallyCopyable{10, 20, 0xacdc}));
 
+    LOG(INFO) << "extracting the forwarded input message as span from input12fwd";
+    auto forwarded = pc.inputs().get<gsl::span<o2::test::TriviallyCopyable>>("input12fwd");
+    ASSERT_ERROR(forwarded.size() == 2);
+    ASSERT_ERROR((forwarded[0] == o2::test::TriviallyCopyable{42, 23, 0xdead}));
+    ASSERT_ERROR((forwarded[1] == o2::test::TriviallyCopyable{10, 20, 0xacdc}));
+
     pc.services().get<ControlService>().readyToQuit(QuitRequest::Me);
   };
 
   return DataProcessorSpec{"spectator-sink", // name of the processor
                            {InputSpec{"inputMP", ConcreteDataTypeMatcher{"TST", "MULTIPARTS"}, Lifetime::Timeframe},
-                            InputSpec{"input12", ConcreteDataTypeMatcher{"TST", "MSGABLVECTORCPY"}, Lifetime::Timeframe}},
+                            InputSpec{"input12", ConcreteDataTypeMatcher{"TST", "MSGABLVECTORCPY"}, Lifetime::Timeframe},
+                            InputSpec{"input12fwd", ConcreteDataTypeMatcher{"TST", "MSGABLVECTORFWD"}, Lifetime::Timeframe}},
                            Outputs{},
                            AlgorithmSpec(processingFct)};
 }
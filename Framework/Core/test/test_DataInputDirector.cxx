@@ -17,6 +17,9 @@
 
 #include "Headers/DataHeader.h"
 #include "Framework/DataInputDirector.h"
+#include <TFile.h>
+#include <TTree.h>
+#include <arrow/table.h>
 
 BOOST_AUTO_TEST_CASE(TestDatainputDirector)
 {
@@ -108,3 +111,67 @@ BOOST_AUTO_TEST_CASE(TestDatainputDirector)
   BOOST_CHECK(didesc);
   BOOST_CHECK_EQUAL(didesc->getNumberInputfiles(), 3);
 }
+
+BOOST_AUTO_TEST_CASE(TestDataInputDirectorReadTable)
+{
+  using namespace o2::header;
+  using namespace o2::framework;
+
+  // two time frames with a tree of two columns
+  std::string fileName("testDataInputDirectorReadTable.root");
+  {
+    TFile f(fileName.c_str(), "RECREATE");
+    for (int itf = 1; itf <= 2; itf++) {
+      auto dir = f.mkdir(("DF_" + std::to_string(itf)).c_str());
+      dir->cd();
+      float a;
+      int b;
+      TTree t("O2uno", "uno");
+      t.Branch("fA", &a, "fA/F");
+      t.Branch("fB", &b, "fB/I");
+      for (int i = 0; i < 10 * itf; i++) {
+        a = i * 0.5f;
+        b = i * itf;
+        t.Fill();
+      }
+      t.Write();
+    }
+    f.Close();
+  }
+
+  auto dh = DataHeader(DataDescription{"UNO"}, DataOrigin{"AOD"}, DataHeader::SubSpecificationType{0});
+  DataInputDirector didir(std::vector<std::string>{fileName});
+
+  // all columns
+  auto all = didir.readTable(TableRequest{dh, {}}, 0, 0);
+  BOOST_REQUIRE(all.table);
+  BOOST_CHECK_EQUAL(all.table->num_columns(), 2);
+  BOOST_CHECK_EQUAL(all.table->num_rows(), 10);
+
+  // only the requested column is read, the second time frame is read in the background
+  didir.setPrefetching(true);
+  TableRequest request{dh, {"fB"}};
+  auto pruned = didir.readTable(request, 0, 0);
+  BOOST_REQUIRE(pruned.table);
+  BOOST_CHECK_EQUAL(pruned.table->num_columns(), 2);
+  BOOST_CHECK_EQUAL(pruned.table->num_rows(), 10);
+  BOOST_REQUIRE(pruned.table->GetColumnByName("fB"));
+  BOOST_CHECK_EQUAL(pruned.table->GetColumnByName("fB")->null_count(), 0);
+  // the other column is not read and only holds nulls
+  BOOST_REQUIRE(pruned.table->GetColumnByName("fA"));
+  BOOST_CHECK(pruned.table->GetColumnByName("fA")->type()->Equals(arrow::float32()));
+  BOOST_CHECK_EQUAL(pruned.table->GetColumnByName("fA")->null_count(), 10);
+  BOOST_CHECK(pruned.compressedBytes < all.compressedBytes);
+
+  didir.prefetch({request}, 0, 1);
+  auto prefetched = didir.readTable(request, 0, 1);
+  BOOST_REQUIRE(prefetched.table);
+  BOOST_CHECK_EQUAL(prefetched.table->num_columns(), 2);
+  BOOST_CHECK_EQUAL(prefetched.table->GetColumnByName("fA")->null_count(), 20);
+  BOOST_CHECK_EQUAL(prefetched.table->num_rows(), 20);
+
+  // no prefetching beyond the last time frame
+  didir.prefetch({request}, 0, 2);
+  BOOST_CHECK(!didir.readTable(request, 0, 2).table);
+  didir.closeInputFiles();
+}
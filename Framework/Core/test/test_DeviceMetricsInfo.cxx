@@ -14,10 +14,19 @@
 
 #include "Framework/DeviceMetricsInfo.h"
 #include "Framework/DeviceMetricsHelper.h"
+#include "Framework/DeviceMetricsChannel.h"
+#include "Framework/DriverClient.h"
+#include "Framework/ServiceRegistry.h"
+#include "../src/DPLMonitoringBackend.h"
+#include <Monitoring/Metric.h>
 #include <boost/test/unit_test.hpp>
+#include <cstdlib>
 #include <iostream>
 #include <regex>
+#include <string>
 #include <string_view>
+#include <vector>
+#include <unistd.h>
 
 BOOST_AUTO_TEST_CASE(TestDeviceMetricsInfo)
 {
@@ -223,3 +232,124 @@ BOOST_AUTO_TEST_CASE(TestHelpers)
   BOOST_CHECK_EQUAL(metric2, 0);
   BOOST_CHECK_EQUAL(metric3, 1);
 }
+
+BOOST_AUTO_TEST_CASE(TestMetricsChannel)
+{
+  using namespace o2::framework;
+  auto name = "/dpl-metrics-test-" + std::to_string(getpid());
+  auto driverSide = DeviceMetricsChannel::create(name);
+  BOOST_REQUIRE(driverSide != nullptr);
+  BOOST_CHECK(DeviceMetricsChannel::create(name) == nullptr);
+  auto deviceSide = DeviceMetricsChannel::attach(name);
+  BOOST_REQUIRE(deviceSide != nullptr);
+  // The name is gone once the device attached
+  BOOST_CHECK(DeviceMetricsChannel::attach(name) == nullptr);
+
+  DeviceMetricsInfo info;
+  BOOST_CHECK_EQUAL(DeviceMetricsHelper::processMetrics(*driverSide, info), 0);
+  BOOST_CHECK(deviceSide->send("bkey", 12, 1000) == DeviceMetricsChannel::SendResult::Sent);
+  BOOST_CHECK(deviceSide->send("akey", 2.5f, 1001) == DeviceMetricsChannel::SendResult::Sent);
+  BOOST_CHECK(deviceSide->send("bkey", 13, 1002) == DeviceMetricsChannel::SendResult::Sent);
+  BOOST_CHECK(deviceSide->send("ckey", uint64_t{1} << 40, 1003) == DeviceMetricsChannel::SendResult::Sent);
+  size_t newMetrics = 0;
+  auto newMetricCallback = [&newMetrics](std::string const&, MetricInfo const&, int, size_t) { newMetrics++; };
+  BOOST_CHECK_EQUAL(DeviceMetricsHelper::processMetrics(*driverSide, info, newMetricCallback), 4);
+  BOOST_CHECK_EQUAL(newMetrics, 3);
+  BOOST_REQUIRE_EQUAL(info.metrics.size(), 3);
+  auto bkey = DeviceMetricsHelper::metricIdxByName("bkey", info);
+  auto akey = DeviceMetricsHelper::metricIdxByName("akey", info);
+  auto ckey = DeviceMetricsHelper::metricIdxByName("ckey", info);
+  BOOST_REQUIRE_EQUAL(info.metrics[bkey].type, MetricType::Int);
+  BOOST_CHECK_EQUAL(info.metrics[bkey].filledMetrics, 2);
+  BOOST_CHECK_EQUAL(info.intMetrics[info.metrics[bkey].storeIdx][0], 12);
+  BOOST_CHECK_EQUAL(info.intMetrics[info.metrics[bkey].storeIdx][1], 13);
+  BOOST_CHECK_EQUAL(info.timestamps[bkey][1], 1002);
+  BOOST_REQUIRE_EQUAL(info.metrics[akey].type, MetricType::Float);
+  BOOST_CHECK_EQUAL(info.floatMetrics[info.metrics[akey].storeIdx][0], 2.5f);
+  BOOST_REQUIRE_EQUAL(info.metrics[ckey].type, MetricType::Uint64);
+  BOOST_CHECK_EQUAL(info.uint64Metrics[info.metrics[ckey].storeIdx][0], uint64_t{1} << 40);
+  BOOST_CHECK_EQUAL(info.changed[bkey], true);
+
+  // A metric coming as text ends up in the same place
+  ParsedMetricMatch match;
+  BOOST_REQUIRE(DeviceMetricsHelper::parseMetric("[METRIC] bkey,0 14 1004 hostname=test.cern.ch", match));
+  BOOST_CHECK(DeviceMetricsHelper::processMetric(match, info));
+  BOOST_CHECK_EQUAL(info.metrics.size(), 3);
+  BOOST_CHECK_EQUAL(info.intMetrics[info.metrics[bkey].storeIdx][2], 14);
+
+  // When the driver does not keep up, sending fails and nothing is overwritten
+  for (size_t i = 0; i < DeviceMetricsChannel::Capacity; ++i) {
+    BOOST_REQUIRE(deviceSide->send("bkey", int(i), 2000 + i) == DeviceMetricsChannel::SendResult::Sent);
+  }
+  BOOST_CHECK(deviceSide->send("bkey", -1, 3000) == DeviceMetricsChannel::SendResult::RingFull);
+  BOOST_CHECK_EQUAL(deviceSide->failed(), 1);
+  BOOST_CHECK_EQUAL(DeviceMetricsHelper::processMetrics(*driverSide, info), DeviceMetricsChannel::Capacity);
+  BOOST_CHECK(deviceSide->send("bkey", -1, 3000) == DeviceMetricsChannel::SendResult::Sent);
+  BOOST_CHECK_EQUAL(DeviceMetricsHelper::processMetrics(*driverSide, info), 1);
+
+  // Once the label table is full new metrics are not queued, nor counted as dropped
+  for (size_t i = 3; i < DeviceMetricsChannel::MaxLabels; ++i) {
+    BOOST_REQUIRE(deviceSide->send("key" + std::to_string(i), int(i), 4000) == DeviceMetricsChannel::SendResult::Sent);
+  }
+  BOOST_CHECK(deviceSide->send("overflow", 1, 5000) == DeviceMetricsChannel::SendResult::NoLabel);
+  BOOST_CHECK(deviceSide->send("bkey", 1, 5000) == DeviceMetricsChannel::SendResult::Sent);
+  BOOST_CHECK_EQUAL(deviceSide->failed(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestMonitoringBackendOverflow)
+{
+  using namespace o2::framework;
+  struct RecordingDriverClient : DriverClient {
+    void tell(char const* msg, size_t s, bool) final { messages.emplace_back(msg, s); }
+    void flushPending() final {}
+    std::vector<std::string> messages;
+  };
+
+  auto name = "/dpl-metrics-backend-test-" + std::to_string(getpid());
+  auto driverSide = DeviceMetricsChannel::create(name);
+  BOOST_REQUIRE(driverSide != nullptr);
+  RecordingDriverClient client;
+  ServiceRegistry registry;
+  registry.registerService(ServiceRegistryHelpers::handleForService<DriverClient>(&client));
+  setenv("DPL_METRICS_CHANNEL", name.c_str(), 1);
+  DPLMonitoringBackend backend(registry);
+  unsetenv("DPL_METRICS_CHANNEL");
+
+  DeviceMetricsInfo info;
+  for (size_t i = 0; i < DeviceMetricsChannel::Capacity; ++i) {
+    backend.send(o2::monitoring::Metric{int(i), "bkey"});
+  }
+  BOOST_CHECK(client.messages.empty());
+  // Once the ring is full numeric values are dropped, rather than sent as text
+  // ahead of the ones still queued
+  backend.send(o2::monitoring::Metric{-1, "bkey"});
+  BOOST_CHECK(client.messages.empty());
+  BOOST_CHECK_EQUAL(driverSide->failed(), 1);
+  // Strings always go through the text protocol
+  backend.send(o2::monitoring::Metric{std::string{"value"}, "skey"});
+  BOOST_REQUIRE_EQUAL(client.messages.size(), 1);
+  BOOST_CHECK(client.messages[0].find("[METRIC] skey") == 0);
+
+  BOOST_CHECK_EQUAL(DeviceMetricsHelper::processMetrics(*driverSide, info), DeviceMetricsChannel::Capacity);
+  auto bkey = DeviceMetricsHelper::metricIdxByName("bkey", info);
+  BOOST_REQUIRE_EQUAL(info.metrics[bkey].filledMetrics, DeviceMetricsChannel::Capacity);
+  auto last = (info.metrics[bkey].pos + info.intMetrics[info.metrics[bkey].storeIdx].size() - 1) % info.intMetrics[info.metrics[bkey].storeIdx].size();
+  BOOST_CHECK_EQUAL(info.intMetrics[info.metrics[bkey].storeIdx][last], int(DeviceMetricsChannel::Capacity - 1));
+  BOOST_CHECK_EQUAL(info.min[bkey], 0);
+
+  // The channel is usable again once the driver caught up
+  backend.send(o2::monitoring::Metric{-2, "bkey"});
+  BOOST_CHECK(client.messages.size() == 1);
+  BOOST_CHECK_EQUAL(DeviceMetricsHelper::processMetrics(*driverSide, info), 1);
+
+  // Metrics which do not fit in the label table go through the text protocol
+  for (size_t i = 1; i < DeviceMetricsChannel::MaxLabels; ++i) {
+    backend.send(o2::monitoring::Metric{int(i), "key" + std::to_string(i)});
+  }
+  BOOST_CHECK(client.messages.size() == 1);
+  backend.send(o2::monitoring::Metric{3, "overflow"});
+  BOOST_REQUIRE_EQUAL(client.messages.size(), 2);
+  BOOST_CHECK(client.messages[1].find("[METRIC] overflow") == 0);
+  BOOST_CHECK_EQUAL(driverSide->failed(), 1);
+  BOOST_CHECK_EQUAL(DeviceMetricsHelper::processMetrics(*driverSide, info), DeviceMetricsChannel::MaxLabels - 1);
+}
@@ -203,3 +203,38 @@ BOOST_AUTO_TEST_CASE(TestGandivaTreeCreation)
   BOOST_REQUIRE(s.ok());
 #endif
 }
+
+BOOST_AUTO_TEST_CASE(TestSelectionCacheAndThreads)
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float>({"phi", "eta"});
+  constexpr int nrows = 300000;
+  for (int i = 0; i < nrows; ++i) {
+    rowWriter(0, (i % 7) * 0.5f, (i % 5) * 0.5f - 1.f);
+  }
+  auto table = builder.finalize();
+
+  expressions::Filter f = ((nodes::phi > 1) && (nodes::phi < 2)) || (nodes::eta < 0);
+  auto tree = createExpressionTree(createOperations(std::move(f)), table->schema());
+  auto filter = createFilter(table->schema(), makeCondition(tree));
+  // the same condition on the same schema gives the cached filter
+  BOOST_CHECK(filter == createFilter(table->schema(), makeCondition(tree)));
+
+  auto selection = createSelection(table, filter);
+  setSelectionThreads(4);
+  auto selectionMT = createSelection(table, filter);
+  setSelectionThreads(1);
+  BOOST_REQUIRE_EQUAL(selection->GetNumSlots(), selectionMT->GetNumSlots());
+  int64_t nexpected = 0;
+  for (int i = 0; i < nrows; ++i) {
+    float phi = (i % 7) * 0.5f, eta = (i % 5) * 0.5f - 1.f;
+    if ((phi > 1 && phi < 2) || eta < 0) {
+      BOOST_REQUIRE_EQUAL(selectionMT->GetIndex(nexpected), static_cast<uint64_t>(i));
+      nexpected++;
+    }
+  }
+  BOOST_CHECK_EQUAL(selection->GetNumSlots(), nexpected);
+  for (int64_t i = 0; i < nexpected; ++i) {
+    BOOST_REQUIRE_EQUAL(selection->GetIndex(i), selectionMT->GetIndex(i));
+  }
+}
@@ -15,6 +15,7 @@
 #include "Framework/HistogramRegistry.h"
 #include <boost/test/unit_test.hpp>
 #include <iostream>
+#include <thread>
 
 using namespace o2;
 using namespace o2::framework;
@@ -129,3 +130,82 @@ BOOST_AUTO_TEST_CASE(HistogramRegistryStepTHn)
 
   registry.print();
 }
+
+BOOST_AUTO_TEST_CASE(HistogramRegistryConcurrentFill)
+{
+  HistogramRegistry serial{"serial", {{"x", "x", {HistType::kTH1F, {{100, 0.0f, 1.0f}}}}, {"xy", "xy", {HistType::kTHnF, {{10, 0.0f, 1.0f}, {10, 0.0f, 1.0f}}}}}};
+  HistogramRegistry concurrent{"concurrent", {{"x", "x", {HistType::kTH1F, {{100, 0.0f, 1.0f}}}}, {"xy", "xy", {HistType::kTHnF, {{10, 0.0f, 1.0f}, {10, 0.0f, 1.0f}}}}}};
+  const int nThreads = 4, nFills = 1000;
+  concurrent.setConcurrentFills(nThreads);
+
+  auto value = [](int thread, int i) { return ((thread * nFills + i) % 997) / 997.f; };
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThreads; ++t) {
+    threads.emplace_back([&concurrent, &value, t]() {
+      for (int i = 0; i < nFills; ++i) {
+        concurrent.fill(HIST("x"), value(t, i));
+        concurrent.fill(HIST("xy"), value(t, i), value(t, nFills - i));
+      }
+    });
+    for (int i = 0; i < nFills; ++i) {
+      serial.fill(HIST("x"), value(t, i));
+      serial.fill(HIST("xy"), value(t, i), value(t, nFills - i));
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // nothing is filled into the registry histograms before merging
+  BOOST_CHECK_EQUAL(concurrent.get<TH1>(HIST("x"))->GetEntries(), 0);
+  concurrent.mergeShards();
+
+  auto& hSerial = serial.get<TH1>(HIST("x"));
+  auto& hConcurrent = concurrent.get<TH1>(HIST("x"));
+  BOOST_CHECK_EQUAL(hConcurrent->GetEntries(), nThreads * nFills);
+  for (int bin = 0; bin <= hSerial->GetNbinsX() + 1; ++bin) {
+    BOOST_CHECK_EQUAL(hConcurrent->GetBinContent(bin), hSerial->GetBinContent(bin));
+  }
+  auto& hnSerial = serial.get<THn>(HIST("xy"));
+  auto& hnConcurrent = concurrent.get<THn>(HIST("xy"));
+  BOOST_CHECK_EQUAL(hnConcurrent->GetEntries(), hnSerial->GetEntries());
+  for (Long64_t bin = 0; bin < hnSerial->GetNbins(); ++bin) {
+    BOOST_CHECK_EQUAL(hnConcurrent->GetBinContent(bin), hnSerial->GetBinContent(bin));
+  }
+
+  // the shards were reset by the merging
+  concurrent.mergeShards();
+  BOOST_CHECK_EQUAL(hConcurrent->GetEntries(), nThreads * nFills);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramRegistryConcurrentFillOverflow)
+{
+  // more threads fill than there are shards, the further threads share the overflow shard
+  HistogramRegistry serial{"serial", {{"x", "x", {HistType::kTH1F, {{100, 0.0f, 1.0f}}}}}};
+  HistogramRegistry concurrent{"concurrent", {{"x", "x", {HistType::kTH1F, {{100, 0.0f, 1.0f}}}}}};
+  const int nShards = 2, nThreads = 8, nFills = 1000;
+  concurrent.setConcurrentFills(nShards);
+
+  auto value = [](int thread, int i) { return ((thread * nFills + i) % 997) / 997.f; };
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThreads; ++t) {
+    threads.emplace_back([&concurrent, &value, t]() {
+      for (int i = 0; i < nFills; ++i) {
+        concurrent.fill(HIST("x"), value(t, i));
+      }
+    });
+    for (int i = 0; i < nFills; ++i) {
+      serial.fill(HIST("x"), value(t, i));
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  concurrent.mergeShards();
+
+  auto& hSerial = serial.get<TH1>(HIST("x"));
+  auto& hConcurrent = concurrent.get<TH1>(HIST("x"));
+  BOOST_CHECK_EQUAL(hConcurrent->GetEntries(), nThreads * nFills);
+  for (int bin = 0; bin <= hSerial->GetNbinsX() + 1; ++bin) {
+    BOOST_CHECK_EQUAL(hConcurrent->GetBinContent(bin), hSerial->GetBinContent(bin));
+  }
+}
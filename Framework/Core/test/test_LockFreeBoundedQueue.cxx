@@ -0,0 +1,92 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test Framework LockFreeBoundedQueue
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include "Framework/LockFreeBoundedQueue.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace o2::framework;
+
+BOOST_AUTO_TEST_CASE(TestBasics)
+{
+  LockFreeBoundedQueue<size_t> queue(3);
+  BOOST_REQUIRE_EQUAL(queue.capacity(), 4);
+  size_t value = 0;
+  BOOST_CHECK(queue.pop(value) == false);
+  for (size_t i = 0; i < 4; ++i) {
+    BOOST_CHECK(queue.push(i));
+  }
+  BOOST_CHECK(queue.push(4) == false);
+  for (size_t i = 0; i < 4; ++i) {
+    BOOST_REQUIRE(queue.pop(value));
+    BOOST_CHECK_EQUAL(value, i);
+  }
+  BOOST_CHECK(queue.pop(value) == false);
+  // wrap around
+  for (size_t round = 0; round < 10; ++round) {
+    BOOST_CHECK(queue.push(round));
+    BOOST_REQUIRE(queue.pop(value));
+    BOOST_CHECK_EQUAL(value, round);
+  }
+  queue.reset(16);
+  BOOST_CHECK_EQUAL(queue.capacity(), 16);
+  BOOST_CHECK(queue.pop(value) == false);
+}
+
+BOOST_AUTO_TEST_CASE(TestConcurrentProducersConsumers)
+{
+  constexpr size_t nProducers = 4;
+  constexpr size_t nConsumers = 4;
+  constexpr size_t nPerProducer = 100000;
+  LockFreeBoundedQueue<size_t> queue(64);
+
+  std::vector<std::atomic<int>> seen(nProducers * nPerProducer);
+  std::atomic<size_t> consumed{0};
+  std::vector<std::thread> threads;
+  for (size_t p = 0; p < nProducers; ++p) {
+    threads.emplace_back([&queue, p]() {
+      for (size_t i = 0; i < nPerProducer; ++i) {
+        while (queue.push(p * nPerProducer + i) == false) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (size_t c = 0; c < nConsumers; ++c) {
+    threads.emplace_back([&queue, &seen, &consumed]() {
+      size_t value;
+      while (consumed.load() < nProducers * nPerProducer) {
+        if (queue.pop(value)) {
+          seen[value]++;
+          consumed++;
+        } else {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  BOOST_CHECK_EQUAL(consumed.load(), nProducers * nPerProducer);
+  size_t wrong = 0;
+  for (auto& s : seen) {
+    wrong += s.load() != 1;
+  }
+  BOOST_CHECK_EQUAL(wrong, 0);
+}
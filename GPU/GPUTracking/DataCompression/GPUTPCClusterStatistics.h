@@ -36,6 +36,7 @@ class GPUTPCClusterStatistics
   static constexpr unsigned int NSLICES = GPUCA_NSLICES;
   void RunStatistics(const o2::tpc::ClusterNativeAccess* clustersNative, const o2::tpc::CompressedClusters* clustersCompressed, const GPUParam& param);
   void Finish();
+  void setNThreads(int n) { mDecoder.setNThreads(n); }
 
  protected:
   template <class T, int I = 0>
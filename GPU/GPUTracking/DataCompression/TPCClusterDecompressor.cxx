@@ -18,7 +18,6 @@
 #include "GPUTPCCompressionTrackModel.h"
 #include <algorithm>
 #include <cstring>
-#include <atomic>
 
 using namespace GPUCA_NAMESPACE::gpu;
 using namespace o2::tpc;
@@ -38,103 +37,131 @@ int TPCClusterDecompressor::decompress(const CompressedClustersFlat* clustersCom
 
 int TPCClusterDecompressor::decompress(const CompressedClusters* clustersCompressed, o2::tpc::ClusterNativeAccess& clustersNative, std::function<o2::tpc::ClusterNative*(size_t)> allocator, const GPUParam& param)
 {
-  std::vector<ClusterNative> clusters[NSLICES][GPUCA_ROW_COUNT];
-  std::atomic_flag locks[NSLICES][GPUCA_ROW_COUNT];
-  for (unsigned int i = 0; i < NSLICES * GPUCA_ROW_COUNT; i++) {
-    (&locks[0][0])[i].clear();
-  }
-  unsigned int offset = 0, lasti = 0;
-  GPUCA_OPENMP(parallel for firstprivate(offset, lasti))
+  // The tracks are split in consecutive blocks, which are decompressed in parallel. The clusters of a block are
+  // then scattered to their slice / row, after those of the preceding blocks. Hence the order of the attached
+  // clusters, and thus the output, does not depend on the number of threads.
+  static constexpr unsigned int NSLICEROWS = NSLICES * GPUCA_ROW_COUNT;
+  std::vector<unsigned int> trackOffsets(clustersCompressed->nTracks + 1);
+  trackOffsets[0] = 0;
   for (unsigned int i = 0; i < clustersCompressed->nTracks; i++) {
-    while (lasti < i) {
-      offset += clustersCompressed->nTrackClusters[lasti++];
-    }
-    lasti++;
-    float zOffset = 0;
-    unsigned int slice = clustersCompressed->sliceA[i];
-    unsigned int row = clustersCompressed->rowA[i];
-    GPUTPCCompressionTrackModel track;
-    unsigned int j;
-    for (j = 0; j < clustersCompressed->nTrackClusters[i]; j++) {
-      unsigned int pad = 0, time = 0;
-      if (j) {
-        unsigned char tmpSlice = clustersCompressed->sliceLegDiffA[offset - i - 1];
-        bool changeLeg = (tmpSlice >= NSLICES);
-        if (changeLeg) {
-          tmpSlice -= NSLICES;
-        }
-        if (clustersCompressed->nComppressionModes & GPUSettings::CompressionDifferences) {
-          slice += tmpSlice;
-          if (slice >= NSLICES) {
-            slice -= NSLICES;
+    trackOffsets[i + 1] = trackOffsets[i] + clustersCompressed->nTrackClusters[i];
+  }
+  const unsigned int nBlocks = std::max(1u, std::min<unsigned int>(4 * mNThreads, clustersCompressed->nTracks));
+  std::vector<std::vector<ClusterNative>> blockClusters(nBlocks);
+  std::vector<std::vector<unsigned short>> blockSliceRows(nBlocks);
+  std::vector<unsigned int> blockCounts(nBlocks * NSLICEROWS, 0);
+  GPUCA_OPENMP(parallel for schedule(dynamic) num_threads(mNThreads))
+  for (unsigned int iBlock = 0; iBlock < nBlocks; iBlock++) {
+    auto& clusterVector = blockClusters[iBlock];
+    auto& sliceRowVector = blockSliceRows[iBlock];
+    unsigned int* counts = &blockCounts[iBlock * NSLICEROWS];
+    const unsigned int firstTrack = (unsigned long)clustersCompressed->nTracks * iBlock / nBlocks;
+    const unsigned int lastTrack = (unsigned long)clustersCompressed->nTracks * (iBlock + 1) / nBlocks;
+    clusterVector.reserve(trackOffsets[lastTrack] - trackOffsets[firstTrack]);
+    sliceRowVector.reserve(trackOffsets[lastTrack] - trackOffsets[firstTrack]);
+    for (unsigned int i = firstTrack; i < lastTrack; i++) {
+      unsigned int offset = trackOffsets[i];
+      float zOffset = 0;
+      unsigned int slice = clustersCompressed->sliceA[i];
+      unsigned int row = clustersCompressed->rowA[i];
+      GPUTPCCompressionTrackModel track;
+      for (unsigned int j = 0; j < clustersCompressed->nTrackClusters[i]; j++) {
+        unsigned int pad = 0, time = 0;
+        if (j) {
+          unsigned char tmpSlice = clustersCompressed->sliceLegDiffA[offset - i - 1];
+          bool changeLeg = (tmpSlice >= NSLICES);
+          if (changeLeg) {
+            tmpSlice -= NSLICES;
+          }
+          if (clustersCompressed->nComppressionModes & GPUSettings::CompressionDifferences) {
+            slice += tmpSlice;
+            if (slice >= NSLICES) {
+              slice -= NSLICES;
+            }
+            row += clustersCompressed->rowDiffA[offset - i - 1];
+            if (row >= GPUCA_ROW_COUNT) {
+              row -= GPUCA_ROW_COUNT;
+            }
+          } else {
+            slice = tmpSlice;
+            row = clustersCompressed->rowDiffA[offset - i - 1];
           }
-          row += clustersCompressed->rowDiffA[offset - i - 1];
-          if (row >= GPUCA_ROW_COUNT) {
-            row -= GPUCA_ROW_COUNT;
+          if (changeLeg && track.Mirror()) {
+            break;
           }
+          if (track.Propagate(param.tpcGeometry.Row2X(row), param.SliceParam[slice].Alpha)) {
+            break;
+          }
+          unsigned int timeTmp = clustersCompressed->timeResA[offset - i - 1];
+          if (timeTmp & 800000) {
+            timeTmp |= 0xFF000000;
+          }
+          time = timeTmp + ClusterNative::packTime(CAMath::Max(0.f, param.tpcGeometry.LinearZ2Time(slice, track.Z() + zOffset)));
+          float tmpPad = CAMath::Max(0.f, CAMath::Min((float)param.tpcGeometry.NPads(GPUCA_ROW_COUNT - 1), param.tpcGeometry.LinearY2Pad(slice, row, track.Y())));
+          pad = clustersCompressed->padResA[offset - i - 1] + ClusterNative::packPad(tmpPad);
         } else {
-          slice = tmpSlice;
-          row = clustersCompressed->rowDiffA[offset - i - 1];
+          time = clustersCompressed->timeA[i];
+          pad = clustersCompressed->padA[i];
         }
-        if (changeLeg && track.Mirror()) {
-          break;
+        clusterVector.emplace_back(time, clustersCompressed->flagsA[offset], pad, clustersCompressed->sigmaTimeA[offset], clustersCompressed->sigmaPadA[offset], clustersCompressed->qMaxA[offset], clustersCompressed->qTotA[offset]);
+        sliceRowVector.emplace_back(slice * GPUCA_ROW_COUNT + row);
+        counts[slice * GPUCA_ROW_COUNT + row]++;
+        auto& cluster = clusterVector.back();
+        float y = param.tpcGeometry.LinearPad2Y(slice, row, cluster.getPad());
+        float z = param.tpcGeometry.LinearTime2Z(slice, cluster.getTime());
+        if (j == 0) {
+          zOffset = z;
+          track.Init(param.tpcGeometry.Row2X(row), y, z - zOffset, param.SliceParam[slice].Alpha, clustersCompressed->qPtA[i], param);
         }
-        if (track.Propagate(param.tpcGeometry.Row2X(row), param.SliceParam[slice].Alpha)) {
+        if (j + 1 < clustersCompressed->nTrackClusters[i] && track.Filter(y, z - zOffset, row)) {
           break;
         }
-        unsigned int timeTmp = clustersCompressed->timeResA[offset - i - 1];
-        if (timeTmp & 800000) {
-          timeTmp |= 0xFF000000;
-        }
-        time = timeTmp + ClusterNative::packTime(CAMath::Max(0.f, param.tpcGeometry.LinearZ2Time(slice, track.Z() + zOffset)));
-        float tmpPad = CAMath::Max(0.f, CAMath::Min((float)param.tpcGeometry.NPads(GPUCA_ROW_COUNT - 1), param.tpcGeometry.LinearY2Pad(slice, row, track.Y())));
-        pad = clustersCompressed->padResA[offset - i - 1] + ClusterNative::packPad(tmpPad);
-      } else {
-        time = clustersCompressed->timeA[i];
-        pad = clustersCompressed->padA[i];
+        offset++;
       }
-      std::vector<ClusterNative>& clusterVector = clusters[slice][row];
-      auto& lock = locks[slice][row];
-      while (lock.test_and_set(std::memory_order_acquire)) {
-      }
-      clusterVector.emplace_back(time, clustersCompressed->flagsA[offset], pad, clustersCompressed->sigmaTimeA[offset], clustersCompressed->sigmaPadA[offset], clustersCompressed->qMaxA[offset], clustersCompressed->qTotA[offset]);
-      auto& cluster = clusterVector.back();
-      float y = param.tpcGeometry.LinearPad2Y(slice, row, cluster.getPad());
-      float z = param.tpcGeometry.LinearTime2Z(slice, cluster.getTime());
-      lock.clear(std::memory_order_release);
-      if (j == 0) {
-        zOffset = z;
-        track.Init(param.tpcGeometry.Row2X(row), y, z - zOffset, param.SliceParam[slice].Alpha, clustersCompressed->qPtA[i], param);
-      }
-      if (j + 1 < clustersCompressed->nTrackClusters[i] && track.Filter(y, z - zOffset, row)) {
-        break;
-      }
-      offset++;
     }
-    offset += clustersCompressed->nTrackClusters[i] - j;
   }
   ClusterNative* clusterBuffer = allocator(clustersCompressed->nAttachedClusters + clustersCompressed->nUnattachedClusters);
   unsigned int offsets[NSLICES][GPUCA_ROW_COUNT];
-  offset = 0;
+  unsigned int nAttached[NSLICES][GPUCA_ROW_COUNT];
+  unsigned int offset = 0;
   for (unsigned int i = 0; i < NSLICES; i++) {
     for (unsigned int j = 0; j < GPUCA_ROW_COUNT; j++) {
-      clustersNative.nClusters[i][j] = clusters[i][j].size() + clustersCompressed->nSliceRowClusters[i * GPUCA_ROW_COUNT + j];
+      nAttached[i][j] = 0;
+      for (unsigned int iBlock = 0; iBlock < nBlocks; iBlock++) {
+        nAttached[i][j] += blockCounts[iBlock * NSLICEROWS + i * GPUCA_ROW_COUNT + j];
+      }
+      clustersNative.nClusters[i][j] = nAttached[i][j] + clustersCompressed->nSliceRowClusters[i * GPUCA_ROW_COUNT + j];
       offsets[i][j] = offset;
       offset += clustersCompressed->nSliceRowClusters[i * GPUCA_ROW_COUNT + j];
     }
   }
   clustersNative.clustersLinear = clusterBuffer;
   clustersNative.setOffsetPtrs();
-  GPUCA_OPENMP(parallel for)
+
+  // turn the counts into the positions of the clusters of each block in the output buffer
+  for (unsigned int sliceRow = 0; sliceRow < NSLICEROWS; sliceRow++) {
+    unsigned int pos = clustersNative.clusterOffset[sliceRow / GPUCA_ROW_COUNT][sliceRow % GPUCA_ROW_COUNT];
+    for (unsigned int iBlock = 0; iBlock < nBlocks; iBlock++) {
+      unsigned int count = blockCounts[iBlock * NSLICEROWS + sliceRow];
+      blockCounts[iBlock * NSLICEROWS + sliceRow] = pos;
+      pos += count;
+    }
+  }
+  GPUCA_OPENMP(parallel for num_threads(mNThreads))
+  for (unsigned int iBlock = 0; iBlock < nBlocks; iBlock++) {
+    unsigned int* positions = &blockCounts[iBlock * NSLICEROWS];
+    for (unsigned int k = 0; k < blockClusters[iBlock].size(); k++) {
+      clusterBuffer[positions[blockSliceRows[iBlock][k]]++] = blockClusters[iBlock][k];
+    }
+  }
+
+  GPUCA_OPENMP(parallel for num_threads(mNThreads))
   for (unsigned int i = 0; i < NSLICES; i++) {
     for (unsigned int j = 0; j < GPUCA_ROW_COUNT; j++) {
       ClusterNative* buffer = &clusterBuffer[clustersNative.clusterOffset[i][j]];
-      if (clusters[i][j].size()) {
-        memcpy((void*)buffer, (const void*)clusters[i][j].data(), clusters[i][j].size() * sizeof(clusterBuffer[0]));
-      }
       unsigned int time = 0;
       unsigned short pad = 0;
-      ClusterNative* cl = buffer + clusters[i][j].size();
+      ClusterNative* cl = buffer + nAttached[i][j];
       unsigned int end = offsets[i][j] + clustersCompressed->nSliceRowClusters[i * GPUCA_ROW_COUNT + j];
       for (unsigned int k = offsets[i][j]; k < end; k++) {
         if (clustersCompressed->nComppressionModes & GPUSettings::CompressionDifferences) {
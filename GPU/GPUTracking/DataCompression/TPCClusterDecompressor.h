@@ -36,7 +36,10 @@ class TPCClusterDecompressor
   int decompress(const o2::tpc::CompressedClustersFlat* clustersCompressed, o2::tpc::ClusterNativeAccess& clustersNative, std::function<o2::tpc::ClusterNative*(size_t)> allocator, const GPUParam& param);
   int decompress(const o2::tpc::CompressedClusters* clustersCompressed, o2::tpc::ClusterNativeAccess& clustersNative, std::function<o2::tpc::ClusterNative*(size_t)> allocator, const GPUParam& param);
 
+  void setNThreads(int n) { mNThreads = n > 0 ? n : 1; }
+
  protected:
+  int mNThreads = 1;
 };
 } // namespace GPUCA_NAMESPACE::gpu
 
@@ -0,0 +1,164 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file testTPCClusterDecompressor.cxx
+/// \brief Test that the decompressed clusters do not depend on the number of threads
+
+#define BOOST_TEST_MODULE Test TPC Cluster Decompressor
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <vector>
+#include "DataFormatsTPC/ClusterNative.h"
+#include "DataFormatsTPC/CompressedClusters.h"
+#include "GPUParam.h"
+#include "GPUSettings.h"
+#include "TPCClusterDecompressor.h"
+
+namespace o2::gpu
+{
+
+/// Random compressed clusters, with the arrays of the attached and unattached clusters filled consistently
+struct CompressedClustersBuffer {
+  std::vector<unsigned short> qTotA, qMaxA, padResA, padA, nTrackClusters, qTotU, qMaxU, padDiffU;
+  std::vector<unsigned char> flagsA, rowDiffA, sliceLegDiffA, sigmaPadA, sigmaTimeA, qPtA, rowA, sliceA, flagsU, sigmaPadU, sigmaTimeU;
+  std::vector<unsigned int> timeResA, timeA, timeDiffU, nSliceRowClusters;
+  o2::tpc::CompressedClusters clusters;
+
+  CompressedClustersBuffer(unsigned char compressionModes)
+  {
+    constexpr unsigned int NSLICES = TPCClusterDecompressor::NSLICES;
+    std::mt19937 gen(compressionModes);
+    auto random = [&gen](unsigned int min, unsigned int max) { return std::uniform_int_distribution<unsigned int>(min, max)(gen); };
+    const bool differences = compressionModes & GPUSettings::CompressionDifferences;
+
+    const unsigned int nTracks = 2000;
+    for (unsigned int i = 0; i < nTracks; i++) {
+      nTrackClusters.push_back(random(1, 40));
+      qPtA.push_back(random(0, 255));
+      rowA.push_back(random(0, GPUCA_ROW_COUNT - 1));
+      sliceA.push_back(random(0, NSLICES - 1));
+      timeA.push_back(random(0, 400 * 64));
+      padA.push_back(random(0, 60 * 64));
+      unsigned int row = rowA.back();
+      for (unsigned int j = 0; j < nTrackClusters.back(); j++) {
+        qTotA.push_back(random(10, 1000));
+        qMaxA.push_back(random(5, 200));
+        flagsA.push_back(random(0, 3));
+        sigmaPadA.push_back(random(0, 255));
+        sigmaTimeA.push_back(random(0, 255));
+        if (j) {
+          // mostly small steps along the track, sometimes a change of leg
+          sliceLegDiffA.push_back(random(0, 20) ? (differences ? 0 : sliceA.back()) : random(NSLICES, 2 * NSLICES - 1));
+          row = differences ? random(0, 2) : std::min<unsigned int>(row + random(0, 2), GPUCA_ROW_COUNT - 1);
+          rowDiffA.push_back(row);
+          padResA.push_back(random(0, 40) - 20);
+          timeResA.push_back(random(0, 40) - 20);
+        }
+      }
+    }
+    for (unsigned int i = 0; i < NSLICES * GPUCA_ROW_COUNT; i++) {
+      nSliceRowClusters.push_back(random(0, 3));
+      for (unsigned int k = 0; k < nSliceRowClusters.back(); k++) {
+        qTotU.push_back(random(10, 1000));
+        qMaxU.push_back(random(5, 200));
+        flagsU.push_back(random(0, 3));
+        padDiffU.push_back(differences ? random(0, 64 * 4) : random(0, 60 * 64));
+        timeDiffU.push_back(differences ? random(0, 64 * 4) : random(0, 400 * 64));
+        sigmaPadU.push_back(random(0, 255));
+        sigmaTimeU.push_back(random(0, 255));
+      }
+    }
+
+    clusters.nTracks = nTracks;
+    clusters.nAttachedClusters = qTotA.size();
+    clusters.nUnattachedClusters = qTotU.size();
+    clusters.nAttachedClustersReduced = clusters.nAttachedClusters - nTracks;
+    clusters.nSliceRows = NSLICES * GPUCA_ROW_COUNT;
+    clusters.nComppressionModes = compressionModes;
+    clusters.qTotA = qTotA.data();
+    clusters.qMaxA = qMaxA.data();
+    clusters.flagsA = flagsA.data();
+    clusters.rowDiffA = rowDiffA.data();
+    clusters.sliceLegDiffA = sliceLegDiffA.data();
+    clusters.padResA = padResA.data();
+    clusters.timeResA = timeResA.data();
+    clusters.sigmaPadA = sigmaPadA.data();
+    clusters.sigmaTimeA = sigmaTimeA.data();
+    clusters.qPtA = qPtA.data();
+    clusters.rowA = rowA.data();
+    clusters.sliceA = sliceA.data();
+    clusters.timeA = timeA.data();
+    clusters.padA = padA.data();
+    clusters.qTotU = qTotU.data();
+    clusters.qMaxU = qMaxU.data();
+    clusters.flagsU = flagsU.data();
+    clusters.padDiffU = padDiffU.data();
+    clusters.timeDiffU = timeDiffU.data();
+    clusters.sigmaPadU = sigmaPadU.data();
+    clusters.sigmaTimeU = sigmaTimeU.data();
+    clusters.nTrackClusters = nTrackClusters.data();
+    clusters.nSliceRowClusters = nSliceRowClusters.data();
+  }
+};
+
+void decompress(const o2::tpc::CompressedClusters& compressed, const GPUParam& param, int nThreads, o2::tpc::ClusterNativeAccess& access, std::vector<o2::tpc::ClusterNative>& buffer)
+{
+  TPCClusterDecompressor decompressor;
+  decompressor.setNThreads(nThreads);
+  auto allocator = [&buffer](size_t size) {
+    buffer.resize(size);
+    return buffer.data();
+  };
+  BOOST_REQUIRE_EQUAL(decompressor.decompress(&compressed, access, allocator, param), 0);
+}
+
+/// \brief Test that the decompression with several threads gives the same clusters as with a single one
+BOOST_AUTO_TEST_CASE(TPCClusterDecompressor_threads)
+{
+  GPUParam param;
+  param.SetDefaults(-5.00668f);
+
+  for (unsigned char compressionModes : {0, int(GPUSettings::CompressionFull)}) {
+    CompressedClustersBuffer compressed(compressionModes);
+    o2::tpc::ClusterNativeAccess reference;
+    std::vector<o2::tpc::ClusterNative> referenceBuffer;
+    decompress(compressed.clusters, param, 1, reference, referenceBuffer);
+    BOOST_REQUIRE(reference.nClustersTotal > compressed.clusters.nUnattachedClusters);
+
+    for (int nThreads : {2, 4, 7}) {
+      o2::tpc::ClusterNativeAccess access;
+      std::vector<o2::tpc::ClusterNative> buffer;
+      decompress(compressed.clusters, param, nThreads, access, buffer);
+      BOOST_REQUIRE_EQUAL(access.nClustersTotal, reference.nClustersTotal);
+      for (unsigned int i = 0; i < TPCClusterDecompressor::NSLICES; i++) {
+        for (unsigned int j = 0; j < GPUCA_ROW_COUNT; j++) {
+          BOOST_REQUIRE_EQUAL(access.nClusters[i][j], reference.nClusters[i][j]);
+          BOOST_CHECK_EQUAL(access.clusterOffset[i][j], reference.clusterOffset[i][j]);
+        }
+      }
+      for (unsigned int k = 0; k < reference.nClustersTotal; k++) {
+        const auto& cl = access.clustersLinear[k];
+        const auto& ref = reference.clustersLinear[k];
+        BOOST_CHECK_EQUAL(cl.timeFlagsPacked, ref.timeFlagsPacked);
+        BOOST_CHECK_EQUAL(cl.padPacked, ref.padPacked);
+        BOOST_CHECK_EQUAL(int(cl.sigmaTimePacked), int(ref.sigmaTimePacked));
+        BOOST_CHECK_EQUAL(int(cl.sigmaPadPacked), int(ref.sigmaPadPacked));
+        BOOST_CHECK_EQUAL(cl.qMax, ref.qMax);
+        BOOST_CHECK_EQUAL(cl.qTot, ref.qTot);
+      }
+    }
+  }
+}
+
+} // namespace o2::gpu
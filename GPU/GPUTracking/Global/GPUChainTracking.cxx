@@ -635,6 +635,7 @@ int GPUChainTracking::RunChainFinalize()
 #ifdef GPUCA_HAVE_O2HEADERS
   if (mIOPtrs.clustersNative && (GetRecoSteps() & RecoStep::TPCCompression) && GetProcessingSettings().runCompressionStatistics) {
     CompressedClusters c = *mIOPtrs.tpcCompressedClusters;
+    mCompressionStatistics->setNThreads(GetProcessingSettings().ompThreads);
     mCompressionStatistics->RunStatistics(mIOPtrs.clustersNative, &c, param());
   }
 #endif
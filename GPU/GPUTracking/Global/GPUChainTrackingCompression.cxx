@@ -208,6 +208,7 @@ int GPUChainTracking::RunTPCDecompression()
 #ifdef GPUCA_HAVE_O2HEADERS
   const auto& threadContext = GetThreadContext();
   TPCClusterDecompressor decomp;
+  decomp.setNThreads(GetProcessingSettings().ompThreads);
   auto allocator = [this](size_t size) {
     this->mInputsHost->mNClusterNative = this->mInputsShadow->mNClusterNative = size;
     this->AllocateRegisteredMemory(this->mInputsHost->mResourceClusterNativeOutput, this->mSubOutputControls[GPUTrackingOutputs::getIndex(&GPUTrackingOutputs::clustersNative)]);
@@ -148,8 +148,8 @@ header::Stack Dispatcher::extractAdditionalHeaders(const char* inputHeaderStack)
 
 void Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, Output&& output) const
 {
-  const auto* inputHeader = header::get<header::DataHeader*>(inputData.header);
-  dataAllocator.snapshot(output, inputData.payload, inputHeader->payloadSize, inputHeader->payloadSerializationMethod);
+  // the payload is shared with the input message, it is not copied unless the transports differ
+  dataAllocator.forward(output, inputData);
 }
 
 void Dispatcher::registerPolicy(std::unique_ptr<DataSamplingPolicy>&& policy)
@@ -0,0 +1,165 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file dataSamplingRawBenchmark.cxx
+/// \brief Measures the throughput of Data Sampling of large TPC and ITS raw payloads, as produced on the FLPs.
+/// Run it with the shared memory transport, e.g.:
+/// o2-datasampling-raw-benchmark -b --shm-segment-size 20000000000 --sampling-fraction 1.0 --test-duration 60
+
+#include "Framework/ConfigParamSpec.h"
+#include "DataSampling/DataSampling.h"
+#include "Framework/CompletionPolicyHelpers.h"
+#include <vector>
+#include <filesystem>
+#include <fstream>
+
+using namespace o2::framework;
+using namespace o2::utilities;
+
+void customize(std::vector<CompletionPolicy>& policies)
+{
+  DataSampling::CustomizeInfrastructure(policies);
+  policies.push_back(CompletionPolicyHelpers::defineByName("rawDataSink", CompletionPolicy::CompletionOp::Consume));
+}
+
+void customize(std::vector<ChannelConfigurationPolicy>& policies)
+{
+  DataSampling::CustomizeInfrastructure(policies);
+}
+
+// we need to add workflow options before including Framework/runDataProcessing
+void customize(std::vector<ConfigParamSpec>& workflowOptions)
+{
+  workflowOptions.push_back(ConfigParamSpec{"sampling-fraction", VariantType::Double, 1.0, {"sampling fraction"}});
+  workflowOptions.push_back(ConfigParamSpec{"tpc-payload-size", VariantType::Int, 32000000, {"payload size of the TPC raw data producers"}});
+  workflowOptions.push_back(ConfigParamSpec{"its-payload-size", VariantType::Int, 8000000, {"payload size of the ITS raw data producers"}});
+  workflowOptions.push_back(ConfigParamSpec{"producers", VariantType::Int, 1, {"number of producers per detector"}});
+  workflowOptions.push_back(ConfigParamSpec{"dispatchers", VariantType::Int, 1, {"number of dispatchers"}});
+  workflowOptions.push_back(ConfigParamSpec{"usleep", VariantType::Int, 10000, {"usleep time of producers"}});
+  workflowOptions.push_back(ConfigParamSpec{"test-duration", VariantType::Int, 60, {"how long should the test run (in seconds, max. 2147)"}});
+}
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+#include "Headers/DataHeader.h"
+#include "Framework/ControlService.h"
+#include "DataSampling/DataSamplingPolicy.h"
+#include "Framework/runDataProcessing.h"
+
+using SubSpec = o2::header::DataHeader::SubSpecificationType;
+
+namespace
+{
+struct SinkStatistics {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  size_t messages = 0;
+  size_t bytes = 0;
+};
+
+DataProcessorSpec getRawProducer(o2::header::DataOrigin origin, SubSpec subSpec, size_t payloadSize, size_t usleepTime)
+{
+  std::string name = std::string("rawProducer") + origin.as<std::string>() + std::to_string(subSpec);
+  return DataProcessorSpec{
+    name,
+    Inputs{},
+    Outputs{{origin, "RAWDATA", subSpec}},
+    AlgorithmSpec{(AlgorithmSpec::ProcessCallback)[=](ProcessingContext& pctx) {
+      usleep(usleepTime);
+      // the payload is written to make sure that its pages are really allocated
+      auto data = pctx.outputs().make<char>(Output{origin, "RAWDATA", subSpec}, payloadSize);
+      memset(data.data(), static_cast<int>(subSpec & 0xff), payloadSize);
+    }}};
+}
+} // namespace
+
+// clang-format off
+WorkflowSpec defineDataProcessing(ConfigContext const& config)
+{
+  double samplingFraction = config.options().get<double>("sampling-fraction");
+  size_t tpcPayloadSize = config.options().get<int>("tpc-payload-size");
+  size_t itsPayloadSize = config.options().get<int>("its-payload-size");
+  size_t producers = config.options().get<int>("producers");
+  size_t dispatchers = config.options().get<int>("dispatchers");
+  size_t usleepTime = config.options().get<int>("usleep");
+  size_t testDuration = config.options().get<int>("test-duration");
+
+  std::string configurationPath = "/tmp/dataSamplingRawBenchmark-" + std::to_string(samplingFraction) + ".json";
+  std::string configuration =
+    "{\n"
+    "  \"dataSamplingPolicies\": [\n"
+    "    {\n"
+    "      \"id\": \"rawbench\",\n"
+    "      \"active\": \"true\",\n"
+    "      \"machines\": [],\n"
+    "      \"query\": \"tpc:TPC/RAWDATA;its:ITS/RAWDATA\",\n"
+    "      \"samplingConditions\": [\n"
+    "        {\n"
+    "          \"condition\": \"random\",\n"
+    "          \"fraction\": \"" + std::to_string(samplingFraction) + "\",\n"
+    "          \"seed\": \"22222\"\n"
+    "        }\n"
+    "      ],\n"
+    "      \"blocking\": \"false\"\n"
+    "    }\n"
+    "  ]\n"
+    "}";
+
+  if (!std::filesystem::exists(configurationPath)) {
+    std::ofstream configurationFile(configurationPath);
+    configurationFile << configuration;
+    configurationFile.close();
+  }
+
+  WorkflowSpec specs;
+  for (size_t p = 0; p < producers; p++) {
+    specs.push_back(getRawProducer("TPC", static_cast<SubSpec>(p), tpcPayloadSize, usleepTime));
+    specs.push_back(getRawProducer("ITS", static_cast<SubSpec>(p), itsPayloadSize, usleepTime));
+  }
+
+  DataSampling::GenerateInfrastructure(specs, "json:/" + configurationPath, dispatchers);
+
+  DataProcessorSpec rawDataSink{
+    "rawDataSink",
+    Inputs{{"tpc", {DataSamplingPolicy::createPolicyDataOrigin(), DataSamplingPolicy::createPolicyDataDescription("rawbench", 0)}},
+           {"its", {DataSamplingPolicy::createPolicyDataOrigin(), DataSamplingPolicy::createPolicyDataDescription("rawbench", 1)}},
+           {"test-timer", "TST", "TIMER", 0, Lifetime::Timer}},
+    Outputs{},
+    AlgorithmSpec{
+      (AlgorithmSpec::InitCallback) [](InitContext&) {
+        auto statistics = std::make_shared<SinkStatistics>();
+        return (AlgorithmSpec::ProcessCallback) [statistics](ProcessingContext& ctx) {
+          for (auto&& input : {"tpc", "its"}) {
+            if (ctx.inputs().isValid(input)) {
+              auto ref = ctx.inputs().get(input);
+              statistics->messages++;
+              statistics->bytes += o2::header::get<o2::header::DataHeader*>(ref.header)->payloadSize;
+            }
+          }
+          if (ctx.inputs().isValid("test-timer")) {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - statistics->start;
+            LOG(INFO) << "Received " << statistics->messages << " sampled raw data messages, "
+                      << statistics->bytes / elapsed.count() / 1e6 << " MB/s";
+            ctx.services().get<ControlService>().readyToQuit(QuitRequest::All);
+          }
+        };
+      }
+    },
+    Options{
+      { "period-test-timer", VariantType::Int, static_cast<int>(testDuration * 1000000), { "timer period" }}
+    }
+  };
+
+  specs.push_back(rawDataSink);
+  return specs;
+}
+// clang-format on
@@ -0,0 +1,157 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef ALICEO2_FLATHISTOGRAM_H
+#define ALICEO2_FLATHISTOGRAM_H
+
+/// \file FlatHistogram.h
+/// \brief Definition of FlatHistogram, a mergeable histogram with a flat binary wire format
+///
+/// Layout of a message (all the arrays start at 8-byte aligned offsets):
+/// Header
+/// Axis[dimensions]
+/// bin edges of the axes with variable binning, Axis::nEdges doubles for each axis
+/// class name, name and title characters, padded to 8 bytes
+/// Dense encoding: the contents of all Header::nCells cells, followed by their sum of squares of weights if present
+/// Sparse encoding: Header::nStored cell indices, sorted, followed by their contents and sums of squares of weights
+///
+/// The cell index is the global bin number of TH1, TH2 and TH3 and the linearised bin coordinates (under- and overflow
+/// included) of THn and THnSparse. Messages may contain full histograms or differences w.r.t. a previous snapshot,
+/// both are merged by adding the bin arrays.
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TObject;
+class TAxis;
+
+namespace o2::mergers
+{
+
+class FlatHistogram
+{
+ public:
+  static constexpr uint32_t Magic = 0x48464f32; // "2OFH"
+  static constexpr uint16_t Version = 1;
+  static constexpr size_t NStats = 13; // size of the TH1 statistics array, enough for TH3
+
+  enum class Encoding : uint8_t {
+    Dense,
+    Sparse,
+    Auto // the smaller of the two
+  };
+
+  enum Flags : uint32_t {
+    HasSumw2 = 0x1,   // sums of squares of weights are stored
+    IsSparseHn = 0x2, // the histogram is a THnSparse, kept sparse also in memory
+    IsHn = 0x4        // the histogram is a THn or a THnSparse, otherwise a TH1, TH2 or TH3
+  };
+
+  struct Header {
+    uint32_t magic = Magic;
+    uint16_t version = Version;
+    uint8_t encoding = 0;
+    uint8_t dimensions = 0;
+    uint32_t flags = 0;
+    uint32_t classNameSize = 0;
+    uint32_t nameSize = 0;
+    uint32_t titleSize = 0;
+    uint64_t nCells = 0;  // number of cells of the histogram, including under- and overflows
+    uint64_t nStored = 0; // number of stored cells
+    double entries = 0;
+    std::array<double, NStats> stats{}; // TH1 statistics (sums of weights), zeros for THn
+  };
+
+  struct Axis {
+    int32_t nBins = 0;
+    uint32_t nEdges = 0; // nBins + 1 for variable binning, 0 otherwise
+    double min = 0;
+    double max = 0;
+  };
+
+  FlatHistogram() = default;
+
+  /// \brief Copies the binning and the contents of a TH1, TH2, TH3, THn or THnSparse, throws for other types.
+  explicit FlatHistogram(const TObject& histogram);
+
+  /// \brief Checks if the buffer starts with a FlatHistogram header.
+  static bool isFlatHistogram(const char* data, size_t size);
+  /// \brief Creates a histogram from a message, throws if the message is not valid.
+  static FlatHistogram decode(const char* data, size_t size);
+
+  /// \brief Adds the contents of a message with the same binning, without creating an intermediate object.
+  void merge(const char* data, size_t size);
+  /// \brief Adds the contents of a histogram with the same binning.
+  void merge(const FlatHistogram& other);
+  /// \brief Sets all the contents and statistics to zero, keeping the binning.
+  void reset();
+
+  /// \brief Size of the message produced by encode()
+  size_t getEncodedSize(Encoding encoding = Encoding::Auto) const;
+  /// \brief Writes the message into a buffer of getEncodedSize(encoding) bytes.
+  void encode(char* buffer, Encoding encoding = Encoding::Auto) const;
+  std::vector<char> encode(Encoding encoding = Encoding::Auto) const;
+  /// \brief Creates the message with the differences w.r.t. a previous snapshot of the same histogram.
+  /// Only the changed cells are stored, unless the dense encoding is smaller.
+  std::vector<char> encodeDelta(const FlatHistogram& previous) const;
+
+  /// \brief Creates the ROOT histogram with the current contents.
+  std::unique_ptr<TObject> toROOT() const;
+
+  const std::string& getClassName() const { return mClassName; }
+  const std::string& getName() const { return mName; }
+  const std::string& getTitle() const { return mTitle; }
+  size_t getDimensions() const { return mAxes.size(); }
+  uint64_t getNCells() const { return mNCells; }
+  double getEntries() const { return mEntries; }
+  bool isSparse() const { return mFlags & IsSparseHn; }
+  /// \brief Number of cells held in memory: all the cells for dense histograms, the filled ones for THnSparse.
+  size_t getNStored() const { return mContents.size(); }
+  /// \brief Content of the cell, the index being defined as in the message
+  double getCellContent(uint64_t cell) const;
+
+ private:
+  struct View; // message being decoded
+
+  static View parse(const char* data, size_t size);
+  void init(const View& view);
+  void merge(const View& other);
+  void checkCompatible(const View& other) const;
+  void addAxis(const TAxis* axis);
+  void addCell(uint64_t cell, double content, double sumw2);
+  uint64_t getHnCell(const int* coordinates) const;
+  void getHnCoordinates(uint64_t cell, int* coordinates) const;
+  size_t getNonZeroCells() const;
+  size_t getPrefixSize() const;
+  Encoding resolveEncoding(Encoding encoding) const;
+
+  std::string mClassName;
+  std::string mName;
+  std::string mTitle;
+  std::vector<Axis> mAxes;
+  std::vector<std::vector<double>> mEdges; // per axis, empty for fixed binning
+  uint32_t mFlags = 0;
+  uint64_t mNCells = 0;
+  double mEntries = 0;
+  std::array<double, NStats> mStats{};
+  std::vector<double> mContents;                       // all cells, or the filled ones for THnSparse
+  std::vector<double> mSumw2;                          // same layout as mContents, empty if not used
+  std::vector<uint64_t> mCells;                        // THnSparse only: cell indices of mContents
+  std::unordered_map<uint64_t, size_t> mCellPositions; // THnSparse only: position of a cell in mContents
+};
+
+} // namespace o2::mergers
+
+#endif //ALICEO2_FLATHISTOGRAM_H
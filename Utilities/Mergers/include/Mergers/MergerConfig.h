@@ -43,6 +43,11 @@ enum class PublicationDecision {
   EachNSeconds,       // Merged object is published each N seconds.
 };
 
+enum class PublishedObjectFormat {
+  ROOT, // Merged objects are published ROOT-serialized.
+  Flat  // Merged FlatHistograms are published in their binary format, other objects are ROOT-serialized.
+};
+
 enum class TopologySize {
   NumberOfLayers, // User specifies the number of layers in topology.
   ReductionFactor // User specifies how many sources should be handled by one merger (by maximum).
@@ -59,6 +64,7 @@ struct MergerConfig {
   ConfigEntry<InputObjectsTimespan> inputObjectTimespan = {InputObjectsTimespan::FullHistory};
   ConfigEntry<MergedObjectTimespan> mergedObjectTimespan = {MergedObjectTimespan::FullHistory};
   ConfigEntry<PublicationDecision> publicationDecision = {PublicationDecision::EachNSeconds, 10};
+  ConfigEntry<PublishedObjectFormat> publishedObjectFormat = {PublishedObjectFormat::ROOT};
   ConfigEntry<TopologySize, int> topologySize = {TopologySize::NumberOfLayers, 1};
   std::string monitoringUrl = "infologger:///debug?qc";
 };
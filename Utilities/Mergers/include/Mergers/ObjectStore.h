@@ -27,15 +27,18 @@ namespace o2::mergers
 {
 
 class MergeInterface;
+class FlatHistogram;
 
 using TObjectPtr = std::shared_ptr<TObject>;
 using MergeInterfacePtr = std::shared_ptr<MergeInterface>;
-using ObjectStore = std::variant<std::monostate, TObjectPtr, MergeInterfacePtr>;
+using FlatHistogramPtr = std::shared_ptr<FlatHistogram>;
+using ObjectStore = std::variant<std::monostate, TObjectPtr, MergeInterfacePtr, FlatHistogramPtr>;
 
 namespace object_store_helpers
 {
 
-/// \brief Takes a DataRef, deserializes it (if type is supported) and puts into an ObjectStore
+/// \brief Takes a DataRef, deserializes it (if type is supported) and puts into an ObjectStore.
+/// Non-serialized payloads in the FlatHistogram format are decoded without ROOT.
 ObjectStore extractObjectFrom(const framework::DataRef& ref);
 
 } // namespace object_store_helpers
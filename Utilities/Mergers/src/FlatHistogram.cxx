@@ -0,0 +1,651 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FlatHistogram.cxx
+/// \brief Implementation of FlatHistogram, a mergeable histogram with a flat binary wire format
+
+#include "Mergers/FlatHistogram.h"
+
+#include <TClass.h>
+#include <TH1.h>
+#include <TH2.h>
+#include <TH3.h>
+#include <THn.h>
+#include <THnSparse.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+namespace o2::mergers
+{
+
+struct FlatHistogram::View {
+  const Header* header = nullptr;
+  const Axis* axes = nullptr;
+  const double* edges = nullptr; // edges of all the axes with variable binning, one after another
+  std::string_view className;
+  std::string_view name;
+  std::string_view title;
+  uint64_t nStored = 0;
+  const uint64_t* cells = nullptr; // sparse encoding only
+  const double* contents = nullptr;
+  const double* sumw2 = nullptr; // nullptr if not stored
+};
+
+namespace
+{
+const std::string errorPrefix = "Could not decode FlatHistogram: ";
+
+size_t alignTo8(size_t size)
+{
+  return (size + 7) & ~size_t(7);
+}
+
+// The arrays of the message are read in place, only a misaligned buffer is copied.
+const char* alignBuffer(const char* data, size_t size, std::vector<uint64_t>& storage)
+{
+  if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) == 0) {
+    return data;
+  }
+  storage.resize(alignTo8(size) / sizeof(uint64_t));
+  std::memcpy(storage.data(), data, size);
+  return reinterpret_cast<const char*>(storage.data());
+}
+
+// Written with restrict-qualified pointers and no dependencies between the iterations, so that it is vectorized.
+void addArrays(double* __restrict target, const double* __restrict other, size_t size)
+{
+  for (size_t i = 0; i < size; i++) {
+    target[i] += other[i];
+  }
+}
+
+template <typename HnT>
+bool createHn(const std::string& className, std::unique_ptr<THnBase>& hn, const char* name, const char* title,
+              int dim, const int* nBins, const double* min, const double* max)
+{
+  if (className != HnT::Class()->GetName()) {
+    return false;
+  }
+  hn = std::make_unique<HnT>(name, title, dim, nBins, min, max);
+  return true;
+}
+} // namespace
+
+FlatHistogram::FlatHistogram(const TObject& histogram)
+  : mClassName(histogram.ClassName()),
+    mName(histogram.GetName()),
+    mTitle(histogram.GetTitle())
+{
+  if (auto h = dynamic_cast<const TH1*>(&histogram)) {
+    // profiles and polygonal bins are not merged by adding the bin contents
+    if (h->InheritsFrom("TProfile") || h->InheritsFrom("TProfile2D") || h->InheritsFrom("TProfile3D") || h->InheritsFrom("TH2Poly")) {
+      throw std::runtime_error("Object with type '" + mClassName + "' cannot be converted to FlatHistogram.");
+    }
+    addAxis(h->GetXaxis());
+    if (h->GetDimension() > 1) {
+      addAxis(h->GetYaxis());
+    }
+    if (h->GetDimension() > 2) {
+      addAxis(h->GetZaxis());
+    }
+    mNCells = h->GetNcells();
+    mContents.resize(mNCells);
+    for (uint64_t cell = 0; cell < mNCells; cell++) {
+      mContents[cell] = h->GetBinContent(cell);
+    }
+    if (h->GetSumw2N() > 0) {
+      mFlags |= HasSumw2;
+      mSumw2.assign(h->GetSumw2()->GetArray(), h->GetSumw2()->GetArray() + mNCells);
+    }
+    mEntries = h->GetEntries();
+    h->GetStats(mStats.data());
+
+  } else if (auto hn = dynamic_cast<const THnBase*>(&histogram)) {
+    mFlags |= IsHn;
+    if (hn->InheritsFrom(THnSparse::Class())) {
+      mFlags |= IsSparseHn;
+    }
+    mNCells = 1;
+    for (int dim = 0; dim < hn->GetNdimensions(); dim++) {
+      addAxis(hn->GetAxis(dim));
+      uint64_t nCells = mAxes.back().nBins + 2;
+      if (mNCells > std::numeric_limits<uint64_t>::max() / nCells) {
+        throw std::runtime_error("Object '" + mName + "' has too many bins to be converted to FlatHistogram.");
+      }
+      mNCells *= nCells;
+    }
+    if (hn->GetCalculateErrors()) {
+      mFlags |= HasSumw2;
+    }
+    if (!isSparse()) {
+      mContents.assign(mNCells, 0);
+      if (mFlags & HasSumw2) {
+        mSumw2.assign(mNCells, 0);
+      }
+    }
+    std::vector<int> coordinates(mAxes.size());
+    for (Long64_t bin = 0; bin < hn->GetNbins(); bin++) {
+      double content = hn->GetBinContent(bin, coordinates.data());
+      addCell(getHnCell(coordinates.data()), content, (mFlags & HasSumw2) ? hn->GetBinError2(bin) : 0.);
+    }
+    mEntries = hn->GetEntries();
+
+  } else {
+    throw std::runtime_error("Object with type '" + mClassName + "' cannot be converted to FlatHistogram.");
+  }
+}
+
+void FlatHistogram::addAxis(const TAxis* axis)
+{
+  Axis flat;
+  flat.nBins = axis->GetNbins();
+  flat.min = axis->GetXmin();
+  flat.max = axis->GetXmax();
+  const auto* edges = axis->GetXbins();
+  if (edges->GetSize() > 0) {
+    flat.nEdges = edges->GetSize();
+    mEdges.emplace_back(edges->GetArray(), edges->GetArray() + edges->GetSize());
+  } else {
+    mEdges.emplace_back();
+  }
+  mAxes.push_back(flat);
+}
+
+uint64_t FlatHistogram::getHnCell(const int* coordinates) const
+{
+  uint64_t cell = 0;
+  for (size_t dim = mAxes.size(); dim-- > 0;) {
+    cell = cell * (mAxes[dim].nBins + 2) + coordinates[dim];
+  }
+  return cell;
+}
+
+void FlatHistogram::getHnCoordinates(uint64_t cell, int* coordinates) const
+{
+  for (size_t dim = 0; dim < mAxes.size(); dim++) {
+    coordinates[dim] = cell % (mAxes[dim].nBins + 2);
+    cell /= (mAxes[dim].nBins + 2);
+  }
+}
+
+bool FlatHistogram::isFlatHistogram(const char* data, size_t size)
+{
+  uint32_t magic = 0;
+  if (data == nullptr || size < sizeof(Header)) {
+    return false;
+  }
+  std::memcpy(&magic, data, sizeof(magic));
+  return magic == Magic;
+}
+
+FlatHistogram::View FlatHistogram::parse(const char* data, size_t size)
+{
+  if (!isFlatHistogram(data, size)) {
+    throw std::runtime_error(errorPrefix + "the message does not start with a FlatHistogram header");
+  }
+  View view;
+  view.header = reinterpret_cast<const Header*>(data);
+  const auto& header = *view.header;
+  if (header.version != Version) {
+    throw std::runtime_error(errorPrefix + "unsupported version " + std::to_string(header.version));
+  }
+  if (header.dimensions == 0 || header.encoding > uint8_t(Encoding::Sparse)) {
+    throw std::runtime_error(errorPrefix + "corrupted header");
+  }
+  size_t pos = sizeof(Header);
+  auto require = [&](size_t bytes) {
+    if (bytes > size - pos) {
+      throw std::runtime_error(errorPrefix + "the message is truncated");
+    }
+  };
+
+  require(header.dimensions * sizeof(Axis));
+  view.axes = reinterpret_cast<const Axis*>(data + pos);
+  pos += header.dimensions * sizeof(Axis);
+  size_t nEdges = 0;
+  for (int dim = 0; dim < header.dimensions; dim++) {
+    const auto& axis = view.axes[dim];
+    if (axis.nBins <= 0 || (axis.nEdges != 0 && axis.nEdges != uint64_t(axis.nBins) + 1)) {
+      throw std::runtime_error(errorPrefix + "corrupted axis " + std::to_string(dim));
+    }
+    nEdges += axis.nEdges;
+  }
+  require(nEdges * sizeof(double));
+  view.edges = reinterpret_cast<const double*>(data + pos);
+  pos += nEdges * sizeof(double);
+
+  size_t stringsSize = size_t(header.classNameSize) + header.nameSize + header.titleSize;
+  require(alignTo8(stringsSize));
+  view.className = std::string_view(data + pos, header.classNameSize);
+  view.name = std::string_view(data + pos + header.classNameSize, header.nameSize);
+  view.title = std::string_view(data + pos + header.classNameSize + header.nameSize, header.titleSize);
+  pos += alignTo8(stringsSize);
+
+  bool sparse = header.encoding == uint8_t(Encoding::Sparse);
+  bool hasSumw2 = header.flags & HasSumw2;
+  view.nStored = sparse ? header.nStored : header.nCells;
+  size_t bytesPerCell = sizeof(double) * (hasSumw2 ? 2 : 1) + (sparse ? sizeof(uint64_t) : 0);
+  if (view.nStored > (size - pos) / bytesPerCell) {
+    throw std::runtime_error(errorPrefix + "the message is truncated");
+  }
+  if (sparse) {
+    view.cells = reinterpret_cast<const uint64_t*>(data + pos);
+    pos += view.nStored * sizeof(uint64_t);
+  }
+  view.contents = reinterpret_cast<const double*>(data + pos);
+  pos += view.nStored * sizeof(double);
+  if (hasSumw2) {
+    view.sumw2 = reinterpret_cast<const double*>(data + pos);
+  }
+  return view;
+}
+
+FlatHistogram FlatHistogram::decode(const char* data, size_t size)
+{
+  std::vector<uint64_t> alignedStorage;
+  auto view = parse(alignBuffer(data, size, alignedStorage), size);
+  FlatHistogram histogram;
+  histogram.init(view);
+  histogram.merge(view);
+  return histogram;
+}
+
+void FlatHistogram::init(const View& view)
+{
+  const auto& header = *view.header;
+  mClassName = view.className;
+  mName = view.name;
+  mTitle = view.title;
+  mFlags = header.flags;
+  mNCells = header.nCells;
+  mAxes.assign(view.axes, view.axes + header.dimensions);
+  mEdges.clear();
+  const double* edges = view.edges;
+  for (const auto& axis : mAxes) {
+    mEdges.emplace_back(edges, edges + axis.nEdges);
+    edges += axis.nEdges;
+  }
+  mCells.clear();
+  mCellPositions.clear();
+  if (isSparse()) {
+    mContents.clear();
+    mSumw2.clear();
+  } else {
+    mContents.assign(mNCells, 0);
+    mSumw2.assign((mFlags & HasSumw2) ? mNCells : 0, 0);
+  }
+  mEntries = 0;
+  mStats.fill(0);
+}
+
+void FlatHistogram::checkCompatible(const View& other) const
+{
+  const auto& header = *other.header;
+  auto error = [&](const std::string& reason) {
+    throw std::runtime_error("Cannot merge FlatHistogram '" + std::string(other.name) + "' into '" + mName + "': " + reason);
+  };
+  if ((header.flags & (IsHn | IsSparseHn)) != (mFlags & (IsHn | IsSparseHn))) {
+    error("different types of histograms");
+  }
+  if (header.dimensions != mAxes.size() || header.nCells != mNCells) {
+    error("different number of bins");
+  }
+  const double* edges = other.edges;
+  for (size_t dim = 0; dim < mAxes.size(); dim++) {
+    const auto& axis = other.axes[dim];
+    if (axis.nBins != mAxes[dim].nBins || axis.min != mAxes[dim].min || axis.max != mAxes[dim].max || axis.nEdges != mAxes[dim].nEdges ||
+        !std::equal(mEdges[dim].begin(), mEdges[dim].end(), edges)) {
+      error("different binning of axis " + std::to_string(dim));
+    }
+    edges += axis.nEdges;
+  }
+}
+
+void FlatHistogram::addCell(uint64_t cell, double content, double sumw2)
+{
+  if (!isSparse()) {
+    if (cell >= mNCells) {
+      throw std::runtime_error(errorPrefix + "cell " + std::to_string(cell) + " is out of range");
+    }
+    mContents[cell] += content;
+    if (!mSumw2.empty()) {
+      mSumw2[cell] += sumw2;
+    }
+    return;
+  }
+  if (content == 0 && sumw2 == 0) {
+    return;
+  }
+  auto [position, inserted] = mCellPositions.try_emplace(cell, mContents.size());
+  if (inserted) {
+    if (cell >= mNCells) {
+      mCellPositions.erase(position);
+      throw std::runtime_error(errorPrefix + "cell " + std::to_string(cell) + " is out of range");
+    }
+    mCells.push_back(cell);
+    mContents.push_back(content);
+    if (mFlags & HasSumw2) {
+      mSumw2.push_back(sumw2);
+    }
+  } else {
+    mContents[position->second] += content;
+    if (mFlags & HasSumw2) {
+      mSumw2[position->second] += sumw2;
+    }
+  }
+}
+
+void FlatHistogram::merge(const char* data, size_t size)
+{
+  std::vector<uint64_t> alignedStorage;
+  merge(parse(alignBuffer(data, size, alignedStorage), size));
+}
+
+void FlatHistogram::merge(const View& other)
+{
+  checkCompatible(other);
+  const auto& header = *other.header;
+  bool otherHasSumw2 = header.flags & HasSumw2;
+  if (otherHasSumw2 && !(mFlags & HasSumw2)) {
+    // as in TH1::Sumw2, the sums of squares of the unweighted entries are the contents
+    mFlags |= HasSumw2;
+    mSumw2 = mContents;
+  }
+  // without stored sums of squares the other histogram was filled with unit weights
+  const double* otherSumw2 = otherHasSumw2 ? other.sumw2 : other.contents;
+
+  if (header.encoding == uint8_t(Encoding::Dense) && !isSparse()) {
+    addArrays(mContents.data(), other.contents, mNCells);
+    if (!mSumw2.empty()) {
+      addArrays(mSumw2.data(), otherSumw2, mNCells);
+    }
+  } else {
+    for (uint64_t i = 0; i < other.nStored; i++) {
+      uint64_t cell = other.cells ? other.cells[i] : i;
+      addCell(cell, other.contents[i], otherSumw2[i]);
+    }
+  }
+  mEntries += header.entries;
+  for (size_t i = 0; i < NStats; i++) {
+    mStats[i] += header.stats[i];
+  }
+}
+
+void FlatHistogram::merge(const FlatHistogram& other)
+{
+  auto message = other.encode(isSparse() ? Encoding::Sparse : Encoding::Dense);
+  merge(message.data(), message.size());
+}
+
+void FlatHistogram::reset()
+{
+  if (isSparse()) {
+    mContents.clear();
+    mSumw2.clear();
+    mCells.clear();
+    mCellPositions.clear();
+  } else {
+    std::fill(mContents.begin(), mContents.end(), 0);
+    std::fill(mSumw2.begin(), mSumw2.end(), 0);
+  }
+  mEntries = 0;
+  mStats.fill(0);
+}
+
+double FlatHistogram::getCellContent(uint64_t cell) const
+{
+  if (cell >= mNCells) {
+    throw std::out_of_range("Cell " + std::to_string(cell) + " is out of range of FlatHistogram '" + mName + "'");
+  }
+  if (!isSparse()) {
+    return mContents[cell];
+  }
+  auto position = mCellPositions.find(cell);
+  return position == mCellPositions.end() ? 0. : mContents[position->second];
+}
+
+size_t FlatHistogram::getNonZeroCells() const
+{
+  size_t nonZero = 0;
+  for (size_t i = 0; i < mContents.size(); i++) {
+    nonZero += mContents[i] != 0 || (!mSumw2.empty() && mSumw2[i] != 0);
+  }
+  return nonZero;
+}
+
+size_t FlatHistogram::getPrefixSize() const
+{
+  size_t nEdges = 0;
+  for (const auto& axis : mAxes) {
+    nEdges += axis.nEdges;
+  }
+  return sizeof(Header) + mAxes.size() * sizeof(Axis) + nEdges * sizeof(double) +
+         alignTo8(mClassName.size() + mName.size() + mTitle.size());
+}
+
+FlatHistogram::Encoding FlatHistogram::resolveEncoding(Encoding encoding) const
+{
+  if (isSparse()) {
+    if (encoding == Encoding::Dense) {
+      throw std::runtime_error("FlatHistogram '" + mName + "' of a THnSparse can be encoded only sparsely");
+    }
+    return Encoding::Sparse;
+  }
+  if (encoding == Encoding::Auto) {
+    size_t valuesPerCell = (mFlags & HasSumw2) ? 2 : 1;
+    return getNonZeroCells() * (valuesPerCell + 1) < mNCells * valuesPerCell ? Encoding::Sparse : Encoding::Dense;
+  }
+  return encoding;
+}
+
+size_t FlatHistogram::getEncodedSize(Encoding encoding) const
+{
+  size_t valuesPerCell = (mFlags & HasSumw2) ? 2 : 1;
+  if (resolveEncoding(encoding) == Encoding::Dense) {
+    return getPrefixSize() + mNCells * valuesPerCell * sizeof(double);
+  }
+  return getPrefixSize() + getNonZeroCells() * (sizeof(uint64_t) + valuesPerCell * sizeof(double));
+}
+
+void FlatHistogram::encode(char* buffer, Encoding encoding) const
+{
+  encoding = resolveEncoding(encoding);
+  bool hasSumw2 = mFlags & HasSumw2;
+  Header header;
+  header.encoding = uint8_t(encoding);
+  header.dimensions = mAxes.size();
+  header.flags = mFlags;
+  header.classNameSize = mClassName.size();
+  header.nameSize = mName.size();
+  header.titleSize = mTitle.size();
+  header.nCells = mNCells;
+  header.nStored = encoding == Encoding::Dense ? mNCells : getNonZeroCells();
+  header.entries = mEntries;
+  header.stats = mStats;
+
+  char* pos = buffer;
+  auto write = [&pos](const void* data, size_t size) {
+    if (size > 0) {
+      std::memcpy(pos, data, size);
+    }
+    pos += size;
+  };
+  write(&header, sizeof(header));
+  write(mAxes.data(), mAxes.size() * sizeof(Axis));
+  for (const auto& edges : mEdges) {
+    write(edges.data(), edges.size() * sizeof(double));
+  }
+  write(mClassName.data(), mClassName.size());
+  write(mName.data(), mName.size());
+  write(mTitle.data(), mTitle.size());
+  size_t stringsSize = mClassName.size() + mName.size() + mTitle.size();
+  std::memset(pos, 0, alignTo8(stringsSize) - stringsSize);
+  pos += alignTo8(stringsSize) - stringsSize;
+
+  if (encoding == Encoding::Dense) {
+    write(mContents.data(), mNCells * sizeof(double));
+    write(mSumw2.data(), mSumw2.size() * sizeof(double));
+    return;
+  }
+  // sparse: the cells are stored sorted, the contents and sums of squares follow in the same order
+  std::vector<size_t> order;
+  order.reserve(header.nStored);
+  for (size_t i = 0; i < mContents.size(); i++) {
+    if (mContents[i] != 0 || (hasSumw2 && mSumw2[i] != 0)) {
+      order.push_back(i);
+    }
+  }
+  if (isSparse()) {
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return mCells[a] < mCells[b]; });
+  }
+  auto* cells = reinterpret_cast<uint64_t*>(pos);
+  auto* contents = reinterpret_cast<double*>(pos + order.size() * sizeof(uint64_t));
+  auto* sumw2 = contents + order.size();
+  for (size_t i = 0; i < order.size(); i++) {
+    cells[i] = isSparse() ? mCells[order[i]] : order[i];
+    contents[i] = mContents[order[i]];
+    if (hasSumw2) {
+      sumw2[i] = mSumw2[order[i]];
+    }
+  }
+}
+
+std::vector<char> FlatHistogram::encode(Encoding encoding) const
+{
+  encoding = resolveEncoding(encoding);
+  // the vector storage of the standard allocator is aligned at least to 8 bytes, as required by the arrays
+  std::vector<char> message(getEncodedSize(encoding));
+  encode(message.data(), encoding);
+  return message;
+}
+
+std::vector<char> FlatHistogram::encodeDelta(const FlatHistogram& previous) const
+{
+  auto previousMessage = previous.encode(isSparse() ? Encoding::Sparse : Encoding::Dense);
+  auto view = parse(previousMessage.data(), previousMessage.size());
+  checkCompatible(view);
+
+  FlatHistogram delta = *this;
+  if (!(previous.mFlags & HasSumw2)) {
+    // subtracting the contents of an unweighted histogram would be wrong for the sums of squares as well
+    delta.mFlags &= ~HasSumw2;
+    delta.mSumw2.clear();
+  }
+  for (size_t i = 0; i < view.nStored; i++) {
+    uint64_t cell = view.cells ? view.cells[i] : i;
+    delta.addCell(cell, -view.contents[i], view.sumw2 ? -view.sumw2[i] : 0.);
+  }
+  delta.mEntries -= previous.mEntries;
+  for (size_t i = 0; i < NStats; i++) {
+    delta.mStats[i] -= previous.mStats[i];
+  }
+  return delta.encode(Encoding::Auto);
+}
+
+std::unique_ptr<TObject> FlatHistogram::toROOT() const
+{
+  if (mAxes.empty()) {
+    throw std::runtime_error("FlatHistogram has no binning, it cannot be converted to a ROOT histogram");
+  }
+  std::vector<int> nBins;
+  std::vector<double> mins, maxs;
+  for (const auto& axis : mAxes) {
+    nBins.push_back(axis.nBins);
+    mins.push_back(axis.min);
+    maxs.push_back(axis.max);
+  }
+
+  if (!(mFlags & IsHn)) {
+    auto* cls = TClass::GetClass(mClassName.c_str());
+    if (cls == nullptr || !cls->InheritsFrom(TH1::Class())) {
+      throw std::runtime_error("Class '" + mClassName + "' of FlatHistogram '" + mName + "' is not a known histogram type");
+    }
+    std::unique_ptr<TH1> h(static_cast<TH1*>(cls->New()));
+    if (h->GetDimension() != int(mAxes.size())) {
+      throw std::runtime_error("FlatHistogram '" + mName + "' has a different number of dimensions than '" + mClassName + "'");
+    }
+    h->SetDirectory(nullptr);
+    h->SetNameTitle(mName.c_str(), mTitle.c_str());
+    if (mAxes.size() == 1) {
+      h->SetBins(nBins[0], mins[0], maxs[0]);
+    } else if (mAxes.size() == 2) {
+      h->SetBins(nBins[0], mins[0], maxs[0], nBins[1], mins[1], maxs[1]);
+    } else {
+      h->SetBins(nBins[0], mins[0], maxs[0], nBins[1], mins[1], maxs[1], nBins[2], mins[2], maxs[2]);
+    }
+    TAxis* axes[] = {h->GetXaxis(), h->GetYaxis(), h->GetZaxis()};
+    for (size_t dim = 0; dim < mAxes.size(); dim++) {
+      if (!mEdges[dim].empty()) {
+        axes[dim]->Set(nBins[dim], mEdges[dim].data());
+      }
+    }
+    if (!mSumw2.empty()) {
+      h->Sumw2();
+      std::copy(mSumw2.begin(), mSumw2.end(), h->GetSumw2()->GetArray());
+    }
+    auto* array = dynamic_cast<TArray*>(h.get());
+    for (uint64_t cell = 0; cell < mNCells; cell++) {
+      array->SetAt(mContents[cell], cell);
+    }
+    h->SetEntries(mEntries);
+    auto stats = mStats;
+    h->PutStats(stats.data());
+    return h;
+  }
+
+  std::unique_ptr<THnBase> hn;
+  const char* name = mName.c_str();
+  const char* title = mTitle.c_str();
+  int dim = mAxes.size();
+  bool created = createHn<THnSparseD>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnSparseF>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnSparseL>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnSparseI>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnSparseS>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnSparseC>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnD>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnF>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnL>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnI>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnS>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data()) ||
+                 createHn<THnC>(mClassName, hn, name, title, dim, nBins.data(), mins.data(), maxs.data());
+  if (!created) {
+    throw std::runtime_error("Class '" + mClassName + "' of FlatHistogram '" + mName + "' is not a known histogram type");
+  }
+  for (size_t axis = 0; axis < mAxes.size(); axis++) {
+    if (!mEdges[axis].empty()) {
+      hn->GetAxis(axis)->Set(nBins[axis], mEdges[axis].data());
+    }
+  }
+  if (!mSumw2.empty()) {
+    hn->Sumw2();
+  }
+  std::vector<int> coordinates(mAxes.size());
+  for (size_t i = 0; i < mContents.size(); i++) {
+    if (mContents[i] == 0 && (mSumw2.empty() || mSumw2[i] == 0)) {
+      continue;
+    }
+    getHnCoordinates(isSparse() ? mCells[i] : i, coordinates.data());
+    auto bin = hn->GetBin(coordinates.data(), true);
+    hn->SetBinContent(bin, mContents[i]);
+    if (!mSumw2.empty()) {
+      hn->SetBinError2(bin, mSumw2[i]);
+    }
+  }
+  hn->SetEntries(mEntries);
+  return hn;
+}
+
+} // namespace o2::mergers
@@ -15,6 +15,7 @@
 /// \author Piotr Konopka, piotr.jan.konopka@cern.ch
 
 #include "Mergers/FullHistoryMerger.h"
+#include "Mergers/FlatHistogram.h"
 #include "Mergers/MergerAlgorithm.h"
 #include "Mergers/MergerBuilder.h"
 #include "Mergers/MergeInterface.h"
@@ -123,6 +124,13 @@ void FullHistoryMerger::mergeCache()
       target->merge(other.get());
       mObjectsMerged++;
     }
+  } else if (std::holds_alternative<FlatHistogramPtr>(mMergedObject)) {
+    auto target = std::get<FlatHistogramPtr>(mMergedObject);
+    for (auto& [name, entry] : mCache) {
+      (void)name;
+      target->merge(*std::get<FlatHistogramPtr>(entry));
+      mObjectsMerged++;
+    }
   }
 }
 
@@ -141,6 +149,16 @@ void FullHistoryMerger::publish(framework::DataAllocator& allocator)
                        *std::get<TObjectPtr>(mMergedObject));
     LOG(INFO) << "Published the merged object containing " << mCache.size() + 1 << " incomplete objects. "
               << mUpdatesReceived << " updates were received during the last cycle.";
+  } else if (std::holds_alternative<FlatHistogramPtr>(mMergedObject)) {
+    const auto& histogram = *std::get<FlatHistogramPtr>(mMergedObject);
+    if (mConfig.publishedObjectFormat.value == PublishedObjectFormat::Flat) {
+      auto message = allocator.make<char>(framework::OutputRef{MergerBuilder::mergerOutputBinding(), mSubSpec}, histogram.getEncodedSize());
+      histogram.encode(message.data());
+    } else {
+      allocator.snapshot(framework::OutputRef{MergerBuilder::mergerOutputBinding(), mSubSpec}, *histogram.toROOT());
+    }
+    LOG(INFO) << "Published the merged object containing " << mCache.size() + 1 << " incomplete objects. "
+              << mUpdatesReceived << " updates were received during the last cycle.";
   } else {
     throw std::runtime_error("mMergedObject' variant has no value.");
   }
@@ -16,6 +16,7 @@
 
 #include "Mergers/IntegratingMerger.h"
 
+#include "Mergers/FlatHistogram.h"
 #include "Mergers/MergerAlgorithm.h"
 #include "Mergers/MergerBuilder.h"
 
@@ -61,6 +62,9 @@ void IntegratingMerger::run(framework::ProcessingContext& ctx)
         // We expect that if the first object inherited MergeInterface, then all should.
         auto other = framework::DataRefUtils::as<MergeInterface>(ref);
         std::get<MergeInterfacePtr>(mMergedObject)->merge(other.get());
+      } else if (std::holds_alternative<FlatHistogramPtr>(mMergedObject)) {
+        // Bin arrays are added directly from the message, without deserializing it.
+        std::get<FlatHistogramPtr>(mMergedObject)->merge(ref.payload, DataRefUtils::getPayloadSize(ref));
       } else {
         throw std::runtime_error("mMergedObject' variant has no value.");
       }
@@ -94,6 +98,16 @@ void IntegratingMerger::publish(framework::DataAllocator& allocator)
                        *std::get<TObjectPtr>(mMergedObject));
     LOG(INFO) << "Published the merged object with " << mTotalDeltasMerged << " deltas in total,"
               << " including " << mDeltasMerged << " in the last cycle.";
+  } else if (std::holds_alternative<FlatHistogramPtr>(mMergedObject)) {
+    const auto& histogram = *std::get<FlatHistogramPtr>(mMergedObject);
+    if (mConfig.publishedObjectFormat.value == PublishedObjectFormat::Flat) {
+      auto message = allocator.make<char>(framework::OutputRef{MergerBuilder::mergerOutputBinding(), mSubSpec}, histogram.getEncodedSize());
+      histogram.encode(message.data());
+    } else {
+      allocator.snapshot(framework::OutputRef{MergerBuilder::mergerOutputBinding(), mSubSpec}, *histogram.toROOT());
+    }
+    LOG(INFO) << "Published the merged object with " << mTotalDeltasMerged << " deltas in total,"
+              << " including " << mDeltasMerged << " in the last cycle.";
   } else {
     throw std::runtime_error("mMergedObject' variant has no value.");
   }
@@ -109,6 +109,9 @@ framework::WorkflowSpec MergerInfrastructureBuilder::generateInfrastructure()
       layerConfig.inputObjectTimespan = {InputObjectsTimespan::FullHistory};     // in LastDifference mode only the first layer should integrate
       layerConfig.mergedObjectTimespan = {MergedObjectTimespan::LastDifference}; // and objects that are merged should not be used again
     }
+    if (layer < mergersPerLayer.size() - 1) {
+      layerConfig.publishedObjectFormat = {PublishedObjectFormat::Flat}; // only the last layer has to produce ROOT objects
+    }
     mergerBuilder.setConfig(layerConfig);
 
     framework::Inputs nextLayerInputs;
@@ -16,6 +16,7 @@
 
 #include "Mergers/ObjectStore.h"
 #include "Framework/DataRefUtils.h"
+#include "Mergers/FlatHistogram.h"
 #include "Mergers/MergeInterface.h"
 #include "Mergers/MergerAlgorithm.h"
 #include <TObject.h>
@@ -38,6 +39,10 @@ ObjectStore extractObjectFrom(const framework::DataRef& ref)
 
   using DataHeader = o2::header::DataHeader;
   auto header = o2::header::get<const DataHeader*>(ref.header);
+  if (header->payloadSerializationMethod == o2::header::gSerializationMethodNone &&
+      FlatHistogram::isFlatHistogram(ref.payload, header->payloadSize)) {
+    return std::make_shared<FlatHistogram>(FlatHistogram::decode(ref.payload, header->payloadSize));
+  }
   if (header->payloadSerializationMethod != o2::header::gSerializationMethodROOT) {
     throw std::runtime_error(errorPrefix + "It is not ROOT-serialized");
   }
@@ -9,6 +9,7 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 #include <benchmark/benchmark.h>
+#include "Mergers/FlatHistogram.h"
 
 #include <TObjArray.h>
 #include <TH1.h>
@@ -195,6 +196,96 @@ static void BM_MergingTHnSparse(benchmark::State& state)
   delete m;
 }
 
+// The same as BM_MergingTH2I, but the objects are received in the flat binary format and their bin arrays are added
+static void BM_MergingFlatTH2I(benchmark::State& state)
+{
+  using o2::mergers::FlatHistogram;
+  const size_t entries = state.range(0) == FULL_OBJECTS ? entriesInFull : entriesInDiff;
+  size_t bins = 250; // 250 bins * 250 bins * 4B makes 250kB
+
+  std::vector<std::vector<char>> messages;
+  TF2* uni = new TF2("uni", "1", 0, 1000000, 0, 1000000);
+  for (size_t i = 0; i < collectionSize; i++) {
+    TH2I h(("test" + std::to_string(i)).c_str(), "test", bins, 0, 1000000, bins, 0, 1000000);
+    h.FillRandom("uni", entries);
+    messages.push_back(FlatHistogram(h).encode());
+  }
+
+  TH2I* m = new TH2I("merged", "merged", bins, 0, 1000000, bins, 0, 1000000);
+  // avoid memory overcommitment by doing something with data.
+  for (size_t i = 0; i < bins; i++) {
+    m->SetBinContent(i, 1);
+  }
+  FlatHistogram merged(*m);
+
+  for (auto _ : state) {
+    if (state.range(0) == FULL_OBJECTS) {
+      merged.reset();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& message : messages) {
+      merged.merge(message.data(), message.size());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+
+  delete m;
+  delete uni;
+}
+
+// The same as BM_MergingTHnSparse, with fewer dimensions to let the linearised cell indices fit in 64 bits
+static void BM_MergingFlatTHnSparse(benchmark::State& state)
+{
+  using o2::mergers::FlatHistogram;
+  const size_t entries = state.range(0) == FULL_OBJECTS ? entriesInFull : entriesInDiff;
+
+  const Double_t min = 0.0;
+  const Double_t max = 1000000.0;
+  const size_t dim = 6;
+  const Int_t bins = 250;
+  const Int_t binsDims[dim] = {bins, bins, bins, bins, bins, bins};
+  const Double_t mins[dim] = {min, min, min, min, min, min};
+  const Double_t maxs[dim] = {max, max, max, max, max, max};
+
+  TRandomMixMax gen;
+  gen.SetSeed(std::random_device()());
+  Double_t randomArray[dim];
+  THnSparseI m("merged", "merged", dim, binsDims, mins, maxs);
+  FlatHistogram merged(m);
+  for (auto _ : state) {
+
+    std::vector<std::vector<char>> messages;
+    for (size_t i = 0; i < collectionSize; i++) {
+      THnSparseI h(("test" + std::to_string(i)).c_str(), "test", dim, binsDims, mins, maxs);
+      for (size_t entry = 0; entry < entries; entry++) {
+        gen.RndmArray(dim, randomArray);
+        for (double& r : randomArray) {
+          r *= max;
+        }
+        h.Fill(randomArray);
+      }
+      messages.push_back(FlatHistogram(h).encode());
+    }
+
+    if (state.range(0) == FULL_OBJECTS) {
+      merged.reset();
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& message : messages) {
+      merged.merge(message.data(), message.size());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    auto elapsed_seconds = std::chrono::duration_cast<std::chrono::duration<double>>(end - start);
+    state.SetIterationTime(elapsed_seconds.count());
+  }
+}
+
 static void BM_MergingTTree(benchmark::State& state)
 {
   const size_t entries = state.range(0) == FULL_OBJECTS ? entriesInFull : entriesInDiff;
@@ -256,6 +347,10 @@ BENCHMARK(BM_MergingTH3I)->Arg(DIFF_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTH3I)->Arg(FULL_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTHnSparse)->Arg(DIFF_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTHnSparse)->Arg(FULL_OBJECTS)->UseManualTime();
+BENCHMARK(BM_MergingFlatTH2I)->Arg(DIFF_OBJECTS)->UseManualTime();
+BENCHMARK(BM_MergingFlatTH2I)->Arg(FULL_OBJECTS)->UseManualTime();
+BENCHMARK(BM_MergingFlatTHnSparse)->Arg(DIFF_OBJECTS)->UseManualTime();
+BENCHMARK(BM_MergingFlatTHnSparse)->Arg(FULL_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTTree)->Arg(DIFF_OBJECTS)->UseManualTime();
 BENCHMARK(BM_MergingTTree)->Arg(FULL_OBJECTS)->UseManualTime();
 
@@ -25,6 +25,7 @@
 #include <TMessage.h>
 
 #include "Framework/TMessageSerializer.h"
+#include "Mergers/FlatHistogram.h"
 
 #include <type_traits>
 
@@ -38,6 +39,7 @@
 #include <sstream>
 
 namespace bh = boost::histogram;
+using o2::mergers::FlatHistogram;
 
 enum class Measurement {
   Size,
@@ -447,6 +449,95 @@ static std::vector<Results> BM_THNSparseI(size_t repetitions, const Parameters p
   return allResults;
 }
 
+// Converts the ROOT object to the flat binary format, sends it and adds its bin arrays to the merged object.
+static Results measureFlat(FlatHistogram& merged, const TObject& input)
+{
+  using clock = std::chrono::high_resolution_clock;
+  auto seconds = [](auto start, auto end) { return std::chrono::duration_cast<std::chrono::duration<double>>(end - start).count(); };
+  Results results;
+  results.sizeBytes = merged.getNStored() * sizeof(double);
+
+  auto start = clock::now();
+  auto message = FlatHistogram(input).encode();
+  auto end = clock::now();
+  results.serialisationSeconds = seconds(start, end);
+  results.sizeSerialisedBytes = message.size();
+
+  start = clock::now();
+  auto decoded = FlatHistogram::decode(message.data(), message.size());
+  end = clock::now();
+  (void)decoded;
+  results.deserialisationSeconds = seconds(start, end);
+
+  start = clock::now();
+  merged.merge(message.data(), message.size());
+  end = clock::now();
+  results.mergingSeconds = seconds(start, end);
+  return results;
+}
+
+static std::vector<Results> BM_FlatTH2I(size_t repetitions, const Parameters p)
+{
+  const size_t objSize = p.objectSize;
+  const size_t entries = p.entries;
+  const size_t bins = std::sqrt(objSize / sizeof(Int_t));
+
+  auto m = std::make_unique<TH2I>("merged", "merged", bins, 0, 1000000, bins, 0, 1000000);
+  // avoid memory overcommitment by doing something with data.
+  for (size_t i = 0; i < bins * bins; i++) {
+    m->SetBinContent(i, 1);
+  }
+  FlatHistogram merged(*m);
+
+  auto uni = std::make_unique<TF2>("uni", "1", 0, 1000000, 0, 1000000);
+  auto h = std::make_unique<TH2I>("test", "test", bins, 0, 1000000, bins, 0, 1000000);
+
+  std::vector<Results> allResults;
+  for (size_t r = 0; r < repetitions; r++) {
+    h->Reset();
+    h->FillRandom("uni", entries);
+    allResults.push_back(measureFlat(merged, *h));
+  }
+  return allResults;
+}
+
+static std::vector<Results> BM_FlatTHnSparseI(size_t repetitions, const Parameters p)
+{
+  const size_t bins = p.bins;
+  const size_t dim = p.dimensions;
+  const size_t entries = p.entries;
+
+  const Double_t min = 0.0;
+  const Double_t max = 1000000.0;
+  const std::vector<Int_t> binsDims(dim, bins);
+  const std::vector<Double_t> mins(dim, min);
+  const std::vector<Double_t> maxs(dim, max);
+
+  TRandomMixMax gen;
+  gen.SetSeed(std::random_device()());
+  Double_t randomArray[dim];
+  auto fill = [&](THnSparseI& h) {
+    for (size_t entry = 0; entry < entries; entry++) {
+      gen.RndmArray(dim, randomArray);
+      for (double& r : randomArray) {
+        r *= max;
+      }
+      h.Fill(randomArray);
+    }
+  };
+
+  std::vector<Results> allResults;
+  for (size_t rep = 0; rep < repetitions; rep++) {
+    THnSparseI h("test", "test", dim, binsDims.data(), mins.data(), maxs.data());
+    THnSparseI m("merged", "merged", dim, binsDims.data(), mins.data(), maxs.data());
+    fill(h);
+    fill(m);
+    FlatHistogram merged(m);
+    allResults.push_back(measureFlat(merged, h));
+  }
+  return allResults;
+}
+
 static std::vector<Results> BM_TTree(size_t repetitions, const Parameters p)
 {
   const size_t branchSize = p.branchSize;
@@ -633,6 +724,47 @@ int main(int argc, const char* argv[])
     }
   }
 
+  {
+    // TH2I in the flat binary format
+    std::vector<Parameters> parameters{
+      Parameters::forHistograms(8 << 0, 50000),
+      Parameters::forHistograms(8 << 3, 50000),
+      Parameters::forHistograms(8 << 6, 50000),
+      Parameters::forHistograms(8 << 9, 50000),
+      Parameters::forHistograms(8 << 12, 50000),
+      Parameters::forHistograms(8 << 15, 50000),
+      Parameters::forHistograms(8 << 18, 50000),
+      Parameters::forHistograms(8 << 21, 50000)};
+    for (const auto& p : parameters) {
+      auto results = BM_FlatTH2I(repetitions, p);
+      printResultsCSV(file, "FlatTH2I", p, results);
+      printResultsCSV(std::cout, "FlatTH2I", p, results);
+    }
+  }
+
+  {
+    // THnSparseI in the flat binary format, the linearised cell indices have to fit in 64 bits
+    std::vector<Parameters> parameters{
+      Parameters::forSparse(8, 8, 512),
+      Parameters::forSparse(64, 8, 512),
+      Parameters::forSparse(512, 4, 512),
+      Parameters::forSparse(512, 2, 512),
+      Parameters::forSparse(512, 4, 1),
+      Parameters::forSparse(512, 4, 64),
+      Parameters::forSparse(512, 4, 4096),
+      Parameters::forSparse(512, 4, 262144),
+      Parameters::forSparse(32, 4, 1),
+      Parameters::forSparse(32, 4, 64),
+      Parameters::forSparse(32, 4, 4096),
+      Parameters::forSparse(32, 4, 262144),
+      Parameters::forSparse(32, 4, 2097152)};
+    for (const auto& p : parameters) {
+      auto results = BM_FlatTHnSparseI(repetitions, p);
+      printResultsCSV(file, "FlatTHnSparseI", p, results);
+      printResultsCSV(std::cout, "FlatTHnSparseI", p, results);
+    }
+  }
+
   {
     // TTree
     std::vector<Parameters> parameters{
@@ -0,0 +1,157 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file test_FlatHistogram.cxx
+/// \brief A unit test of the binary histogram transport of mergers
+
+#define BOOST_TEST_MODULE Test Utilities MergerFlatHistogram
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include "Mergers/FlatHistogram.h"
+#include "Mergers/MergerAlgorithm.h"
+
+#include <TH1.h>
+#include <TH2.h>
+#include <THnSparse.h>
+#include <TProfile.h>
+#include <TRandom.h>
+
+#include <cstring>
+
+using namespace o2::mergers;
+
+BOOST_AUTO_TEST_CASE(FlatHistogramRoundTrip)
+{
+  TH2F histo("histo", "title", 10, 0, 10, 20, -1, 1);
+  histo.Fill(5, 0.5);
+  histo.Fill(15, 0.5, 2.);
+  histo.Fill(3, -0.25);
+
+  for (auto encoding : {FlatHistogram::Encoding::Dense, FlatHistogram::Encoding::Sparse}) {
+    auto message = FlatHistogram(histo).encode(encoding);
+    BOOST_CHECK(FlatHistogram::isFlatHistogram(message.data(), message.size()));
+    auto flat = FlatHistogram::decode(message.data(), message.size());
+    BOOST_CHECK_EQUAL(flat.getName(), "histo");
+    BOOST_CHECK_EQUAL(flat.getDimensions(), 2);
+
+    std::unique_ptr<TObject> object = flat.toROOT();
+    auto* result = dynamic_cast<TH2F*>(object.get());
+    BOOST_REQUIRE(result != nullptr);
+    BOOST_CHECK_EQUAL(result->GetTitle(), std::string("title"));
+    BOOST_CHECK_EQUAL(result->GetNcells(), histo.GetNcells());
+    for (int cell = 0; cell < histo.GetNcells(); cell++) {
+      BOOST_CHECK_EQUAL(result->GetBinContent(cell), histo.GetBinContent(cell));
+    }
+    BOOST_CHECK_EQUAL(result->GetEntries(), histo.GetEntries());
+    BOOST_CHECK_CLOSE(result->GetMean(1), histo.GetMean(1), 1e-9);
+  }
+
+  // the arrays are read in place only from aligned buffers, others are copied
+  auto message = FlatHistogram(histo).encode();
+  std::vector<char> misaligned(message.size() + 1);
+  std::copy(message.begin(), message.end(), misaligned.begin() + 1);
+  auto flat = FlatHistogram::decode(misaligned.data() + 1, message.size());
+  BOOST_CHECK_EQUAL(flat.getCellContent(histo.FindBin(5, 0.5)), 1);
+
+  BOOST_CHECK_THROW(FlatHistogram::decode(message.data(), message.size() - 8), std::runtime_error);
+  TProfile profile("profile", "profile", 10, 0, 10);
+  BOOST_CHECK_THROW(FlatHistogram{profile}, std::runtime_error);
+
+  // the number of edges of a variable binned axis has to match its number of bins
+  double edges[] = {0, 1, 2, 4, 8};
+  TH1F variable("variable", "variable", 4, edges);
+  auto variableMessage = FlatHistogram(variable).encode();
+  BOOST_CHECK_NO_THROW(FlatHistogram::decode(variableMessage.data(), variableMessage.size()));
+  FlatHistogram::Axis axis;
+  std::memcpy(&axis, variableMessage.data() + sizeof(FlatHistogram::Header), sizeof(axis));
+  BOOST_CHECK_EQUAL(axis.nEdges, 5u);
+  axis.nEdges = 4;
+  std::memcpy(variableMessage.data() + sizeof(FlatHistogram::Header), &axis, sizeof(axis));
+  BOOST_CHECK_THROW(FlatHistogram::decode(variableMessage.data(), variableMessage.size()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(FlatHistogramMergeDeltas)
+{
+  TH1D reference("histo", "histo", 1000, 0, 1000);
+  TH1D producer("histo", "histo", 1000, 0, 1000);
+  producer.Sumw2();
+  reference.Sumw2();
+  gRandom->SetSeed(1234);
+
+  // the merger integrates the differences sent by the producer
+  FlatHistogram previous(producer);
+  auto first = previous.encode();
+  FlatHistogram merged = FlatHistogram::decode(first.data(), first.size());
+  for (int cycle = 0; cycle < 5; cycle++) {
+    for (int entry = 0; entry < 20; entry++) {
+      double value = gRandom->Uniform(0, 1000);
+      producer.Fill(value, 0.5);
+      reference.Fill(value, 0.5);
+    }
+    FlatHistogram current(producer);
+    auto delta = current.encodeDelta(previous);
+    BOOST_CHECK_LT(delta.size(), current.getEncodedSize(FlatHistogram::Encoding::Dense));
+    merged.merge(delta.data(), delta.size());
+    previous = std::move(current);
+  }
+
+  std::unique_ptr<TObject> object = merged.toROOT();
+  auto* result = dynamic_cast<TH1D*>(object.get());
+  BOOST_REQUIRE(result != nullptr);
+  for (int cell = 0; cell < reference.GetNcells(); cell++) {
+    BOOST_CHECK_CLOSE(result->GetBinContent(cell), reference.GetBinContent(cell), 1e-9);
+    BOOST_CHECK_CLOSE(result->GetBinError(cell), reference.GetBinError(cell), 1e-9);
+  }
+  BOOST_CHECK_EQUAL(result->GetEntries(), reference.GetEntries());
+
+  TH1D otherBinning("histo", "histo", 100, 0, 1000);
+  auto otherMessage = FlatHistogram(otherBinning).encode();
+  BOOST_CHECK_THROW(merged.merge(otherMessage.data(), otherMessage.size()), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(FlatHistogramMergeSparse)
+{
+  const int dim = 4;
+  const int bins[dim] = {100, 200, 300, 400};
+  const double mins[dim] = {0, 0, 0, 0};
+  const double maxs[dim] = {1, 1, 1, 1};
+  THnSparseF target("sparse", "sparse", dim, bins, mins, maxs);
+  THnSparseF other("sparse", "sparse", dim, bins, mins, maxs);
+  gRandom->SetSeed(1234);
+  double x[dim];
+  for (int entry = 0; entry < 1000; entry++) {
+    for (auto& v : x) {
+      v = gRandom->Uniform();
+    }
+    (entry % 2 ? target : other).Fill(x);
+  }
+  other.Fill(x); // a bin filled in both histograms
+
+  FlatHistogram flat(target);
+  BOOST_CHECK(flat.isSparse());
+  auto message = FlatHistogram(other).encode();
+  flat.merge(message.data(), message.size());
+  algorithm::merge(&target, &other);
+
+  std::unique_ptr<TObject> object = flat.toROOT();
+  auto* result = dynamic_cast<THnSparseF*>(object.get());
+  BOOST_REQUIRE(result != nullptr);
+  BOOST_CHECK_EQUAL(result->GetNbins(), target.GetNbins());
+  BOOST_CHECK_EQUAL(result->GetEntries(), target.GetEntries());
+  int coordinates[dim];
+  for (Long64_t bin = 0; bin < target.GetNbins(); bin++) {
+    double content = target.GetBinContent(bin, coordinates);
+    BOOST_CHECK_EQUAL(result->GetBinContent(coordinates), content);
+  }
+}
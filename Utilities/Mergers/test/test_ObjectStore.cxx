@@ -14,6 +14,7 @@
 #define BOOST_TEST_DYN_LINK
 
 #include "Mergers/ObjectStore.h"
+#include "Mergers/FlatHistogram.h"
 #include "Mergers/CustomMergeableObject.h"
 #include "Mergers/CustomMergeableTObject.h"
 #include "Headers/DataHeader.h"
@@ -114,4 +115,23 @@ BOOST_AUTO_TEST_CASE(TestObjectExtraction)
     delete ref.payload;
     delete array;
   }
+
+  {
+    TH1I histo("histo flat", "histo flat", 100, 0, 100);
+    histo.Fill(5);
+    auto message = FlatHistogram(histo).encode();
+
+    DataRef ref;
+    o2::header::DataHeader dh;
+    dh.payloadSerializationMethod = o2::header::gSerializationMethodNone;
+    dh.payloadSize = message.size();
+    ref.header = reinterpret_cast<char const*>(dh.data());
+    ref.payload = message.data();
+
+    auto objStore = object_store_helpers::extractObjectFrom(ref);
+    BOOST_REQUIRE(std::holds_alternative<FlatHistogramPtr>(objStore));
+    auto objExtractedFlat = std::get<FlatHistogramPtr>(objStore);
+    BOOST_CHECK_EQUAL(objExtractedFlat->getName(), "histo flat");
+    BOOST_CHECK_EQUAL(objExtractedFlat->getEntries(), 1);
+  }
 }
\ No newline at end of file
@@ -45,15 +45,17 @@ class Decoder : public internal::DecoderBase<coder_T, stream_T, source_T>
  public:
   using internal::DecoderBase<coder_T, stream_T, source_T>::DecoderBase;
 
-  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  // decode a message encoded with nStreams_V interleaved rANS states
+  template <size_t nStreams_V = 2, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength) const;
 
  private:
-  using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::ransDecoder_t;
+  template <size_t nStreams_V>
+  using interleavedDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::template interleavedDecoder_t<nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
-template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
 void Decoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength) const
 {
   using namespace internal;
@@ -72,26 +74,25 @@ void Decoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT
   // make Iter point to the last last element
   --inputIter;
 
-  ransDecoder_t rans0{this->mSymbolTablePrecission};
-  ransDecoder_t rans1{this->mSymbolTablePrecission};
-
-  inputIter = rans0.init(inputIter);
-  inputIter = rans1.init(inputIter);
-
-  for (size_t i = 0; i < (messageLength & ~1); i += 2) {
-    const int64_t s0 = this->mReverseLUT[rans0.get()];
-    const int64_t s1 = this->mReverseLUT[rans1.get()];
-    *it++ = s0;
-    *it++ = s1;
-    inputIter = rans0.advanceSymbol(inputIter, this->mSymbolTable[s0]);
-    inputIter = rans1.advanceSymbol(inputIter, this->mSymbolTable[s1]);
+  interleavedDecoder_t<nStreams_V> decoder{this->mSymbolTablePrecission};
+  inputIter = decoder.init(inputIter);
+
+  typename interleavedDecoder_t<nStreams_V>::symbolBatch_t symbols;
+  size_t i = 0;
+  for (; i + nStreams_V <= messageLength; i += nStreams_V) {
+    for (size_t lane = 0; lane < nStreams_V; ++lane) {
+      const int64_t s = this->mReverseLUT[decoder.get(lane)];
+      *it++ = s;
+      symbols[lane] = &(this->mSymbolTable[s]);
+    }
+    inputIter = decoder.advanceSymbols(inputIter, symbols);
   }
 
-  // last byte, if message length was odd
-  if (messageLength & 1) {
-    const int64_t s0 = this->mReverseLUT[rans0.get()];
-    *it = s0;
-    inputIter = rans0.advanceSymbol(inputIter, this->mSymbolTable[s0]);
+  // last symbols, if message length is not a multiple of nStreams_V
+  for (size_t lane = 0; i < messageLength; ++i, ++lane) {
+    const int64_t s = this->mReverseLUT[decoder.get(lane)];
+    *it++ = s;
+    inputIter = decoder.advanceSymbol(inputIter, lane, this->mSymbolTable[s]);
   }
   t.stop();
   LOG(debug1) << "Decoder::" << __func__ << " { DecodedSymbols: " << messageLength << ","
@@ -46,15 +46,17 @@ class DedupDecoder : public internal::DecoderBase<coder_T, stream_T, source_T>
   //inherit constructors;
   using internal::DecoderBase<coder_T, stream_T, source_T>::DecoderBase;
 
-  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  // decode a message encoded with nStreams_V interleaved rANS states
+  template <size_t nStreams_V = 1, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, duplicatesMap_t& duplicates) const;
 
  private:
-  using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::ransDecoder_t;
+  template <size_t nStreams_V>
+  using interleavedDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::template interleavedDecoder_t<nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
-template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
 void DedupDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, duplicatesMap_t& duplicates) const
 {
   using namespace internal;
@@ -73,11 +75,18 @@ void DedupDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, sour
   // make Iter point to the last last element
   --inputIter;
 
-  ransDecoder_t rans{this->mSymbolTablePrecission};
-  inputIter = rans.init(inputIter);
+  interleavedDecoder_t<nStreams_V> decoder{this->mSymbolTablePrecission};
+  inputIter = decoder.init(inputIter);
 
-  for (size_t i = 0; i < (messageLength); i++) {
-    const auto s = (this->mReverseLUT)[rans.get()];
+  // number of entropy coded symbols
+  size_t nCodedSymbols = messageLength;
+  for (const auto& [pos, numDuplicates] : duplicates) {
+    nCodedSymbols -= numDuplicates;
+  }
+
+  size_t i = 0; // position in the decoded message
+  auto decode = [&, this](size_t lane) {
+    const auto s = (this->mReverseLUT)[decoder.get(lane)];
 
     // deduplication
     auto duplicatesIter = duplicates.find(i);
@@ -89,9 +98,23 @@ void DedupDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, sour
       }
     }
     *it++ = s;
-    inputIter = rans.advanceSymbol(inputIter, (this->mSymbolTable)[s]);
+    i++;
+    return &(this->mSymbolTable)[s];
+  };
+
+  typename interleavedDecoder_t<nStreams_V>::symbolBatch_t symbols;
+  size_t codedSymbol = 0;
+  for (; codedSymbol + nStreams_V <= nCodedSymbols; codedSymbol += nStreams_V) {
+    for (size_t lane = 0; lane < nStreams_V; ++lane) {
+      symbols[lane] = decode(lane);
+    }
+    inputIter = decoder.advanceSymbols(inputIter, symbols);
   }
 
+  // last symbols, if number of coded symbols is not a multiple of nStreams_V
+  for (size_t lane = 0; codedSymbol < nCodedSymbols; ++codedSymbol, ++lane) {
+    inputIter = decoder.advanceSymbol(inputIter, lane, *decode(lane));
+  }
   t.stop();
   LOG(debug1) << "Decoder::" << __func__ << " { DecodedSymbols: " << messageLength << ","
               << "processedBytes: " << messageLength * sizeof(source_T) << ","
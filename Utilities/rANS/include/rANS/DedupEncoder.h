@@ -46,15 +46,18 @@ class DedupEncoder : public internal::EncoderBase<coder_T, stream_T, source_T>
 
   using duplicatesMap_t = std::map<uint32_t, uint32_t>;
 
-  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
+  // encode using nStreams_V interleaved rANS states sharing the same output stream
+  template <size_t nStreams_V = 1, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
   stream_IT process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, duplicatesMap_t& duplicates) const;
 
  private:
   using ransCoder_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::ransCoder_t;
+  template <size_t nStreams_V>
+  using ransCoders_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::template ransCoders_t<nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
-template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
 stream_IT DedupEncoder<coder_T, stream_T, source_T>::process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, duplicatesMap_t& duplicates) const
 {
   using namespace internal;
@@ -66,43 +69,49 @@ stream_IT DedupEncoder<coder_T, stream_T, source_T>::process(source_IT inputBegi
     LOG(warning) << "passed empty message to encoder, skip encoding";
     return outputBegin;
   }
-  ransCoder_t rans{this->mSymbolTablePrecission};
+  ransCoders_t<nStreams_V> coders = makeCoders<ransCoder_t, nStreams_V>(this->mSymbolTablePrecission);
 
   stream_IT outputIter = outputBegin;
   source_IT inputIT = inputEnd;
 
   const auto inputBufferSize = std::distance(inputBegin, inputEnd);
 
+  // only the first symbol of each run of identical symbols is entropy coded.
+  // The n-th coded symbol is assigned to state n % nStreams_V, so we need to know their number upfront.
+  size_t nCodedSymbols = 1;
+  for (auto iter = std::next(inputBegin); iter != inputEnd; ++iter) {
+    nCodedSymbols += (*iter != *std::prev(iter));
+  }
+
   auto encode = [&inputBegin, &duplicates, this](source_IT symbolIter, stream_IT outputIter, ransCoder_t& coder) {
     const source_T symbol = *symbolIter;
     const auto& encoderSymbol = (this->mSymbolTable)[symbol];
 
-    // dedup step:
+    // dedup step: find out how many duplicates we have
     auto dedupIT = symbolIter;
-    //advance on source by one.
-    --dedupIT;
     size_t numDuplicates = 0;
-
-    // find out how many duplicates we have
-    while (*dedupIT == symbol) {
+    while (dedupIT != inputBegin && *std::prev(dedupIT) == symbol) {
       --dedupIT;
       ++numDuplicates;
     }
 
     // if we have a duplicate treat it.
     if (numDuplicates > 0) {
-      const auto pos = std::distance(inputBegin, symbolIter) - 1;
+      const auto pos = std::distance(inputBegin, dedupIT);
       LOG(trace) << "pos[" << pos << "]: found " << numDuplicates << " duplicates of symbol " << (char)symbol;
       duplicates.emplace(pos, numDuplicates);
     }
 
-    return std::pair(++dedupIT, coder.putSymbol(outputIter, encoderSymbol));
+    return std::pair(dedupIT, coder.putSymbol(outputIter, encoderSymbol));
   };
 
   while (inputIT != inputBegin) { // NB: working in reverse!
-    std::tie(inputIT, outputIter) = encode(--inputIT, outputIter, rans);
+    --nCodedSymbols;
+    std::tie(inputIT, outputIter) = encode(--inputIT, outputIter, coders[nCodedSymbols % nStreams_V]);
+  }
+  for (size_t i = nStreams_V; i-- > 0;) {
+    outputIter = coders[i].flush(outputIter);
   }
-  outputIter = rans.flush(outputIter);
   // first iterator past the range so that sizes, distances and iterators work correctly.
   ++outputIter;
 
@@ -121,6 +130,7 @@ stream_IT DedupEncoder<coder_T, stream_T, source_T>::process(source_IT inputBegi
     << "sourceTypeB: " << sizeof(source_T) << ", "
     << "streamTypeB: " << sizeof(stream_T) << ", "
     << "coderTypeB: " << sizeof(coder_T) << ", "
+    << "nStreams: " << nStreams_V << ", "
     << "probabilityBits: " << this->mSymbolTablePrecission << ", "
     << "inputBufferSizeB: " << inputBufferSizeB << "}";
 #endif
@@ -44,15 +44,18 @@ class Encoder : public internal::EncoderBase<coder_T, stream_T, source_T>
   //inherit constructors;
   using internal::EncoderBase<coder_T, stream_T, source_T>::EncoderBase;
 
-  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
+  // encode using nStreams_V interleaved rANS states sharing the same output stream
+  template <size_t nStreams_V = 2, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool> = true>
   const stream_IT process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin) const;
 
  private:
   using ransCoder_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::ransCoder_t;
+  template <size_t nStreams_V>
+  using ransCoders_t = typename internal::EncoderBase<coder_T, stream_T, source_T>::template ransCoders_t<nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
-template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<source_T, source_IT>, bool>>
 const stream_IT Encoder<coder_T, stream_T, source_T>::process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin) const
 {
   using namespace internal;
@@ -65,8 +68,7 @@ const stream_IT Encoder<coder_T, stream_T, source_T>::process(source_IT inputBeg
     return outputBegin;
   }
 
-  ransCoder_t rans0{this->mSymbolTablePrecission};
-  ransCoder_t rans1{this->mSymbolTablePrecission};
+  ransCoders_t<nStreams_V> coders = makeCoders<ransCoder_t, nStreams_V>(this->mSymbolTablePrecission);
 
   stream_IT outputIter = outputBegin;
   source_IT inputIT = inputEnd;
@@ -79,17 +81,19 @@ const stream_IT Encoder<coder_T, stream_T, source_T>::process(source_IT inputBeg
     return coder.putSymbol(outputIter, encoderSymbol);
   };
 
-  // odd number of bytes?
-  if (inputBufferSize & 1) {
-    outputIter = encode(--inputIT, outputIter, rans0);
+  // symbol i is coded by state i % nStreams_V: first treat the incomplete group at the end of the message
+  for (size_t i = inputBufferSize % nStreams_V; i-- > 0;) {
+    outputIter = encode(--inputIT, outputIter, coders[i]);
   }
 
   while (inputIT != inputBegin) { // NB: working in reverse!
-    outputIter = encode(--inputIT, outputIter, rans1);
-    outputIter = encode(--inputIT, outputIter, rans0);
+    for (size_t i = nStreams_V; i-- > 0;) {
+      outputIter = encode(--inputIT, outputIter, coders[i]);
+    }
+  }
+  for (size_t i = nStreams_V; i-- > 0;) {
+    outputIter = coders[i].flush(outputIter);
   }
-  outputIter = rans1.flush(outputIter);
-  outputIter = rans0.flush(outputIter);
   // first iterator past the range so that sizes, distances and iterators work correctly.
   ++outputIter;
 
@@ -107,6 +111,7 @@ const stream_IT Encoder<coder_T, stream_T, source_T>::process(source_IT inputBeg
               << "sourceTypeB: " << sizeof(source_T) << ", "
               << "streamTypeB: " << sizeof(stream_T) << ", "
               << "coderTypeB: " << sizeof(coder_T) << ", "
+              << "nStreams: " << nStreams_V << ", "
               << "probabilityBits: " << this->mSymbolTablePrecission << ", "
               << "inputBufferSizeB: " << inputBufferSizeB << "}";
 #endif
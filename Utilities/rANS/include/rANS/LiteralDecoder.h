@@ -44,15 +44,17 @@ class LiteralDecoder : public internal::DecoderBase<coder_T, stream_T, source_T>
  public:
   using internal::DecoderBase<coder_T, stream_T, source_T>::DecoderBase;
 
-  template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
+  // decode a message encoded with nStreams_V interleaved rANS states
+  template <size_t nStreams_V = 2, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const;
 
  private:
-  using ransDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::ransDecoder_t;
+  template <size_t nStreams_V>
+  using interleavedDecoder_t = typename internal::DecoderBase<coder_T, stream_T, source_T>::template interleavedDecoder_t<nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
-template <typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
+template <size_t nStreams_V, typename stream_IT, typename source_IT, std::enable_if_t<internal::isCompatibleIter_v<stream_T, stream_IT>, bool>>
 void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, std::vector<source_T>& literals) const
 {
   using namespace internal;
@@ -68,8 +70,10 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
   stream_IT inputIter = inputEnd;
   source_IT it = outputBegin;
 
-  auto decode = [&, this](ransDecoder_t& decoder) {
-    const auto cumul = decoder.get();
+  interleavedDecoder_t<nStreams_V> decoder{this->mSymbolTablePrecission};
+
+  auto decode = [&, this](size_t lane) {
+    const auto cumul = decoder.get(lane);
     const auto streamSymbol = (this->mReverseLUT)[cumul];
     source_T symbol = streamSymbol;
     if (this->mSymbolTable.isEscapeSymbol(streamSymbol)) {
@@ -77,25 +81,28 @@ void LiteralDecoder<coder_T, stream_T, source_T>::process(stream_IT inputEnd, so
       literals.pop_back();
     }
 
-    return std::make_tuple(symbol, decoder.advanceSymbol(inputIter, (this->mSymbolTable)[streamSymbol]));
+    return std::make_tuple(symbol, &(this->mSymbolTable)[streamSymbol]);
   };
 
   // make Iter point to the last last element
   --inputIter;
 
-  ransDecoder_t rans0{this->mSymbolTablePrecission};
-  ransDecoder_t rans1{this->mSymbolTablePrecission};
-  inputIter = rans0.init(inputIter);
-  inputIter = rans1.init(inputIter);
+  inputIter = decoder.init(inputIter);
 
-  for (size_t i = 0; i < (messageLength & ~1); i += 2) {
-    std::tie(*it++, inputIter) = decode(rans0);
-    std::tie(*it++, inputIter) = decode(rans1);
+  typename interleavedDecoder_t<nStreams_V>::symbolBatch_t symbols;
+  size_t i = 0;
+  for (; i + nStreams_V <= messageLength; i += nStreams_V) {
+    for (size_t lane = 0; lane < nStreams_V; ++lane) {
+      std::tie(*it++, symbols[lane]) = decode(lane);
+    }
+    inputIter = decoder.advanceSymbols(inputIter, symbols);
   }
 
-  // last byte, if message length was odd
-  if (messageLength & 1) {
-    std::tie(*it++, inputIter) = decode(rans0);
+  // last symbols, if message length is not a multiple of nStreams_V
+  for (size_t lane = 0; i < messageLength; ++i, ++lane) {
+    const auto [symbol, decoderSymbol] = decode(lane);
+    *it++ = symbol;
+    inputIter = decoder.advanceSymbol(inputIter, lane, *decoderSymbol);
   }
   t.stop();
   LOG(debug1) << "Decoder::" << __func__ << " { DecodedSymbols: " << messageLength << ","
@@ -20,6 +20,7 @@
 #include <memory>
 #include <algorithm>
 #include <iomanip>
+#include <array>
 
 #include <fairlogger/Logger.h>
 #include <stdexcept>
@@ -65,6 +66,8 @@ class EncoderBase
   size_t mSymbolTablePrecission{};
 
   using ransCoder_t = typename internal::Encoder<coder_T, stream_T>;
+  template <size_t nStreams_V>
+  using ransCoders_t = std::array<ransCoder_t, nStreams_V>;
 };
 
 template <typename coder_T, typename stream_T, typename source_T>
@@ -0,0 +1,315 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   InterleavedDecoder.h
+/// @brief  decoder for N independent rANS states sharing a single stream
+
+#ifndef RANS_INTERNAL_INTERLEAVEDDECODER_H_
+#define RANS_INTERNAL_INTERLEAVEDDECODER_H_
+
+#include <array>
+#include <cstdint>
+#include <cassert>
+#include <tuple>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+#include "rANS/internal/DecoderSymbol.h"
+#include "rANS/internal/helper.h"
+
+namespace o2
+{
+namespace rans
+{
+namespace internal
+{
+
+#if defined(__AVX2__)
+// Lookup tables to renormalize 4 lanes of 64 bit states at once: for n lanes in need of renormalization
+// we load the last n words of the stream and distribute them in lane order.
+struct AVX2RenormLUT_t {
+  using entry_t = std::array<int32_t, 4>;
+  alignas(16) std::array<entry_t, 5> loadMask{};
+  alignas(16) std::array<entry_t, 16> permutation{};
+
+  constexpr AVX2RenormLUT_t()
+  {
+    for (int nWords = 0; nWords <= 4; ++nWords) {
+      for (int element = 0; element < 4; ++element) {
+        loadMask[nWords][element] = element >= (4 - nWords) ? -1 : 0;
+      }
+    }
+    for (int renormMask = 0; renormMask < 16; ++renormMask) {
+      int rank = 0;
+      for (int lane = 0; lane < 4; ++lane) {
+        if (renormMask & (1 << lane)) {
+          permutation[renormMask][lane] = 3 - rank++;
+        }
+      }
+    }
+  };
+};
+inline constexpr AVX2RenormLUT_t AVX2RenormLUT{};
+#endif
+
+// Symbol i of a message is always coded by state i % nStreams_V. The states are initialized in increasing
+// and flushed by the encoder in decreasing order, so that for nStreams_V = 2 the layout of the stream is
+// identical to the one of the classic two-way interleaved coder.
+template <typename state_T, typename stream_T, size_t nStreams_V>
+class InterleavedDecoder
+{
+  // the Coder works either with a 64Bit state and 32 bit streaming or
+  //a 32 Bit state and 8 Bit streaming We need to make sure it gets initialized with
+  //the right template arguments at compile time.
+  static_assert((sizeof(state_T) == sizeof(uint32_t) && sizeof(stream_T) == sizeof(uint8_t)) ||
+                  (sizeof(state_T) == sizeof(uint64_t) && sizeof(stream_T) == sizeof(uint32_t)),
+                "Coder can either be 32Bit with 8 Bit stream type or 64 Bit Type with 32 Bit stream type");
+  static_assert(nStreams_V > 0, "need at least one rANS state");
+
+ public:
+  using symbolBatch_t = std::array<const DecoderSymbol*, nStreams_V>;
+
+  explicit InterleavedDecoder(size_t symbolTablePrecission) noexcept;
+
+  static constexpr size_t getNStreams() noexcept { return nStreams_V; };
+
+  // Initializes all states, starting with state 0.
+  template <typename stream_IT>
+  stream_IT init(stream_IT inputIter);
+
+  // Returns the current cumulative frequency of the state in a given lane.
+  inline uint32_t get(size_t lane) const noexcept { return mStates[lane] & ((pow2(mSymbolTablePrecission)) - 1); };
+
+  // Advance a single lane, used for the tail of a message.
+  template <typename stream_IT>
+  stream_IT advanceSymbol(stream_IT inputIter, size_t lane, const DecoderSymbol& symbol);
+
+  // Advance all lanes at once, the lane with the lowest index is renormalized first.
+  template <typename stream_IT>
+  stream_IT advanceSymbols(stream_IT inputIter, const symbolBatch_t& symbols);
+
+ private:
+  alignas(64) std::array<state_T, nStreams_V> mStates{};
+  size_t mSymbolTablePrecission{};
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+  template <typename stream_IT>
+  stream_IT advanceSymbolsAVX512(stream_IT inputIter, const symbolBatch_t& symbols);
+#endif
+#if defined(__AVX2__)
+  template <typename stream_IT>
+  stream_IT advanceSymbolsAVX2(stream_IT inputIter, const symbolBatch_t& symbols);
+#endif
+
+  // Renormalize.
+  template <typename stream_IT>
+  std::tuple<state_T, stream_IT> renorm(state_T x, stream_IT iter);
+
+  inline static constexpr state_T LOWER_BOUND = needs64Bit<state_T>() ? (1u << 31) : (1u << 23); // lower bound of our normalization interval
+
+  inline static constexpr state_T STREAM_BITS = sizeof(stream_T) * 8; // lower bound of our normalization interval
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+InterleavedDecoder<state_T, stream_T, nStreams_V>::InterleavedDecoder(size_t symbolTablePrecission) noexcept : mSymbolTablePrecission{symbolTablePrecission} {};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::init(stream_IT inputIter)
+{
+  stream_IT streamPosition = inputIter;
+
+  for (auto& state : mStates) {
+    state_T newState = 0;
+    if constexpr (needs64Bit<state_T>()) {
+      newState = static_cast<state_T>(*streamPosition) << 0;
+      --streamPosition;
+      newState |= static_cast<state_T>(*streamPosition) << 32;
+      --streamPosition;
+    } else {
+      newState = static_cast<state_T>(*streamPosition) << 0;
+      --streamPosition;
+      newState |= static_cast<state_T>(*streamPosition) << 8;
+      --streamPosition;
+      newState |= static_cast<state_T>(*streamPosition) << 16;
+      --streamPosition;
+      newState |= static_cast<state_T>(*streamPosition) << 24;
+      --streamPosition;
+    }
+    state = newState;
+  }
+  return streamPosition;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbol(stream_IT inputIter, size_t lane, const DecoderSymbol& symbol)
+{
+  static_assert(std::is_same<typename std::iterator_traits<stream_IT>::value_type, stream_T>::value);
+  assert(lane < nStreams_V);
+
+  const state_T mask = (pow2(mSymbolTablePrecission)) - 1;
+
+  // s, x = D(x)
+  state_T newState = mStates[lane];
+  newState = symbol.getFrequency() * (newState >> mSymbolTablePrecission) + (newState & mask) - symbol.getCumulative();
+
+  // renormalize
+  const auto [renormedState, newStreamPosition] = this->renorm(newState, inputIter);
+  mStates[lane] = renormedState;
+  return newStreamPosition;
+};
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbols(stream_IT inputIter, const symbolBatch_t& symbols)
+{
+  static_assert(std::is_same<typename std::iterator_traits<stream_IT>::value_type, stream_T>::value);
+
+  // the vectorized kernels need 64 bit states, which renormalize by at most one stream word per step,
+  // and direct access to the underlying memory of the stream.
+  [[maybe_unused]] constexpr bool isSIMDCompatible = needs64Bit<state_T>() && std::is_pointer_v<stream_IT>;
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+  if constexpr (isSIMDCompatible && (nStreams_V % 8 == 0)) {
+    return advanceSymbolsAVX512(inputIter, symbols);
+  }
+#endif
+#if defined(__AVX2__)
+  if constexpr (isSIMDCompatible && (nStreams_V % 4 == 0)) {
+    return advanceSymbolsAVX2(inputIter, symbols);
+  }
+#endif
+
+  // scalar fallback: the lanes are independent up to the renormalization, which has to respect the lane order.
+  stream_IT streamPosition = inputIter;
+  for (size_t lane = 0; lane < nStreams_V; ++lane) {
+    streamPosition = advanceSymbol(streamPosition, lane, *symbols[lane]);
+  }
+  return streamPosition;
+};
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__) && defined(__AVX512VL__)
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbolsAVX512(stream_IT inputIter, const symbolBatch_t& symbols)
+{
+  const __m512i mask = _mm512_set1_epi64((pow2(mSymbolTablePrecission)) - 1);
+  const __m512i lowerBound = _mm512_set1_epi64(LOWER_BOUND);
+  const __m128i shift = _mm_cvtsi64_si128(mSymbolTablePrecission);
+  const __m256i reverse = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  stream_IT streamPosition = inputIter;
+  for (size_t lane = 0; lane < nStreams_V; lane += 8) {
+    const auto* sym = symbols.data() + lane;
+    const __m512i frequency = _mm512_set_epi64(sym[7]->getFrequency(), sym[6]->getFrequency(), sym[5]->getFrequency(), sym[4]->getFrequency(),
+                                               sym[3]->getFrequency(), sym[2]->getFrequency(), sym[1]->getFrequency(), sym[0]->getFrequency());
+    const __m512i cumulative = _mm512_set_epi64(sym[7]->getCumulative(), sym[6]->getCumulative(), sym[5]->getCumulative(), sym[4]->getCumulative(),
+                                                sym[3]->getCumulative(), sym[2]->getCumulative(), sym[1]->getCumulative(), sym[0]->getCumulative());
+    __m512i state = _mm512_load_si512(mStates.data() + lane);
+
+    // s, x = D(x)
+    const __m512i product = _mm512_mullo_epi64(frequency, _mm512_srl_epi64(state, shift));
+    state = _mm512_sub_epi64(_mm512_add_epi64(product, _mm512_and_si512(state, mask)), cumulative);
+
+    // renormalize: the n-th lane that needs a new word gets the n-th word when reading the stream backwards
+    const __mmask8 renormMask = _mm512_cmplt_epu64_mask(state, lowerBound);
+    if (renormMask) {
+      const int nWords = __builtin_popcount(renormMask);
+      // masked loads do not touch memory of masked out elements, we never read in front of the stream
+      const __m256i words = _mm256_maskz_loadu_epi32((1u << nWords) - 1, streamPosition - (nWords - 1));
+      const __m256i reversedWords = _mm256_permutexvar_epi32(_mm256_add_epi32(reverse, _mm256_set1_epi32(nWords - 8)), words);
+      const __m512i newWords = _mm512_cvtepu32_epi64(_mm256_maskz_expand_epi32(renormMask, reversedWords));
+      state = _mm512_mask_or_epi64(state, renormMask, _mm512_slli_epi64(state, STREAM_BITS), newWords);
+      streamPosition -= nWords;
+    }
+    _mm512_store_si512(mStates.data() + lane, state);
+  }
+  return streamPosition;
+};
+#endif
+
+#if defined(__AVX2__)
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline stream_IT InterleavedDecoder<state_T, stream_T, nStreams_V>::advanceSymbolsAVX2(stream_IT inputIter, const symbolBatch_t& symbols)
+{
+  const __m256i mask = _mm256_set1_epi64x((pow2(mSymbolTablePrecission)) - 1);
+  const __m256i lowerBound = _mm256_set1_epi64x(LOWER_BOUND);
+  const __m128i shift = _mm_cvtsi64_si128(mSymbolTablePrecission);
+
+  stream_IT streamPosition = inputIter;
+  for (size_t lane = 0; lane < nStreams_V; lane += 4) {
+    const auto* sym = symbols.data() + lane;
+    const __m256i frequency = _mm256_set_epi64x(sym[3]->getFrequency(), sym[2]->getFrequency(), sym[1]->getFrequency(), sym[0]->getFrequency());
+    const __m256i cumulative = _mm256_set_epi64x(sym[3]->getCumulative(), sym[2]->getCumulative(), sym[1]->getCumulative(), sym[0]->getCumulative());
+    __m256i state = _mm256_load_si256(reinterpret_cast<const __m256i*>(mStates.data() + lane));
+
+    // s, x = D(x). There is no 64x64 bit multiply in AVX2, but the frequency fits into 32 bits,
+    // so we multiply both halves of the quotient separately.
+    const __m256i quotient = _mm256_srl_epi64(state, shift);
+    const __m256i productLow = _mm256_mul_epu32(frequency, quotient);
+    const __m256i productHigh = _mm256_mul_epu32(frequency, _mm256_srli_epi64(quotient, 32));
+    const __m256i product = _mm256_add_epi64(productLow, _mm256_slli_epi64(productHigh, 32));
+    state = _mm256_sub_epi64(_mm256_add_epi64(product, _mm256_and_si256(state, mask)), cumulative);
+
+    // renormalize: the n-th lane that needs a new word gets the n-th word when reading the stream backwards.
+    // States are < 2^63, so the signed comparison is safe.
+    const __m256i needsRenorm = _mm256_cmpgt_epi64(lowerBound, state);
+    const int renormMask = _mm256_movemask_pd(_mm256_castsi256_pd(needsRenorm));
+    if (renormMask) {
+      const int nWords = __builtin_popcount(renormMask);
+      // masked loads do not touch memory of masked out elements, we never read in front of the stream
+      const __m128i loadMask = _mm_load_si128(reinterpret_cast<const __m128i*>(AVX2RenormLUT.loadMask[nWords].data()));
+      const __m128i permutation = _mm_load_si128(reinterpret_cast<const __m128i*>(AVX2RenormLUT.permutation[renormMask].data()));
+      const __m128i words = _mm_maskload_epi32(reinterpret_cast<const int*>(streamPosition - 3), loadMask);
+      const __m128i newWords = _mm_castps_si128(_mm_permutevar_ps(_mm_castsi128_ps(words), permutation));
+      const __m256i renormed = _mm256_or_si256(_mm256_slli_epi64(state, STREAM_BITS), _mm256_cvtepu32_epi64(newWords));
+      state = _mm256_blendv_epi8(state, renormed, needsRenorm);
+      streamPosition -= nWords;
+    }
+    _mm256_store_si256(reinterpret_cast<__m256i*>(mStates.data() + lane), state);
+  }
+  return streamPosition;
+};
+#endif
+
+template <typename state_T, typename stream_T, size_t nStreams_V>
+template <typename stream_IT>
+inline std::tuple<state_T, stream_IT> InterleavedDecoder<state_T, stream_T, nStreams_V>::renorm(state_T state, stream_IT inputIter)
+{
+  stream_IT streamPosition = inputIter;
+
+  // renormalize
+  if (state < LOWER_BOUND) {
+    if constexpr (needs64Bit<state_T>()) {
+      state = (state << STREAM_BITS) | *streamPosition;
+      --streamPosition;
+      assert(state >= LOWER_BOUND);
+    } else {
+
+      do {
+        state = (state << STREAM_BITS) | *streamPosition;
+        --streamPosition;
+      } while (state < LOWER_BOUND);
+    }
+  }
+  return std::make_tuple(state, streamPosition);
+}
+
+} // namespace internal
+} // namespace rans
+} // namespace o2
+
+#endif /* RANS_INTERNAL_INTERLEAVEDDECODER_H_ */
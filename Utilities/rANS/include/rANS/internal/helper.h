@@ -22,6 +22,8 @@
 #include <chrono>
 #include <type_traits>
 #include <iterator>
+#include <array>
+#include <utility>
 
 namespace o2
 {
@@ -83,6 +85,19 @@ class RANSTimer
   std::chrono::time_point<std::chrono::high_resolution_clock> mStop;
 };
 
+// array of identically initialized coders, needed because coders are not default constructible
+template <typename coder_T, size_t nStreams_V, size_t... Is>
+inline std::array<coder_T, nStreams_V> makeCoders(size_t symbolTablePrecission, std::index_sequence<Is...>)
+{
+  return {{((void)Is, coder_T{symbolTablePrecission})...}};
+}
+
+template <typename coder_T, size_t nStreams_V>
+inline std::array<coder_T, nStreams_V> makeCoders(size_t symbolTablePrecission)
+{
+  return makeCoders<coder_T, nStreams_V>(symbolTablePrecission, std::make_index_sequence<nStreams_V>{});
+}
+
 template <typename T, typename IT>
 inline constexpr bool isCompatibleIter_v = std::is_convertible_v<typename std::iterator_traits<IT>::value_type, T>;
 template <typename IT>
@@ -60,6 +60,10 @@ using DedupDecoder32 = DedupDecoder<uint32_t, uint8_t, source_T>;
 template <typename source_T>
 using DedupDecoder64 = DedupDecoder<uint64_t, uint32_t, source_T>;
 
+// number of rANS states interleaved on a single stream by the multi-stream coding scheme,
+// allows to decode 8 symbols independently and to fill a full AVX-512 register with 64 bit states.
+inline constexpr size_t NInterleavedStreams = 8;
+
 inline size_t calculateMaxBufferSize(size_t num, size_t rangeBits, size_t sizeofStreamT)
 {
   //  // RS: w/o safety margin the o2-test-ctf-io produces an overflow in the Encoder::process
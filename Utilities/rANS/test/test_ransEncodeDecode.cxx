@@ -121,42 +121,42 @@ struct EncodeDecodeBase {
   std::vector<typename Params<coder_T>::source_t> decodeBuffer{};
 };
 
-template <typename coder_T, class dictString_T, class testString_T>
+template <typename coder_T, class dictString_T, class testString_T, size_t nStreams_V = 2>
 struct EncodeDecode : public EncodeDecodeBase<o2::rans::Encoder, o2::rans::Decoder, coder_T, dictString_T, testString_T> {
   void encode() override
   {
-    BOOST_CHECK_NO_THROW(this->encoder.process(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer)));
+    BOOST_CHECK_NO_THROW(this->encoder.template process<nStreams_V>(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer)));
   };
   void decode() override
   {
-    BOOST_CHECK_NO_THROW(this->decoder.process(this->encodeBuffer.end(), std::back_inserter(this->decodeBuffer), this->source.data.size()));
+    BOOST_CHECK_NO_THROW(this->decoder.template process<nStreams_V>(this->encodeBuffer.data() + this->encodeBuffer.size(), std::back_inserter(this->decodeBuffer), this->source.data.size()));
   };
 };
 
-template <typename coder_T, class dictString_T, class testString_T>
+template <typename coder_T, class dictString_T, class testString_T, size_t nStreams_V = 2>
 struct EncodeDecodeLiteral : public EncodeDecodeBase<o2::rans::LiteralEncoder, o2::rans::LiteralDecoder, coder_T, dictString_T, testString_T> {
   void encode() override
   {
-    BOOST_CHECK_NO_THROW(this->encoder.process(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer), literals));
+    BOOST_CHECK_NO_THROW(this->encoder.template process<nStreams_V>(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer), literals));
   };
   void decode() override
   {
-    BOOST_CHECK_NO_THROW(this->decoder.process(this->encodeBuffer.end(), std::back_inserter(this->decodeBuffer), this->source.data.size(), literals));
+    BOOST_CHECK_NO_THROW(this->decoder.template process<nStreams_V>(this->encodeBuffer.data() + this->encodeBuffer.size(), std::back_inserter(this->decodeBuffer), this->source.data.size(), literals));
     BOOST_CHECK(literals.empty());
   };
 
   std::vector<typename Params<coder_T>::source_t> literals;
 };
 
-template <typename coder_T, class dictString_T, class testString_T>
+template <typename coder_T, class dictString_T, class testString_T, size_t nStreams_V = 1>
 struct EncodeDecodeDedup : public EncodeDecodeBase<o2::rans::DedupEncoder, o2::rans::DedupDecoder, coder_T, dictString_T, testString_T> {
   void encode() override
   {
-    BOOST_CHECK_NO_THROW(this->encoder.process(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer), duplicates));
+    BOOST_CHECK_NO_THROW(this->encoder.template process<nStreams_V>(std::begin(this->source.data), std::end(this->source.data), std::back_inserter(this->encodeBuffer), duplicates));
   };
   void decode() override
   {
-    BOOST_CHECK_NO_THROW(this->decoder.process(this->encodeBuffer.end(), std::back_inserter(this->decodeBuffer), this->source.data.size(), duplicates));
+    BOOST_CHECK_NO_THROW(this->decoder.template process<nStreams_V>(this->encodeBuffer.data() + this->encodeBuffer.size(), std::back_inserter(this->decodeBuffer), this->source.data.size(), duplicates));
   };
 
   using params_t = Params<coder_T>;
@@ -180,10 +180,27 @@ using testCase_t = boost::mpl::vector<EncodeDecode<uint32_t, EmptyTestString, Em
                                       EncodeDecodeDedup<uint32_t, FullTestString, FullTestString>,
                                       EncodeDecodeDedup<uint64_t, FullTestString, FullTestString>>;
 
+using interleavedTestCase_t = boost::mpl::vector<EncodeDecode<uint32_t, EmptyTestString, EmptyTestString, o2::rans::NInterleavedStreams>,
+                                                 EncodeDecode<uint32_t, FullTestString, FullTestString, o2::rans::NInterleavedStreams>,
+                                                 EncodeDecode<uint64_t, FullTestString, FullTestString, o2::rans::NInterleavedStreams>,
+                                                 EncodeDecode<uint64_t, FullTestString, FullTestString, 5>,
+                                                 EncodeDecodeLiteral<uint32_t, EmptyTestString, FullTestString, o2::rans::NInterleavedStreams>,
+                                                 EncodeDecodeLiteral<uint64_t, EmptyTestString, FullTestString, o2::rans::NInterleavedStreams>,
+                                                 EncodeDecodeDedup<uint32_t, FullTestString, FullTestString, o2::rans::NInterleavedStreams>,
+                                                 EncodeDecodeDedup<uint64_t, FullTestString, FullTestString, o2::rans::NInterleavedStreams>>;
+
 BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecode, testCase_T, testCase_t)
 {
   testCase_T testCase;
   testCase.encode();
   testCase.decode();
   testCase.check();
-};
\ No newline at end of file
+};
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_encodeDecodeInterleaved, testCase_T, interleavedTestCase_t)
+{
+  testCase_T testCase;
+  testCase.encode();
+  testCase.decode();
+  testCase.check();
+};
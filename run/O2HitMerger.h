@@ -25,6 +25,7 @@
 #include <SimulationDataFormat/PrimaryChunk.h>
 #include <DetectorsCommonDataFormats/DetID.h>
 #include <DetectorsCommonDataFormats/NameConf.h>
+#include <DetectorsBase/FlatHits.h>
 #include <gsl/gsl>
 #include "TFile.h"
 #include "TMemFile.h"
@@ -222,6 +223,7 @@ class O2HitMerger : public FairMQDevice
     mPartsCheckSum.clear();
     mEventToTTreeMap.clear();
     mEventToTMemFileMap.clear();
+    mEventToFlatHitsMap.clear();
     mEntries = 0;
     mEventChecksum = 0;
     return true;
@@ -251,8 +253,8 @@ class O2HitMerger : public FairMQDevice
   void consumeHits(int eventID, FairMQParts& data, int& index)
   {
     auto detIDmessage = std::move(data.At(index++));
-    // this should be a detector ID
-    if (detIDmessage->GetSize() == 4) {
+    // this should be a detector ID, or a HitHeader with the detector ID and the encoding of the hits
+    if (detIDmessage->GetSize() == 4 || detIDmessage->GetSize() == sizeof(o2::base::HitHeader)) {
       auto ptr = (int*)detIDmessage->GetData();
       o2::detectors::DetID id(ptr[0]);
       LOG(DEBUG2) << "I1 " << ptr[0] << " NAME " << id.getName() << " MB "
@@ -263,7 +265,15 @@ class O2HitMerger : public FairMQDevice
       // get the detector that can interpret it
       auto detector = mDetectorInstances[id].get();
       if (detector) {
-        detector->fillHitBranch(*tree, data, index);
+        if (detIDmessage->GetSize() == sizeof(o2::base::HitHeader) &&
+            reinterpret_cast<o2::base::HitHeader*>(ptr)->encoding == o2::base::HitEncoding::Flat) {
+          // the hits are kept as received until the event is complete, the sub-event entry is the
+          // current one of the SubEventInfo branch
+          const std::lock_guard<std::mutex> lock(mMapsMtx);
+          detector->collectFlatHits(data, index, tree->GetEntries(), mEventToFlatHitsMap[eventID][id]);
+        } else {
+          detector->fillHitBranch(*tree, data, index);
+        }
       }
     }
   }
@@ -432,6 +442,7 @@ class O2HitMerger : public FairMQDevice
     delete mEventToTMemFileMap[eventID];
     mEventToTTreeMap.erase(eventID);
     mEventToTMemFileMap.erase(eventID); // remove memfile
+    mEventToFlatHitsMap.erase(eventID); // releases the hits received in the flat encoding
   }
 
   template <typename T>
@@ -638,6 +649,14 @@ class O2HitMerger : public FairMQDevice
     mDetectorOutFiles[detID] = new TFile(name.c_str(), "RECREATE");
     mDetectorToTTreeMap[detID] = new TTree("o2sim", "o2sim");
     mDetectorToTTreeMap[detID]->SetDirectory(mDetectorOutFiles[detID]);
+
+    // the flat files receive the hits merged from the flat encoding only
+    mDetectorFlatOutFiles.erase(detID);
+    if (o2::conf::SimConfig::Instance().useFlatHits() && o2::conf::SimConfig::Instance().writeFlatHits()) {
+      auto writer = std::make_unique<o2::base::FlatHitFileWriter>();
+      writer->open(o2::base::NameConf::getHitsFileName(detID, prefix, o2::base::NameConf::HITSFLATEXT), detID);
+      mDetectorFlatOutFiles[detID] = std::move(writer);
+    }
   }
 
   // This method goes over the tree containing data for a given event; potentially merges
@@ -725,11 +744,27 @@ class O2HitMerger : public FairMQDevice
     // c) do the merge procedure for all hits ... delegate this to detector specific functions
     // since they know about types; number of branches; etc.
     // this will also fix the trackIDs inside the hits
+    // the hits received in the flat encoding are concatenated directly, without going through the TTree
+    std::map<int, std::vector<o2::base::FlatHitChunk>>* flatHits = nullptr;
+    {
+      const std::lock_guard<std::mutex> lock(mMapsMtx);
+      auto iter = mEventToFlatHitsMap.find(eventID);
+      if (iter != mEventToFlatHitsMap.end()) {
+        flatHits = &iter->second;
+      }
+    }
     for (int id = 0; id < mDetectorInstances.size(); ++id) {
       auto& det = mDetectorInstances[id];
       if (det) {
         auto hittree = mDetectorToTTreeMap[id];
-        det->mergeHitEntries(*tree, *hittree, trackoffsets, nprimaries, subevOrdered);
+        auto detFlatHits = flatHits ? flatHits->find(id) : std::map<int, std::vector<o2::base::FlatHitChunk>>::iterator{};
+        if (flatHits && detFlatHits != flatHits->end()) {
+          auto writer = mDetectorFlatOutFiles.find(id);
+          det->mergeFlatHits(detFlatHits->second, *hittree, writer != mDetectorFlatOutFiles.end() ? writer->second.get() : nullptr,
+                             trackoffsets, nprimaries, subevOrdered);
+        } else {
+          det->mergeHitEntries(*tree, *hittree, trackoffsets, nprimaries, subevOrdered);
+        }
         hittree->SetEntries(hittree->GetEntries() + 1);
         LOG(INFO) << "flushing tree to file " << hittree->GetDirectory()->GetFile()->GetName();
         mDetectorOutFiles[id]->Write("", TObject::kOverwrite);
@@ -752,16 +787,18 @@ class O2HitMerger : public FairMQDevice
   std::string mOutFileName; //!
 
   // structures for the final flush
-  TFile* mOutFile;                                     //! outfile for kinematics
-  TTree* mOutTree;                                     //! tree (kinematics) associated to mOutFile
-  std::unordered_map<int, TFile*> mDetectorOutFiles;   //! outfiles per detector for hits
-  std::unordered_map<int, TTree*> mDetectorToTTreeMap; //! the trees
+  TFile* mOutFile;                                                                             //! outfile for kinematics
+  TTree* mOutTree;                                                                             //! tree (kinematics) associated to mOutFile
+  std::unordered_map<int, TFile*> mDetectorOutFiles;                                           //! outfiles per detector for hits
+  std::unordered_map<int, TTree*> mDetectorToTTreeMap;                                         //! the trees
+  std::unordered_map<int, std::unique_ptr<o2::base::FlatHitFileWriter>> mDetectorFlatOutFiles; //! optional flat outfiles per detector for hits
 
   // intermediate structures to collect data per event
-  std::unordered_map<int, TTree*> mEventToTTreeMap;       //! in memory trees to collect / presort incoming data per event
-  std::unordered_map<int, TMemFile*> mEventToTMemFileMap; //! files associated to the TTrees
-  std::thread mMergerIOThread;                            //! a thread used to do hit merging and IO flushing asynchronously
-  std::mutex mMapsMtx;                                    //!
+  std::unordered_map<int, TTree*> mEventToTTreeMap;                                                //! in memory trees to collect / presort incoming data per event
+  std::unordered_map<int, TMemFile*> mEventToTMemFileMap;                                          //! files associated to the TTrees
+  std::unordered_map<int, std::map<int, std::vector<o2::base::FlatHitChunk>>> mEventToFlatHitsMap; //! hits received in the flat encoding, per event and detector
+  std::thread mMergerIOThread;                                                                     //! a thread used to do hit merging and IO flushing asynchronously
+  std::mutex mMapsMtx;                                                                             //!
   int mEntries = 0;         //! counts the number of entries in the branches
   int mEventChecksum = 0;   //! checksum for events
   int mNExpectedEvents = 0; //! number of events that we expect to receive